@@ -0,0 +1,512 @@
+// Benchmark.hpp
+#pragma once
+
+#include "Statistics.hpp"
+#include "Platform.hpp"
+#include "../Profile/Roofline.hpp"
+#include "../Profile/PerfCounters.hpp"
+#include "../Profile/Trace.hpp"
+#include <ctime>
+
+#define _MATH_BENCHMARK_CAT_IMPL_(a, b) a##b
+#define _MATH_BENCHMARK_CAT_(a, b) _MATH_BENCHMARK_CAT_IMPL_(a, b)
+// Defines a function(run at static initialization) that registers benchmarks through math::bench::register_benchmark.
+#define _MATH_BENCHMARK_REGISTRAR_(id) \
+    static void id(); \
+    static const bool _MATH_BENCHMARK_CAT_(id, _registered) = (id(), true); \
+    static void id()
+
+namespace math::bench {
+/**
+ * @brief Keeping the compiler from optimizing away a value computed by a benchmark.
+ * @tparam T Type of the value.
+ * @param value Value that must be treated as observed.
+*/
+_MTEMPL_ inline void do_not_optimize(T &&value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    const volatile void *volatile sink = &value;
+    (void)sink;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+/**
+ * @brief Keeping the compiler from caching memory across this point(writes before it are considered observed).
+*/
+inline void clobber_memory() noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+/**
+ * @brief The hardware counters of the calling thread and of every thread of the OpenMP team, summed.
+ * @note The OpenMP runtime reuses its threads for teams of the same size, so the counters follow every later parallel region of that size.
+ *       Time the team spends spinning between regions is counted too.
+*/
+class TeamPerfCounters {
+    public:
+        TeamPerfCounters() : m_groups(static_cast<size_t>(omp_get_max_threads())) {
+            #pragma omp parallel num_threads(static_cast<int>(m_groups.size()))
+            {
+                try { m_groups[static_cast<size_t>(omp_get_thread_num())] = std::make_unique<math::profile::PerfCounterGroup>(); }
+                catch(...) {} // Leaves that thread uncounted, mask() reports nothing then.
+            }
+        }
+
+    public:
+        _NODISC_ size_t size() const noexcept { return m_groups.size(); }
+
+        // Events counted on every thread of the team.
+        _NODISC_ uint32_t mask() const noexcept {
+            uint32_t result = ~0u;
+            for (const auto &group : m_groups) result &= group ? group->mask() : 0u;
+            return m_groups.empty() ? 0u : result;
+        }
+
+        /**
+         * @brief Sampling every thread's group.
+         * @param out One sample per thread, sized to size().
+        */
+        void sample(std::vector<math::profile::PerfSample> &out) const noexcept {
+            for (size_t t = 0; t < m_groups.size(); t++) out[t] = m_groups[t] ? m_groups[t]->sample() : math::profile::PerfSample{};
+        }
+
+        _NODISC_ math::profile::PerfReading delta(const std::vector<math::profile::PerfSample> &start, const std::vector<math::profile::PerfSample> &end) const noexcept {
+            math::profile::PerfReading result;
+            for (size_t t = 0; t < m_groups.size(); t++) result += math::profile::perf_delta(start[t], end[t]);
+            result.mask &= mask();
+            return result;
+        }
+
+    private:
+        std::vector<std::unique_ptr<math::profile::PerfCounterGroup>> m_groups;
+};
+
+/**
+ * @brief State of a single timed run of a benchmark, the benchmark body loops on keep_running().
+*/
+class State {
+    public:
+        using clock_t = std::chrono::steady_clock;
+
+    public:
+        explicit State(const size_t iterations, const TeamPerfCounters *perf = nullptr) : m_iterations(iterations), m_remaining(iterations), m_perf(perf) {
+            if (m_perf) {
+                m_perf_start.resize(m_perf->size());
+                m_perf_end.resize(m_perf->size());
+            }
+        }
+
+    public:
+        /**
+         * @brief Advancing the benchmark loop, the clock starts on the first call and stops on the last one.
+         * @return Whether another operation has to be timed.
+        */
+        _NODISC_ bool keep_running() noexcept {
+            if (!m_started) [[unlikely]] {
+                m_started = true;
+                start_perf();
+                m_start = clock_t::now();
+            }
+            if (m_remaining != 0) [[likely]] {
+                --m_remaining;
+                return true;
+            }
+            if (!m_paused) {
+                m_elapsed += clock_t::now() - m_start;
+                stop_perf();
+            }
+            return false;
+        }
+
+        // Excluding per-operation setup(e.g. restoring a matrix that the operation mutates) from the timing.
+        void pause_timing() noexcept {
+            if (m_paused) return;
+            m_elapsed += clock_t::now() - m_start;
+            stop_perf();
+            m_paused = true;
+        }
+        void resume_timing() noexcept {
+            if (!m_paused) return;
+            m_paused = false;
+            start_perf();
+            m_start = clock_t::now();
+        }
+
+    public:
+        void set_bytes_per_op(const double bytes) noexcept { m_bytes_per_op = bytes; }
+        void set_flops_per_op(const double flops) noexcept { m_flops_per_op = flops; }
+
+    public:
+        _NODISC_ size_t iterations() const noexcept { return m_iterations; }
+        _NODISC_ double bytes_per_op() const noexcept { return m_bytes_per_op; }
+        _NODISC_ double flops_per_op() const noexcept { return m_flops_per_op; }
+        _NODISC_ double elapsed_seconds() const noexcept { return std::chrono::duration<double>(m_elapsed).count(); }
+        _NODISC_ const math::profile::PerfReading &perf_counts() const noexcept { return m_perf_counts; } // Over the timed part only.
+
+    private:
+        void start_perf() noexcept {
+            if (m_perf) m_perf->sample(m_perf_start);
+        }
+        void stop_perf() noexcept {
+            if (!m_perf) return;
+            m_perf->sample(m_perf_end);
+            m_perf_counts += m_perf->delta(m_perf_start, m_perf_end);
+        }
+
+    private:
+        size_t m_iterations;
+        size_t m_remaining;
+        double m_bytes_per_op = 0;
+        double m_flops_per_op = 0;
+        bool m_started = false;
+        bool m_paused = false;
+        clock_t::time_point m_start{};
+        clock_t::duration m_elapsed{};
+        const TeamPerfCounters *m_perf;
+        std::vector<math::profile::PerfSample> m_perf_start, m_perf_end;
+        math::profile::PerfReading m_perf_counts;
+};
+
+struct BenchmarkCase {
+    std::string name;
+    std::function<void(State&)> run;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    size_t iterations;              // Per repetition.
+    std::vector<double> samples;    // ns/op of every repetition.
+    double ns_per_op;               // Median of the samples.
+    double mad_ns_per_op;           // Median absolute deviation of the samples.
+    double bytes_per_op;
+    double flops_per_op;
+    double gb_per_s;                // At the median.
+    double gflop_per_s;             // At the median.
+    math::profile::PerfReading perf; // Hardware counts per op over all repetitions, with --perf.
+};
+
+struct RunOptions {
+    std::string filter;
+    std::string out_path;
+    std::string trace_path; // Chrome trace of the run, needs MATH_ENABLE_TRACING.
+    double min_time = 0.1;
+    size_t repetitions = 5;
+    size_t pin_cpu = 0;
+    bool pin = true;
+    bool roofline = false;
+    bool perf = false;
+    bool list_only = false;
+};
+
+// Machine state recorded alongside the results.
+struct RunContext {
+    CpuInfo cpu;
+    double mhz_end = 0; // Frequency after the run, a drop against cpu.mhz hints at throttling.
+    std::vector<int> pinned_cpus;
+    std::optional<math::profile::MachinePeak> peak; // Measured with --roofline.
+    uint32_t perf_events = 0; // Hardware events counted with --perf.
+};
+
+_NODISC_ inline std::vector<BenchmarkCase> &registry() {
+    static std::vector<BenchmarkCase> benchmarks;
+    return benchmarks;
+}
+
+/**
+ * @brief Registering a benchmark, names are '/' separated paths like "matrix/mul/f64/64x64x64".
+ * @param name Name of the benchmark(must be unique).
+ * @param run Benchmark body, it must loop on State::keep_running().
+*/
+inline void register_benchmark(std::string name, std::function<void(State&)> run) {
+    math::bench::registry().push_back(BenchmarkCase{ std::move(name), std::move(run) });
+}
+
+/**
+ * @brief Finding the iteration count for which a run lasts at least min_time seconds, the calibration runs double as warm up.
+ * @param benchmark Benchmark to calibrate.
+ * @param min_time Minimum duration in seconds of a run.
+ * @return The iteration count.
+*/
+_NODISC_ inline size_t calibrate_iterations(const BenchmarkCase &benchmark, const double min_time) {
+    static constexpr const size_t max_iterations = size_t(1) << 30;
+    size_t iterations = 1;
+    for (;;) {
+        State state(iterations);
+        benchmark.run(state);
+        const double seconds = state.elapsed_seconds();
+        if (seconds >= min_time || iterations >= max_iterations) return iterations;
+        const double multiplier = seconds > 0 ? std::min(10.0, 1.4 * min_time / seconds) : 10.0;
+        iterations = std::min(max_iterations, std::max(iterations + 1, static_cast<size_t>(static_cast<double>(iterations) * multiplier)));
+    }
+}
+
+/**
+ * @brief Running a benchmark repetitions times with a calibrated iteration count.
+ * @param benchmark Benchmark to run.
+ * @param min_time Minimum duration in seconds of every repetition.
+ * @param repetitions Number of timed runs(at least 1).
+ * @param perf Hardware counters to read around the timed part of every repetition, nullptr for none.
+ * @return The samples with their median and MAD, the throughputs are taken at the median.
+*/
+_NODISC_ inline BenchmarkResult run_benchmark(const BenchmarkCase &benchmark, const double min_time, const size_t repetitions, const TeamPerfCounters *perf = nullptr) {
+    const size_t iterations = math::bench::calibrate_iterations(benchmark, min_time);
+    BenchmarkResult result{ benchmark.name, iterations, {}, 0, 0, 0, 0, 0, 0, {} };
+    result.samples.reserve(repetitions);
+    for (size_t r = 0; r < std::max<size_t>(repetitions, 1); r++) {
+        State state(iterations, perf);
+        benchmark.run(state);
+        result.samples.push_back(state.elapsed_seconds() * 1e9 / static_cast<double>(iterations));
+        result.bytes_per_op = state.bytes_per_op();
+        result.flops_per_op = state.flops_per_op();
+        result.perf += state.perf_counts();
+    }
+    for (double &value : result.perf.values) value /= static_cast<double>(iterations * result.samples.size());
+    result.ns_per_op = math::bench::median(result.samples);
+    result.mad_ns_per_op = math::bench::median_absolute_deviation(result.samples);
+    if (result.ns_per_op > 0) {
+        result.gb_per_s = result.bytes_per_op / result.ns_per_op;
+        result.gflop_per_s = result.flops_per_op / result.ns_per_op;
+    }
+    return result;
+}
+}
+
+namespace math::bench::impl {
+inline void write_json_string(std::FILE *out, const std::string_view s) {
+    std::fputc('"', out);
+    for (const char c : s) {
+        switch (c) {
+            case '"': std::fputs("\\\"", out); break;
+            case '\\': std::fputs("\\\\", out); break;
+            case '\n': std::fputs("\\n", out); break;
+            case '\t': std::fputs("\\t", out); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) std::fprintf(out, "\\u%04x", static_cast<unsigned>(c));
+                else std::fputc(c, out);
+        }
+    }
+    std::fputc('"', out);
+}
+
+_NODISC_ inline std::string utc_timestamp() {
+    const std::time_t now = std::time(nullptr);
+    std::tm tm{};
+#if defined(_MSC_VER)
+    gmtime_s(&tm, &now);
+#else
+    gmtime_r(&now, &tm);
+#endif
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    return buffer;
+}
+
+_NODISC_ inline const char *compiler_string() noexcept {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc";
+#else
+    return "unknown";
+#endif
+}
+}
+
+namespace math::bench {
+/**
+ * @brief Writing the results of a run as JSON.
+ * @param out Stream to write to.
+ * @param results Results of the benchmarks.
+ * @param options Options the benchmarks were run with.
+ * @param context Machine state of the run.
+*/
+inline void write_json(std::FILE *out, const std::vector<BenchmarkResult> &results, const RunOptions &options, const RunContext &context) {
+    std::fprintf(out, "{\n  \"context\": {\n");
+    std::fprintf(out, "    \"date\": \"%s\",\n", math::bench::impl::utc_timestamp().c_str());
+    std::fprintf(out, "    \"compiler\": ");
+    math::bench::impl::write_json_string(out, math::bench::impl::compiler_string());
+    std::fprintf(out, ",\n    \"build_type\": \"%s\",\n",
+#if defined(NDEBUG)
+        "release"
+#else
+        "debug"
+#endif
+    );
+    std::fprintf(out, "    \"pool_allocator\": %s,\n",
+#if defined(MATH_USE_POOL_ALLOCATOR)
+        "true"
+#else
+        "false"
+#endif
+    );
+    std::fprintf(out, "    \"cpu_model\": ");
+    math::bench::impl::write_json_string(out, context.cpu.model);
+    std::fprintf(out, ",\n    \"cpu_governor\": ");
+    math::bench::impl::write_json_string(out, context.cpu.governor);
+    std::fprintf(out, ",\n    \"cpu_mhz\": %.17g,\n    \"cpu_mhz_end\": %.17g,\n    \"cpu_max_mhz\": %.17g,\n    \"logical_cpus\": %d,\n",
+        context.cpu.mhz, context.mhz_end, context.cpu.max_mhz, context.cpu.logical_cpus);
+    std::fprintf(out, "    \"pinned_cpus\": [");
+    for (size_t i = 0; i < context.pinned_cpus.size(); i++) std::fprintf(out, "%s%d", i == 0 ? "" : ", ", context.pinned_cpus[i]);
+    std::fprintf(out, "],\n    \"omp_max_threads\": %d,\n", omp_get_max_threads());
+    std::fprintf(out, "    \"repetitions\": %zu,\n", options.repetitions);
+    if (options.perf) {
+        std::fprintf(out, "    \"perf_events\": [");
+        bool first = true;
+        for (size_t e = 0; e < math::profile::perf_event_count; e++) {
+            if (!((context.perf_events >> e) & 1)) continue;
+            std::fprintf(out, "%s\"%s\"", first ? "" : ", ", math::profile::perf_event_name(static_cast<math::profile::PerfEvent>(e)));
+            first = false;
+        }
+        std::fprintf(out, "],\n");
+    }
+    if (context.peak) std::fprintf(out, "    \"peak_gb_per_s\": %.17g,\n    \"peak_gflop_per_s\": %.17g,\n", context.peak->gb_per_s, context.peak->gflop_per_s);
+    std::fprintf(out, "    \"min_time_s\": %.17g\n  },\n  \"benchmarks\": [", options.min_time);
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult &r = results[i];
+        std::fprintf(out, "%s\n    {\"name\": ", i == 0 ? "" : ",");
+        math::bench::impl::write_json_string(out, r.name);
+        std::fprintf(out, ", \"iterations\": %zu, \"ns_per_op\": %.17g, \"mad_ns_per_op\": %.17g, \"bytes_per_op\": %.17g, \"flops_per_op\": %.17g, \"gb_per_s\": %.17g, \"gflop_per_s\": %.17g, \"samples_ns_per_op\": [",
+            r.iterations, r.ns_per_op, r.mad_ns_per_op, r.bytes_per_op, r.flops_per_op, r.gb_per_s, r.gflop_per_s);
+        for (size_t j = 0; j < r.samples.size(); j++) std::fprintf(out, "%s%.17g", j == 0 ? "" : ", ", r.samples[j]);
+        std::fprintf(out, "]");
+        if (context.peak) {
+            const math::profile::RooflinePlacement placement = math::profile::place_on_roofline(r.flops_per_op, r.bytes_per_op, r.ns_per_op * 1e-9, *context.peak);
+            std::fprintf(out, ", \"intensity\": %.17g, \"roof_fraction\": %.17g, \"bound\": \"%s\"", placement.intensity, placement.roof_fraction, math::profile::bound_name(placement.bound));
+        }
+        if (r.perf.mask != 0) {
+            std::fprintf(out, ", \"perf\": {");
+            bool first = true;
+            for (size_t e = 0; e < math::profile::perf_event_count; e++) {
+                if (!((r.perf.mask >> e) & 1)) continue;
+                std::fprintf(out, "%s\"%s_per_op\": %.17g", first ? "" : ", ", math::profile::perf_event_name(static_cast<math::profile::PerfEvent>(e)), r.perf.values[e]);
+                first = false;
+            }
+            if (r.perf.has(math::profile::PE::cycles) && r.perf.has(math::profile::PE::instructions) && r.perf.of(math::profile::PE::cycles) > 0)
+                std::fprintf(out, ", \"ipc\": %.17g", r.perf.of(math::profile::PE::instructions) / r.perf.of(math::profile::PE::cycles));
+            std::fprintf(out, "}");
+        }
+        std::fprintf(out, "}");
+    }
+    std::fprintf(out, "%s]", results.empty() ? "" : "\n  ");
+#if defined(MATH_ENABLE_PERF_COUNTERS)
+    std::fprintf(out, ",\n  \"perf_by_op\": %s", math::profile::perf_json(math::profile::perf_stats()).c_str()); // Per operation and thread, from the library's own scopes.
+#endif
+    std::fprintf(out, "\n}\n");
+}
+
+/**
+ * @brief Parsing the command line of the benchmark executable.
+ * @throws std::invalid_argument On an unknown or malformed option.
+*/
+_NODISC_ inline RunOptions parse_options(const int argc, const char *const *argv) {
+    RunOptions options;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg(argv[i]);
+        if (arg.starts_with("--filter=")) options.filter = arg.substr(9);
+        else if (arg.starts_with("--out=")) options.out_path = arg.substr(6);
+        else if (arg.starts_with("--trace=")) options.trace_path = arg.substr(8);
+        else if (arg.starts_with("--min-time=")) {
+            const std::string value(arg.substr(11));
+            char *end = nullptr;
+            options.min_time = std::strtod(value.c_str(), &end);
+            if (end == value.c_str() || *end != '\0' || !(options.min_time >= 0)) throw std::invalid_argument("--min-time expects a non-negative number of seconds.");
+        }
+        else if (arg.starts_with("--repetitions=")) {
+            const std::string value(arg.substr(14));
+            char *end = nullptr;
+            const long long repetitions = std::strtoll(value.c_str(), &end, 10);
+            if (end == value.c_str() || *end != '\0' || repetitions < 1) throw std::invalid_argument("--repetitions expects a positive integer.");
+            options.repetitions = static_cast<size_t>(repetitions);
+        }
+        else if (arg.starts_with("--pin-cpu=")) {
+            const std::string value(arg.substr(10));
+            char *end = nullptr;
+            const long long cpu = std::strtoll(value.c_str(), &end, 10);
+            if (end == value.c_str() || *end != '\0' || cpu < 0) throw std::invalid_argument("--pin-cpu expects a non-negative integer.");
+            options.pin_cpu = static_cast<size_t>(cpu);
+        }
+        else if (arg == "--no-pin") options.pin = false;
+        else if (arg == "--roofline") options.roofline = true;
+        else if (arg == "--perf") options.perf = true;
+        else if (arg == "--list") options.list_only = true;
+        else throw std::invalid_argument("Unknown option: " + std::string(arg));
+    }
+    return options;
+}
+
+/**
+ * @brief Entry point of the benchmark executable, runs every registered benchmark whose name contains the filter and writes JSON to stdout or --out.
+ * @return Process exit code.
+*/
+inline int run_main(const int argc, const char *const *argv) {
+    RunOptions options;
+    try { options = math::bench::parse_options(argc, argv); }
+    catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\nUsage: %s [--filter=<substring>] [--min-time=<seconds>] [--repetitions=<n>] [--pin-cpu=<index>] [--no-pin] [--roofline] [--perf] [--out=<file.json>] [--trace=<file.json>] [--list]\n", e.what(), argc > 0 ? argv[0] : "math_benchmarks");
+        return 2;
+    }
+    RunContext context;
+    std::optional<TeamPerfCounters> perf;
+    if (!options.list_only) {
+        if (options.pin) {
+            context.pinned_cpus = math::bench::pin_threads(options.pin_cpu);
+            if (context.pinned_cpus.empty()) std::fprintf(stderr, "Could not pin the benchmark threads, results may be noisier.\n");
+        }
+        context.cpu = math::bench::read_cpu_info(context.pinned_cpus.empty() ? 0 : context.pinned_cpus.front());
+        if (options.roofline) {
+            context.peak = math::profile::machine_peak();
+            std::fprintf(stderr, "peak %.2f GB/s, %.2f GFLOP/s\n", context.peak->gb_per_s, context.peak->gflop_per_s);
+        }
+        if (options.perf) {
+            perf.emplace(); // After pinning, so the team it opens the counters on is the pinned one.
+            context.perf_events = perf->mask();
+            if (context.perf_events == 0) {
+                std::fprintf(stderr, "Hardware counters are not available(see /proc/sys/kernel/perf_event_paranoid), --perf only records that.\n");
+                perf.reset();
+            }
+        }
+    }
+    std::vector<BenchmarkResult> results;
+    for (const BenchmarkCase &benchmark : math::bench::registry()) {
+        if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) continue;
+        if (options.list_only) {
+            std::printf("%s\n", benchmark.name.c_str());
+            continue;
+        }
+        results.push_back(math::bench::run_benchmark(benchmark, options.min_time, options.repetitions, perf ? &*perf : nullptr));
+        const BenchmarkResult &r = results.back();
+        std::fprintf(stderr, "%-48s %14.1f ns/op (MAD %5.1f%%) %9.3f GB/s %9.3f GFLOP/s", r.name.c_str(), r.ns_per_op, r.ns_per_op > 0 ? 100.0 * r.mad_ns_per_op / r.ns_per_op : 0.0, r.gb_per_s, r.gflop_per_s);
+        if (r.perf.has(math::profile::PE::cycles) && r.perf.has(math::profile::PE::instructions) && r.perf.of(math::profile::PE::cycles) > 0)
+            std::fprintf(stderr, " %6.2f IPC", r.perf.of(math::profile::PE::instructions) / r.perf.of(math::profile::PE::cycles));
+        std::fprintf(stderr, "\n");
+    }
+    if (options.list_only) return 0;
+    context.mhz_end = math::bench::read_cpu_info(context.pinned_cpus.empty() ? 0 : context.pinned_cpus.front()).mhz;
+    std::FILE *out = options.out_path.empty() ? stdout : std::fopen(options.out_path.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "Cannot open %s for writing.\n", options.out_path.c_str());
+        return 1;
+    }
+    math::bench::write_json(out, results, options, context);
+    if (out != stdout) std::fclose(out);
+    if (!options.trace_path.empty()) {
+#if defined(MATH_ENABLE_TRACING)
+        if (!math::profile::write_chrome_trace(options.trace_path.c_str())) {
+            std::fprintf(stderr, "Cannot write the trace to %s.\n", options.trace_path.c_str());
+            return 1;
+        }
+#else
+        std::fprintf(stderr, "--trace needs a build with MATH_ENABLE_TRACING, no trace written.\n");
+#endif
+    }
+    return 0;
+}
+}
\ No newline at end of file
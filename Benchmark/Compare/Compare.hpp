@@ -0,0 +1,133 @@
+// Compare.hpp
+#pragma once
+
+#include "Json.hpp"
+#include "../Statistics.hpp"
+
+namespace math::bench {
+enum class Verdict : char {
+    same, improvement, regression, missing, added
+};
+
+struct Threshold {
+    std::string pattern; // Substring of the benchmark names it applies to, empty for the default.
+    double fraction;     // Allowed slow down of the median, 0.05 is 5%.
+};
+
+struct CompareOptions {
+    std::string baseline_path;
+    std::string contender_path;
+    std::vector<Threshold> thresholds;
+    double default_threshold = 0.05;
+    double alpha = 0.05;
+};
+
+struct Comparison {
+    std::string name;
+    Verdict verdict = Verdict::same;
+    double baseline_median = 0, contender_median = 0;
+    double baseline_mad = 0, contender_mad = 0;
+    MedianInterval contender_interval{ 0, 0 }; // Of the contender median at 1 - alpha.
+    double change = 0;  // contender / baseline - 1 of the medians, positive is slower.
+    double p_value = 1;
+    double threshold = 0;
+    bool enough_samples = false;
+};
+}
+
+namespace math::bench::impl {
+/**
+ * @brief Per repetition ns/op of a benchmark entry, falling back on the single ns_per_op of older outputs.
+*/
+_NODISC_ inline std::vector<double> samples_of(const JsonValue &entry) {
+    std::vector<double> samples;
+    if (const JsonValue *array = entry.find("samples_ns_per_op"); array && array->type == JT::array)
+        for (const JsonValue &v : array->array) if (v.type == JT::number) samples.push_back(v.number);
+    if (samples.empty())
+        if (const JsonValue *v = entry.find("ns_per_op"); v && v->type == JT::number) samples.push_back(v->number);
+    return samples;
+}
+
+_NODISC_ inline std::vector<std::pair<std::string, std::vector<double>>> benchmarks_of(const JsonValue &document) {
+    const JsonValue *list = document.find("benchmarks");
+    if (!list || list->type != JT::array) throw std::runtime_error("The JSON has no \"benchmarks\" array.");
+    std::vector<std::pair<std::string, std::vector<double>>> result;
+    for (const JsonValue &entry : list->array) {
+        const JsonValue *name = entry.find("name");
+        if (!name || name->type != JT::string) continue;
+        result.emplace_back(name->string, math::bench::impl::samples_of(entry));
+    }
+    return result;
+}
+}
+
+namespace math::bench {
+/**
+ * @brief Threshold of a benchmark, the longest matching pattern wins over the default.
+*/
+_NODISC_ inline double threshold_for(const std::string_view name, const CompareOptions &options) noexcept {
+    double threshold = options.default_threshold;
+    size_t best = 0;
+    for (const Threshold &t : options.thresholds) {
+        if (t.pattern.size() >= best && name.find(t.pattern) != std::string_view::npos) {
+            best = t.pattern.size();
+            threshold = t.fraction;
+        }
+    }
+    return threshold;
+}
+
+/**
+ * @brief Comparing two benchmark runs by their ns/op samples.
+ * @param baseline Parsed output of the reference run.
+ * @param contender Parsed output of the run under test.
+ * @param options Thresholds and significance level.
+ * @return One comparison per benchmark(of the contender order, then the ones missing from it).
+ * @note A change counts only if the medians differ by more than the threshold and the Mann-Whitney U test rejects
+ *       equal distributions at alpha. With fewer than 4 samples on a side the test can not reach usual alphas, so only the threshold is used.
+*/
+_NODISC_ inline std::vector<Comparison> compare_runs(const JsonValue &baseline, const JsonValue &contender, const CompareOptions &options) {
+    const auto base = math::bench::impl::benchmarks_of(baseline);
+    const auto next = math::bench::impl::benchmarks_of(contender);
+    std::unordered_map<std::string_view, const std::vector<double>*> base_by_name;
+    for (const auto &[name, samples] : base) base_by_name.emplace(name, &samples);
+
+    std::vector<Comparison> result;
+    std::unordered_set<std::string_view> seen;
+    for (const auto &[name, samples] : next) {
+        Comparison c;
+        c.name = name;
+        c.threshold = math::bench::threshold_for(name, options);
+        c.contender_median = math::bench::median(samples);
+        c.contender_mad = math::bench::median_absolute_deviation(samples);
+        c.contender_interval = math::bench::median_confidence_interval(samples, 1 - options.alpha);
+        const auto found = base_by_name.find(name);
+        if (found == base_by_name.end()) {
+            c.verdict = Verdict::added;
+            result.push_back(std::move(c));
+            continue;
+        }
+        seen.insert(found->first);
+        const std::vector<double> &reference = *found->second;
+        c.baseline_median = math::bench::median(reference);
+        c.baseline_mad = math::bench::median_absolute_deviation(reference);
+        c.change = c.baseline_median > 0 ? c.contender_median / c.baseline_median - 1 : 0;
+        c.p_value = math::bench::mann_whitney_u(reference, samples).p_value;
+        c.enough_samples = reference.size() >= 4 && samples.size() >= 4;
+        const bool significant = !c.enough_samples || c.p_value < options.alpha;
+        if (significant && c.change > c.threshold) c.verdict = Verdict::regression;
+        else if (significant && c.change < -c.threshold) c.verdict = Verdict::improvement;
+        result.push_back(std::move(c));
+    }
+    for (const auto &[name, samples] : base) {
+        if (seen.contains(name)) continue;
+        Comparison c;
+        c.name = name;
+        c.verdict = Verdict::missing;
+        c.baseline_median = math::bench::median(samples);
+        c.baseline_mad = math::bench::median_absolute_deviation(samples);
+        result.push_back(std::move(c));
+    }
+    return result;
+}
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+// Json.hpp
+#pragma once
+
+#include "../../Helper/Headers.hpp"
+
+namespace math::bench {
+enum class JsonType : char {
+    null, boolean, number, string, array, object
+};
+using JT = JsonType;
+
+// Just enough JSON to read the benchmark outputs back.
+struct JsonValue {
+    JsonType type = JT::null;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    /**
+     * @brief Member lookup of an object.
+     * @return Pointer to the member, nullptr if this is not an object or the key does not exist.
+    */
+    _NODISC_ const JsonValue *find(const std::string_view key) const noexcept {
+        if (type != JT::object) return nullptr;
+        for (const auto &[name, value] : object) if (name == key) return &value;
+        return nullptr;
+    }
+};
+}
+
+namespace math::bench::impl {
+class JsonParser {
+    public:
+        explicit JsonParser(const std::string_view text) noexcept : m_text(text) {}
+
+    public:
+        _NODISC_ JsonValue parse_document() {
+            JsonValue value = parse_value();
+            skip_space();
+            if (m_pos != m_text.size()) fail("trailing characters");
+            return value;
+        }
+
+    private:
+        [[noreturn]] void fail(const char *what) const {
+            throw std::runtime_error("Invalid JSON at offset " + std::to_string(m_pos) + ": " + what);
+        }
+
+        void skip_space() noexcept {
+            while (m_pos < m_text.size() && (m_text[m_pos] == ' ' || m_text[m_pos] == '\n' || m_text[m_pos] == '\r' || m_text[m_pos] == '\t')) m_pos++;
+        }
+
+        void expect(const char c) {
+            skip_space();
+            if (m_pos >= m_text.size() || m_text[m_pos] != c) fail("unexpected character");
+            m_pos++;
+        }
+
+        bool consume_literal(const std::string_view literal) noexcept {
+            if (m_text.substr(m_pos, literal.size()) != literal) return false;
+            m_pos += literal.size();
+            return true;
+        }
+
+        _NODISC_ JsonValue parse_value() {
+            skip_space();
+            if (m_pos >= m_text.size()) fail("unexpected end");
+            JsonValue value;
+            const char c = m_text[m_pos];
+            if (c == '{') {
+                value.type = JT::object;
+                m_pos++;
+                skip_space();
+                if (m_pos < m_text.size() && m_text[m_pos] == '}') { m_pos++; return value; }
+                for (;;) {
+                    skip_space();
+                    std::string key = parse_string();
+                    expect(':');
+                    value.object.emplace_back(std::move(key), parse_value());
+                    skip_space();
+                    if (m_pos < m_text.size() && m_text[m_pos] == ',') { m_pos++; continue; }
+                    expect('}');
+                    return value;
+                }
+            }
+            if (c == '[') {
+                value.type = JT::array;
+                m_pos++;
+                skip_space();
+                if (m_pos < m_text.size() && m_text[m_pos] == ']') { m_pos++; return value; }
+                for (;;) {
+                    value.array.push_back(parse_value());
+                    skip_space();
+                    if (m_pos < m_text.size() && m_text[m_pos] == ',') { m_pos++; continue; }
+                    expect(']');
+                    return value;
+                }
+            }
+            if (c == '"') {
+                value.type = JT::string;
+                value.string = parse_string();
+                return value;
+            }
+            if (consume_literal("true")) { value.type = JT::boolean; value.boolean = true; return value; }
+            if (consume_literal("false")) { value.type = JT::boolean; return value; }
+            if (consume_literal("null")) return value;
+            // Numbers(strtod also takes "nan"/"inf" which printf can emit for degenerate runs).
+            const std::string rest(m_text.substr(m_pos, std::min<size_t>(64, m_text.size() - m_pos)));
+            char *end = nullptr;
+            value.number = std::strtod(rest.c_str(), &end);
+            if (end == rest.c_str()) fail("expected a value");
+            value.type = JT::number;
+            m_pos += static_cast<size_t>(end - rest.c_str());
+            return value;
+        }
+
+        _NODISC_ std::string parse_string() {
+            if (m_pos >= m_text.size() || m_text[m_pos] != '"') fail("expected a string");
+            m_pos++;
+            std::string result;
+            while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+                char c = m_text[m_pos++];
+                if (c == '\\') {
+                    if (m_pos >= m_text.size()) fail("unterminated escape");
+                    switch (c = m_text[m_pos++]) {
+                        case 'n': c = '\n'; break;
+                        case 't': c = '\t'; break;
+                        case 'r': c = '\r'; break;
+                        case 'b': c = '\b'; break;
+                        case 'f': c = '\f'; break;
+                        case 'u': {
+                            if (m_pos + 4 > m_text.size()) fail("short unicode escape");
+                            const unsigned code = static_cast<unsigned>(std::strtoul(std::string(m_text.substr(m_pos, 4)).c_str(), nullptr, 16));
+                            m_pos += 4;
+                            c = code < 0x80 ? static_cast<char>(code) : '?'; // Names are ASCII.
+                            break;
+                        }
+                        default: break; // '"', '\\' and '/' stand for themselves.
+                    }
+                }
+                result.push_back(c);
+            }
+            if (m_pos >= m_text.size()) fail("unterminated string");
+            m_pos++;
+            return result;
+        }
+
+    private:
+        std::string_view m_text;
+        size_t m_pos = 0;
+};
+}
+
+namespace math::bench {
+/**
+ * @brief Parsing a JSON document.
+ * @throws std::runtime_error If the text is not valid JSON.
+*/
+_NODISC_ inline JsonValue parse_json(const std::string_view text) {
+    return math::bench::impl::JsonParser(text).parse_document();
+}
+
+/**
+ * @brief Reading and parsing a JSON file.
+ * @throws std::runtime_error If the file can not be read or is not valid JSON.
+*/
+_NODISC_ inline JsonValue read_json_file(const std::string &path) {
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) throw std::runtime_error("Cannot open " + path);
+    std::string text;
+    char buffer[1 << 16];
+    size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) text.append(buffer, read);
+    std::fclose(file);
+    return math::bench::parse_json(text);
+}
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+// main.cpp
+#include "Compare.hpp"
+
+namespace {
+const char *const usage =
+    "Usage: %s [--threshold=<fraction>] [--threshold=<name substring>:<fraction>]... [--alpha=<p>] <baseline.json> <contender.json>\n"
+    "Exits with 1 if any benchmark regressed, 2 on bad input.\n";
+
+double parse_fraction(const std::string &value, const char *option) {
+    char *end = nullptr;
+    const double fraction = std::strtod(value.c_str(), &end);
+    if (end == value.c_str() || *end != '\0' || !(fraction >= 0)) throw std::invalid_argument(std::string(option) + " expects a non-negative number.");
+    return fraction;
+}
+
+math::bench::CompareOptions parse_options(const int argc, const char *const *argv) {
+    math::bench::CompareOptions options;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg(argv[i]);
+        if (arg.starts_with("--threshold=")) {
+            const std::string value(arg.substr(12));
+            const size_t colon = value.rfind(':');
+            if (colon == std::string::npos) options.default_threshold = parse_fraction(value, "--threshold");
+            else options.thresholds.push_back(math::bench::Threshold{ value.substr(0, colon), parse_fraction(value.substr(colon + 1), "--threshold") });
+        }
+        else if (arg.starts_with("--alpha=")) {
+            options.alpha = parse_fraction(std::string(arg.substr(8)), "--alpha");
+            if (options.alpha <= 0 || options.alpha >= 1) throw std::invalid_argument("--alpha must be in (0, 1).");
+        }
+        else if (arg.starts_with("--")) throw std::invalid_argument("Unknown option: " + std::string(arg));
+        else paths.emplace_back(arg);
+    }
+    if (paths.size() != 2) throw std::invalid_argument("Expected a baseline and a contender JSON file.");
+    options.baseline_path = paths[0];
+    options.contender_path = paths[1];
+    return options;
+}
+
+std::string context_string(const math::bench::JsonValue &document, const char *key) {
+    const math::bench::JsonValue *context = document.find("context");
+    const math::bench::JsonValue *value = context ? context->find(key) : nullptr;
+    if (!value) return "?";
+    if (value->type == math::bench::JT::string) return value->string;
+    if (value->type == math::bench::JT::number) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%g", value->number);
+        return buffer;
+    }
+    return "?";
+}
+
+const char *verdict_name(const math::bench::Verdict verdict) noexcept {
+    switch (verdict) {
+        case math::bench::Verdict::improvement: return "faster";
+        case math::bench::Verdict::regression: return "REGRESSION";
+        case math::bench::Verdict::missing: return "missing";
+        case math::bench::Verdict::added: return "new";
+        default: return "same";
+    }
+}
+}
+
+int main(int argc, char **argv) {
+    math::bench::CompareOptions options;
+    math::bench::JsonValue baseline, contender;
+    try {
+        options = parse_options(argc, argv);
+        baseline = math::bench::read_json_file(options.baseline_path);
+        contender = math::bench::read_json_file(options.contender_path);
+    }
+    catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        std::fprintf(stderr, usage, argc > 0 ? argv[0] : "math_bench_compare");
+        return 2;
+    }
+
+    for (const char *key : { "cpu_model", "cpu_mhz", "cpu_governor", "compiler", "build_type", "omp_max_threads" }) {
+        const std::string a = context_string(baseline, key), b = context_string(contender, key);
+        std::printf("%-16s %s%s%s\n", key, a.c_str(), a == b ? "" : "  ->  ", a == b ? "" : b.c_str());
+    }
+    std::printf("\n");
+
+    std::vector<math::bench::Comparison> comparisons;
+    try { comparisons = math::bench::compare_runs(baseline, contender, options); }
+    catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 2;
+    }
+
+    size_t regressions = 0;
+    std::printf("%-48s %14s %14s %23s %9s %9s %9s  %s\n", "benchmark", "base ns/op", "new ns/op", "new median interval", "change", "p-value", "limit", "verdict");
+    for (const math::bench::Comparison &c : comparisons) {
+        if (c.verdict == math::bench::Verdict::regression) ++regressions;
+        if (c.verdict == math::bench::Verdict::missing || c.verdict == math::bench::Verdict::added) {
+            std::printf("%-48s %14.1f %14.1f %23s %9s %9s %9s  %s\n", c.name.c_str(), c.baseline_median, c.contender_median, "-", "-", "-", "-", verdict_name(c.verdict));
+            continue;
+        }
+        std::printf("%-48s %14.1f %14.1f  [%9.1f, %9.1f] %+8.1f%% %9.4f %8.1f%%  %s%s\n", c.name.c_str(), c.baseline_median, c.contender_median,
+            c.contender_interval.low, c.contender_interval.high, 100.0 * c.change, c.p_value, 100.0 * c.threshold, verdict_name(c.verdict), c.enough_samples ? "" : " (few samples)");
+    }
+    std::printf("\n%zu regression(s) in %zu benchmark(s).\n", regressions, comparisons.size());
+    return regressions == 0 ? 0 : 1;
+}
\ No newline at end of file
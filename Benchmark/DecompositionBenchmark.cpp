@@ -0,0 +1,173 @@
+// DecompositionBenchmark.cpp
+#include "Benchmark.hpp"
+#include "../Matrix/Decomposition/LU.hpp"
+#include "../Matrix/Decomposition/Cholesky.hpp"
+#include "../Matrix/Decomposition/QR.hpp"
+#include "../Matrix/Decomposition/SymmetricEigen.hpp"
+#include "../Matrix/Decomposition/RandomizedSVD.hpp"
+
+namespace {
+using math::bench::State;
+using math::bench::do_not_optimize;
+using math::bench::register_benchmark;
+using Mat = math::Matrix<double>;
+
+constexpr const double elem = sizeof(double);
+
+std::string shape(const size_t r, const size_t c) {
+    return std::to_string(r) + "x" + std::to_string(c);
+}
+
+// Diagonally dominant, so every factorisation runs to the end whatever its pivoting.
+Mat dominant(const size_t size) {
+    return Mat(size, size, [=](size_t i, size_t j) { return static_cast<double>((i * 131 + j * 71) % 97) * 0.01 + (i == j ? static_cast<double>(size) : 0.0); });
+}
+
+// Full column rank whatever the height.
+Mat tall(const size_t rows, const size_t columns) {
+    return Mat(rows, columns, [](size_t i, size_t j) { return static_cast<double>((i * 131 + j * 71) % 97) * 0.01 + (i == j ? 1.0 : 0.0); });
+}
+}
+
+_MATH_BENCHMARK_REGISTRAR_(register_decomposition_benchmarks) {
+    for (const size_t size : { size_t(256), size_t(1024) }) {
+        register_benchmark("decomposition/lu/f64/" + shape(size, size), [=](State &state) {
+            const Mat a = dominant(size);
+            state.set_flops_per_op(2.0 / 3.0 * static_cast<double>(size * size * size));
+            state.set_bytes_per_op(2.0 * static_cast<double>(size * size) * elem);
+            while (state.keep_running()) {
+                math::LU<double> lu(a);
+                do_not_optimize(lu);
+            }
+        });
+        register_benchmark("decomposition/lu_solve/f64/" + shape(size, size) + "/rhs_16", [=](State &state) {
+            const math::LU<double> lu(dominant(size));
+            const Mat b(size, 16, 1.0);
+            state.set_flops_per_op(2.0 * static_cast<double>(size * size * 16));
+            state.set_bytes_per_op((static_cast<double>(size * size) + 2.0 * static_cast<double>(size * 16)) * elem);
+            while (state.keep_running()) {
+                Mat x = lu.solve(b);
+                do_not_optimize(x);
+            }
+        });
+        register_benchmark("decomposition/inverse/f64/" + shape(size, size), [=](State &state) {
+            const Mat a = dominant(size);
+            state.set_flops_per_op(2.0 * static_cast<double>(size * size * size));
+            state.set_bytes_per_op(2.0 * static_cast<double>(size * size) * elem);
+            while (state.keep_running()) {
+                Mat x = a.inverse();
+                do_not_optimize(x);
+            }
+        });
+        // min(i, j) + 1 is all ones lower triangular times its transpose, every leading minor is 1 and no entry outgrows the size.
+        register_benchmark("decomposition/determinant/i64/" + shape(size, size), [=](State &state) {
+            const math::Matrix<long long> a(size, size, [](size_t i, size_t j) { return static_cast<long long>(std::min(i, j)) + 1; });
+            state.set_flops_per_op(static_cast<double>(size * size * size));
+            state.set_bytes_per_op(2.0 * static_cast<double>(size * size) * sizeof(long long));
+            while (state.keep_running()) {
+                long long determinant = a.determinant();
+                do_not_optimize(determinant);
+            }
+        });
+        // Only the lower triangle is read, the symmetric matrix it defines is positive definite by dominance.
+        register_benchmark("decomposition/cholesky/f64/" + shape(size, size), [=](State &state) {
+            const Mat a = dominant(size);
+            state.set_flops_per_op(1.0 / 3.0 * static_cast<double>(size * size * size));
+            state.set_bytes_per_op(2.0 * static_cast<double>(size * size) * elem);
+            while (state.keep_running()) {
+                math::Cholesky<double> cholesky(a);
+                do_not_optimize(cholesky);
+            }
+        });
+        register_benchmark("decomposition/cholesky_solve/f64/" + shape(size, size) + "/rhs_16", [=](State &state) {
+            const math::Cholesky<double> cholesky(dominant(size));
+            const Mat b(size, 16, 1.0);
+            state.set_flops_per_op(2.0 * static_cast<double>(size * size * 16));
+            state.set_bytes_per_op((static_cast<double>(size * size) + 2.0 * static_cast<double>(size * 16)) * elem);
+            while (state.keep_running()) {
+                Mat x = cholesky.solve(b);
+                do_not_optimize(x);
+            }
+        });
+    }
+
+    // Symmetric eigenproblems: the eigenvalues alone, every eigenpair, and the top tenth of them.
+    for (const size_t size : { size_t(256), size_t(1024) }) {
+        const double cube = static_cast<double>(size * size * size);
+        register_benchmark("decomposition/symmetric_eigen/f64/" + shape(size, size) + "/values", [=](State &state) {
+            const Mat a = dominant(size);
+            state.set_flops_per_op(4.0 / 3.0 * cube);
+            state.set_bytes_per_op(2.0 * static_cast<double>(size * size) * elem);
+            while (state.keep_running()) {
+                math::SymmetricEigen<double> eigen(a, math::matrix::EV::no);
+                do_not_optimize(eigen);
+            }
+        });
+        register_benchmark("decomposition/symmetric_eigen/f64/" + shape(size, size) + "/vectors", [=](State &state) {
+            const Mat a = dominant(size);
+            state.set_flops_per_op((4.0 / 3.0 + 4.0 / 3.0 + 2.0) * cube);
+            state.set_bytes_per_op(3.0 * static_cast<double>(size * size) * elem);
+            while (state.keep_running()) {
+                math::SymmetricEigen<double> eigen(a);
+                do_not_optimize(eigen);
+            }
+        });
+        register_benchmark("decomposition/symmetric_eigen/f64/" + shape(size, size) + "/top_tenth", [=](State &state) {
+            const Mat a = dominant(size);
+            state.set_flops_per_op((4.0 / 3.0 + 0.2) * cube);
+            state.set_bytes_per_op(2.2 * static_cast<double>(size * size) * elem);
+            while (state.keep_running()) {
+                math::SymmetricEigen<double> eigen(a, size - size / 10, size / 10);
+                do_not_optimize(eigen);
+            }
+        });
+    }
+
+    // Tall least squares: the decomposition, its solve, and lstsq streaming through the rows without keeping Q.
+    for (const size_t rows : { size_t(1024), size_t(65536) }) {
+        const size_t columns = 64;
+        const double flops = 2.0 * static_cast<double>(rows * columns * columns) - 2.0 / 3.0 * static_cast<double>(columns * columns * columns);
+        register_benchmark("decomposition/qr/f64/" + shape(rows, columns), [=](State &state) {
+            const Mat a = tall(rows, columns);
+            state.set_flops_per_op(flops);
+            state.set_bytes_per_op(2.0 * static_cast<double>(rows * columns) * elem);
+            while (state.keep_running()) {
+                math::QR<double> qr(a);
+                do_not_optimize(qr);
+            }
+        });
+        register_benchmark("decomposition/qr_solve/f64/" + shape(rows, columns) + "/rhs_1", [=](State &state) {
+            const math::QR<double> qr(tall(rows, columns));
+            const Mat b(rows, 1, 1.0);
+            state.set_flops_per_op(4.0 * static_cast<double>(rows * columns));
+            state.set_bytes_per_op(static_cast<double>(rows * columns + 2 * rows) * elem);
+            while (state.keep_running()) {
+                Mat x = qr.solve(b);
+                do_not_optimize(x);
+            }
+        });
+        register_benchmark("decomposition/lstsq/f64/" + shape(rows, columns) + "/rhs_1", [=](State &state) {
+            const Mat a = tall(rows, columns), b(rows, 1, 1.0);
+            state.set_flops_per_op(flops);
+            state.set_bytes_per_op(static_cast<double>(rows * columns + rows) * elem);
+            while (state.keep_running()) {
+                Mat x = math::lstsq(a, b);
+                do_not_optimize(x);
+            }
+        });
+    }
+
+    // Randomised truncated SVD of a tall Matrix, by rank: 2 * (power iterations + 1) gemm by rank + oversampling columns.
+    for (const size_t rank : { size_t(10), size_t(50) }) {
+        const size_t rows = 8192, columns = 1024, samples = rank + math::matrix::impl::rsvd_oversampling;
+        register_benchmark("decomposition/randomized_svd/f64/" + shape(rows, columns) + "/rank_" + std::to_string(rank), [=](State &state) {
+            const Mat a = tall(rows, columns);
+            state.set_flops_per_op(4.0 * static_cast<double>((math::matrix::impl::rsvd_power_iterations + 1) * rows * columns * samples));
+            state.set_bytes_per_op(2.0 * static_cast<double>((math::matrix::impl::rsvd_power_iterations + 1) * rows * columns) * elem);
+            while (state.keep_running()) {
+                math::RandomizedSVD<double> svd(a, rank);
+                do_not_optimize(svd);
+            }
+        });
+    }
+}
\ No newline at end of file
@@ -0,0 +1,334 @@
+// MatrixBenchmark.cpp
+#include "Benchmark.hpp"
+#include "../Matrix/Matrix.hpp"
+
+namespace {
+using math::bench::State;
+using math::bench::do_not_optimize;
+using math::bench::register_benchmark;
+using Mat = math::Matrix<double>;
+
+constexpr const double elem = sizeof(double);
+
+std::string shape(const size_t r, const size_t c) {
+    return std::to_string(r) + "x" + std::to_string(c);
+}
+
+Mat filled(const size_t r, const size_t c) {
+    return Mat(r, c, [](size_t i, size_t j) { return static_cast<double>((i * 131 + j * 71) % 97) * 0.01; });
+}
+
+constexpr const size_t square_sizes[] = { 16, 64, 256, 1024 };
+constexpr const size_t rect_shapes[][2] = { { 1024, 64 }, { 64, 1024 } };
+// { m, k, n } of an m x k by k x n product.
+constexpr const size_t mul_shapes[][3] = {
+    { 16, 16, 16 }, { 64, 64, 64 }, { 128, 128, 128 }, { 256, 256, 256 },
+    { 256, 16, 256 }, { 16, 256, 16 }, { 512, 64, 32 }, { 32, 64, 512 },
+};
+
+void register_elementwise(const size_t r, const size_t c) {
+    const std::string s = shape(r, c);
+    const double n = static_cast<double>(r * c);
+
+    register_benchmark("matrix/construct/zero/f64/" + s, [=](State &state) {
+        state.set_bytes_per_op(n * elem);
+        while (state.keep_running()) {
+            Mat m(r, c);
+            do_not_optimize(m);
+        }
+    });
+    register_benchmark("matrix/construct/fill/f64/" + s, [=](State &state) {
+        state.set_bytes_per_op(n * elem);
+        while (state.keep_running()) {
+            Mat m(r, c, 1.5);
+            do_not_optimize(m);
+        }
+    });
+    register_benchmark("matrix/copy/f64/" + s, [=](State &state) {
+        const Mat a = filled(r, c);
+        state.set_bytes_per_op(2 * n * elem);
+        while (state.keep_running()) {
+            Mat m(a);
+            do_not_optimize(m);
+        }
+    });
+    register_benchmark("matrix/add_assign/f64/" + s, [=](State &state) {
+        Mat a = filled(r, c);
+        const Mat b = filled(r, c);
+        state.set_bytes_per_op(3 * n * elem);
+        state.set_flops_per_op(n);
+        while (state.keep_running()) {
+            a += b;
+            do_not_optimize(a);
+        }
+    });
+    register_benchmark("matrix/add/f64/" + s, [=](State &state) {
+        const Mat a = filled(r, c), b = filled(r, c);
+        state.set_bytes_per_op(3 * n * elem);
+        state.set_flops_per_op(n);
+        while (state.keep_running()) {
+            Mat m = a + b;
+            do_not_optimize(m);
+        }
+    });
+    register_benchmark("matrix/transpose/f64/" + s, [=](State &state) {
+        const Mat a = filled(r, c);
+        state.set_bytes_per_op(2 * n * elem);
+        while (state.keep_running()) {
+            Mat m = a.transpose();
+            do_not_optimize(m);
+        }
+    });
+    register_benchmark("matrix/equal/f64/" + s, [=](State &state) {
+        const Mat a = filled(r, c), b = filled(r, c);
+        state.set_bytes_per_op(2 * n * elem);
+        while (state.keep_running()) {
+            bool equal = (a == b);
+            do_not_optimize(equal);
+        }
+    });
+    register_benchmark("matrix/not_equal_last/f64/" + s, [=](State &state) {
+        const Mat a = filled(r, c);
+        Mat b = filled(r, c);
+        b(r - 1, c - 1) += 1.0;
+        state.set_bytes_per_op(2 * n * elem);
+        while (state.keep_running()) {
+            bool not_equal = (a != b);
+            do_not_optimize(not_equal);
+        }
+    });
+    register_benchmark("matrix/count/f64/" + s, [=](State &state) {
+        const Mat a = filled(r, c);
+        state.set_bytes_per_op(n * elem);
+        while (state.keep_running()) {
+            size_t found = a.count(0.5);
+            do_not_optimize(found);
+        }
+    });
+}
+
+void register_extend(const size_t size, const size_t amount) {
+    const std::string s = shape(size, size) + "+" + std::to_string(amount);
+    const double n = static_cast<double>(size);
+    const double a = static_cast<double>(amount);
+    // Every operation mutates the matrix, restoring it is excluded from the timing.
+    register_benchmark("matrix/extend_rows/f64/" + s, [=](State &state) {
+        const Mat base = filled(size, size);
+        Mat m;
+        state.set_bytes_per_op(a * n * elem);
+        while (state.keep_running()) {
+            state.pause_timing();
+            m = base;
+            state.resume_timing();
+            m.extend_rows_by(amount, 1.0);
+            do_not_optimize(m);
+        }
+    });
+    register_benchmark("matrix/extend_columns/f64/" + s, [=](State &state) {
+        const Mat base = filled(size, size);
+        Mat m;
+        state.set_bytes_per_op(n * a * elem);
+        while (state.keep_running()) {
+            state.pause_timing();
+            m = base;
+            state.resume_timing();
+            m.extend_columns_by(amount, 1.0);
+            do_not_optimize(m);
+        }
+    });
+    register_benchmark("matrix/extend/f64/" + s, [=](State &state) {
+        const Mat base = filled(size, size);
+        Mat m;
+        state.set_bytes_per_op(((n + a) * (n + a) - n * n) * elem);
+        while (state.keep_running()) {
+            state.pause_timing();
+            m = base;
+            state.resume_timing();
+            m.extend_by(amount, 1.0);
+            do_not_optimize(m);
+        }
+    });
+}
+}
+
+_MATH_BENCHMARK_REGISTRAR_(register_matrix_benchmarks) {
+    for (const size_t size : square_sizes) register_elementwise(size, size);
+    for (const auto &rc : rect_shapes) register_elementwise(rc[0], rc[1]);
+
+    for (const auto &mkn : mul_shapes) {
+        const size_t m = mkn[0], k = mkn[1], n = mkn[2];
+        register_benchmark("matrix/mul/f64/" + std::to_string(m) + "x" + std::to_string(k) + "x" + std::to_string(n), [=](State &state) {
+            const Mat a = filled(m, k), b = filled(k, n);
+            state.set_flops_per_op(2.0 * static_cast<double>(m * k * n));
+            state.set_bytes_per_op(static_cast<double>(m * k + k * n + m * n) * elem);
+            while (state.keep_running()) {
+                Mat c = a * b;
+                do_not_optimize(c);
+            }
+        });
+    }
+
+    // Classic(crossover 0) against the Strassen-Winograd recursion, FLOPs are those of the classic product for comparable rates.
+    for (const size_t crossover : { size_t(0), size_t(128), size_t(512) }) {
+        const size_t size = 1024;
+        register_benchmark("matrix/strassen/f64/" + shape(size, size) + "/crossover_" + std::to_string(crossover), [=](State &state) {
+            const Mat a = filled(size, size), b = filled(size, size);
+            const size_t previous = math::matrix::strassen_crossover();
+            math::matrix::set_strassen_crossover(crossover);
+            state.set_flops_per_op(2.0 * static_cast<double>(size * size * size));
+            state.set_bytes_per_op(3.0 * static_cast<double>(size * size) * elem);
+            while (state.keep_running()) {
+                Mat c = a * b;
+                do_not_optimize(c);
+            }
+            math::matrix::set_strassen_crossover(previous);
+        });
+    }
+
+    // Accumulating into an existing result, with every combination of transposed operands.
+    for (const size_t size : { size_t(256), size_t(1024) })
+        for (const char *flags : { "nn", "nt", "tn", "tt" }) {
+            const math::matrix::Transpose ta = flags[0] == 't' ? math::matrix::TR::yes : math::matrix::TR::no;
+            const math::matrix::Transpose tb = flags[1] == 't' ? math::matrix::TR::yes : math::matrix::TR::no;
+            register_benchmark("matrix/gemm/f64/" + shape(size, size) + "/" + flags, [=](State &state) {
+                const Mat a = filled(size, size), b = filled(size, size);
+                Mat c = filled(size, size);
+                state.set_flops_per_op(2.0 * static_cast<double>(size * size * size));
+                state.set_bytes_per_op(4.0 * static_cast<double>(size * size) * elem);
+                while (state.keep_running()) {
+                    math::gemm(1.0, a, ta, b, tb, 0.5, c);
+                    do_not_optimize(c);
+                }
+            });
+        }
+
+    // Gram matrices, one triangle against the full product of the materialised transpose.
+    for (const char *flag : { "n", "t" }) {
+        const size_t size = 1024;
+        const math::matrix::Transpose ta = flag[0] == 't' ? math::matrix::TR::yes : math::matrix::TR::no;
+        register_benchmark("matrix/syrk/f64/" + shape(size, size) + "/" + flag, [=](State &state) {
+            const Mat a = filled(size, size);
+            Mat c = filled(size, size);
+            state.set_flops_per_op(static_cast<double>(size * (size + 1) * size));
+            state.set_bytes_per_op(2.0 * static_cast<double>(size * size) * elem);
+            while (state.keep_running()) {
+                math::syrk(1.0, a, ta, 0.0, c, math::matrix::TRI::lower);
+                do_not_optimize(c);
+            }
+        });
+    }
+    register_benchmark("matrix/gram_by_transpose/f64/" + shape(1024, 1024), [=](State &state) {
+        const Mat a = filled(1024, 1024);
+        state.set_flops_per_op(2.0 * 1024.0 * 1024.0 * 1024.0);
+        state.set_bytes_per_op(3.0 * 1024.0 * 1024.0 * elem);
+        while (state.keep_running()) {
+            Mat c = a * a.transpose();
+            do_not_optimize(c);
+        }
+    });
+
+    // Rank-1 and rank-8 updates in place, the matrix is read and written once either way.
+    for (const size_t count : { size_t(1), size_t(8) }) {
+        const size_t size = 2048;
+        register_benchmark("matrix/ger/f64/" + shape(size, size) + "/rank_" + std::to_string(count), [=](State &state) {
+            Mat a = filled(size, size);
+            const std::vector<double> x(size * count, 1e-9), y(size * count, 1e-9);
+            state.set_flops_per_op(2.0 * static_cast<double>(size * size * count));
+            state.set_bytes_per_op(2.0 * static_cast<double>(size * size) * elem);
+            while (state.keep_running()) {
+                math::ger_batched(1.0, x, y, a, count);
+                do_not_optimize(a);
+            }
+        });
+    }
+
+    // Matrix-vector products, the batched ones read the matrix once for all their vectors.
+    for (const size_t count : { size_t(1), size_t(8) })
+        for (const char *flag : { "n", "t" }) {
+            const size_t size = 2048;
+            const math::matrix::Transpose ta = flag[0] == 't' ? math::matrix::TR::yes : math::matrix::TR::no;
+            register_benchmark("matrix/gemv/f64/" + shape(size, size) + "/" + flag + "/vectors_" + std::to_string(count), [=](State &state) {
+                const Mat a = filled(size, size);
+                const std::vector<double> x(size * count, 1.5);
+                std::vector<double> y(size * count, 0.5);
+                state.set_flops_per_op(2.0 * static_cast<double>(size * size * count));
+                state.set_bytes_per_op((static_cast<double>(size * size) + 3.0 * static_cast<double>(size * count)) * elem);
+                while (state.keep_running()) {
+                    math::gemv_batched(1.0, a, ta, x, 0.5, y, count);
+                    do_not_optimize(y);
+                }
+            });
+        }
+
+    // Triangular solves with a unit diagonal(the solutions stay bounded run after run), many right hand sides on either side and a single vector.
+    for (const char *variant : { "left_lower_n", "left_upper_t", "right_lower_t" }) {
+        const size_t size = 1024;
+        const math::matrix::Side side = variant[0] == 'l' ? math::matrix::SD::left : math::matrix::SD::right;
+        const math::matrix::Triangle triangle = (variant[side == math::matrix::SD::left ? 5 : 6] == 'l') ? math::matrix::TRI::lower : math::matrix::TRI::upper;
+        const math::matrix::Transpose ta = std::string_view(variant).ends_with('t') ? math::matrix::TR::yes : math::matrix::TR::no;
+        register_benchmark("matrix/trsm/f64/" + shape(size, size) + "/" + variant, [=](State &state) {
+            const Mat a = Mat(size, size, [](size_t i, size_t j) { return static_cast<double>((i * 131 + j * 71) % 97) * 1e-5; });
+            Mat b = filled(size, size);
+            state.set_flops_per_op(static_cast<double>(size * size * size));
+            state.set_bytes_per_op(2.5 * static_cast<double>(size * size) * elem);
+            while (state.keep_running()) {
+                math::trsm(1.0, a, side, triangle, ta, math::matrix::DG::unit, b);
+                do_not_optimize(b);
+            }
+        });
+    }
+    register_benchmark("matrix/trsv/f64/" + shape(2048, 2048), [=](State &state) {
+        const Mat a = Mat(2048, 2048, [](size_t i, size_t j) { return static_cast<double>((i * 131 + j * 71) % 97) * 1e-6; });
+        std::vector<double> x(2048, 1.0);
+        state.set_flops_per_op(2048.0 * 2048.0);
+        state.set_bytes_per_op(0.5 * 2048.0 * 2048.0 * elem);
+        while (state.keep_running()) {
+            math::trsv(a, math::matrix::TRI::lower, math::matrix::TR::no, math::matrix::DG::unit, std::span<double>(x));
+            do_not_optimize(x);
+        }
+    });
+
+    for (const size_t size : { size_t(64), size_t(1024) }) {
+        register_benchmark("matrix/transpose_in_place/f64/" + shape(size, size), [=](State &state) {
+            Mat a = filled(size, size);
+            state.set_bytes_per_op(2.0 * static_cast<double>(size * size) * elem);
+            while (state.keep_running()) {
+                a.transpose_in_place();
+                do_not_optimize(a);
+            }
+        });
+    }
+
+    // n-step transitions of a Markov chain(rows summing to one keep the powers bounded), and the exponential of a generator(rows summing to zero).
+    for (const size_t size : { size_t(64), size_t(512) }) {
+        const auto chain = [size](const double diagonal) {
+            return Mat(size, size, [=](size_t i, size_t j) {
+                return (static_cast<double>((i * 131 + j * 71) % 97) + 1.0) / (49.0 * static_cast<double>(size)) + ((i == j) ? diagonal : 0.0);
+            });
+        };
+        register_benchmark("matrix/pow/f64/" + shape(size, size) + "/exponent_100", [=](State &state) {
+            const Mat a = chain(0.0);
+            state.set_flops_per_op(2.0 * static_cast<double>(size * size * size * math::matrix::impl::power_products(100)));
+            state.set_bytes_per_op(3.0 * static_cast<double>(size * size) * elem);
+            while (state.keep_running()) {
+                Mat p = a.pow(100);
+                do_not_optimize(p);
+            }
+        });
+        register_benchmark("matrix/expm/f64/" + shape(size, size), [=](State &state) {
+            const Mat a = chain(-1.0);
+            size_t squarings = 0;
+            const size_t degree = math::matrix::impl::expm_degree(math::matrix::impl::expm_norm<double>(a.view()), squarings);
+            state.set_flops_per_op(static_cast<double>(size * size * math::matrix::impl::expm_flops_per_element(size, degree, squarings)));
+            state.set_bytes_per_op(7.0 * static_cast<double>(size * size) * elem);
+            while (state.keep_running()) {
+                Mat e = a.expm();
+                do_not_optimize(e);
+            }
+        });
+    }
+
+    register_extend(64, 1);
+    register_extend(64, 64);
+    register_extend(512, 8);
+}
\ No newline at end of file
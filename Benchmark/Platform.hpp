@@ -0,0 +1,116 @@
+// Platform.hpp
+#pragma once
+
+#include "../Helper/Headers.hpp"
+#include <cctype>
+
+#if defined(__linux__)
+    #include <sched.h>
+#endif
+
+namespace math::bench {
+struct CpuInfo {
+    std::string model = "unknown";
+    std::string governor = "unknown";
+    double mhz = 0;     // Current frequency of the first pinned CPU(0 if unknown).
+    double max_mhz = 0; // 0 if unknown.
+    int logical_cpus = 0;
+};
+}
+
+namespace math::bench::impl {
+_NODISC_ inline std::string trim(std::string_view s) {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
+    return std::string(s);
+}
+
+/**
+ * @brief Reading the first line of a small text file(like the files in /sys).
+ * @return The trimmed line, empty if the file can not be read.
+*/
+_NODISC_ inline std::string read_first_line(const char *path) {
+    std::FILE *file = std::fopen(path, "r");
+    if (file == nullptr) return {};
+    char buffer[256];
+    const bool ok = std::fgets(buffer, sizeof(buffer), file) != nullptr;
+    std::fclose(file);
+    return ok ? math::bench::impl::trim(buffer) : std::string();
+}
+
+_NODISC_ inline double read_khz_as_mhz(const std::string &path) {
+    const std::string value = math::bench::impl::read_first_line(path.c_str());
+    return value.empty() ? 0.0 : std::strtod(value.c_str(), nullptr) / 1000.0;
+}
+}
+
+namespace math::bench {
+/**
+ * @brief Reading the CPU model and frequency, from /proc/cpuinfo and cpufreq on Linux.
+ * @param cpu CPU whose frequency and governor are read.
+ * @return The CPU description, fields that are not available keep their defaults.
+*/
+_NODISC_ inline CpuInfo read_cpu_info(const int cpu = 0) {
+    CpuInfo info;
+    info.logical_cpus = omp_get_num_procs();
+#if defined(__linux__)
+    if (std::FILE *file = std::fopen("/proc/cpuinfo", "r")) {
+        char line[512];
+        double cpuinfo_mhz = 0;
+        while (std::fgets(line, sizeof(line), file)) {
+            const std::string_view view(line);
+            const size_t colon = view.find(':');
+            if (colon == std::string_view::npos) continue;
+            const std::string key = math::bench::impl::trim(view.substr(0, colon));
+            const std::string value = math::bench::impl::trim(view.substr(colon + 1));
+            if (info.model == "unknown" && (key == "model name" || key == "Model" || key == "cpu model")) info.model = value;
+            else if (cpuinfo_mhz == 0 && key == "cpu MHz") cpuinfo_mhz = std::strtod(value.c_str(), nullptr);
+        }
+        std::fclose(file);
+        info.mhz = cpuinfo_mhz;
+    }
+    const std::string cpufreq = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/";
+    if (const double mhz = math::bench::impl::read_khz_as_mhz(cpufreq + "scaling_cur_freq"); mhz > 0) info.mhz = mhz;
+    info.max_mhz = math::bench::impl::read_khz_as_mhz(cpufreq + "cpuinfo_max_freq");
+    if (std::string governor = math::bench::impl::read_first_line((cpufreq + "scaling_governor").c_str()); !governor.empty()) info.governor = std::move(governor);
+#else
+    (void)cpu;
+#endif
+    return info;
+}
+
+/**
+ * @brief Pinning the calling thread and every thread of the OpenMP team to its own CPU(round robin over the CPUs the process may run on).
+ * @param first_cpu Index into the allowed CPUs the calling thread(OpenMP thread 0) gets pinned to.
+ * @return The CPU of each OpenMP thread(indexed by thread number), empty if pinning is not supported or failed.
+ * @note The OpenMP runtime reuses its threads for teams of the same size, so the pinning holds for every later parallel region of that size.
+*/
+inline std::vector<int> pin_threads(const size_t first_cpu = 0) {
+#if defined(__linux__)
+    cpu_set_t allowed_set;
+    CPU_ZERO(&allowed_set);
+    if (sched_getaffinity(0, sizeof(allowed_set), &allowed_set) != 0) return {};
+    std::vector<int> allowed;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) if (CPU_ISSET(cpu, &allowed_set)) allowed.push_back(cpu);
+    if (allowed.empty()) return {};
+
+    std::vector<int> pinned(static_cast<size_t>(omp_get_max_threads()), -1);
+    std::atomic<bool> failed{false};
+    #pragma omp parallel num_threads(static_cast<int>(pinned.size()))
+    {
+        const size_t thread = static_cast<size_t>(omp_get_thread_num());
+        const int cpu = allowed[(first_cpu + thread) % allowed.size()];
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) == 0) pinned[thread] = cpu; // 0 is the calling thread.
+        else failed.store(true, std::memory_order_relaxed);
+    }
+    if (failed.load(std::memory_order_relaxed)) return {};
+    return pinned;
+#else
+    (void)first_cpu;
+    return {};
+#endif
+}
+}
\ No newline at end of file
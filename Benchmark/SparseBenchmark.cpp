@@ -0,0 +1,84 @@
+// SparseBenchmark.cpp
+#include "Benchmark.hpp"
+#include "../Matrix/SparseMatrix.hpp"
+
+namespace {
+using math::bench::State;
+using math::bench::do_not_optimize;
+using math::bench::register_benchmark;
+using Mat = math::Matrix<double>;
+using Sparse = math::SparseMatrix<double>;
+
+constexpr const double elem = sizeof(double);
+constexpr const double index_size = sizeof(Sparse::index_t);
+
+// Square and uneven: most rows hold a few elements, every 1024th one a few thousand, as in graphs with hubs.
+math::SparseBuilder<double> skewed(const size_t size) {
+    math::SparseBuilder<double> builder(size, size);
+    std::uint64_t state = 0x9e3779b97f4a7c15ull;
+    const auto next = [&state]() noexcept {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 33;
+    };
+    for (size_t i = 0; i < size; i++) {
+        const size_t length = (i % 1024 == 0) ? 2048 : 4 + next() % 24;
+        for (size_t k = 0; k < length; k++) builder.add(i, next() % size, static_cast<double>(next() % 97) * 0.01 - 0.48);
+    }
+    return builder;
+}
+
+std::string shape(const size_t r, const size_t c) {
+    return std::to_string(r) + "x" + std::to_string(c);
+}
+}
+
+_MATH_BENCHMARK_REGISTRAR_(register_sparse_benchmarks) {
+    const size_t size = 1 << 16;
+    register_benchmark("sparse/build/f64/" + shape(size, size) + "/skewed", [=](State &state) {
+        const math::SparseBuilder<double> builder = skewed(size);
+        state.set_bytes_per_op(2.0 * static_cast<double>(builder.size()) * (elem + 2.0 * index_size));
+        while (state.keep_running()) {
+            Sparse a = builder.build();
+            do_not_optimize(a);
+        }
+    });
+    // Gathered dot products by rows for CSR, scattered into per thread copies of y for its transpose.
+    for (const auto ta : { math::matrix::TR::no, math::matrix::TR::yes }) {
+        const std::string name = (ta == math::matrix::TR::no) ? "" : "/transposed";
+        register_benchmark("sparse/spmv/f64/" + shape(size, size) + "/skewed" + name, [=](State &state) {
+            const Sparse a = skewed(size).build();
+            const std::vector<double> x(size, 1.0);
+            std::vector<double> y(size);
+            state.set_flops_per_op(2.0 * static_cast<double>(a.non_zeros()));
+            state.set_bytes_per_op(static_cast<double>(a.non_zeros()) * (elem + index_size) + 2.0 * static_cast<double>(size) * elem);
+            while (state.keep_running()) {
+                math::spmv<double>(1.0, a, ta, x, 0.0, y);
+                do_not_optimize(y);
+            }
+        });
+    }
+    register_benchmark("sparse/spmm/f64/" + shape(size, size) + "/skewed/columns_16", [=](State &state) {
+        const Sparse a = skewed(size).build();
+        const Mat b(size, 16, [](size_t i, size_t j) { return static_cast<double>((i * 131 + j * 71) % 97) * 0.01; });
+        Mat c(size, 16);
+        state.set_flops_per_op(2.0 * 16.0 * static_cast<double>(a.non_zeros()));
+        state.set_bytes_per_op(static_cast<double>(a.non_zeros()) * (elem + index_size) + 2.0 * 16.0 * static_cast<double>(size) * elem);
+        while (state.keep_running()) {
+            math::spmm<double>(1.0, a, math::matrix::TR::no, b, 0.0, c);
+            do_not_optimize(c);
+        }
+    });
+    // Two hops over the skewed graph, the hub rows make a few rows of the product orders of magnitude longer than the rest.
+    register_benchmark("sparse/spgemm/f64/" + shape(size, size) + "/skewed_squared", [=](State &state) {
+        const Sparse a = skewed(size).build();
+        double products = 0.0;
+        for (size_t i = 0; i < size; i++)
+            for (size_t k = a.offsets()[i]; k < a.offsets()[i + 1]; k++) products += static_cast<double>(a.offsets()[a.indices()[k] + 1] - a.offsets()[a.indices()[k]]);
+        state.set_flops_per_op(2.0 * products);
+        state.set_bytes_per_op(2.0 * products * (elem + index_size));
+        while (state.keep_running()) {
+            Sparse c = a * a;
+            do_not_optimize(c);
+        }
+    });
+}
\ No newline at end of file
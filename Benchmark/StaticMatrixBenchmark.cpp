@@ -0,0 +1,97 @@
+// StaticMatrixBenchmark.cpp
+#include "Benchmark.hpp"
+#include "../Matrix/MatrixStatic.hpp"
+#include "../Matrix/StackMatrix.hpp"
+
+namespace {
+using math::bench::State;
+using math::bench::do_not_optimize;
+using math::bench::register_benchmark;
+using M2 = math::Matrix2x2<double>;
+
+constexpr const double elem = sizeof(double);
+
+// Operands go through do_not_optimize every operation so that the compiler can not hoist the work out of the loop.
+template <typename Op>
+void run_2x2(State &state, const double flops, Op op) {
+    M2 a(1.25, -0.5, 0.75, 2.0), b(0.5, 1.5, -1.0, 0.25);
+    state.set_flops_per_op(flops);
+    state.set_bytes_per_op(8 * elem);
+    while (state.keep_running()) {
+        do_not_optimize(a);
+        do_not_optimize(b);
+        auto result = op(a, b);
+        do_not_optimize(result);
+    }
+}
+
+template <size_t R, size_t C>
+void register_stack(const char *shape) {
+    using MS = math::MatrixS<double, R, C>;
+    const std::string s(shape);
+    static constexpr const double n = static_cast<double>(R * C);
+
+    register_benchmark("matrix_s/construct/f64/" + s, [](State &state) {
+        state.set_bytes_per_op(n * elem);
+        while (state.keep_running()) {
+            MS m;
+            do_not_optimize(m);
+        }
+    });
+    register_benchmark("matrix_s/copy/f64/" + s, [](State &state) {
+        MS a;
+        state.set_bytes_per_op(2 * n * elem);
+        while (state.keep_running()) {
+            do_not_optimize(a);
+            MS m(a);
+            do_not_optimize(m);
+        }
+    });
+    register_benchmark("matrix_s/add_assign/f64/" + s, [](State &state) {
+        MS a, b;
+        for (size_t i = 0; i < R; i++) for (size_t j = 0; j < C; j++) b(i, j) = static_cast<double>(i + j) * 0.5;
+        state.set_bytes_per_op(3 * n * elem);
+        state.set_flops_per_op(n);
+        while (state.keep_running()) {
+            do_not_optimize(b);
+            a += b;
+            do_not_optimize(a);
+        }
+    });
+    register_benchmark("matrix_s/add/f64/" + s, [](State &state) {
+        MS a, b;
+        for (size_t i = 0; i < R; i++) for (size_t j = 0; j < C; j++) a(i, j) = b(i, j) = static_cast<double>(i + j) * 0.5;
+        state.set_bytes_per_op(3 * n * elem);
+        state.set_flops_per_op(n);
+        while (state.keep_running()) {
+            do_not_optimize(a);
+            do_not_optimize(b);
+            MS m = a + b;
+            do_not_optimize(m);
+        }
+    });
+}
+}
+
+_MATH_BENCHMARK_REGISTRAR_(register_static_matrix_benchmarks) {
+    register_benchmark("matrix2x2/construct/f64", [](State &state) {
+        double v = 1.5;
+        state.set_bytes_per_op(4 * elem);
+        while (state.keep_running()) {
+            do_not_optimize(v);
+            M2 m(v, v, v, v);
+            do_not_optimize(m);
+        }
+    });
+    register_benchmark("matrix2x2/add/f64", [](State &state) { run_2x2(state, 4, [](const M2 &a, const M2 &b) { return a + b; }); });
+    register_benchmark("matrix2x2/add_assign/f64", [](State &state) { run_2x2(state, 4, [](M2 &a, const M2 &b) -> bool { a += b; return true; }); });
+    register_benchmark("matrix2x2/mul/f64", [](State &state) { run_2x2(state, 12, [](const M2 &a, const M2 &b) { return a * b; }); });
+    register_benchmark("matrix2x2/square/f64", [](State &state) { run_2x2(state, 8, [](const M2 &a, const M2 &) { return a.square(); }); });
+    register_benchmark("matrix2x2/transpose/f64", [](State &state) { run_2x2(state, 0, [](const M2 &a, const M2 &) { return a.transpose(); }); });
+    register_benchmark("matrix2x2/determinant/f64", [](State &state) { run_2x2(state, 3, [](const M2 &a, const M2 &) { return a.determinant(); }); });
+    register_benchmark("matrix2x2/equal/f64", [](State &state) { run_2x2(state, 0, [](const M2 &a, const M2 &b) { return a == b; }); });
+
+    register_stack<4, 4>("4x4");
+    register_stack<16, 16>("16x16");
+    register_stack<64, 8>("64x8");
+}
\ No newline at end of file
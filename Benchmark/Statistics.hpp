@@ -0,0 +1,131 @@
+// Statistics.hpp
+#pragma once
+
+#include "../Helper/Headers.hpp"
+
+namespace math::bench {
+/**
+ * @brief Median of a sample.
+ * @param samples Sample(taken by value since it is partially reordered).
+ * @return The median, NaN for an empty sample.
+*/
+_NODISC_ inline double median(std::vector<double> samples) {
+    if (samples.empty()) return std::numeric_limits<double>::quiet_NaN();
+    const size_t mid = samples.size() / 2;
+    std::nth_element(samples.begin(), samples.begin() + mid, samples.end());
+    const double upper = samples[mid];
+    if (samples.size() % 2 == 1) return upper;
+    return (*std::max_element(samples.begin(), samples.begin() + mid) + upper) / 2;
+}
+
+/**
+ * @brief Median absolute deviation(unscaled) of a sample around its median.
+ * @param samples Sample.
+ * @return The MAD, NaN for an empty sample.
+*/
+_NODISC_ inline double median_absolute_deviation(const std::vector<double> &samples) {
+    const double center = math::bench::median(samples);
+    std::vector<double> deviations(samples.size());
+    std::transform(samples.begin(), samples.end(), deviations.begin(), [center](const double x) { return std::fabs(x - center); });
+    return math::bench::median(std::move(deviations));
+}
+
+// Range holding the median of the distribution a sample was drawn from with at least the asked confidence.
+struct MedianInterval {
+    double low, high;
+};
+
+/**
+ * @brief Distribution free confidence interval of the median from the order statistics of a sample.
+ * @param samples Sample(taken by value since it is sorted).
+ * @param level Confidence level, 0.95 for a 95% interval.
+ * @return The widest pair of order statistics x(k), x(n - 1 - k) the number of samples below the median(binomial(n, 1/2)) leaves it outside with at most (1 - level) / 2
+ *         on each side, NaNs for an empty sample.
+ * @note Samples too small to reach the level(fewer than 6 at 95%) get their whole range.
+*/
+_NODISC_ inline MedianInterval median_confidence_interval(std::vector<double> samples, const double level = 0.95) {
+    if (samples.empty()) return MedianInterval{ std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN() };
+    std::sort(samples.begin(), samples.end());
+    const size_t n = samples.size();
+    const double tail = (1 - level) / 2, log_half = -static_cast<double>(n) * std::log(2.0);
+    size_t k = 0;
+    double below = 0; // P(at most j samples below the median).
+    for (size_t j = 0; 2 * j + 1 < n; j++) {
+        below += std::exp(std::lgamma(static_cast<double>(n + 1)) - std::lgamma(static_cast<double>(j + 1)) - std::lgamma(static_cast<double>(n - j + 1)) + log_half);
+        if (below > tail) break;
+        k = j;
+    }
+    return MedianInterval{ samples[k], samples[n - 1 - k] };
+}
+
+struct MannWhitneyResult {
+    double u;       // U statistic of the first sample.
+    double p_value; // Two-sided.
+    bool exact;     // Whether p_value comes from the exact distribution(small samples without ties) instead of the normal approximation.
+};
+}
+
+namespace math::bench::impl {
+/**
+ * @brief Two-sided exact p-value of U by counting the rank arrangements, f(n1, n2, u) = f(n1 - 1, n2, u - n2) + f(n1, n2 - 1, u).
+*/
+_NODISC_ inline double mann_whitney_exact_p(const size_t n1, const size_t n2, const double u) {
+    const size_t max_u = n1 * n2;
+    // counts[j][v] holds f(i, j, v) for the current i.
+    std::vector<std::vector<double>> counts(n2 + 1, std::vector<double>(max_u + 1, 0.0));
+    for (size_t j = 0; j <= n2; j++) counts[j][0] = 1.0;
+    for (size_t i = 1; i <= n1; i++) {
+        std::vector<std::vector<double>> next(n2 + 1, std::vector<double>(max_u + 1, 0.0));
+        next[0][0] = 1.0;
+        for (size_t j = 1; j <= n2; j++)
+            for (size_t v = 0; v <= i * j; v++)
+                next[j][v] = (v >= j ? counts[j][v - j] : 0.0) + next[j - 1][v];
+        counts.swap(next);
+    }
+    const std::vector<double> &dist = counts[n2];
+    double total = 0;
+    for (const double c : dist) total += c;
+    const double u_low = std::min(u, static_cast<double>(max_u) - u);
+    double tail = 0;
+    for (size_t v = 0; static_cast<double>(v) <= u_low + 1e-9; v++) tail += dist[v];
+    return std::min(1.0, 2.0 * tail / total);
+}
+}
+
+namespace math::bench {
+/**
+ * @brief Mann-Whitney U test between two independent samples, exact for small tie-free samples and normal approximated(tie and continuity corrected) otherwise.
+ * @param a First sample.
+ * @param b Second sample.
+ * @return U of the first sample with the two-sided p-value, p_value is 1 if either sample is empty.
+*/
+_NODISC_ inline MannWhitneyResult mann_whitney_u(const std::vector<double> &a, const std::vector<double> &b) {
+    const size_t n1 = a.size(), n2 = b.size();
+    if (n1 == 0 || n2 == 0) return MannWhitneyResult{ 0.0, 1.0, true };
+    std::vector<std::pair<double, size_t>> pooled;
+    pooled.reserve(n1 + n2);
+    for (const double x : a) pooled.emplace_back(x, 0);
+    for (const double x : b) pooled.emplace_back(x, 1);
+    std::sort(pooled.begin(), pooled.end(), [](const auto &l, const auto &r) { return l.first < r.first; });
+
+    double rank_sum_a = 0, tie_term = 0;
+    for (size_t i = 0; i < pooled.size();) {
+        size_t j = i + 1;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first) j++;
+        const double average_rank = static_cast<double>(i + j + 1) / 2; // Ranks are 1 based.
+        for (size_t k = i; k < j; k++) if (pooled[k].second == 0) rank_sum_a += average_rank;
+        const double t = static_cast<double>(j - i);
+        tie_term += t * t * t - t;
+        i = j;
+    }
+    const double dn1 = static_cast<double>(n1), dn2 = static_cast<double>(n2), n = dn1 + dn2;
+    const double u = rank_sum_a - dn1 * (dn1 + 1) / 2;
+    if (tie_term == 0 && n1 + n2 <= 40) return MannWhitneyResult{ u, math::bench::impl::mann_whitney_exact_p(n1, n2, u), true };
+
+    const double mean = dn1 * dn2 / 2;
+    const double variance = dn1 * dn2 / 12 * ((n + 1) - tie_term / (n * (n - 1)));
+    if (variance <= 0) return MannWhitneyResult{ u, 1.0, false }; // Every value is the same.
+    const double z = std::max(0.0, std::fabs(u - mean) - 0.5) / std::sqrt(variance);
+    return MannWhitneyResult{ u, std::min(1.0, std::erfc(z / std::sqrt(2.0))), false };
+}
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+// VariableBenchmark.cpp
+#include "Benchmark.hpp"
+#include "../Expression/Utility/Variable/VariableString.hpp"
+
+namespace {
+using math::bench::State;
+using math::bench::do_not_optimize;
+using math::bench::register_benchmark;
+using math::expr::var::VariableName;
+
+// Names that fit the small buffer and names that need an external one.
+constexpr const std::string_view short_name = "x_1";
+constexpr const std::string_view long_name = "velocity_of_the_particle_2";
+
+void register_name(const char *label, const std::string_view name) {
+    const std::string suffix(label);
+    const double bytes = static_cast<double>(name.size());
+
+    register_benchmark("variable/construct/" + suffix, [=](State &state) {
+        state.set_bytes_per_op(bytes);
+        while (state.keep_running()) {
+            const char *data = name.data();
+            do_not_optimize(data);
+            VariableName v(data, name.size());
+            do_not_optimize(v);
+        }
+    });
+    register_benchmark("variable/copy/" + suffix, [=](State &state) {
+        const VariableName source(name);
+        state.set_bytes_per_op(2 * bytes);
+        while (state.keep_running()) {
+            VariableName v(source);
+            do_not_optimize(v);
+        }
+    });
+    register_benchmark("variable/equal/" + suffix, [=](State &state) {
+        const VariableName a(name), b(name);
+        state.set_bytes_per_op(2 * bytes);
+        while (state.keep_running()) {
+            bool equal = (a == b);
+            do_not_optimize(equal);
+        }
+    });
+    register_benchmark("variable/name_check/" + suffix, [=](State &state) {
+        state.set_bytes_per_op(bytes);
+        while (state.keep_running()) {
+            const char *data = name.data();
+            do_not_optimize(data);
+            auto validity = math::expr::var::is_valid_var_name(data, name.size());
+            do_not_optimize(validity);
+        }
+    });
+}
+}
+
+_MATH_BENCHMARK_REGISTRAR_(register_variable_benchmarks) {
+    register_name("sso", short_name);
+    register_name("external", long_name);
+
+    register_benchmark("variable/construct/char", [](State &state) {
+        char c = 'y';
+        while (state.keep_running()) {
+            do_not_optimize(c);
+            VariableName v(c);
+            do_not_optimize(v);
+        }
+    });
+    register_benchmark("variable/name_check/math_function", [](State &state) {
+        const std::string_view name = "sinh";
+        while (state.keep_running()) {
+            const char *data = name.data();
+            do_not_optimize(data);
+            auto validity = math::expr::var::is_valid_var_name(data, name.size());
+            do_not_optimize(validity);
+        }
+    });
+    register_benchmark("variable/name_check/invalid_char", [](State &state) {
+        const std::string_view name = "speed-of_light";
+        while (state.keep_running()) {
+            const char *data = name.data();
+            do_not_optimize(data);
+            auto validity = math::expr::var::is_valid_var_name(data, name.size());
+            do_not_optimize(validity);
+        }
+    });
+}
\ No newline at end of file
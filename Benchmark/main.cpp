@@ -0,0 +1,6 @@
+// main.cpp
+#include "Benchmark.hpp"
+
+int main(int argc, char **argv) {
+    return math::bench::run_main(argc, argv);
+}
\ No newline at end of file
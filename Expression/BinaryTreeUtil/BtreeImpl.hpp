@@ -1,7 +1,7 @@
 // BtreeImpl.hpp
 #pragma once
 
-#include "..\Utility\Node.hpp"
+#include "../Utility/Node.hpp"
 
 namespace math::expr::btree {
 
@@ -2,7 +2,7 @@
 #pragma once
 
 #include "Functions.hpp"
-#include "Variable\VariableValue.hpp"
+#include "Variable/VariableValue.hpp"
 
 namespace math::expr {
 
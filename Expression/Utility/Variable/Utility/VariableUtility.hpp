@@ -1,22 +1,22 @@
 // VariableUtility.hpp
 #pragma once
 
-#include "..\..\..\..\Helper\Headers.hpp"
+#include "../../../../Helper/Headers.hpp"
 
 namespace math::expr::var {
 
-const std::unordered_set<std::string_view> unicode_operators {
+inline const std::unordered_set<std::string_view> unicode_operators {
     "÷", "√", "·", "×",
 };
 
-const std::unordered_set<std::string_view> function_names {
+inline const std::unordered_set<std::string_view> function_names {
     "exp" , "log" , "logk", "pow" , "sqrt", "cbrt",
     "sin" , "cos" , "tan" , "csc" , "sec" , "cot" ,
     "asin", "acos", "atan", "acsc", "asec", "acot",
     "sinh", "cosh", "tanh", "csch", "sech", "coth",
 };
 
-bool is_math_func(std::string_view s) noexcept {
+inline bool is_math_func(std::string_view s) noexcept {
     switch(s.size()) {
         case 3:
         case 4:
@@ -36,7 +36,7 @@ constexpr bool is_math_operator(const char c) noexcept {
     }
 }
 
-bool is_unicode_math_operator(std::string_view s) noexcept {
+inline bool is_unicode_math_operator(std::string_view s) noexcept {
     switch(s.size()) {
         case 2:
         case 3:
@@ -45,7 +45,7 @@ bool is_unicode_math_operator(std::string_view s) noexcept {
     }
 }
 
-bool is_math_operator(std::string_view s) noexcept {
+inline bool is_math_operator(std::string_view s) noexcept {
     switch(s.size()) {
         case 1: return is_math_operator(s[0]);
         case 2:
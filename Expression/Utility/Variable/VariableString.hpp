@@ -1,7 +1,9 @@
 // VariableString.hpp
 #pragma once
 
-#include "Utility\VariableNameCheck.hpp"
+#include "Utility/VariableNameCheck.hpp"
+#include "../../../Memory/MemoryStats.hpp"
+#include "../../../Profile/OpCounters.hpp"
 
 namespace math::expr::var {
 
@@ -47,13 +49,14 @@ public:
         if (size > MAX_VAR_SIZE) throw std::invalid_argument("Can't make a variable with a name greater than 255 characters.");
         if (is_valid_var_name(val) == VNET::first_character_be_letter) throw std::invalid_argument("Name of the variable must start with an english alphabet.");
         m_data.size = size;
-        if (m_data.size >= SSO_SIZE) m_data.data.external_buffer = static_cast<mut_ptr<char> >(::operator new(static_cast<size_t>(m_data.size + 1)));
+        if (m_data.size >= SSO_SIZE) m_data.data.external_buffer = allocate_external(m_data.size);
         mut_ptr<char> loc = m_data.size >= SSO_SIZE ? m_data.data.external_buffer : m_data.data.internal_buffer;
         std::memset(loc, val, m_data.size);
         loc[m_data.size] = '\0';
     }
 
     VariableString(read_ptr<char> data, size_t size) {
+        _OP_SCOPE_SIZED_(variable, size, 1, 0, sizeof(char))
         if (size < MIN_VAR_SIZE) throw std::invalid_argument("Can't instantiate a variable with no name.");
         if (size > MAX_VAR_SIZE) throw std::invalid_argument("Can't make a variable with a name greater than 255 characters.");
         auto validity = is_valid_var_name(data, size);
@@ -70,7 +73,7 @@ public:
             default: break;
         }
         m_data.size = size;
-        if (m_data.size >= SSO_SIZE) m_data.data.external_buffer = static_cast<mut_ptr<char> >(::operator new(static_cast<size_t>(m_data.size + 1)));
+        if (m_data.size >= SSO_SIZE) m_data.data.external_buffer = allocate_external(m_data.size);
         mut_ptr<char> loc = m_data.size >= SSO_SIZE ? m_data.data.external_buffer : m_data.data.internal_buffer;
         std::memcpy(loc, data, m_data.size);
         loc[m_data.size] = '\0';
@@ -88,8 +91,8 @@ public:
         }
         else {
             m_data.size = other.size();
-            m_data.data.external_buffer = static_cast<mut_ptr<char> >(::operator new(m_data.size + 1));
-            std::memcpy(m_data.data.external_buffer, other.m_data.data.external_buffer, m_data.size);
+            m_data.data.external_buffer = allocate_external(m_data.size);
+            std::memcpy(m_data.data.external_buffer, other.m_data.data.external_buffer, static_cast<size_t>(m_data.size) + 1);
         }
     }
     VariableString &operator=(const VariableString &other) {
@@ -110,7 +113,10 @@ public:
 
 public:
     ~VariableString() noexcept {
-        if (m_data.size >= SSO_SIZE) ::operator delete(m_data.data.external_buffer);
+        if (m_data.size >= SSO_SIZE) {
+            math::memory::impl::record_free(static_cast<size_t>(m_data.size) + 1, math::memory::AT::variable);
+            ::operator delete(m_data.data.external_buffer);
+        }
     }
 
 public:
@@ -152,12 +158,12 @@ public:
     }
 
 public:
-    bool operator==(const VariableString &other) noexcept {
+    bool operator==(const VariableString &other) const noexcept {
         if (this == &other) return true;
         if (m_data.size != other.m_data.size) return false;
         return std::memcmp(data(), other.data(), m_data.size) == 0;
     }
-    bool operator!=(const VariableString &other) noexcept {
+    bool operator!=(const VariableString &other) const noexcept {
         if (this == &other) return false;
         if (m_data.size != other.m_data.size) return true;
         return std::memcmp(data(), other.data(), m_data.size) != 0;
@@ -168,6 +174,13 @@ public:
         return std::string_view(data(), m_data.size);
     }
 
+private:
+    static mut_ptr<char> allocate_external(const size8_t size) {
+        mut_ptr<char> buffer = static_cast<mut_ptr<char> >(::operator new(static_cast<size_t>(size) + 1));
+        (void)math::memory::impl::record_allocation(static_cast<size_t>(size) + 1, math::memory::AT::variable); // Always "variable", the free can't know an outer tag.
+        return buffer;
+    }
+
 private:
     data_t m_data;
 };
@@ -177,7 +190,7 @@ using VariableName = VariableString;
 
 namespace math::literals {
 
-math::expr::var::VariableString operator""_var(read_ptr<char> data, size_t size) {
+inline math::expr::var::VariableString operator""_var(read_ptr<char> data, size_t size) {
     return math::expr::var::VariableString(data, size);
 }
 
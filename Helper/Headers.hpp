@@ -17,16 +17,25 @@
 
 #include <any>
 #include <variant>
+#include <optional>
 
 #include <string>
 #include <string_view>
 #include <cstring>
 
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <typeindex>
 #include <cmath>
+#include <bit>
+#include <chrono>
 
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <span>
 
 #include <new>
 #include <stdexcept>
@@ -14,18 +14,10 @@ inline constexpr bool is_equal(const T a, const T b) noexcept {
     return a == b;
 }
 
-#define _IS_EQUAL_SHORTCUT_(T) static constexpr const T rel_tol(static_cast<T>(4) * std::numeric_limits<T>::epsilon()); \
-    static constexpr const T abs_tol(std::numeric_limits<T>::denorm_min()); \
+#define _IS_EQUAL_SHORTCUT_(T) constexpr const T rel_tol(static_cast<T>(4) * std::numeric_limits<T>::epsilon()); \
+    constexpr const T abs_tol(std::numeric_limits<T>::denorm_min()); \
     return (std::fabs(a - b) <= std::max(rel_tol * std::max(std::fabs(a), std::fabs(b)), abs_tol));
 
-template <long double T>
-requires (sizeof(long double) != sizeof(double))
-inline constexpr bool is_equal(const long double &a, const long double &b) noexcept {
-    _IS_EQUAL_SHORTCUT_(long double)
-}
-
-template <long double T>
-requires (sizeof(long double) == sizeof(double))
 inline constexpr bool is_equal(const long double a, const long double b) noexcept {
     _IS_EQUAL_SHORTCUT_(long double)
 }
@@ -35,12 +27,14 @@ inline constexpr bool is_equal(const T a, const T b) noexcept {
     _IS_EQUAL_SHORTCUT_(T)
 }
 
-_MTEMPL_ requires ( std::is_trivially_copyable_v<T> && ProperEquality<T> && (sizeof(T) <= sizeof(double)))
+_MTEMPL_ concept SmallTrivialEquality = (!std::integral<T>) && (!std::floating_point<T>) && std::is_trivially_copyable_v<T> && ProperEquality<T> && (sizeof(T) <= sizeof(double));
+
+_MTEMPL_ requires SmallTrivialEquality<T>
 inline constexpr bool is_equal(const T a, const T b) noexcept {
     return a == b;
 }
 
-_MTEMPL_ requires ProperEquality<T>
+_MTEMPL_ requires ProperEquality<T> && (!std::integral<T>) && (!std::floating_point<T>) && (!SmallTrivialEquality<T>)
 inline constexpr bool is_equal(const T &a, const T &b) noexcept( _DECL_ == _DECL_ ) {
     return a == b;
 }
@@ -95,13 +89,13 @@ class ZeroValueHolder {
             return zero_vals;
         }
     public:
-        _MTEMPL_ constexpr void store_of(const T &val) { // Cannot do noexcept because typeid can throw.
+        _MTEMPL_ void store_of(const T &val) { // Cannot do noexcept because typeid can throw.
             m_vals[std::type_index(typeid(T))] = val;
         }
-        _MTEMPL_ _NODISC_ constexpr bool exists_of() {
+        _MTEMPL_ _NODISC_ bool exists_of() const {
             return (m_vals.find(std::type_index(typeid(T))) != m_vals.end());   
         }
-        _MTEMPL_ _NODISC_ constexpr const T &get_of() const {
+        _MTEMPL_ _NODISC_ const T &get_of() const {
             const auto loc = m_vals.find(std::type_index(typeid(T)));
             if (loc != m_vals.end()) return std::any_cast<const T&>(loc->second);
             else throw std::logic_error("Cannot provide the zero value of a type that is not already stored in helper::zero_vals.\n");
@@ -109,7 +103,7 @@ class ZeroValueHolder {
     private:
         std::unordered_map<std::type_index, std::any> m_vals;
     private:
-        constexpr ZeroValueHolder() { // Helping the file user by pre-saving some of the types' 0 val.
+        ZeroValueHolder() { // Helping the file user by pre-saving some of the types' 0 val.
             store_of<char>(static_cast<char>(0));
             store_of<short>(static_cast<short>(0));
             store_of<int>(static_cast<int>(0));
@@ -170,7 +164,7 @@ class ZeroValueHolder {
         ZeroValueHolder(const ZeroValueHolder&) = delete;
         ZeroValueHolder& operator=(const ZeroValueHolder&) = delete;
 };
-ZeroValueHolder& zero_vals = ZeroValueHolder::instance();
+inline ZeroValueHolder& zero_vals = ZeroValueHolder::instance();
 }
 
 namespace math::helper {
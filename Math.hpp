@@ -1,4 +1,11 @@
 #pragma once
 
-#include "Matrix\Matrix.hpp"
-#include "Matrix\MatrixStatic.hpp"
\ No newline at end of file
+#include "Matrix/Matrix.hpp"
+#include "Matrix/MatrixStatic.hpp"
+#include "Matrix/StackMatrix.hpp"
+#include "Matrix/Decomposition/LU.hpp"
+#include "Matrix/Decomposition/Cholesky.hpp"
+#include "Matrix/Decomposition/QR.hpp"
+#include "Matrix/Decomposition/SymmetricEigen.hpp"
+#include "Matrix/Decomposition/RandomizedSVD.hpp"
+#include "Matrix/SparseMatrix.hpp"
\ No newline at end of file
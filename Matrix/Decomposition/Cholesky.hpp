@@ -0,0 +1,255 @@
+// Cholesky.hpp
+#pragma once
+#include "../Matrix.hpp"
+
+namespace math::matrix {
+// Outcome of a Cholesky factorisation, reported instead of thrown.
+struct CholeskyStatus {
+    size_t failed_column = static_cast<size_t>(-1); // First column whose pivot was not positive(or NaN), -1 on success.
+
+    _NODISC_ bool ok() const noexcept {
+        return failed_column == static_cast<size_t>(-1);
+    }
+    explicit operator bool() const noexcept {
+        return this->ok();
+    }
+};
+}
+
+namespace math::matrix::impl {
+inline constexpr const size_t cholesky_tile = 128;  // Side of the tiles, the unit of work of the task graph.
+inline constexpr const size_t cholesky_inner = 64;  // Columns of the blocks solved unblocked inside a tile, the rest goes through gemm.
+
+/**
+ * @brief Unblocked A = L * L^T of a small diagonal block, in its lower triangle.
+ * @return The first column of the block with a pivot that is not positive, the size on success.
+*/
+template <std::floating_point T>
+_NODISC_ inline size_t cholesky_unblocked(const MatrixView<T> a) noexcept {
+    const size_t n = a.num_rows();
+    for (size_t j = 0; j < n; j++) {
+        const T *const r_j = a.row(j);
+        T sum = T(0);
+        #pragma omp simd reduction(+:sum)
+        for (size_t p = 0; p < j; p++) sum += r_j[p] * r_j[p];
+        const T d = r_j[j] - sum;
+        if (!(d > T(0))) return j;
+        const T l = std::sqrt(d), inverse = T(1) / l;
+        a(j, j) = l;
+        for (size_t i = j + 1; i < n; i++) {
+            T *const r_i = a.row(i);
+            T dot = T(0);
+            #pragma omp simd reduction(+:dot)
+            for (size_t p = 0; p < j; p++) dot += r_i[p] * r_j[p];
+            r_i[j] = (r_i[j] - dot) * inverse;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief A = L * L^T of a diagonal tile, left-looking by cholesky_inner columns: the columns already factorised reach a block through syrk and gemm.
+ * @return The first column of the tile with a pivot that is not positive, the size on success.
+*/
+template <std::floating_point T>
+_NODISC_ inline size_t cholesky_tile_potrf(const MatrixView<T> a) noexcept {
+    constexpr size_t s = cholesky_inner;
+    const size_t n = a.num_rows();
+    for (size_t j0 = 0; j0 < n; j0 += s) {
+        const size_t count = std::min(s, n - j0), below = n - j0 - count;
+        if (j0 != 0) {
+            const MatrixView<const T> done = a.block(j0, 0, n - j0, j0);
+            math::matrix::impl::syrk_kernel<T>(T(-1), done.block(0, 0, count, j0), TR::no, T(1), a.block(j0, j0, count, count), TRI::lower, false);
+            if (below != 0) math::matrix::impl::gemm_nothrow<T>(T(-1), done.block(count, 0, below, j0), TR::no, done.block(0, 0, count, j0), TR::yes,
+                T(1), a.block(j0 + count, j0, below, count), false);
+        }
+        const size_t column = math::matrix::impl::cholesky_unblocked<T>(a.block(j0, j0, count, count));
+        if (column != count) return j0 + column;
+        if (below != 0) math::matrix::impl::trsm_kernel<T>(T(1), a.block(j0, j0, count, count), SD::right, TRI::lower, TR::yes, DG::non_unit,
+            a.block(j0 + count, j0, below, count), false);
+    }
+    return n;
+}
+
+/**
+ * @brief Tiled right-looking Cholesky of the lower triangle of a as a graph of OpenMP tasks: every tile operation waits only on the tiles it reads.
+ * @param dependencies One marker per tile(tiles x tiles), only their addresses matter.
+*/
+template <std::floating_point T>
+_NODISC_ inline CholeskyStatus cholesky_tiles(const MatrixView<T> a, char *const dependencies, const bool is_parallel) noexcept {
+    constexpr size_t nb = cholesky_tile;
+    const size_t n = a.num_rows(), tiles = (n + nb - 1) / nb;
+    std::atomic<size_t> failed{static_cast<size_t>(-1)};
+    const auto tile = [&](const size_t i, const size_t j) noexcept {
+        return a.block(i * nb, j * nb, std::min(nb, n - i * nb), std::min(nb, n - j * nb));
+    };
+    const auto has_failed = [&]() noexcept { return failed.load(std::memory_order_relaxed) != static_cast<size_t>(-1); };
+
+    #pragma omp parallel if(is_parallel)
+    #pragma omp single
+    for (size_t k = 0; k < tiles; k++) {
+        #pragma omp task depend(inout: dependencies[k * tiles + k])
+        {
+            _TRACE_SPAN_(compute, "cholesky_potrf")
+            if (!has_failed()) {
+                const size_t column = math::matrix::impl::cholesky_tile_potrf<T>(tile(k, k));
+                if (column != tile(k, k).num_rows()) {
+                    size_t expected = static_cast<size_t>(-1);
+                    failed.compare_exchange_strong(expected, k * nb + column, std::memory_order_relaxed);
+                }
+            }
+        }
+        for (size_t i = k + 1; i < tiles; i++) {
+            #pragma omp task depend(in: dependencies[k * tiles + k]) depend(inout: dependencies[i * tiles + k])
+            {
+                _TRACE_SPAN_(compute, "cholesky_trsm")
+                if (!has_failed()) math::matrix::impl::trsm_kernel<T>(T(1), tile(k, k), SD::right, TRI::lower, TR::yes, DG::non_unit, tile(i, k), false);
+            }
+        }
+        for (size_t i = k + 1; i < tiles; i++) {
+            #pragma omp task depend(in: dependencies[i * tiles + k]) depend(inout: dependencies[i * tiles + i])
+            {
+                _TRACE_SPAN_(compute, "cholesky_syrk")
+                if (!has_failed()) math::matrix::impl::syrk_kernel<T>(T(-1), tile(i, k), TR::no, T(1), tile(i, i), TRI::lower, false);
+            }
+            for (size_t j = k + 1; j < i; j++) {
+                #pragma omp task depend(in: dependencies[i * tiles + k], dependencies[j * tiles + k]) depend(inout: dependencies[i * tiles + j])
+                {
+                    _TRACE_SPAN_(compute, "cholesky_gemm")
+                    if (!has_failed()) math::matrix::impl::gemm_nothrow<T>(T(-1), tile(i, k), TR::no, tile(j, k), TR::yes, T(1), tile(i, j), false);
+                }
+            }
+        }
+    }
+    return CholeskyStatus{ failed.load(std::memory_order_relaxed) };
+}
+}
+
+namespace math {
+/**
+ * @brief A = L * L^T of a symmetric positive definite a, in place in its lower triangle(the strict upper triangle is neither read nor written).
+ * @param a Square view, only its lower triangle is referenced.
+ * @return The status: failing is an outcome, not an exception, the factor is then incomplete.
+ * @throws std::invalid_argument If a is not square.
+ * @throws std::bad_alloc If the task graph's markers can not be allocated.
+ * @note Tiles of cholesky_tile rows, scheduled as a task graph(potrf, trsm, syrk and gemm tasks) so that the next panels start before the trailing updates end.
+*/
+template <std::floating_point T>
+_NODISC_ inline math::matrix::CholeskyStatus cholesky_in_place(const math::matrix::MatrixView<T> a) {
+    if (!a.is_square()) throw std::invalid_argument("Cannot compute the Cholesky decomposition of a Matrix which is not square.");
+    const size_t n = a.num_rows(), tiles = (n + math::matrix::impl::cholesky_tile - 1) / math::matrix::impl::cholesky_tile;
+    if (n == 0) return {};
+    _OP_SCOPE_(factorize, n, n, n / 3)
+    std::vector<char> dependencies(tiles * tiles);
+    const bool is_parallel = (tiles > 1) && !omp_in_parallel() && (omp_get_max_threads() > 1);
+    return math::matrix::impl::cholesky_tiles<T>(a, dependencies.data(), is_parallel);
+}
+
+/**
+ * @brief Cholesky decomposition A = L * L^T of a symmetric positive definite floating point Matrix.
+ * @note A matrix that is not positive definite leaves the object with a failed status(is_positive_definite() false) rather than throwing.
+*/
+template <std::floating_point T>
+class Cholesky {
+    private:
+        Matrix<T> m_factor; // L, zero above the diagonal.
+        math::matrix::CholeskyStatus m_status;
+
+    public:
+        /**
+         * @brief Factorising a(only its lower triangle is read), in place when it is moved in.
+         * @throws std::invalid_argument If a is not square.
+        */
+        explicit Cholesky(Matrix<T> a) : m_factor(std::move(a)) {
+            m_status = math::cholesky_in_place<T>(m_factor.view());
+            const math::matrix::MatrixView<T> v = m_factor.view();
+            for (size_t i = 0; i < v.num_rows(); i++) std::fill(v.row(i) + i + 1, v.row(i) + v.num_columns(), T(0));
+        }
+
+    public:
+        _NODISC_ const Matrix<T> &factor() const noexcept {
+            return m_factor;
+        }
+        _NODISC_ math::matrix::CholeskyStatus status() const noexcept {
+            return m_status;
+        }
+        _NODISC_ bool is_positive_definite() const noexcept {
+            return m_status.ok();
+        }
+        _NODISC_ size_t size() const noexcept {
+            return m_factor.num_rows();
+        }
+
+        // The square of the product of the diagonal of L.
+        _NODISC_ T determinant() const noexcept {
+            T result = T(1);
+            for (size_t i = 0; i < m_factor.num_rows(); i++) result *= m_factor(i, i);
+            return result * result;
+        }
+        _NODISC_ T log_determinant() const noexcept {
+            T result = T(0);
+            for (size_t i = 0; i < m_factor.num_rows(); i++) result += std::log(m_factor(i, i));
+            return 2 * result;
+        }
+
+        /**
+         * @brief x such that A * x = b.
+         * @param vector Contiguous vector(anything that converts to std::span<const T>, a Matrix picks the overload below).
+         * @throws std::invalid_argument If b doesn't have a row of A per element.
+         * @throws std::domain_error If A is not positive definite.
+        */
+        template <typename V>
+        requires std::convertible_to<const V&, std::span<const T>> && (!std::same_as<V, Matrix<T>>)
+        _NODISC_ std::vector<T> solve(const V &vector) const {
+            const std::span<const T> b = vector;
+            const size_t n = this->size();
+            if (b.size() != n) throw std::invalid_argument("Cannot solve for a right hand side whose size is not the number of rows of the Matrix.");
+            this->check_positive_definite();
+            std::vector<T> x(b.begin(), b.end());
+            this->substitute(x.data());
+            return x;
+        }
+
+        /**
+         * @brief X such that A * X = B, for all the columns of B at once.
+         * @throws std::invalid_argument If B doesn't have the rows of A.
+         * @throws std::domain_error If A is not positive definite.
+        */
+        _NODISC_ Matrix<T> solve(const Matrix<T> &b) const {
+            if (b.num_rows() != this->size()) throw std::invalid_argument("Cannot solve for right hand sides whose number of rows is not the one of the Matrix.");
+            this->check_positive_definite();
+            Matrix<T> x(b);
+            this->substitute(x.view());
+            return x;
+        }
+
+        /**
+         * @brief A^-1, solving for the columns of the identity.
+         * @throws std::domain_error If A is not positive definite.
+        */
+        _NODISC_ Matrix<T> inverse() const {
+            const size_t n = this->size();
+            this->check_positive_definite();
+            if (n == 0) return Matrix<T>();
+            Matrix<T> x(n, n);
+            for (size_t i = 0; i < n; i++) x(i, i) = T(1);
+            this->substitute(x.view());
+            return x;
+        }
+
+    private:
+        // x = L^-T * L^-1 * x.
+        void substitute(const math::matrix::MatrixView<T> x) const noexcept {
+            math::matrix::impl::trsm_kernel<T>(T(1), m_factor.view(), math::matrix::SD::left, math::matrix::TRI::lower, math::matrix::TR::no, math::matrix::DG::non_unit, x, true);
+            math::matrix::impl::trsm_kernel<T>(T(1), m_factor.view(), math::matrix::SD::left, math::matrix::TRI::lower, math::matrix::TR::yes, math::matrix::DG::non_unit, x, true);
+        }
+        void substitute(T *const x) const noexcept {
+            math::matrix::impl::trsv_kernel<T>(m_factor.view(), math::matrix::TRI::lower, math::matrix::TR::no, math::matrix::DG::non_unit, x, true);
+            math::matrix::impl::trsv_kernel<T>(m_factor.view(), math::matrix::TRI::lower, math::matrix::TR::yes, math::matrix::DG::non_unit, x, true);
+        }
+
+        void check_positive_definite() const {
+            if (!m_status.ok()) throw std::domain_error("Cannot solve with the Cholesky decomposition of a Matrix which is not positive definite.");
+        }
+};
+}
\ No newline at end of file
@@ -0,0 +1,199 @@
+// LU.hpp
+#pragma once
+#include "../Matrix.hpp"
+
+namespace math::matrix::impl {
+inline constexpr const size_t lu_block = 96;               // Columns factorised per panel before the trailing update through gemm.
+inline constexpr const size_t lu_parallel_rows = 512;      // Panels at least this tall update their rows over the team.
+
+/**
+ * @brief Unblocked LU with partial pivoting of the columns [k0, k0 + kb) below row k0, a pivot swaps whole rows of a(pointers only).
+ * @param permutation Original row of every row of a, updated with the swaps.
+ * @param is_odd Flipped on every swap.
+ * @return Whether an exactly zero pivot was met, its column is left as it is.
+*/
+template <std::floating_point T>
+inline bool lu_panel(Matrix<T> &a, const size_t k0, const size_t kb, size_t *const permutation, bool &is_odd) noexcept {
+    _TRACE_SPAN_(compute, "lu_panel")
+    const size_t n = a.num_rows(), k_end = k0 + kb;
+    const MatrixView<T> v = a.view(); // Reads the row pointers through, so it follows the swaps.
+    bool is_singular = false;
+    for (size_t j = k0; j < k_end; j++) {
+        size_t pivot = j;
+        T largest = std::abs(v(j, j));
+        for (size_t i = j + 1; i < n; i++)
+            if (std::abs(v(i, j)) > largest) {
+                largest = std::abs(v(i, j));
+                pivot = i;
+            }
+        if (pivot != j) {
+            a.swap_rows(j, pivot);
+            std::swap(permutation[j], permutation[pivot]);
+            is_odd = !is_odd;
+        }
+        if (largest == T(0)) {
+            is_singular = true;
+            continue;
+        }
+        const T inverse = T(1) / v(j, j);
+        const T *const u = v.row(j);
+        #pragma omp parallel for schedule(static) if((n - j > lu_parallel_rows) && !omp_in_parallel())
+        for (size_t i = j + 1; i < n; i++) {
+            T *const r = v.row(i);
+            const T l = (r[j] *= inverse);
+            #pragma omp simd
+            for (size_t c = j + 1; c < k_end; c++) r[c] -= l * u[c];
+        }
+    }
+    return is_singular;
+}
+}
+
+namespace math {
+/**
+ * @brief LU decomposition with partial pivoting, P * A = L * U, of a square floating point Matrix.
+ * @note Blocked and right-looking: every panel of lu_block columns is factorised unblocked(pivots swap row pointers, O(1) a swap),
+ *       then the block row of U is solved through trsm and the trailing matrix updated through the packed, parallel gemm kernel.
+*/
+template <std::floating_point T>
+class LU {
+    private:
+        Matrix<T> m_factors;                // L strictly below the diagonal(its unit diagonal implied), U on and above it.
+        std::vector<size_t> m_permutation;  // Row i of the factors comes from row m_permutation[i] of A.
+        bool m_is_odd = false;              // Whether the permutation has an odd number of swaps.
+        bool m_is_singular = false;         // Whether an exactly zero pivot was met.
+
+    public:
+        /**
+         * @brief Factorising a, in place when it is moved in.
+         * @throws std::invalid_argument If a is not square.
+         * @throws std::bad_alloc If the permutation or the packing scratch of the trailing updates can not be allocated.
+        */
+        explicit LU(Matrix<T> a) : m_factors(std::move(a)) {
+            if (!m_factors.is_square()) throw std::invalid_argument("Cannot compute the LU decomposition of a Matrix which is not square.");
+            const size_t n = m_factors.num_rows();
+            m_permutation.resize(n);
+            for (size_t i = 0; i < n; i++) m_permutation[i] = i;
+            _OP_SCOPE_(factorize, n, n, 2 * n / 3)
+            const math::matrix::MatrixView<T> v = m_factors.view();
+            for (size_t k0 = 0; k0 < n; k0 += math::matrix::impl::lu_block) {
+                const size_t kb = std::min(math::matrix::impl::lu_block, n - k0), k_end = k0 + kb;
+                if (math::matrix::impl::lu_panel<T>(m_factors, k0, kb, m_permutation.data(), m_is_odd)) m_is_singular = true;
+                if (k_end == n) break;
+                math::matrix::impl::trsm_kernel<T>(T(1), v.block(k0, k0, kb, kb), math::matrix::SD::left, math::matrix::TRI::lower, math::matrix::TR::no,
+                    math::matrix::DG::unit, v.block(k0, k_end, kb, n - k_end), true); // U12 = L11^-1 * A12
+                math::matrix::impl::gemm_kernel<T>(T(-1), v.block(k_end, k0, n - k_end, kb), math::matrix::TR::no, v.block(k0, k_end, kb, n - k_end),
+                    math::matrix::TR::no, T(1), v.block(k_end, k_end, n - k_end, n - k_end), true); // A22 -= L21 * U12
+            }
+        }
+
+    public:
+        _NODISC_ const Matrix<T> &factors() const noexcept {
+            return m_factors;
+        }
+        _NODISC_ std::span<const size_t> permutation() const noexcept {
+            return m_permutation;
+        }
+        _NODISC_ bool is_singular() const noexcept {
+            return m_is_singular;
+        }
+        _NODISC_ size_t size() const noexcept {
+            return m_factors.num_rows();
+        }
+
+        // Product of the pivots with the sign of the permutation.
+        _NODISC_ T determinant() const noexcept {
+            T result = m_is_odd ? T(-1) : T(1);
+            for (size_t i = 0; i < m_factors.num_rows(); i++) result *= m_factors(i, i);
+            return result;
+        }
+        // log|det A|, for the matrices whose determinant over or underflows(-inf when singular).
+        _NODISC_ T log_abs_determinant() const noexcept {
+            T result = T(0);
+            for (size_t i = 0; i < m_factors.num_rows(); i++) result += std::log(std::abs(m_factors(i, i)));
+            return result;
+        }
+
+        /**
+         * @brief x such that A * x = b.
+         * @param b Contiguous vector(anything that converts to std::span<const T>, a Matrix picks the overload below).
+         * @throws std::invalid_argument If b doesn't have a row of A per element.
+         * @throws std::domain_error If A is singular.
+        */
+        template <typename V>
+        requires std::convertible_to<const V&, std::span<const T>> && (!std::same_as<V, Matrix<T>>)
+        _NODISC_ std::vector<T> solve(const V &vector) const {
+            const std::span<const T> b = vector;
+            const size_t n = this->size();
+            if (b.size() != n) throw std::invalid_argument("Cannot solve for a right hand side whose size is not the number of rows of the Matrix.");
+            this->check_regular();
+            std::vector<T> x(n);
+            for (size_t i = 0; i < n; i++) x[i] = b[m_permutation[i]];
+            this->substitute(x.data());
+            return x;
+        }
+
+        /**
+         * @brief X such that A * X = B, for all the columns of B at once.
+         * @throws std::invalid_argument If B doesn't have the rows of A.
+         * @throws std::domain_error If A is singular.
+        */
+        _NODISC_ Matrix<T> solve(const Matrix<T> &b) const {
+            const size_t n = this->size();
+            if (b.num_rows() != n) throw std::invalid_argument("Cannot solve for right hand sides whose number of rows is not the one of the Matrix.");
+            this->check_regular();
+            if (n == 0) return Matrix<T>();
+            Matrix<T> x(n, b.num_columns(), math::matrix::CAR::possible_garbage);
+            const math::matrix::MatrixView<T> v = x.view();
+            for (size_t i = 0; i < n; i++) std::copy_n(b[m_permutation[i]], b.num_columns(), v.row(i));
+            this->substitute(v);
+            return x;
+        }
+
+        /**
+         * @brief A^-1, solving for the columns of the identity.
+         * @throws std::domain_error If A is singular.
+        */
+        _NODISC_ Matrix<T> inverse() const {
+            this->check_regular();
+            if (this->size() == 0) return Matrix<T>();
+            Matrix<T> x(this->size(), this->size(), math::matrix::CAR::possible_garbage);
+            this->inverse_into(x.view());
+            return x;
+        }
+
+        /**
+         * @brief Writes A^-1 over x, whatever x holds, so the storage of A itself can take its inverse.
+         * @param x Square view of the size of A, not overlapping the factors.
+         * @throws std::invalid_argument If x is not of the size of A.
+         * @throws std::domain_error If A is singular.
+        */
+        void inverse_into(const math::matrix::MatrixView<T> x) const {
+            const size_t n = this->size();
+            if (x.num_rows() != n || x.num_columns() != n) throw std::invalid_argument("Cannot write the inverse into a view whose size is not the one of the Matrix.");
+            this->check_regular();
+            #pragma omp parallel for schedule(static) if((n > math::matrix::impl::lu_parallel_rows) && !omp_in_parallel())
+            for (size_t i = 0; i < n; i++) {
+                T *const r = x.row(i);
+                std::fill_n(r, n, T(0));
+                r[m_permutation[i]] = T(1);
+            }
+            this->substitute(x);
+        }
+
+    private:
+        // x = U^-1 * L^-1 * x for the permuted right hand sides.
+        void substitute(const math::matrix::MatrixView<T> x) const noexcept {
+            math::matrix::impl::trsm_kernel<T>(T(1), m_factors.view(), math::matrix::SD::left, math::matrix::TRI::lower, math::matrix::TR::no, math::matrix::DG::unit, x, true);
+            math::matrix::impl::trsm_kernel<T>(T(1), m_factors.view(), math::matrix::SD::left, math::matrix::TRI::upper, math::matrix::TR::no, math::matrix::DG::non_unit, x, true);
+        }
+        void substitute(T *const x) const noexcept {
+            math::matrix::impl::trsv_kernel<T>(m_factors.view(), math::matrix::TRI::lower, math::matrix::TR::no, math::matrix::DG::unit, x, true);
+            math::matrix::impl::trsv_kernel<T>(m_factors.view(), math::matrix::TRI::upper, math::matrix::TR::no, math::matrix::DG::non_unit, x, true);
+        }
+
+        void check_regular() const {
+            if (m_is_singular) throw std::domain_error("Cannot solve with the LU decomposition of a singular Matrix.");
+        }
+};
+}
\ No newline at end of file
@@ -0,0 +1,385 @@
+// QR.hpp
+#pragma once
+#include "../Matrix.hpp"
+
+namespace math::matrix::impl {
+inline constexpr const size_t qr_block = 64;            // Reflectors per block, the depth of the compact WY updates.
+inline constexpr const size_t qr_leaf = 8;              // Columns of the panel factorised one reflector at a time.
+inline constexpr const size_t qr_parallel_rows = 4096;  // Columns at least this tall are scaled and reduced over the team.
+inline constexpr const size_t lstsq_rows = 2048;        // Least rows of A taken per step of lstsq, 4 times its columns when more.
+
+/**
+ * @brief Unblocked QR of the columns [k0, k0 + kb) below row k0, one Householder reflector H = I - tau * v * v^T a column.
+ * @note Row oriented: a reflector costs two passes over the rows(scaling v while reducing w = panel^T * v, then the update
+ *       fused with the norm of the next column), every pass touching a row of the panel once instead of walking down its columns.
+*/
+template <std::floating_point T>
+inline void qr_unblocked(const MatrixView<T> a, const size_t k0, const size_t kb, T *const tau) noexcept {
+    const size_t m = a.num_rows(), k_end = k0 + kb;
+    T w[qr_leaf]; // kb is at most qr_leaf, w lives in registers rather than behind a pointer the rows could alias.
+    T norm2 = T(0); // Of the current column below the diagonal.
+    #pragma omp parallel for reduction(+:norm2) schedule(static) if((m - k0 > qr_parallel_rows) && !omp_in_parallel())
+    for (size_t i = k0 + 1; i < m; i++) norm2 += a(i, k0) * a(i, k0);
+    for (size_t j = k0; j < k_end; j++) {
+        const size_t rest = k_end - j - 1;
+        if (norm2 == T(0)) { // Already reduced, H = I.
+            tau[j] = T(0);
+            if (rest == 0) break;
+            #pragma omp parallel for reduction(+:norm2) schedule(static) if((m - j > qr_parallel_rows) && !omp_in_parallel())
+            for (size_t i = j + 2; i < m; i++) norm2 += a(i, j + 1) * a(i, j + 1);
+            continue;
+        }
+        const T alpha = a(j, j);
+        const T beta = -std::copysign(std::sqrt(alpha * alpha + norm2), alpha);
+        const T scale = T(1) / (alpha - beta), t = tau[j] = (beta - alpha) / beta;
+        a(j, j) = beta;
+        if (rest == 0) {
+            #pragma omp parallel for schedule(static) if((m - j > qr_parallel_rows) && !omp_in_parallel())
+            for (size_t i = j + 1; i < m; i++) a(i, j) *= scale;
+            break;
+        }
+        const T *const head = a.row(j) + j + 1;
+        for (size_t c = 0; c < rest; c++) w[c] = head[c]; // v starts with an implied 1.
+        #pragma omp parallel for reduction(+:w[:rest]) schedule(static) if((m - j > qr_parallel_rows) && !omp_in_parallel())
+        for (size_t i = j + 1; i < m; i++) {
+            T *const r = a.row(i) + j;
+            const T v_i = (r[0] *= scale);
+            for (size_t c = 0; c < rest; c++) w[c] += v_i * r[c + 1];
+        }
+        norm2 = T(0);
+        for (size_t c = 0; c < rest; c++) a(j, j + 1 + c) -= t * w[c];
+        #pragma omp parallel for reduction(+:norm2) firstprivate(w) schedule(static) if((m - j > qr_parallel_rows) && !omp_in_parallel())
+        for (size_t i = j + 1; i < m; i++) {
+            T *const r = a.row(i) + j;
+            const T f = t * r[0];
+            for (size_t c = 0; c < rest; c++) r[c + 1] -= f * w[c];
+            if (i > j + 1) norm2 += r[1] * r[1];
+        }
+    }
+}
+
+/**
+ * @brief V, the reflectors [k0, k0 + kb) of the factors with their unit heads and zeros above, (rows of a - k0) x kb.
+*/
+template <std::floating_point T>
+inline void qr_gather_reflectors(const MatrixView<const T> a, const size_t k0, const size_t kb, const MatrixView<T> v) noexcept {
+    const size_t rows = v.num_rows();
+    #pragma omp parallel for schedule(static) if((rows > qr_parallel_rows) && !omp_in_parallel())
+    for (size_t i = 0; i < rows; i++) {
+        T *const r = v.row(i);
+        const T *const f = a.row(k0 + i) + k0;
+        for (size_t j = 0; j < kb; j++) r[j] = (j < i) ? f[j] : (j == i ? T(1) : T(0));
+    }
+}
+
+/**
+ * @brief The upper triangular t with H_1 * ... * H_kb = I - V * t * V^T, from the upper triangle of V^T * V.
+ * @param tau The scales of the kb reflectors.
+ * @param s kb x kb scratch.
+*/
+template <std::floating_point T>
+inline void qr_triangular_factor(const MatrixView<const T> v, const T *const tau, const MatrixView<T> t, const MatrixView<T> s) noexcept {
+    const size_t kb = v.num_columns();
+    math::matrix::impl::syrk_kernel<T>(T(1), v, TR::yes, T(0), s, TRI::upper, true); // Only s(q, j) with q < j is read.
+    for (size_t j = 0; j < kb; j++) {
+        for (size_t r = 0; r < j; r++) {
+            T dot = T(0);
+            for (size_t q = r; q < j; q++) dot += t(r, q) * s(q, j);
+            t(r, j) = -tau[j] * dot;
+        }
+        t(j, j) = tau[j];
+    }
+}
+
+/**
+ * @brief w = t * w(trans no) or t^T * w(trans yes) in place, t being upper triangular.
+*/
+template <std::floating_point T>
+inline void qr_triangular_multiply(const MatrixView<const T> t, const Transpose trans, const MatrixView<T> w) noexcept {
+    const size_t kb = t.num_rows(), p = w.num_columns();
+    // Row i only needs the rows not yet overwritten: those below it for t, above it for t^T.
+    for (size_t step = 0; step < kb; step++) {
+        const size_t i = (trans == TR::no) ? step : kb - 1 - step;
+        T *const r = w.row(i);
+        const T d = t(i, i);
+        #pragma omp simd
+        for (size_t c = 0; c < p; c++) r[c] *= d;
+        const size_t q0 = (trans == TR::no) ? i + 1 : 0, q1 = (trans == TR::no) ? kb : i;
+        for (size_t q = q0; q < q1; q++) {
+            const T f = (trans == TR::no) ? t(i, q) : t(q, i);
+            if (f == T(0)) continue;
+            const T *const u = w.row(q);
+            #pragma omp simd
+            for (size_t c = 0; c < p; c++) r[c] += f * u[c];
+        }
+    }
+}
+
+/**
+ * @brief c = (I - V * t * V^T) * c(trans no) or its transpose times c(trans yes), through two gemm and a triangular multiply.
+ * @param w kb x (columns of c) scratch.
+*/
+template <std::floating_point T>
+inline void qr_apply_block(const MatrixView<const T> v, const MatrixView<const T> t, const Transpose trans, const MatrixView<T> c, const MatrixView<T> w) {
+    math::matrix::impl::gemm_kernel<T>(T(1), v, TR::yes, c, TR::no, T(0), w, true);
+    math::matrix::impl::qr_triangular_multiply<T>(t, trans, w);
+    math::matrix::impl::gemm_kernel<T>(T(-1), v, TR::no, w, TR::no, T(1), c, true);
+}
+
+/**
+ * @brief QR of the columns [k0, k0 + kb) below row k0, recursively: the left half's reflectors reach the right half as one block through gemm.
+ * @param v Scratch of the rows of a by kb / 2, for the left half's reflectors.
+ * @param w Scratch of kb / 2 by kb / 2, for their triangular factor.
+ * @param s Scratch of kb by kb.
+*/
+template <std::floating_point T>
+inline void qr_panel(const MatrixView<T> a, const size_t k0, const size_t kb, T *const tau, const MatrixView<T> v, const MatrixView<T> w,
+                     const MatrixView<T> s) {
+    if (kb <= qr_leaf) return math::matrix::impl::qr_unblocked<T>(a, k0, kb, tau);
+    const size_t m = a.num_rows(), half = kb / 2;
+    math::matrix::impl::qr_panel<T>(a, k0, half, tau, v, w, s);
+    const MatrixView<T> v_half = v.block(0, 0, m - k0, half), t_half = w.block(0, 0, half, half);
+    math::matrix::impl::qr_gather_reflectors<T>(a, k0, half, v_half);
+    math::matrix::impl::qr_triangular_factor<T>(v_half, tau + k0, t_half, s.block(0, 0, half, half));
+    // Right half = (I - V * t^T * V^T) * right half.
+    math::matrix::impl::qr_apply_block<T>(v_half, t_half, TR::yes, a.block(k0, k0 + half, m - k0, kb - half), s.block(0, 0, half, kb - half));
+    math::matrix::impl::qr_panel<T>(a, k0 + half, kb - half, tau, v, w, s);
+}
+
+/**
+ * @brief Blocked Householder QR of the first columns of a, in place: R on and above the diagonal, the reflectors below, the columns after them updated as Q^T * a.
+ * @param columns The columns factorised(min with the rows of a), the remaining ones are only transformed.
+ * @param tau A scale per reflector.
+ * @param t qr_block rows by at least the reflectors, the triangular factor of every block at its first column.
+ * @throws std::bad_alloc If the scratch can not be allocated.
+*/
+template <std::floating_point T>
+inline void qr_factor(const MatrixView<T> a, const size_t columns, T *const tau, const MatrixView<T> t) {
+    const size_t m = a.num_rows(), n = a.num_columns(), k = std::min(m, columns);
+    if (k == 0) return;
+    Matrix<T> v(m, std::min(qr_block, k), CAR::possible_garbage), s(qr_block, qr_block), w(qr_block, std::max(n, size_t(1)), CAR::possible_garbage);
+    for (size_t k0 = 0; k0 < k; k0 += qr_block) {
+        const size_t kb = std::min(qr_block, k - k0), k_end = k0 + kb;
+        math::matrix::impl::qr_panel<T>(a, k0, kb, tau, v.view(), w.view(), s.view());
+        const MatrixView<T> v_block = v.view().block(0, 0, m - k0, kb), t_block = t.block(0, k0, kb, kb);
+        math::matrix::impl::qr_gather_reflectors<T>(a, k0, kb, v_block);
+        math::matrix::impl::qr_triangular_factor<T>(v_block, tau + k0, t_block, s.view().block(0, 0, kb, kb));
+        if (k_end == n) continue;
+        math::matrix::impl::qr_apply_block<T>(v_block, t_block, TR::yes, a.block(k0, k_end, m - k0, n - k_end),
+            w.view().block(0, 0, kb, n - k_end)); // A2 = (I - V * t^T * V^T) * A2
+    }
+}
+
+/**
+ * @brief x = R^-1 * x with the upper triangle of the square r, through trsm. False, x untouched, if a diagonal element is zero.
+*/
+template <std::floating_point T>
+_NODISC_ inline bool qr_back_substitute(const MatrixView<const T> r, const MatrixView<T> x) noexcept {
+    for (size_t i = 0; i < r.num_rows(); i++)
+        if (r(i, i) == T(0)) return false;
+    math::matrix::impl::trsm_kernel<T>(T(1), r, SD::left, TRI::upper, TR::no, DG::non_unit, x, true);
+    return true;
+}
+
+// FLOPs per element of an m x n Householder QR, 2 * m * n * k - 2 / 3 * k^3 in all with k = min(m, n).
+_NODISC_ inline size_t qr_flops_per_element(const size_t m, const size_t n) noexcept {
+    const size_t k = std::min(m, n);
+    return (k == 0) ? 0 : 2 * k - 2 * k * k / (3 * m) * k / n;
+}
+}
+
+namespace math {
+/**
+ * @brief Householder QR decomposition A = Q * R of a floating point Matrix of any shape.
+ * @note Blocked by qr_block reflectors in compact WY form(I - V * T * V^T), so the trailing updates are two gemm each.
+ *       Q is kept as its reflectors: it is applied through the same blocks and only formed by q() and full_q().
+*/
+template <std::floating_point T>
+class QR {
+    private:
+        Matrix<T> m_factors;    // R on and above the diagonal, the reflectors below it(their unit heads implied).
+        std::vector<T> m_tau;   // Scale of every reflector.
+        Matrix<T> m_t;          // Upper triangular factor of every block of reflectors, at the block's first column.
+
+    public:
+        /**
+         * @brief Factorising a, in place when it is moved in.
+         * @throws std::bad_alloc If the scratch of the blocked updates can not be allocated.
+        */
+        explicit QR(Matrix<T> a) : m_factors(std::move(a)) {
+            const size_t m = m_factors.num_rows(), n = m_factors.num_columns(), k = std::min(m, n);
+            m_tau.resize(k);
+            if (k == 0) return;
+            m_t = Matrix<T>(math::matrix::impl::qr_block, k);
+            _OP_SCOPE_(factorize, m, n, math::matrix::impl::qr_flops_per_element(m, n))
+            math::matrix::impl::qr_factor<T>(m_factors.view(), n, m_tau.data(), m_t.view());
+        }
+
+    public:
+        _NODISC_ const Matrix<T> &factors() const noexcept {
+            return m_factors;
+        }
+        _NODISC_ std::span<const T> tau() const noexcept {
+            return m_tau;
+        }
+        _NODISC_ size_t num_rows() const noexcept {
+            return m_factors.num_rows();
+        }
+        _NODISC_ size_t num_columns() const noexcept {
+            return m_factors.num_columns();
+        }
+        // Whether no diagonal element of R is exactly zero.
+        _NODISC_ bool is_full_rank() const noexcept {
+            for (size_t i = 0; i < m_tau.size(); i++)
+                if (m_factors(i, i) == T(0)) return false;
+            return true;
+        }
+
+        // The min(rows, columns) x columns upper triangular R of the economy decomposition.
+        _NODISC_ Matrix<T> r() const {
+            const size_t k = m_tau.size(), n = this->num_columns();
+            return Matrix<T>(k, n, [&](size_t i, size_t j) { return j < i ? T(0) : m_factors(i, j); });
+        }
+        // The rows x min(rows, columns) Q of the economy decomposition, with orthonormal columns.
+        _NODISC_ Matrix<T> q() const {
+            const size_t m = this->num_rows(), k = m_tau.size();
+            Matrix<T> q(m, k);
+            for (size_t i = 0; i < k; i++) q(i, i) = T(1);
+            this->apply(math::matrix::TR::no, q.view());
+            return q;
+        }
+        // The square, orthogonal Q of the full decomposition.
+        _NODISC_ Matrix<T> full_q() const {
+            const size_t m = this->num_rows();
+            Matrix<T> q(m, m);
+            for (size_t i = 0; i < m; i++) q(i, i) = T(1);
+            this->apply(math::matrix::TR::no, q.view());
+            return q;
+        }
+
+        /**
+         * @brief b = Q * b in place, Q being the square factor.
+         * @throws std::invalid_argument If b doesn't have the rows of A.
+        */
+        void apply_q(Matrix<T> &b) const {
+            this->check_rows(b.num_rows());
+            this->apply(math::matrix::TR::no, b.view());
+        }
+        /**
+         * @brief b = Q^T * b in place, Q being the square factor.
+         * @throws std::invalid_argument If b doesn't have the rows of A.
+        */
+        void apply_qt(Matrix<T> &b) const {
+            this->check_rows(b.num_rows());
+            this->apply(math::matrix::TR::yes, b.view());
+        }
+
+        /**
+         * @brief The least squares solution x minimising ||A * x - b||, for A with at least as many rows as columns.
+         * @param vector Contiguous vector(anything that converts to std::span<const T>, a Matrix picks the overload below).
+         * @throws std::invalid_argument If A is wide or b doesn't have a row of A per element.
+         * @throws std::domain_error If A is rank deficient.
+        */
+        template <typename V>
+        requires std::convertible_to<const V&, std::span<const T>> && (!std::same_as<V, Matrix<T>>)
+        _NODISC_ std::vector<T> solve(const V &vector) const {
+            const std::span<const T> b = vector;
+            Matrix<T> x(b.size(), 1, [&](size_t i, size_t) { return b[i]; });
+            x = this->solve(x);
+            std::vector<T> result(x.num_rows());
+            for (size_t i = 0; i < result.size(); i++) result[i] = x(i, 0);
+            return result;
+        }
+
+        /**
+         * @brief The least squares solutions of all the columns of B at once.
+         * @throws std::invalid_argument If A is wide or B doesn't have the rows of A.
+         * @throws std::domain_error If A is rank deficient.
+        */
+        _NODISC_ Matrix<T> solve(const Matrix<T> &b) const {
+            const size_t m = this->num_rows(), n = this->num_columns(), p = b.num_columns();
+            if (m < n) throw std::invalid_argument("Cannot solve least squares with the QR decomposition of a Matrix with fewer rows than columns.");
+            this->check_rows(b.num_rows());
+            Matrix<T> y(b);
+            this->apply(math::matrix::TR::yes, y.view());
+            Matrix<T> x(n, p, math::matrix::CAR::possible_garbage);
+            for (size_t i = 0; i < n; i++) std::copy_n(y[i], p, x.view().row(i));
+            if (!math::matrix::impl::qr_back_substitute<T>(m_factors.view().block(0, 0, n, n), x.view()))
+                throw std::domain_error("Cannot solve least squares with the QR decomposition of a rank deficient Matrix.");
+            return x;
+        }
+
+    private:
+        // b = Q * b(trans no) or Q^T * b(trans yes), block by block.
+        void apply(const math::matrix::Transpose trans, const math::matrix::MatrixView<T> b) const {
+            const size_t m = this->num_rows(), k = m_tau.size(), p = b.num_columns();
+            if (k == 0 || p == 0) return;
+            constexpr size_t nb = math::matrix::impl::qr_block;
+            Matrix<T> v(m, std::min(nb, k), math::matrix::CAR::possible_garbage), w(nb, p, math::matrix::CAR::possible_garbage);
+            const size_t blocks = (k + nb - 1) / nb;
+            for (size_t step = 0; step < blocks; step++) {
+                const size_t k0 = ((trans == math::matrix::TR::yes) ? step : blocks - 1 - step) * nb, kb = std::min(nb, k - k0);
+                const math::matrix::MatrixView<T> v_block = v.view().block(0, 0, m - k0, kb);
+                math::matrix::impl::qr_gather_reflectors<T>(m_factors.view(), k0, kb, v_block);
+                math::matrix::impl::qr_apply_block<T>(v_block, m_t.view().block(0, k0, kb, kb), trans, b.block(k0, 0, m - k0, p), w.view().block(0, 0, kb, p));
+            }
+        }
+
+        void check_rows(const size_t rows) const {
+            if (rows != this->num_rows()) throw std::invalid_argument("Cannot apply Q to a Matrix which doesn't have the rows of the decomposed one.");
+        }
+};
+
+/**
+ * @brief The least squares solutions X minimising ||A * X - B|| column by column, for A with at least as many rows as columns.
+ * @throws std::invalid_argument If A is wide or B doesn't have the rows of A.
+ * @throws std::domain_error If A is rank deficient.
+ * @note Streams through A by blocks of max(lstsq_rows, 4 * columns) rows: each block is stacked under the R(and Q^T * B) of the rows before it
+ *       and the stack factorised again, so memory stays at a block whatever the height of A and Q is never formed.
+*/
+template <std::floating_point T>
+_NODISC_ inline Matrix<T> lstsq(const Matrix<T> &a, const Matrix<T> &b) {
+    const size_t m = a.num_rows(), n = a.num_columns(), p = b.num_columns();
+    if (m < n) throw std::invalid_argument("Cannot solve least squares for a Matrix with fewer rows than columns.");
+    if (b.num_rows() != m) throw std::invalid_argument("Cannot solve least squares for right hand sides whose number of rows is not the one of the Matrix.");
+    if (n == 0) return Matrix<T>();
+    _OP_SCOPE_(factorize, m, n, math::matrix::impl::qr_flops_per_element(m, n))
+    const size_t step = std::max(math::matrix::impl::lstsq_rows, 4 * n);
+    Matrix<T> stack(n + std::min(step, m), n + p, math::matrix::CAR::possible_garbage), t(math::matrix::impl::qr_block, n);
+    std::vector<T> tau(n);
+    const math::matrix::MatrixView<T> s = stack.view();
+    size_t held = 0; // Rows of [R | Q^T * B] on top of the stack.
+    for (size_t r0 = 0; r0 < m; r0 += step) {
+        _TRACE_SPAN_(compute, "lstsq_block")
+        const size_t height = std::min(step, m - r0), total = held + height;
+        #pragma omp parallel for schedule(static) if((height > math::matrix::impl::qr_parallel_rows) && !omp_in_parallel())
+        for (size_t i = 0; i < height; i++) {
+            std::copy_n(a[r0 + i], n, s.row(held + i));
+            std::copy_n(b[r0 + i], p, s.row(held + i) + n);
+        }
+        math::matrix::impl::qr_factor<T>(s.block(0, 0, total, n + p), n, tau.data(), t.view());
+        held = std::min(total, n);
+        for (size_t i = 1; i < held; i++) std::fill_n(s.row(i), i, T(0)); // The reflectors are spent, R is data for the next block.
+    }
+    Matrix<T> x(n, p, math::matrix::CAR::possible_garbage);
+    for (size_t i = 0; i < n; i++) std::copy_n(s.row(i) + n, p, x.view().row(i));
+    if (!math::matrix::impl::qr_back_substitute<T>(s.block(0, 0, n, n), x.view()))
+        throw std::domain_error("Cannot solve least squares for a rank deficient Matrix.");
+    return x;
+}
+
+/**
+ * @brief The least squares solution x minimising ||A * x - b||, streaming through A like the Matrix overload.
+ * @throws std::invalid_argument If A is wide or b doesn't have a row of A per element.
+ * @throws std::domain_error If A is rank deficient.
+*/
+template <std::floating_point T, typename V>
+requires std::convertible_to<const V&, std::span<const T>> && (!std::same_as<V, Matrix<T>>)
+_NODISC_ inline std::vector<T> lstsq(const Matrix<T> &a, const V &vector) {
+    const std::span<const T> b = vector;
+    const Matrix<T> x = math::lstsq<T>(a, Matrix<T>(b.size(), 1, [&](size_t i, size_t) { return b[i]; }));
+    std::vector<T> result(x.num_rows());
+    for (size_t i = 0; i < result.size(); i++) result[i] = x(i, 0);
+    return result;
+}
+}
\ No newline at end of file
@@ -0,0 +1,254 @@
+// RandomizedSVD.hpp
+#pragma once
+#include "QR.hpp"
+#include <numbers>
+#include <numeric>
+
+namespace math::matrix::impl {
+inline constexpr const size_t rsvd_oversampling = 10;         // Samples taken past the rank by default, they soak up the tail of the spectrum.
+inline constexpr const size_t rsvd_power_iterations = 2;      // Passes of subspace iteration by default, each one raising the decay of the spectrum.
+inline constexpr const size_t rsvd_block_elements = 1 << 22;  // Elements of A held per block of rows read through a reader, at least one row.
+inline constexpr const size_t rsvd_parallel_rows = 1024;      // Test matrices with at least this many rows are drawn over the team.
+inline constexpr const size_t rsvd_jacobi_sweeps = 30;        // One-sided Jacobi sweeps allowed on the small projected factor.
+
+// Standard normal numbers in omega, element (i, j) only a function of the seed and of i * columns + j, whatever the team.
+template <std::floating_point T>
+inline void rsvd_gaussian(const MatrixView<T> omega, const std::uint64_t seed) noexcept {
+    const size_t n = omega.num_rows(), l = omega.num_columns();
+    #pragma omp parallel for schedule(static) if((n > rsvd_parallel_rows) && !omp_in_parallel())
+    for (size_t i = 0; i < n; i++) {
+        T *const row = omega.row(i);
+        for (size_t j = 0; j < l; j++) {
+            std::uint64_t state = seed + 2 * (i * l + j) * 0x9E3779B97F4A7C15ull;
+            const auto next = [&state]() noexcept {
+                std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                return z ^ (z >> 31);
+            };
+            // Box-Muller, the first uniform in (0, 1] to keep the logarithm finite.
+            const double radius = std::sqrt(-2.0 * std::log(static_cast<double>((next() >> 11) + 1) * 0x1.0p-53));
+            row[j] = static_cast<T>(radius * std::cos(2.0 * std::numbers::pi * static_cast<double>(next() >> 11) * 0x1.0p-53));
+        }
+    }
+}
+
+/**
+ * @brief y = A * x, A being read by blocks of step rows through blocks(first_row, rows), a MatrixView<const T> of them.
+ * @throws std::bad_alloc If the scratch of gemm can not be allocated. Anything blocks throws.
+*/
+template <std::floating_point T, typename Blocks>
+inline void rsvd_sample(Blocks &blocks, const size_t step, const MatrixView<const T> x, const MatrixView<T> y) {
+    _TRACE_SPAN_(compute, "rsvd_sample")
+    const size_t m = y.num_rows(), l = y.num_columns();
+    for (size_t r0 = 0; r0 < m; r0 += step) {
+        const size_t height = std::min(step, m - r0);
+        const MatrixView<const T> a = blocks(r0, height);
+        math::matrix::impl::gemm_kernel<T>(T(1), a, TR::no, x, TR::no, T(0), y.block(r0, 0, height, l), true);
+    }
+}
+
+/**
+ * @brief z = Q^T * A, A being read like in rsvd_sample, the block of Q matching each block of A.
+ * @throws std::bad_alloc If the scratch of gemm can not be allocated. Anything blocks throws.
+*/
+template <std::floating_point T, typename Blocks>
+inline void rsvd_project(Blocks &blocks, const size_t step, const MatrixView<const T> q, const MatrixView<T> z) {
+    _TRACE_SPAN_(compute, "rsvd_project")
+    const size_t m = q.num_rows(), l = q.num_columns();
+    for (size_t r0 = 0; r0 < m; r0 += step) {
+        const size_t height = std::min(step, m - r0);
+        const MatrixView<const T> a = blocks(r0, height);
+        math::matrix::impl::gemm_kernel<T>(T(1), q.block(r0, 0, height, l), TR::yes, a, TR::no, (r0 == 0) ? T(0) : T(1), z, true);
+    }
+}
+
+/**
+ * @brief Orthonormal columns spanning the range of A * Omega for l Gaussian columns of Omega, sharpened by subspace iteration.
+ * @note Every pass through A is a gemm by l columns, orthonormalised by QR before the next one so the small singular values survive rounding.
+ * @throws std::bad_alloc If the scratch can not be allocated. Anything blocks throws.
+*/
+template <std::floating_point T, typename Blocks>
+_NODISC_ inline Matrix<T> rsvd_range(Blocks &blocks, const size_t m, const size_t n, const size_t step, const size_t l,
+                                     const size_t power_iterations, const std::uint64_t seed) {
+    Matrix<T> omega(n, l, CAR::possible_garbage), y(m, l, CAR::possible_garbage), z(l, n, CAR::possible_garbage);
+    math::matrix::impl::rsvd_gaussian<T>(omega.view(), seed);
+    math::matrix::impl::rsvd_sample<T>(blocks, step, omega.view(), y.view());
+    for (size_t iteration = 0; iteration < power_iterations; iteration++) {
+        y = math::QR<T>(std::move(y)).q();
+        math::matrix::impl::rsvd_project<T>(blocks, step, y.view(), z.view());
+        omega = math::QR<T>(z.transpose()).q();
+        math::matrix::impl::rsvd_sample<T>(blocks, step, omega.view(), y.view());
+    }
+    return math::QR<T>(std::move(y)).q();
+}
+
+/**
+ * @brief One-sided Jacobi on the rows of the square c: rotations of pairs of rows, gathered in the rows of j, until every pair is orthogonal.
+ * @return False if rsvd_jacobi_sweeps were not enough, c * c^T is then diagonal up to the last rotations.
+ * @note j * c_in = c_out, so c_in = j^T * diag(norms) * (rows of c_out normalised) is a singular value decomposition with relative accuracy.
+*/
+template <std::floating_point T>
+_NODISC_ inline bool rsvd_jacobi(const MatrixView<T> c, const MatrixView<T> j) noexcept {
+    const size_t l = c.num_rows(), n = c.num_columns();
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    for (size_t sweep = 0; sweep < rsvd_jacobi_sweeps; sweep++) {
+        bool is_rotated = false;
+        for (size_t p = 0; p + 1 < l; p++) {
+            for (size_t q = p + 1; q < l; q++) {
+                T *const x = c.row(p), *const y = c.row(q);
+                T alpha = T(0), beta = T(0), gamma = T(0);
+                for (size_t k = 0; k < n; k++) {
+                    alpha += x[k] * x[k];
+                    beta += y[k] * y[k];
+                    gamma += x[k] * y[k];
+                }
+                if (std::abs(gamma) <= eps * std::sqrt(alpha * beta)) continue;
+                is_rotated = true;
+                const T zeta = (beta - alpha) / (T(2) * gamma);
+                const T t = std::copysign(T(1), zeta) / (std::abs(zeta) + std::hypot(T(1), zeta));
+                const T cosine = T(1) / std::hypot(T(1), t), sine = cosine * t;
+                for (size_t k = 0; k < n; k++) {
+                    const T xk = x[k], yk = y[k];
+                    x[k] = cosine * xk - sine * yk;
+                    y[k] = sine * xk + cosine * yk;
+                }
+                T *const u = j.row(p), *const v = j.row(q);
+                for (size_t k = 0; k < l; k++) {
+                    const T uk = u[k], vk = v[k];
+                    u[k] = cosine * uk - sine * vk;
+                    v[k] = sine * uk + cosine * vk;
+                }
+            }
+        }
+        if (!is_rotated) return true;
+    }
+    return false;
+}
+
+// FLOPs per element of A of the randomised decomposition with l samples, a gemm by l columns per pass through A.
+_NODISC_ inline size_t rsvd_flops_per_element(const size_t l, const size_t power_iterations) noexcept {
+    return 4 * l * (power_iterations + 1);
+}
+}
+
+namespace math {
+/**
+ * @brief Truncated singular value decomposition A ~ U * diag(values) * V^T of the leading rank triplets of a floating point Matrix,
+ *        through the randomised range finder of Halko, Martinsson and Tropp.
+ * @note A is sampled by rank + oversampling Gaussian columns and the sample sharpened by power_iterations passes of subspace iteration,
+ *       which leaves an orthonormal Q with A ~ Q * Q^T * A. The small B = Q^T * A is decomposed by QR of B^T and one-sided Jacobi on its
+ *       triangle. All the work on A is 2 * power_iterations + 2 gemm by the sample width, so the time grows with the rank, not the size of A.
+ *       A can be read a block of rows at a time instead of held, it is then read 2 * power_iterations + 2 times.
+*/
+template <std::floating_point T>
+class RandomizedSVD {
+    private:
+        std::vector<T> m_values;    // Descending.
+        Matrix<T> m_u;              // rows x rank, orthonormal columns.
+        Matrix<T> m_v;              // columns x rank, orthonormal columns.
+
+    public:
+        /**
+         * @brief The leading rank singular triplets of a.
+         * @param oversampling Samples past the rank, the approximation improves quickly with a few more.
+         * @param power_iterations Passes of subspace iteration, for spectra that decay slowly.
+         * @param seed Seed of the Gaussian test matrix, the same seed giving the same decomposition.
+         * @throws std::invalid_argument If rank is over the smaller dimension of a.
+         * @throws std::runtime_error If one-sided Jacobi does not converge.
+         * @throws std::bad_alloc If the scratch can not be allocated.
+        */
+        RandomizedSVD(const Matrix<T> &a, const size_t rank, const size_t oversampling = math::matrix::impl::rsvd_oversampling,
+                      const size_t power_iterations = math::matrix::impl::rsvd_power_iterations, const std::uint64_t seed = 0) {
+            const size_t m = a.num_rows();
+            auto blocks = [&a](size_t r0, size_t rows) { return a.view().block(r0, 0, rows, a.num_columns()); };
+            this->factor(blocks, m, a.num_columns(), std::max(m, size_t(1)), rank, oversampling, power_iterations, seed);
+        }
+
+        /**
+         * @brief The leading rank singular triplets of the rows x columns A which isn't held in memory.
+         * @param read Called as read(first_row, block) to fill the MatrixView<T> block with the rows of A from first_row on,
+         *             at most rsvd_block_elements elements(or a row) at a time. It is called 2 * power_iterations + 2 times per row.
+         * @throws std::invalid_argument If rank is over the smaller dimension of A.
+         * @throws std::runtime_error If one-sided Jacobi does not converge.
+         * @throws std::bad_alloc If the scratch can not be allocated. Anything read throws.
+        */
+        template <typename Reader>
+        requires std::invocable<Reader&, size_t, math::matrix::MatrixView<T>>
+        RandomizedSVD(const size_t rows, const size_t columns, Reader &&read, const size_t rank, const size_t oversampling = math::matrix::impl::rsvd_oversampling,
+                      const size_t power_iterations = math::matrix::impl::rsvd_power_iterations, const std::uint64_t seed = 0) {
+            const size_t step = std::clamp(math::matrix::impl::rsvd_block_elements / std::max(columns, size_t(1)), size_t(1), std::max(rows, size_t(1)));
+            Matrix<T> buffer;
+            auto blocks = [&](size_t r0, size_t height) {
+                const math::matrix::MatrixView<T> block = buffer.view().block(0, 0, height, columns);
+                read(r0, block);
+                return math::matrix::MatrixView<const T>(block);
+            };
+            if (rank != 0 && rank <= std::min(rows, columns)) buffer = Matrix<T>(step, columns, math::matrix::CAR::possible_garbage);
+            this->factor(blocks, rows, columns, step, rank, oversampling, power_iterations, seed);
+        }
+
+    public:
+        _NODISC_ std::span<const T> values() const noexcept {
+            return m_values;
+        }
+        // rows x rank, column i is the left singular vector of values()[i].
+        _NODISC_ const Matrix<T> &u() const noexcept {
+            return m_u;
+        }
+        // columns x rank, column i is the right singular vector of values()[i].
+        _NODISC_ const Matrix<T> &v() const noexcept {
+            return m_v;
+        }
+        _NODISC_ size_t rank() const noexcept {
+            return m_values.size();
+        }
+
+    private:
+        template <typename Blocks>
+        void factor(Blocks &blocks, const size_t m, const size_t n, const size_t step, const size_t rank, const size_t oversampling,
+                    const size_t power_iterations, const std::uint64_t seed) {
+            if (rank > std::min(m, n)) throw std::invalid_argument("Cannot compute more singular values than the smaller dimension of the Matrix.");
+            if (rank == 0) return;
+            const size_t l = std::min(rank + oversampling, std::min(m, n));
+            _OP_SCOPE_(factorize, m, n, math::matrix::impl::rsvd_flops_per_element(l, power_iterations))
+            const Matrix<T> q = math::matrix::impl::rsvd_range<T>(blocks, m, n, step, l, power_iterations, seed);
+            Matrix<T> b(l, n, math::matrix::CAR::possible_garbage);
+            math::matrix::impl::rsvd_project<T>(blocks, step, q.view(), b.view());
+            // B^T = Q2 * R2, so B = R2^T * Q2^T and only the l x l R2^T is left to decompose.
+            Matrix<T> q2, c;
+            {
+                const math::QR<T> qr(b.transpose());
+                q2 = qr.q();
+                c = qr.r().transpose();
+            }
+            Matrix<T> j(l, l, [](size_t row, size_t column) { return (row == column) ? T(1) : T(0); });
+            if (!math::matrix::impl::rsvd_jacobi<T>(c.view(), j.view()))
+                throw std::runtime_error("Cannot compute the singular values as one-sided Jacobi did not converge.");
+            std::vector<T> norms(l);
+            for (size_t i = 0; i < l; i++) {
+                const T *const row = c[i];
+                T squares = T(0);
+                for (size_t k = 0; k < l; k++) squares += row[k] * row[k];
+                norms[i] = std::sqrt(squares);
+            }
+            std::vector<size_t> order(l);
+            std::iota(order.begin(), order.end(), size_t(0));
+            std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) { return norms[x] > norms[y]; });
+            // U = Q * J^T and V = Q2 * (rows of c normalised)^T over the leading rank rows.
+            Matrix<T> left(rank, l, math::matrix::CAR::possible_garbage), right(rank, l, math::matrix::CAR::possible_garbage);
+            m_values.resize(rank);
+            for (size_t i = 0; i < rank; i++) {
+                const size_t from = order[i];
+                const T value = norms[from], inverse = (value > T(0)) ? T(1) / value : T(0);
+                m_values[i] = value;
+                std::copy_n(j[from], l, left.view().row(i));
+                for (size_t k = 0; k < l; k++) right(i, k) = c(from, k) * inverse;
+            }
+            m_u = Matrix<T>(m, rank, math::matrix::CAR::possible_garbage);
+            m_v = Matrix<T>(n, rank, math::matrix::CAR::possible_garbage);
+            math::matrix::impl::gemm_kernel<T>(T(1), q.view(), math::matrix::TR::no, left.view(), math::matrix::TR::yes, T(0), m_u.view(), true);
+            math::matrix::impl::gemm_kernel<T>(T(1), q2.view(), math::matrix::TR::no, right.view(), math::matrix::TR::yes, T(0), m_v.view(), true);
+        }
+};
+}
\ No newline at end of file
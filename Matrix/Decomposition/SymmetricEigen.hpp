@@ -0,0 +1,765 @@
+// SymmetricEigen.hpp
+#pragma once
+#include "QR.hpp"
+#include <numeric>
+
+namespace math::matrix::impl {
+inline constexpr const size_t eigen_block = 64;             // Columns reduced per panel of the tridiagonalisation, the depth of its rank 2k trailing update.
+inline constexpr const size_t eigen_update_rows = 128;      // Rows of a block row of the trailing update, the unit of work of the team.
+inline constexpr const size_t eigen_parallel_rows = 512;    // Symmetric products of at least this many rows are split over the team.
+inline constexpr const size_t eigen_leaf = 32;              // Subproblems of divide and conquer this small are solved by implicit QL.
+inline constexpr const size_t eigen_ql_iterations = 30;     // Implicit QL sweeps allowed per eigenvalue.
+inline constexpr const size_t eigen_inverse_iterations = 5; // Inverse iterations allowed per eigenvector before it is taken as it is.
+
+// Copies the lower triangle of the square a over its upper one, tile by tile.
+template <std::floating_point T>
+inline void eigen_symmetrize(const MatrixView<T> a) noexcept {
+    constexpr size_t tile = 32;
+    const size_t n = a.num_rows(), tiles = (n + tile - 1) / tile;
+    #pragma omp parallel for schedule(dynamic) if((n > eigen_parallel_rows) && !omp_in_parallel())
+    for (size_t ti = 0; ti < tiles; ti++)
+        for (size_t tj = 0; tj <= ti; tj++)
+            for (size_t i = ti * tile; i < std::min(n, (ti + 1) * tile); i++)
+                for (size_t j = tj * tile; j < std::min(i, (tj + 1) * tile); j++) a(j, i) = a(i, j);
+}
+
+/**
+ * @brief y = A * x for the symmetric A of which only the upper triangle is read, every element once.
+ * @param scratch Room for a copy of y per thread of the team.
+*/
+template <std::floating_point T>
+inline void eigen_symv_upper(const MatrixView<const T> a, const T *const x, T *const y, T *const scratch, const bool is_parallel) noexcept {
+    const size_t m = a.num_rows();
+    const auto rows = [&](T *const out, const size_t i) noexcept {
+        const T *const r = a.row(i);
+        const T x_i = x[i];
+        T dot = r[i] * x_i;
+        #pragma omp simd reduction(+:dot)
+        for (size_t j = i + 1; j < m; j++) {
+            dot += r[j] * x[j];
+            out[j] += r[j] * x_i;
+        }
+        out[i] += dot;
+    };
+    std::fill_n(y, m, T(0));
+    if (!is_parallel || m < eigen_parallel_rows || omp_in_parallel() || omp_get_max_threads() == 1) {
+        for (size_t i = 0; i < m; i++) rows(y, i);
+        return;
+    }
+    const size_t threads = static_cast<size_t>(omp_get_max_threads());
+    #pragma omp parallel num_threads(threads)
+    {
+        T *const out = scratch + static_cast<size_t>(omp_get_thread_num()) * m;
+        std::fill_n(out, m, T(0));
+        #pragma omp for schedule(dynamic, 16)
+        for (size_t i = 0; i < m; i++) rows(out, i);
+        #pragma omp for schedule(static)
+        for (size_t j = 0; j < m; j++) {
+            T sum = T(0);
+            for (size_t t = 0; t < threads; t++) sum += scratch[t * m + j];
+            y[j] = sum;
+        }
+    }
+}
+
+/**
+ * @brief Householder reduction Q^T * A * Q = T of the symmetric a(upper triangle) to tridiagonal form, in place.
+ * @param d The diagonal of T.
+ * @param e The off diagonal of T, e[i] couples d[i] and d[i + 1].
+ * @param tau The scale of reflector i, whose vector is 1 at i + 1 and row i of a after it(Q = H_0 * ... * H_(n - 2)).
+ * @note Blocked like the QR: every panel of eigen_block rows is reduced against the trailing matrix as it was, corrected through the
+ *       panel's reflectors V and their images W, then the trailing upper triangle takes A -= V * W^T + W * V^T through gemm, a block row at a time.
+ *       Half of the work stays in the symmetric products of the panels, which read the trailing matrix once per reflector.
+ * @throws std::bad_alloc If the scratch can not be allocated.
+*/
+template <std::floating_point T>
+inline void eigen_tridiagonalize(const MatrixView<T> a, T *const d, T *const e, T *const tau) {
+    const size_t n = a.num_rows();
+    if (n == 0) return;
+    constexpr size_t nb = eigen_block;
+    const size_t threads = static_cast<size_t>(omp_get_max_threads());
+    Matrix<T> vw(2 * nb, n, CAR::possible_garbage);
+    std::vector<T> scratch(threads * n), g(2 * nb);
+    std::vector<T*> xp(2 * nb), yp(2 * nb);
+    for (size_t k = 0; k < n; ) {
+        _TRACE_SPAN_(compute, "eigen_panel")
+        const size_t m = n - k, kb = std::min(nb, m);
+        // Rows [0, kb) of X are the reflectors V, [kb, 2 * kb) their images W, Y lists the same rows the other way round.
+        for (size_t p = 0; p < kb; p++) {
+            xp[p] = yp[kb + p] = vw.view().row(p);
+            xp[kb + p] = yp[p] = vw.view().row(nb + p);
+            std::fill_n(xp[p], m, T(0));
+            std::fill_n(xp[kb + p], m, T(0));
+        }
+        T *const *const v_rows = xp.data(), *const *const w_rows = xp.data() + kb;
+        for (size_t i = 0; i < kb; i++) {
+            T *const r = a.row(k + i) + k;
+            // Row i of the panel brought up to date with the reflectors before it.
+            for (size_t p = 0; p < i; p++) {
+                const T v_i = v_rows[p][i], w_i = w_rows[p][i];
+                const T *const v = v_rows[p], *const w = w_rows[p];
+                #pragma omp simd
+                for (size_t c = i; c < m; c++) r[c] -= v_i * w[c] + w_i * v[c];
+            }
+            d[k + i] = r[i];
+            if (i + 1 == m) break;
+            // The reflector taking r[i + 2, m) to zero.
+            const T alpha = r[i + 1];
+            T squares = T(0);
+            #pragma omp simd reduction(+:squares)
+            for (size_t c = i + 2; c < m; c++) squares += r[c] * r[c];
+            T *const v = v_rows[i];
+            v[i + 1] = T(1);
+            if (squares == T(0)) {
+                tau[k + i] = T(0);
+                e[k + i] = alpha;
+            }
+            else {
+                const T beta = -std::copysign(std::sqrt(alpha * alpha + squares), alpha), scale = T(1) / (alpha - beta);
+                tau[k + i] = (beta - alpha) / beta;
+                e[k + i] = beta;
+                for (size_t c = i + 2; c < m; c++) v[c] = (r[c] *= scale);
+            }
+            // w = tau * (A - V * W^T - W * V^T) * v, then w -= tau / 2 * (w . v) * v.
+            const size_t len = m - i - 1;
+            const T t = tau[k + i];
+            T *const w = w_rows[i];
+            if (t == T(0)) continue;
+            eigen_symv_upper<T>(a.block(k + i + 1, k + i + 1, len, len), v + i + 1, w + i + 1, scratch.data(), true);
+            if (i > 0) {
+                const MatrixView<const T> vb = MatrixView<const T>(v_rows, i, m).block(0, i + 1, i, len), wb = MatrixView<const T>(w_rows, i, m).block(0, i + 1, i, len);
+                math::matrix::impl::gemv_kernel<T>(T(1), vb, TR::no, v + i + 1, T(0), g.data(), 1, false);
+                math::matrix::impl::gemv_kernel<T>(T(1), wb, TR::no, v + i + 1, T(0), g.data() + nb, 1, false);
+                math::matrix::impl::gemv_kernel<T>(T(-1), wb, TR::yes, g.data(), T(1), w + i + 1, 1, len > eigen_parallel_rows);
+                math::matrix::impl::gemv_kernel<T>(T(-1), vb, TR::yes, g.data() + nb, T(1), w + i + 1, 1, len > eigen_parallel_rows);
+            }
+            T dot = T(0);
+            #pragma omp simd reduction(+:dot)
+            for (size_t c = i + 1; c < m; c++) dot += (w[c] *= t) * v[c];
+            const T shift = T(-0.5) * t * dot;
+            #pragma omp simd
+            for (size_t c = i + 1; c < m; c++) w[c] += shift * v[c];
+        }
+        if (kb == m) break;
+        // Trailing update of the upper triangle, block row by block row: A[r, r:] -= X[:, r]^T * Y[:, r:].
+        const size_t rest = m - kb, tiles = (rest + eigen_update_rows - 1) / eigen_update_rows;
+        const MatrixView<const T> x_all(xp.data(), 2 * kb, m), y_all(yp.data(), 2 * kb, m);
+        const bool is_parallel = (tiles > 1) && (omp_get_max_threads() > 1) && !omp_in_parallel();
+        #pragma omp parallel for schedule(dynamic) if(is_parallel)
+        for (size_t tile = 0; tile < tiles; tile++) {
+            const size_t r0 = tile * eigen_update_rows, rb = std::min(eigen_update_rows, rest - r0);
+            math::matrix::impl::gemm_nothrow<T>(T(-1), x_all.block(0, kb + r0, 2 * kb, rb), TR::yes, y_all.block(0, kb + r0, 2 * kb, rest - r0), TR::no,
+                T(1), a.block(k + kb + r0, k + kb + r0, rb, rest - r0), !is_parallel);
+        }
+        k += kb;
+    }
+}
+
+/**
+ * @brief z = Q * z, Q being the product of the reflectors left in a by eigen_tridiagonalize, in blocks of qr_block through compact WY.
+ * @throws std::bad_alloc If the scratch can not be allocated.
+*/
+template <std::floating_point T>
+inline void eigen_back_transform(const MatrixView<const T> a, const T *const tau, const MatrixView<T> z) {
+    const size_t n = a.num_rows(), p = z.num_columns();
+    if (n < 2 || p == 0) return;
+    constexpr size_t nb = qr_block;
+    const size_t reflectors = n - 1, blocks = (reflectors + nb - 1) / nb;
+    Matrix<T> v(reflectors, std::min(nb, reflectors), CAR::possible_garbage), t(nb, nb), s(nb, nb), w(nb, p, CAR::possible_garbage);
+    for (size_t step = 0; step < blocks; step++) {
+        _TRACE_SPAN_(compute, "eigen_back_transform")
+        const size_t j0 = (blocks - 1 - step) * nb, kb = std::min(nb, reflectors - j0), rows = reflectors - j0;
+        const MatrixView<T> v_block = v.view().block(0, 0, rows, kb);
+        #pragma omp parallel for schedule(static) if((rows > qr_parallel_rows) && !omp_in_parallel())
+        for (size_t r = 0; r < rows; r++) {
+            T *const out = v_block.row(r);
+            for (size_t q = 0; q < kb; q++) out[q] = (r < q) ? T(0) : (r == q ? T(1) : a(j0 + q, j0 + 1 + r));
+        }
+        math::matrix::impl::qr_triangular_factor<T>(v_block, tau + j0, t.view().block(0, 0, kb, kb), s.view().block(0, 0, kb, kb));
+        math::matrix::impl::qr_apply_block<T>(v_block, t.view().block(0, 0, kb, kb), TR::no, z.block(j0 + 1, 0, rows, p), w.view().block(0, 0, kb, p));
+    }
+}
+
+/**
+ * @brief Eigenvalues of the tridiagonal(d, e) by implicit QL with Wilkinson shifts, the rotations applied to the columns of z(none when it is empty).
+ * @param e n elements, the last one is scratch, the whole of it is destroyed.
+ * @return Whether every eigenvalue converged within eigen_ql_iterations sweeps, they are not sorted.
+*/
+template <std::floating_point T>
+_NODISC_ inline bool eigen_tridiagonal_ql(T *const d, T *const e, const size_t n, const MatrixView<T> z) noexcept {
+    if (n == 0) return true;
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    e[n - 1] = T(0);
+    for (size_t l = 0; l < n; l++)
+        for (size_t iterations = 0; ; iterations++) {
+            size_t m = l;
+            for (; m + 1 < n; m++)
+                if (std::abs(e[m]) <= eps * (std::abs(d[m]) + std::abs(d[m + 1]))) break;
+            if (m == l) break;
+            if (iterations == eigen_ql_iterations) return false;
+            T g = (d[l + 1] - d[l]) / (T(2) * e[l]), r = std::hypot(g, T(1));
+            g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+            T s = T(1), c = T(1), p = T(0);
+            bool is_underflow = false;
+            for (size_t i = m; i-- > l; ) {
+                T f = s * e[i];
+                const T b = c * e[i];
+                e[i + 1] = (r = std::hypot(f, g));
+                if (r == T(0)) {
+                    d[i + 1] -= p;
+                    e[m] = T(0);
+                    is_underflow = true;
+                    break;
+                }
+                s = f / r;
+                c = g / r;
+                g = d[i + 1] - p;
+                r = (d[i] - g) * s + T(2) * c * b;
+                p = s * r;
+                d[i + 1] = g + p;
+                g = c * r - b;
+                for (size_t k = 0; k < z.num_rows(); k++) {
+                    T *const row = z.row(k);
+                    f = row[i + 1];
+                    row[i + 1] = s * row[i] + c * f;
+                    row[i] = c * row[i] - s * f;
+                }
+            }
+            if (is_underflow) continue;
+            d[l] -= p;
+            e[l] = g;
+            e[m] = T(0);
+        }
+    return true;
+}
+
+// The eigenvalues of a subproblem of divide and conquer of at most eigen_leaf rows, ascending, with the eigenvectors as the columns of z.
+template <std::floating_point T>
+_NODISC_ inline bool eigen_leaf_solve(T *const d, const T *const e, const MatrixView<T> z) noexcept {
+    const size_t n = z.num_rows();
+    T couplings[eigen_leaf];
+    std::copy_n(e, n - 1, couplings);
+    for (size_t i = 0; i < n; i++) {
+        std::fill_n(z.row(i), n, T(0));
+        z(i, i) = T(1);
+    }
+    if (!math::matrix::impl::eigen_tridiagonal_ql<T>(d, couplings, n, z)) return false;
+    for (size_t i = 0; i < n; i++) {
+        const size_t smallest = static_cast<size_t>(std::min_element(d + i, d + n) - d);
+        if (smallest == i) continue;
+        std::swap(d[i], d[smallest]);
+        for (size_t r = 0; r < n; r++) std::swap(z(r, i), z(r, smallest));
+    }
+    return true;
+}
+
+/**
+ * @brief Root j of the secular equation 1 + rho * sum_i w_i^2 / (d_i - x) = 0 of the ascending poles d, by bisection from its nearer pole.
+ * @param delta Column j receives d_i - x for every pole i, computed from the nearer pole so that the closest differences keep their accuracy.
+ * @return The root x.
+*/
+template <std::floating_point T>
+_NODISC_ inline T eigen_secular_root(const T *const d, const T *const w, const size_t k, const T rho, const T w_squares, const size_t j,
+                                     const MatrixView<T> delta) noexcept {
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    const auto secular = [&](const size_t origin, const T offset) noexcept {
+        T sum = T(0);
+        #pragma omp simd reduction(+:sum)
+        for (size_t i = 0; i < k; i++) sum += w[i] * w[i] / ((d[i] - d[origin]) - offset);
+        return T(1) + rho * sum;
+    };
+    size_t origin = j;
+    T low = T(0), high = rho * w_squares;
+    if (j + 1 < k) {
+        const T half = (d[j + 1] - d[j]) / T(2);
+        if (secular(j, half) >= T(0)) high = half;
+        else {
+            origin = j + 1;
+            low = -half;
+            high = T(0);
+        }
+    }
+    // The secular function increases between two poles.
+    for (size_t iteration = 0; iteration < 256; iteration++) {
+        if (high - low <= T(2) * eps * std::max(std::abs(low), std::abs(high))) break;
+        const T middle = (low + high) / T(2);
+        if (middle <= low || middle >= high) break;
+        if (secular(origin, middle) > T(0)) high = middle;
+        else low = middle;
+    }
+    const T offset = (low + high) / T(2);
+    for (size_t i = 0; i < k; i++) delta(i, j) = (d[i] - d[origin]) - offset;
+    return d[origin] + offset;
+}
+
+/**
+ * @brief Merges the two halves of a divide and conquer subproblem: diag(Q1, Q2) in z, the ascending eigenvalues of either half in d.
+ * @param m Rows of the first half.
+ * @param beta The off diagonal element cut between the halves, whose magnitude was taken off both diagonal elements beside it.
+ * @note The rank one update diag(D1, D2) + rho * w * w^T is deflated(negligible w_i, or poles close enough to be rotated together), its
+ *       remaining roots found by eigen_secular_root and their eigenvectors built from the w recomputed through Lowner's formula, so they stay
+ *       orthogonal whatever the accuracy of the roots. The columns of z only holding rows of one half enter gemm with that half only.
+ * @throws std::bad_alloc If the scratch can not be allocated.
+*/
+template <std::floating_point T>
+inline void eigen_merge(T *const d, const MatrixView<T> z, const size_t m, const T beta, const bool is_parallel) {
+    _TRACE_SPAN_(compute, "eigen_merge")
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    const size_t s = z.num_rows();
+    // ||w|| = 1 once rho takes the norm of the two unit rows.
+    const T rho = T(2) * std::abs(beta), scale = T(1) / std::sqrt(T(2)), sign = (beta < T(0)) ? T(-1) : T(1);
+    std::vector<T> w(s);
+    for (size_t j = 0; j < s; j++) w[j] = (j < m) ? z(m - 1, j) * scale : sign * z(m, j) * scale;
+    std::vector<size_t> order(s), kept, deflated;
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&](const size_t x, const size_t y) { return d[x] < d[y]; });
+    T d_max = T(0), w_max = T(0);
+    for (size_t j = 0; j < s; j++) {
+        d_max = std::max(d_max, std::abs(d[j]));
+        w_max = std::max(w_max, std::abs(w[j]));
+    }
+    const T tolerance = T(8) * eps * std::max(d_max, w_max);
+    // 0 for a column of the first half, 1 of the second, 2 once rotated with one of the other half.
+    std::vector<unsigned char> half(s);
+    for (size_t j = 0; j < s; j++) half[j] = (j < m) ? 0 : 1;
+    size_t previous = s;
+    for (const size_t j : order) {
+        if (rho * std::abs(w[j]) <= tolerance) {
+            deflated.push_back(j);
+            continue;
+        }
+        if (previous == s) {
+            previous = j;
+            continue;
+        }
+        const T t = std::hypot(w[previous], w[j]), c = w[j] / t, sn = -w[previous] / t;
+        if (std::abs((d[j] - d[previous]) * c * sn) <= tolerance) {
+            for (size_t r = 0; r < s; r++) {
+                T *const row = z.row(r);
+                const T x = row[previous], y = row[j];
+                row[previous] = c * x + sn * y;
+                row[j] = c * y - sn * x;
+            }
+            const T rotated = d[previous] * c * c + d[j] * sn * sn;
+            d[j] = d[previous] * sn * sn + d[j] * c * c;
+            d[previous] = rotated;
+            w[j] = t;
+            w[previous] = T(0);
+            if (half[j] != half[previous]) half[j] = 2;
+            deflated.push_back(previous);
+        }
+        else kept.push_back(previous);
+        previous = j;
+    }
+    if (previous != s) kept.push_back(previous);
+    std::sort(kept.begin(), kept.end(), [&](const size_t x, const size_t y) { return d[x] < d[y]; });
+    std::sort(deflated.begin(), deflated.end(), [&](const size_t x, const size_t y) { return d[x] < d[y]; });
+    const size_t k = kept.size();
+
+    std::vector<T> poles(k), weights(k), roots(k), deflated_values(deflated.size());
+    for (size_t i = 0; i < k; i++) {
+        poles[i] = d[kept[i]];
+        weights[i] = w[kept[i]];
+    }
+    for (size_t i = 0; i < deflated.size(); i++) deflated_values[i] = d[deflated[i]];
+    Matrix<T> u, r, buffers(static_cast<size_t>(omp_get_max_threads()), s, CAR::possible_garbage);
+    if (k > 0) {
+        u = Matrix<T>(k, k, CAR::possible_garbage);
+        r = Matrix<T>(s, k, CAR::possible_garbage);
+        T w_squares = T(0);
+        for (size_t i = 0; i < k; i++) w_squares += weights[i] * weights[i];
+        const MatrixView<T> delta = u.view();
+        #pragma omp parallel for schedule(dynamic, 8) if(is_parallel && (k > 64) && !omp_in_parallel())
+        for (size_t j = 0; j < k; j++) roots[j] = math::matrix::impl::eigen_secular_root<T>(poles.data(), weights.data(), k, rho, w_squares, j, delta);
+        // Lowner: the w for which the roots found are exact, then the eigenvectors w_i / (d_i - x_j) of the rank one update, normalised.
+        #pragma omp parallel for schedule(static) if(is_parallel && (k > 64) && !omp_in_parallel())
+        for (size_t i = 0; i < k; i++) {
+            const T *const row = delta.row(i);
+            T product = row[i];
+            for (size_t j = 0; j < k; j++)
+                if (j != i) product *= row[j] / (poles[i] - poles[j]);
+            weights[i] = std::copysign(std::sqrt(std::max(-product, T(0))), w[kept[i]]);
+        }
+        std::vector<T> norms(k, T(0));
+        for (size_t i = 0; i < k; i++) {
+            T *const row = delta.row(i);
+            const T weight = weights[i];
+            #pragma omp simd
+            for (size_t j = 0; j < k; j++) {
+                row[j] = weight / row[j];
+                norms[j] += row[j] * row[j];
+            }
+        }
+        for (size_t j = 0; j < k; j++) norms[j] = T(1) / std::sqrt(norms[j]);
+        #pragma omp parallel for schedule(static) if(is_parallel && (k > 64) && !omp_in_parallel())
+        for (size_t i = 0; i < k; i++) {
+            T *const row = delta.row(i);
+            #pragma omp simd
+            for (size_t j = 0; j < k; j++) row[j] *= norms[j];
+        }
+    }
+    // Columns of z reordered as the kept ones of the first half, the rotated, the kept ones of the second half, then the deflated.
+    std::vector<size_t> columns;
+    columns.reserve(s);
+    size_t first_only = 0, mixed = 0;
+    std::vector<T*> u_rows;
+    u_rows.reserve(k);
+    for (const unsigned char type : { 0, 2, 1 })
+        for (size_t i = 0; i < k; i++)
+            if (half[kept[i]] == type) {
+                columns.push_back(kept[i]);
+                u_rows.push_back(u.view().row(i));
+                first_only += (type == 0);
+                mixed += (type == 2);
+            }
+    columns.insert(columns.end(), deflated.begin(), deflated.end());
+    const bool is_team = is_parallel && (s > eigen_parallel_rows) && !omp_in_parallel();
+    #pragma omp parallel for schedule(static) if(is_team)
+    for (size_t row = 0; row < s; row++) {
+        T *const buffer = buffers.view().row(static_cast<size_t>(omp_get_thread_num())), *const out = z.row(row);
+        for (size_t c = 0; c < s; c++) buffer[c] = out[columns[c]];
+        std::copy_n(buffer, s, out);
+    }
+    if (k > 0) {
+        const MatrixView<const T> u_grouped(u_rows.data(), k, k);
+        math::matrix::impl::gemm_kernel<T>(T(1), z.block(0, 0, m, first_only + mixed), TR::no, u_grouped.block(0, 0, first_only + mixed, k), TR::no,
+            T(0), r.view().block(0, 0, m, k), is_parallel);
+        math::matrix::impl::gemm_kernel<T>(T(1), z.block(m, first_only, s - m, k - first_only), TR::no, u_grouped.block(first_only, 0, k - first_only, k), TR::no,
+            T(0), r.view().block(m, 0, s - m, k), is_parallel);
+    }
+    // Both the roots and the deflated eigenvalues are ascending, merged into d with their vectors.
+    std::vector<size_t> sources(s);
+    for (size_t o = 0, i = 0, t = 0; o < s; o++) {
+        const bool is_root = (t == deflated.size()) || (i < k && roots[i] <= deflated_values[t]);
+        if (is_root) {
+            d[o] = roots[i];
+            sources[o] = i++;
+        }
+        else {
+            d[o] = deflated_values[t];
+            sources[o] = s + k + t++;
+        }
+    }
+    #pragma omp parallel for schedule(static) if(is_team)
+    for (size_t row = 0; row < s; row++) {
+        T *const buffer = buffers.view().row(static_cast<size_t>(omp_get_thread_num())), *const out = z.row(row);
+        const T *const from_roots = (k > 0) ? r.view().row(row) : nullptr;
+        for (size_t o = 0; o < s; o++) buffer[o] = (sources[o] < s) ? from_roots[sources[o]] : out[sources[o] - s];
+        std::copy_n(buffer, s, out);
+    }
+}
+
+// Splits [start, start + size) in halves down to depth, the nodes of every depth in order.
+inline void eigen_split(const size_t start, const size_t size, const size_t depth, const size_t target, std::vector<std::vector<std::pair<size_t, size_t>>> &levels) {
+    levels[depth].emplace_back(start, size);
+    if (depth == target) return;
+    math::matrix::impl::eigen_split(start, size / 2, depth + 1, target, levels);
+    math::matrix::impl::eigen_split(start + size / 2, size - size / 2, depth + 1, target, levels);
+}
+
+/**
+ * @brief All the eigenvalues(ascending, in d) and eigenvectors(the columns of z) of the tridiagonal(d, e) by divide and conquer.
+ * @param e The n - 1 off diagonal elements.
+ * @param z n x n, zero.
+ * @return Whether the implicit QL of every leaf converged.
+ * @note Bottom up: the leaves are solved over the team, then a level of merges at a time, each over the team when it stands alone.
+ * @throws std::bad_alloc If the scratch can not be allocated.
+*/
+template <std::floating_point T>
+_NODISC_ inline bool eigen_divide_conquer(T *const d, const T *const e, const MatrixView<T> z) {
+    const size_t n = z.num_rows();
+    if (n == 0) return true;
+    size_t depth = 0;
+    while (((n - 1) >> depth) + 1 > eigen_leaf) depth++;
+    std::vector<std::vector<std::pair<size_t, size_t>>> levels(depth + 1);
+    math::matrix::impl::eigen_split(0, n, 0, depth, levels);
+    for (size_t level = 0; level < depth; level++)
+        for (const auto &[start, size] : levels[level]) {
+            const size_t cut = start + size / 2 - 1;
+            d[cut] -= std::abs(e[cut]);
+            d[cut + 1] -= std::abs(e[cut]);
+        }
+    const std::vector<std::pair<size_t, size_t>> &leaves = levels[depth];
+    bool is_converged = true;
+    #pragma omp parallel for schedule(dynamic) if((leaves.size() > 1) && !omp_in_parallel())
+    for (size_t leaf = 0; leaf < leaves.size(); leaf++) {
+        const auto [start, size] = leaves[leaf];
+        if (!math::matrix::impl::eigen_leaf_solve<T>(d + start, e + start, z.block(start, start, size, size))) {
+            #pragma omp atomic write
+            is_converged = false;
+        }
+    }
+    if (!is_converged) return false;
+    for (size_t level = depth; level-- > 0; ) {
+        const std::vector<std::pair<size_t, size_t>> &nodes = levels[level];
+        bool is_allocated = true;
+        #pragma omp parallel for schedule(dynamic) if((nodes.size() > 1) && !omp_in_parallel())
+        for (size_t node = 0; node < nodes.size(); node++) {
+            const auto [start, size] = nodes[node];
+            try { math::matrix::impl::eigen_merge<T>(d + start, z.block(start, start, size, size), size / 2, e[start + size / 2 - 1], nodes.size() == 1); }
+            catch(...) {
+                #pragma omp atomic write
+                is_allocated = false;
+            }
+        }
+        if (!is_allocated) throw std::bad_alloc();
+    }
+    return true;
+}
+
+// Number of eigenvalues of the tridiagonal below x, from the signs of the pivots of T - x * I(squares holds e_i^2).
+template <std::floating_point T>
+_NODISC_ inline size_t eigen_sturm_count(const T *const d, const T *const squares, const size_t n, const T x, const T pivot_min) noexcept {
+    size_t count = 0;
+    T q = d[0] - x;
+    for (size_t i = 0; ; ) {
+        if (std::abs(q) < pivot_min) q = -pivot_min;
+        count += (q < T(0));
+        if (++i == n) return count;
+        q = d[i] - x - squares[i - 1] / q;
+    }
+}
+
+/**
+ * @brief The eigenvalues [first, first + count) in ascending order of the tridiagonal(d, e) by bisection on Sturm counts, each over the team.
+ * @note Converged to eps * ||T|| like the tridiagonalisation, which bounds the accuracy anyway.
+*/
+template <std::floating_point T>
+inline void eigen_bisection(const T *const d, const T *const e, const size_t n, const size_t first, const size_t count, T *const values) {
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    std::vector<T> squares(n);
+    T low = d[0], high = d[0], e_max = T(0);
+    for (size_t i = 0; i < n; i++) {
+        const T radius = ((i > 0) ? std::abs(e[i - 1]) : T(0)) + ((i + 1 < n) ? std::abs(e[i]) : T(0));
+        low = std::min(low, d[i] - radius);
+        high = std::max(high, d[i] + radius);
+        if (i + 1 < n) {
+            squares[i] = e[i] * e[i];
+            e_max = std::max(e_max, squares[i]);
+        }
+    }
+    const T pivot_min = std::numeric_limits<T>::min() * std::max(T(1), e_max), norm = std::max(std::abs(low), std::abs(high));
+    low -= T(2) * eps * norm * static_cast<T>(n) + T(2) * pivot_min;
+    high += T(2) * eps * norm * static_cast<T>(n) + T(2) * pivot_min;
+    #pragma omp parallel for schedule(dynamic, 4) if((count * n > eigen_parallel_rows * eigen_leaf) && !omp_in_parallel())
+    for (size_t t = 0; t < count; t++) {
+        T lo = low, hi = high;
+        for (size_t iteration = 0; iteration < 256; iteration++) {
+            if (hi - lo <= T(2) * eps * std::max(std::abs(lo), std::abs(hi)) + eps * norm) break;
+            const T middle = (lo + hi) / T(2);
+            if (math::matrix::impl::eigen_sturm_count<T>(d, squares.data(), n, middle, pivot_min) > first + t) hi = middle;
+            else lo = middle;
+        }
+        values[t] = (lo + hi) / T(2);
+    }
+}
+
+/**
+ * @brief The eigenvectors of the tridiagonal(d, e) for its ascending eigenvalues, as the rows of x, by inverse iteration.
+ * @note Eigenvalues closer than 1e-3 * ||T|| form a cluster whose vectors are orthogonalised against each other, clusters go over the team.
+ * @throws std::bad_alloc If the scratch can not be allocated.
+*/
+template <std::floating_point T>
+inline void eigen_inverse_iteration(const T *const d, const T *const e, const size_t n, const T *const values, const MatrixView<T> x) {
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    constexpr size_t extra = 2;
+    const size_t count = x.num_rows();
+    T norm = T(0);
+    for (size_t i = 0; i < n; i++) norm = std::max(norm, std::abs(d[i]) + ((i > 0) ? std::abs(e[i - 1]) : T(0)) + ((i + 1 < n) ? std::abs(e[i]) : T(0)));
+    const T cluster_gap = T(1e-3) * norm, growth = std::sqrt(T(0.1) / static_cast<T>(n));
+    std::vector<size_t> clusters{ 0 };
+    for (size_t j = 1; j < count; j++)
+        if (values[j] - values[j - 1] > cluster_gap) clusters.push_back(j);
+    clusters.push_back(count);
+    const size_t cluster_count = clusters.size() - 1;
+    Matrix<T> workspace(static_cast<size_t>(omp_get_max_threads()), 6 * n, CAR::possible_garbage);
+    #pragma omp parallel for schedule(dynamic) if((cluster_count > 1) && (count * n > eigen_parallel_rows * eigen_leaf) && !omp_in_parallel())
+    for (size_t cluster = 0; cluster < cluster_count; cluster++) {
+        T *const diagonal = workspace.view().row(static_cast<size_t>(omp_get_thread_num()));
+        T *const upper = diagonal + n, *const second = upper + n, *const lower = second + n, *const swapped = lower + n, *const y = swapped + n;
+        T previous = T(0);
+        for (size_t j = clusters[cluster]; j < clusters[cluster + 1]; j++) {
+            // Apart enough from the previous eigenvalue of the cluster for the factorisation to differ.
+            T shift = values[j];
+            const T separation = T(10) * std::abs(eps * shift);
+            if (j > clusters[cluster] && shift - previous < separation) shift = previous + separation;
+            previous = shift;
+            // T - shift * I = P * L * U with partial pivoting, U has two diagonals over its own.
+            T largest = T(0);
+            for (size_t i = 0; i < n; i++) {
+                diagonal[i] = d[i] - shift;
+                if (i + 1 < n) upper[i] = e[i];
+            }
+            for (size_t i = 0; i + 1 < n; i++) {
+                const T below = e[i];
+                if (std::abs(below) > std::abs(diagonal[i])) {
+                    const T a_i = diagonal[i], b_i = upper[i], a_next = diagonal[i + 1];
+                    lower[i] = a_i / below;
+                    diagonal[i] = below;
+                    upper[i] = a_next;
+                    diagonal[i + 1] = b_i - lower[i] * a_next;
+                    second[i] = (i + 2 < n) ? upper[i + 1] : T(0);
+                    if (i + 2 < n) upper[i + 1] = -lower[i] * second[i];
+                    swapped[i] = T(1);
+                }
+                else {
+                    lower[i] = (diagonal[i] != T(0)) ? below / diagonal[i] : T(0);
+                    diagonal[i + 1] -= lower[i] * upper[i];
+                    second[i] = T(0);
+                    swapped[i] = T(0);
+                }
+                largest = std::max({ largest, std::abs(diagonal[i]), std::abs(upper[i]), std::abs(second[i]) });
+            }
+            largest = std::max(largest, std::abs(diagonal[n - 1]));
+            const T tiny = (largest > T(0)) ? eps * largest : eps;
+            // Deterministic start in (-1, 1).
+            std::uint64_t state = 0x9E3779B97F4A7C15ull * (j + 1);
+            for (size_t i = 0; i < n; i++) {
+                state = state * 6364136223846793005ull + 1442695040888963407ull;
+                y[i] = static_cast<T>(static_cast<double>(state >> 11) * 0x1.0p-52 - 1.0);
+            }
+            size_t max_at = 0;
+            for (size_t iteration = 0, checks = 0; iteration < eigen_inverse_iterations; iteration++) {
+                T sum = T(0);
+                for (size_t i = 0; i < n; i++) sum += std::abs(y[i]);
+                const T scale = static_cast<T>(n) * norm * std::max(eps, std::abs(diagonal[n - 1])) / sum;
+                for (size_t i = 0; i < n; i++) y[i] *= scale;
+                for (size_t i = 0; i + 1 < n; i++) {
+                    if (swapped[i] != T(0)) std::swap(y[i], y[i + 1]);
+                    y[i + 1] -= lower[i] * y[i];
+                }
+                for (size_t i = n; i-- > 0; ) {
+                    T value = y[i];
+                    if (i + 1 < n) value -= upper[i] * y[i + 1];
+                    if (i + 2 < n) value -= second[i] * y[i + 2];
+                    T pivot = diagonal[i];
+                    if (std::abs(pivot) < tiny) pivot = (pivot < T(0)) ? -tiny : tiny;
+                    y[i] = value / pivot;
+                }
+                for (size_t q = clusters[cluster]; q < j; q++) {
+                    const T *const other = x.row(q);
+                    T dot = T(0);
+                    for (size_t i = 0; i < n; i++) dot += y[i] * other[i];
+                    for (size_t i = 0; i < n; i++) y[i] -= dot * other[i];
+                }
+                max_at = 0;
+                for (size_t i = 1; i < n; i++)
+                    if (std::abs(y[i]) > std::abs(y[max_at])) max_at = i;
+                // Converged once the solve grew the vector enough, then refined twice more.
+                if (std::abs(y[max_at]) >= growth && ++checks > extra) break;
+            }
+            T squares = T(0);
+            for (size_t i = 0; i < n; i++) squares += y[i] * y[i];
+            const T scale = std::copysign(T(1) / std::sqrt(squares), y[max_at]);
+            T *const out = x.row(j);
+            for (size_t i = 0; i < n; i++) out[i] = y[i] * scale;
+        }
+    }
+}
+
+// FLOPs per element of the symmetric eigenproblem of order n for count eigenpairs, the divide and conquer one taken without deflation.
+_NODISC_ inline size_t eigen_flops_per_element(const size_t n, const size_t count, const bool is_divide_conquer, const Eigenvectors vectors) noexcept {
+    size_t flops = 4 * n / 3;
+    if (vectors == EV::yes) flops += 2 * count + (is_divide_conquer ? 4 * n / 3 : 0);
+    return flops;
+}
+}
+
+namespace math {
+/**
+ * @brief Eigenvalues and eigenvectors A * v = lambda * v of a symmetric floating point Matrix, of which only the lower triangle is read.
+ * @note A is reduced to tridiagonal form by blocked Householder reflections. All the eigenpairs then come from divide and conquer(implicit QL
+ *       without the vectors), a range of them from bisection and inverse iteration unless it covers over half of the spectrum. The eigenvectors
+ *       of the tridiagonal matrix are brought back to A through the reflectors in blocks, gemm doing the bulk of the work throughout.
+*/
+template <std::floating_point T>
+class SymmetricEigen {
+    private:
+        std::vector<T> m_values;    // Ascending.
+        Matrix<T> m_vectors;        // Column i is the unit eigenvector of m_values[i], empty without the eigenvectors.
+        size_t m_size = 0;
+
+    public:
+        /**
+         * @brief All the eigenvalues of a, and their eigenvectors with EV::yes.
+         * @throws std::invalid_argument If a is not square.
+         * @throws std::runtime_error If the implicit QL iteration does not converge.
+         * @throws std::bad_alloc If the scratch can not be allocated.
+        */
+        explicit SymmetricEigen(const Matrix<T> &a, const math::matrix::Eigenvectors vectors = math::matrix::EV::yes) : SymmetricEigen(a, 0, a.num_rows(), vectors) {}
+
+        /**
+         * @brief The eigenvalues [first, first + count) in ascending order of a, and their eigenvectors with EV::yes.
+         * @throws std::invalid_argument If a is not square or the range goes past its order.
+         * @throws std::runtime_error If the implicit QL iteration does not converge.
+         * @throws std::bad_alloc If the scratch can not be allocated.
+        */
+        SymmetricEigen(const Matrix<T> &a, const size_t first, const size_t count, const math::matrix::Eigenvectors vectors = math::matrix::EV::yes) : m_size(a.num_rows()) {
+            if (!a.is_square()) throw std::invalid_argument("Cannot compute the eigenvalues of a Matrix which is not square.");
+            const size_t n = m_size;
+            if (first > n || count > n - first) throw std::invalid_argument("Cannot compute eigenvalues past the order of the Matrix.");
+            if (count == 0) return;
+            const bool is_divide_conquer = (count == n) || (vectors == math::matrix::EV::yes && 2 * count > n);
+            _OP_SCOPE_(factorize, n, n, math::matrix::impl::eigen_flops_per_element(n, count, is_divide_conquer, vectors))
+            Matrix<T> work(a);
+            math::matrix::impl::eigen_symmetrize<T>(work.view());
+            std::vector<T> d(n), e(n), tau(n);
+            math::matrix::impl::eigen_tridiagonalize<T>(work.view(), d.data(), e.data(), tau.data());
+            // Scaled to a largest element of one, out of reach of overflow in the secular equations and Sturm counts.
+            T scale = T(0);
+            for (size_t i = 0; i < n; i++) scale = std::max({ scale, std::abs(d[i]), (i + 1 < n) ? std::abs(e[i]) : T(0) });
+            if (scale == T(0)) {
+                m_values.assign(count, T(0));
+                if (vectors == math::matrix::EV::yes) m_vectors = Matrix<T>(n, count, [=](size_t i, size_t j) { return (i == first + j) ? T(1) : T(0); });
+                return;
+            }
+            for (size_t i = 0; i < n; i++) {
+                d[i] /= scale;
+                e[i] /= scale;
+            }
+            if (is_divide_conquer && vectors == math::matrix::EV::yes) {
+                Matrix<T> z(n, n);
+                if (!math::matrix::impl::eigen_divide_conquer<T>(d.data(), e.data(), z.view())) this->throw_not_converged();
+                if (count == n) m_vectors = std::move(z);
+                else m_vectors = Matrix<T>(n, count, [&](size_t i, size_t j) { return z(i, first + j); });
+                m_values.assign(d.begin() + first, d.begin() + first + count);
+            }
+            else if (is_divide_conquer) {
+                if (!math::matrix::impl::eigen_tridiagonal_ql<T>(d.data(), e.data(), n, math::matrix::MatrixView<T>())) this->throw_not_converged();
+                std::sort(d.begin(), d.end());
+                m_values.assign(d.begin() + first, d.begin() + first + count);
+            }
+            else {
+                m_values.resize(count);
+                math::matrix::impl::eigen_bisection<T>(d.data(), e.data(), n, first, count, m_values.data());
+                if (vectors == math::matrix::EV::yes) {
+                    Matrix<T> x(count, n, math::matrix::CAR::possible_garbage);
+                    math::matrix::impl::eigen_inverse_iteration<T>(d.data(), e.data(), n, m_values.data(), x.view());
+                    m_vectors = x.transpose();
+                }
+            }
+            if (vectors == math::matrix::EV::yes) math::matrix::impl::eigen_back_transform<T>(work.view(), tau.data(), m_vectors.view());
+            for (T &value : m_values) value *= scale;
+        }
+
+    public:
+        _NODISC_ std::span<const T> values() const noexcept {
+            return m_values;
+        }
+        // n x count, column i belongs to values()[i].
+        _NODISC_ const Matrix<T> &vectors() const noexcept {
+            return m_vectors;
+        }
+        _NODISC_ bool has_vectors() const noexcept {
+            return !m_vectors.order().is_zero();
+        }
+        _NODISC_ size_t size() const noexcept {
+            return m_size;
+        }
+
+    private:
+        [[noreturn]] static void throw_not_converged() {
+            throw std::runtime_error("Cannot compute the eigenvalues as the implicit QL iteration did not converge.");
+        }
+};
+}
\ No newline at end of file
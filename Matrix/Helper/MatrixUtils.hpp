@@ -1,7 +1,7 @@
 // MatrixUtils.hpp
 #pragma once
 
-#include "..\..\Helper\Helper.hpp"
+#include "../../Helper/Helper.hpp"
 
 namespace math::matrix {
 // A lightweight wrapper on two size_t(s).
@@ -416,25 +416,25 @@ _MTEMPL_ class Row {
         }
 
         _NODISC_ bool are_all_same_as(const T &val_to_compare) const
-        requires _MATH_ isEqualityOperationPossible<T> {
+        requires math::isEqualityOperationPossible<T> {
             if (m_row_len == 0) return false;
             for (size_t i = 0; i < m_row_len; i++)
-                if (!_MATH_ is_equal(m_data[i], val_to_compare)) return false;
+                if (!math::is_equal(m_data[i], val_to_compare)) return false;
             return true;
         }
 
         _NODISC_ bool are_all_same() const
-        requires _MATH_ isEqualityOperationPossible<T> {
+        requires math::isEqualityOperationPossible<T> {
             if (m_row_len < 2) return true;
             for (size_t i = 0; i < m_row_len - 1; i++)
-                if (!_MATH_ is_equal(m_data[i], m_data[i + 1])) return false;
+                if (!math::is_equal(m_data[i], m_data[i + 1])) return false;
             return true;
         }
 
         _NODISC_ bool is_zero() const
-        requires _MATH_ isEqualityOperationPossible<T> {
+        requires math::isEqualityOperationPossible<T> {
             _ZERO_EXISTS_
-            _NO_ZERO_COND_ throw std::logic_error("Cannot check for is_zero property of the row as the zero value(stored in _MATH_ zero_vals or defautlt construction for the type) is not defined.");
+            _NO_ZERO_COND_ throw std::logic_error("Cannot check for is_zero property of the row as the zero value(stored in math::zero_vals or defautlt construction for the type) is not defined.");
             if constexpr (!DfltCtor<T>)
                 return are_all_same_as(_GET_ZERO_);
             else return are_all_same_as(T{});
@@ -442,23 +442,23 @@ _MTEMPL_ class Row {
 
         _NODISC_
         size_t count(const T &val_to_compare) const
-        requires _MATH_ isEqualityOperationPossible<T> {
+        requires math::isEqualityOperationPossible<T> {
             size_t count = 0;
-            for (size_t i = 0; i < m_row_len; i++) count += _MATH_ is_equal(m_data[i], val_to_compare);
+            for (size_t i = 0; i < m_row_len; i++) count += math::is_equal(m_data[i], val_to_compare);
             return count;
         }
 
     public:
         _NODISC_ bool operator==(const Row &other) const
-        requires _MATH_ isEqualityOperationPossible<T> {
+        requires math::isEqualityOperationPossible<T> {
             if (this->is_same_as(other)) return true;
             for (size_t i = 0; i < m_row_len; i++)
-                if (!_MATH_ is_equal(m_data[i], other.m_data[i])) return false;
+                if (!math::is_equal(m_data[i], other.m_data[i])) return false;
             return true;
         }
 
         _NODISC_ bool operator!=(const Row &other) const
-        requires _MATH_ isEqualityOperationPossible<T> {
+        requires math::isEqualityOperationPossible<T> {
             return !((*this)==other);
         }
 };
@@ -515,16 +515,16 @@ _MTEMPL_ class Column {
         }
 
         _NODISC_ bool operator==(const Column &other) const
-        requires _MATH_ isEqualityOperationPossible<T> {
+        requires math::isEqualityOperationPossible<T> {
             if (this->is_same_as(other)) return true;
             for (size_t i = 0; i < m_num_rows; i++) {
-                if (!_MATH_ is_equal(m_data[i][m_column_index], other.m_data[i][m_column_index])) return false;
+                if (!math::is_equal(m_data[i][m_column_index], other.m_data[i][m_column_index])) return false;
             }
             return true;
         }
 
         _NODISC_ bool operator!=(const Column &other) const
-        requires _MATH_ isEqualityOperationPossible<T> {
+        requires math::isEqualityOperationPossible<T> {
             return !((*this)==other);
         }
 };
@@ -617,6 +617,97 @@ _MTEMPL_ class MatrixIterator {
         }
 };
 
+// A non owning view of a rectangular block of a Matrix(or of any array of row pointers), for the kernels that work on sub-blocks.
+_MTEMPL_ class MatrixView {
+    private:
+        T *const *m_rows = nullptr;
+        size_t m_num_rows = 0;
+        size_t m_num_columns = 0;
+        size_t m_column_offset = 0;
+
+    public:
+        constexpr MatrixView() noexcept = default;
+        constexpr MatrixView(T *const *rows, const size_t num_rows, const size_t num_columns, const size_t column_offset = 0) noexcept
+        : m_rows(rows), m_num_rows(num_rows), m_num_columns(num_columns), m_column_offset(column_offset) {}
+
+        // A view of T converts to a view of const T.
+        constexpr operator MatrixView<const T>() const noexcept requires (!std::is_const_v<T>) {
+            return MatrixView<const T>(m_rows, m_num_rows, m_num_columns, m_column_offset);
+        }
+
+    public:
+        _NODISC_ T &operator()(const size_t row, const size_t column) const noexcept {
+            return m_rows[row][m_column_offset + column];
+        }
+        _NODISC_ T *row(const size_t row) const noexcept {
+            return m_rows[row] + m_column_offset;
+        }
+
+        /**
+         * @brief View of a sub-block, no bounds are checked.
+         * @param row First row of the block.
+         * @param column First column of the block.
+         * @param num_rows Number of rows of the block.
+         * @param num_columns Number of columns of the block.
+        */
+        _NODISC_ MatrixView block(const size_t row, const size_t column, const size_t num_rows, const size_t num_columns) const noexcept {
+            return MatrixView(m_rows + row, num_rows, num_columns, m_column_offset + column);
+        }
+
+    public:
+        _NODISC_ size_t num_rows() const noexcept {
+            return m_num_rows;
+        }
+        _NODISC_ size_t num_columns() const noexcept {
+            return m_num_columns;
+        }
+        _NODISC_ bool is_square() const noexcept {
+            return m_num_rows == m_num_columns;
+        }
+        _NODISC_ bool is_empty() const noexcept {
+            return (m_num_rows == 0) || (m_num_columns == 0);
+        }
+};
+
+// Whether an operand enters a product as it is or transposed.
+enum class Transpose : bool {
+    no, yes
+};
+using TR = Transpose;
+
+// Which triangle of a square result is computed or referenced, the diagonal belongs to both.
+enum class Triangle : bool {
+    lower, upper
+};
+using TRI = Triangle;
+
+// Whether the triangular operand of a solve stands left(op(a) * x = b) or right(x * op(a) = b) of the unknowns.
+enum class Side : bool {
+    left, right
+};
+using SD = Side;
+
+// Whether the diagonal of a triangular operand is read, or taken as ones without being referenced.
+enum class Diagonal : bool {
+    non_unit, unit
+};
+using DG = Diagonal;
+
+// Whether an eigensolver computes the eigenvectors along with the eigenvalues.
+enum class Eigenvectors : bool {
+    no, yes
+};
+using EV = Eigenvectors;
+
+// Whether a sparse matrix compresses its elements row by row(CSR) or column by column(CSC).
+enum class SparseFormat : bool {
+    csr, csc
+};
+using SF = SparseFormat;
+
+// Element types the packed product kernels handle, they rely on T(0), + and * only.
+_MTEMPL_ concept GemmScalar = std::is_arithmetic_v<T> && (!std::same_as<T, bool>);
+
 // Construction rules.
 
 enum class ConstructAllocateRule : bool {
@@ -0,0 +1,121 @@
+// Bareiss.hpp
+#pragma once
+#include "../Helper/MatrixUtils.hpp"
+#include "../../Profile/OpCounters.hpp"
+
+namespace math::matrix::impl {
+inline constexpr const size_t bareiss_parallel_rows = 128; // Steps updating at least this many rows split them over the team.
+
+// Products of two entries are formed in this type before the exact division brings them back to T, twice as wide where possible.
+#ifdef __SIZEOF_INT128__
+__extension__ using bareiss_int128 = __int128;
+template <std::signed_integral T>
+using bareiss_wide_t = std::conditional_t<(sizeof(T) < sizeof(long long)), long long, bareiss_int128>;
+#else
+template <std::signed_integral T>
+using bareiss_wide_t = std::conditional_t<(sizeof(T) < sizeof(long long)), long long, T>;
+#endif
+
+// (p * x - l * y) / previous, exact. The wide division is only paid for when the numerator doesn't fit in 64 bits, a quotient outside of T sets is_overflow.
+template <std::signed_integral T>
+_NODISC_ inline T bareiss_update(const bareiss_wide_t<T> p, const T x, const bareiss_wide_t<T> l, const T y, const bareiss_wide_t<T> previous, bool &is_overflow) noexcept {
+    using W = bareiss_wide_t<T>;
+    const W numerator = p * static_cast<W>(x) - l * static_cast<W>(y);
+    if constexpr (sizeof(W) == sizeof(T)) {
+        // Without a wider type only the division itself can be checked.
+        if ((previous == W(-1)) && (numerator == std::numeric_limits<W>::min())) [[unlikely]] {
+            is_overflow = true;
+            return T(0);
+        }
+        return static_cast<T>(numerator / previous);
+    }
+    else {
+        W quotient;
+        if ((sizeof(W) > sizeof(long long)) && (numerator == static_cast<W>(static_cast<long long>(numerator))) && (previous != W(-1)))
+            quotient = static_cast<long long>(numerator) / static_cast<long long>(previous);
+        else quotient = numerator / previous;
+        if ((quotient < static_cast<W>(std::numeric_limits<T>::min())) || (quotient > static_cast<W>(std::numeric_limits<T>::max()))) [[unlikely]] is_overflow = true;
+        return static_cast<T>(quotient);
+    }
+}
+
+inline void bareiss_check(const bool is_overflow) {
+    if (is_overflow) throw std::overflow_error("Cannot eliminate the integer Matrix exactly because one of its minors does not fit in the element type.");
+}
+
+/**
+ * @brief Determinant of the n x n matrix held by rows through fraction-free elimination, the rows are overwritten.
+ * @throws std::overflow_error If a minor(the determinant included) does not fit in T.
+ * @note After step k every entry below it is a (k + 2) x (k + 2) minor of the input, so each division by the previous pivot is exact.
+ *       A zero pivot swaps in the first row below with a non zero entry in its column, swapping the row pointers only.
+*/
+template <std::signed_integral T>
+_NODISC_ inline T bareiss_determinant(T **const rows, const size_t n) {
+    _TRACE_SPAN_(compute, "bareiss_determinant")
+    using W = bareiss_wide_t<T>;
+    if (n == 0) return T(1);
+    bool is_odd = false;
+    W previous = 1;
+    for (size_t k = 0; k + 1 < n; k++) {
+        size_t pivot = k;
+        while (pivot < n && rows[pivot][k] == T(0)) pivot++;
+        if (pivot == n) return T(0);
+        if (pivot != k) {
+            std::swap(rows[k], rows[pivot]);
+            is_odd = !is_odd;
+        }
+        const T *const u = rows[k];
+        const W p = u[k];
+        bool is_overflow = false;
+        #pragma omp parallel for schedule(static) reduction(||:is_overflow) if((n - k > bareiss_parallel_rows) && !omp_in_parallel())
+        for (size_t i = k + 1; i < n; i++) {
+            T *const r = rows[i];
+            const W l = r[k];
+            for (size_t j = k + 1; j < n; j++) r[j] = bareiss_update<T>(p, r[j], l, u[j], previous, is_overflow);
+        }
+        math::matrix::impl::bareiss_check(is_overflow);
+        previous = p;
+    }
+    math::matrix::impl::bareiss_check(is_odd && (rows[n - 1][n - 1] == std::numeric_limits<T>::min()));
+    return is_odd ? static_cast<T>(-rows[n - 1][n - 1]) : rows[n - 1][n - 1];
+}
+
+/**
+ * @brief Fraction-free Gauss-Jordan elimination of [left | right], the n x n left becomes d * I and right becomes d * left^-1 * right.
+ * @throws std::overflow_error If a minor of [left | right] does not fit in T(both are then left half eliminated).
+ * @return d, the determinant of left up to the sign of the row swaps, zero when left is singular(both are then left half eliminated).
+ * @note Every row but the pivot one is updated at every step, so all the entries stay minors of [left | right] and the divisions exact.
+*/
+template <std::signed_integral T>
+_NODISC_ inline T bareiss_gauss_jordan(T **const left, T **const right, const size_t n, const size_t right_columns) {
+    _TRACE_SPAN_(compute, "bareiss_gauss_jordan")
+    using W = bareiss_wide_t<T>;
+    W previous = 1;
+    for (size_t k = 0; k < n; k++) {
+        size_t pivot = k;
+        while (pivot < n && left[pivot][k] == T(0)) pivot++;
+        if (pivot == n) return T(0);
+        if (pivot != k) {
+            std::swap(left[k], left[pivot]);
+            std::swap(right[k], right[pivot]);
+        }
+        const T *const u = left[k], *const v = right[k];
+        const W p = u[k];
+        bool is_overflow = false;
+        #pragma omp parallel for schedule(static) reduction(||:is_overflow) if((n > bareiss_parallel_rows) && !omp_in_parallel())
+        for (size_t i = 0; i < n; i++) {
+            if (i == k) continue;
+            T *const r = left[i], *const s = right[i];
+            const W l = r[k];
+            // Columns before k of the left only hold the previous pivot on the diagonal, which becomes the current one.
+            if (i < k) r[i] = static_cast<T>(p);
+            r[k] = T(0);
+            for (size_t j = k + 1; j < n; j++) r[j] = bareiss_update<T>(p, r[j], l, u[j], previous, is_overflow);
+            for (size_t j = 0; j < right_columns; j++) s[j] = bareiss_update<T>(p, s[j], l, v[j], previous, is_overflow);
+        }
+        math::matrix::impl::bareiss_check(is_overflow);
+        previous = p;
+    }
+    return static_cast<T>(previous);
+}
+}
\ No newline at end of file
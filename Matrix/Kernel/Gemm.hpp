@@ -0,0 +1,335 @@
+// Gemm.hpp
+#pragma once
+#include "../Helper/MatrixUtils.hpp"
+#include "../../Memory/MemoryAlloc.hpp"
+#include "../../Profile/OpCounters.hpp"
+#include "Gemv.hpp"
+
+namespace math::matrix::impl {
+inline constexpr const size_t gemm_block_rows = 128;      // Rows of op(a) packed at once, the packed block(256 KiB of doubles) stays in L2.
+inline constexpr const size_t gemm_block_depth = 256;     // Depth of the packed panels.
+inline constexpr const size_t gemm_min_block_depth = 32;  // Shallowest panels tried when the memory budget is short, below it gemm_direct takes over.
+inline constexpr const size_t gemm_block_columns = 2048;  // Columns of op(b) packed at once, shared by the whole team through L3.
+inline constexpr const size_t gemm_register_rows = 4;     // Tile of c kept in registers by the micro kernel.
+_MTEMPL_ inline constexpr const size_t gemm_register_columns = std::max<size_t>(4, 64 / sizeof(T));
+inline constexpr const size_t gemm_direct_work = 48 * 48 * 48; // Below this many multiply-adds packing costs more than it saves.
+inline constexpr const size_t gemm_parallel_work = 64 * 64 * 64;
+
+// op(x)(i, j).
+_MTEMPL_ _NODISC_ inline T gemm_operand(const MatrixView<const T> x, const Transpose t, const size_t i, const size_t j) noexcept {
+    return t == TR::no ? x(i, j) : x(j, i);
+}
+
+// c = beta * c, a zero beta overwrites without reading c(so NaNs in c don't survive).
+_MTEMPL_ inline void gemm_scale(const MatrixView<T> c, const T beta, const size_t first_row, const size_t end_row) noexcept {
+    if (beta == T(1)) return;
+    const size_t n = c.num_columns();
+    for (size_t i = first_row; i < end_row; i++) {
+        T *const c_row = c.row(i);
+        if (beta == T(0)) std::fill_n(c_row, n, T(0));
+        else {
+            #pragma omp simd
+            for (size_t j = 0; j < n; j++) c_row[j] *= beta;
+        }
+    }
+}
+
+/**
+ * @brief Rows [first_row, first_row + rows) by depth [first, first + depth) of op(a) into strips of gemm_register_rows rows, depth major within a strip.
+ * @note The last strip is padded with zeros.
+*/
+_MTEMPL_ inline void gemm_pack_a(T *packed, const MatrixView<const T> a, const Transpose ta, const size_t first_row, const size_t rows,
+                                 const size_t first, const size_t depth) noexcept {
+    constexpr size_t mr = gemm_register_rows;
+    for (size_t s = 0; s < rows; s += mr, packed += mr * depth) {
+        const size_t height = std::min(mr, rows - s);
+        if (ta == TR::no)
+            for (size_t i = 0; i < height; i++) {
+                const T *const src = a.row(first_row + s + i) + first;
+                for (size_t p = 0; p < depth; p++) packed[p * mr + i] = src[p];
+            }
+        else
+            for (size_t p = 0; p < depth; p++) {
+                const T *const src = a.row(first + p) + first_row + s;
+                for (size_t i = 0; i < height; i++) packed[p * mr + i] = src[i];
+            }
+        if (height != mr)
+            for (size_t p = 0; p < depth; p++) std::fill(packed + p * mr + height, packed + (p + 1) * mr, T(0));
+    }
+}
+
+/**
+ * @brief Depth [first, first + depth) by columns [first_column, first_column + columns) of op(b) into strips of gemm_register_columns columns.
+ * @param strip The strip to pack, so that a team can share the work.
+*/
+_MTEMPL_ inline void gemm_pack_b(T *const packed, const MatrixView<const T> b, const Transpose tb, const size_t first, const size_t depth,
+                                 const size_t first_column, const size_t columns, const size_t strip) noexcept {
+    constexpr size_t nr = gemm_register_columns<T>;
+    const size_t s = strip * nr;
+    const size_t width = std::min(nr, columns - s);
+    T *const out = packed + s * depth;
+    if (tb == TR::no)
+        for (size_t p = 0; p < depth; p++) {
+            const T *const src = b.row(first + p) + first_column + s;
+            for (size_t j = 0; j < width; j++) out[p * nr + j] = src[j];
+        }
+    else
+        for (size_t j = 0; j < width; j++) {
+            const T *const src = b.row(first_column + s + j) + first;
+            for (size_t p = 0; p < depth; p++) out[p * nr + j] = src[p];
+        }
+    if (width != nr)
+        for (size_t p = 0; p < depth; p++) std::fill(out + p * nr + width, out + (p + 1) * nr, T(0));
+}
+
+/**
+ * @brief A gemm_register_rows x gemm_register_columns tile of c = beta * c + alpha * (packed a strip) * (packed b strip).
+ * @param height, width Part of the tile inside c.
+*/
+_MTEMPL_ inline void gemm_micro_kernel(const size_t depth, const T *__restrict a, const T *__restrict b, const MatrixView<T> c, const size_t i0, const size_t j0,
+                                       const size_t height, const size_t width, const T alpha, const T beta) noexcept {
+    constexpr size_t mr = gemm_register_rows, nr = gemm_register_columns<T>;
+    T acc[mr * nr] = {};
+    for (size_t p = 0; p < depth; p++, a += mr, b += nr)
+        for (size_t i = 0; i < mr; i++) {
+            const T a_ip = a[i];
+            #pragma omp simd
+            for (size_t j = 0; j < nr; j++) acc[i * nr + j] += a_ip * b[j];
+        }
+    for (size_t i = 0; i < height; i++) {
+        T *const c_row = c.row(i0 + i) + j0;
+        const T *const acc_row = acc + i * nr;
+        if (beta == T(0)) for (size_t j = 0; j < width; j++) c_row[j] = alpha * acc_row[j];
+        else if (beta == T(1)) for (size_t j = 0; j < width; j++) c_row[j] += alpha * acc_row[j];
+        else for (size_t j = 0; j < width; j++) c_row[j] = beta * c_row[j] + alpha * acc_row[j];
+    }
+}
+
+/**
+ * @brief c = alpha * op(a) * op(b) + beta * c straight from the operands, for products too small to repay packing(or when its scratch doesn't fit the budget).
+*/
+_MTEMPL_ inline void gemm_direct(const T alpha, const MatrixView<const T> a, const Transpose ta, const MatrixView<const T> b, const Transpose tb,
+                                 const T beta, const MatrixView<T> c, const size_t depth, const bool is_parallel) noexcept {
+    const size_t m = c.num_rows(), n = c.num_columns();
+    #pragma omp parallel for schedule(static) if(is_parallel)
+    for (size_t i = 0; i < m; i++) {
+        T *const c_row = c.row(i);
+        math::matrix::impl::gemm_scale<T>(c, beta, i, i + 1);
+        if (tb == TR::no)
+            for (size_t p = 0; p < depth; p++) {
+                const T a_ip = alpha * math::matrix::impl::gemm_operand<T>(a, ta, i, p);
+                const T *const b_row = b.row(p);
+                #pragma omp simd
+                for (size_t j = 0; j < n; j++) c_row[j] += a_ip * b_row[j];
+            }
+        else
+            for (size_t j = 0; j < n; j++) {
+                const T *const b_row = b.row(j); // Row j of b is column j of op(b).
+                T dot = T(0);
+                for (size_t p = 0; p < depth; p++) dot += math::matrix::impl::gemm_operand<T>(a, ta, i, p) * b_row[p];
+                c_row[j] += alpha * dot;
+            }
+    }
+}
+
+/**
+ * @brief Allocating scratch memory from the pool only if it fits the memory budget.
+ * @param num_elements Number of elements of the scratch.
+ * @throws std::bad_alloc If the memory allocation fails for another reason than the budget.
+ * @return Pointer to the scratch(freed with free_scratch_memory) or nullptr if it doesn't fit the budget, also when the budget shrank past the check(other threads charge it too).
+*/
+_MTEMPL_ _NODISC_ inline T *gemm_try_scratch(const size_t num_elements) {
+    if (num_elements * sizeof(T) > math::memory::memory_budget_available()) return nullptr;
+    try { return math::memory::allocate_scratch_memory<T>(num_elements); }
+    catch(const math::memory::memory_budget_exceeded&) { return nullptr; }
+}
+
+// Packing buffers of gemm_kernel, a panel of op(b) and a block of op(a) per thread, each a block of the pool of the caller so repeated products reuse them.
+_MTEMPL_ struct GemmPacking {
+    T *packed_b = nullptr;
+    T **packed_a = nullptr;
+    size_t threads = 0; // Blocks of op(a) held.
+
+    GemmPacking() noexcept = default;
+    GemmPacking(const GemmPacking&) = delete;
+    GemmPacking &operator=(const GemmPacking&) = delete;
+    ~GemmPacking() { this->release(); }
+
+    void release() noexcept {
+        for (; threads != 0; threads--) math::memory::free_scratch_memory(packed_a[threads - 1]);
+        math::memory::free_scratch_memory(packed_a);
+        math::memory::free_scratch_memory(packed_b);
+    }
+
+    /**
+     * @brief Allocating every buffer, or none of them.
+     * @throws std::bad_alloc If the memory allocation fails for another reason than the budget.
+     * @return false(nothing held) if the buffers don't fit the memory budget.
+    */
+    _NODISC_ bool try_allocate(const size_t num_threads, const size_t a_elements, const size_t b_elements) {
+        if ((num_threads * a_elements + b_elements) * sizeof(T) > math::memory::memory_budget_available()) return false;
+        try {
+            packed_b = math::memory::allocate_scratch_memory<T>(b_elements);
+            packed_a = math::memory::allocate_scratch_memory<T*>(num_threads);
+            for (; threads < num_threads; threads++) packed_a[threads] = math::memory::allocate_scratch_memory<T>(a_elements);
+        }
+        catch(const math::memory::memory_budget_exceeded&) {
+            this->release();
+            return false;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief A product with a single row or column of c as a matrix-vector product, the vectors that aren't contiguous are gathered.
+ * @return false(c untouched) if the gathered vectors don't fit the memory budget.
+*/
+_MTEMPL_ inline bool gemm_as_gemv(const T alpha, const MatrixView<const T> a, const Transpose ta, const MatrixView<const T> b, const Transpose tb,
+                                  const T beta, const MatrixView<T> c, const size_t depth, const bool is_parallel) {
+    const size_t m = c.num_rows();
+    if (m == 1) {
+        // The row of c = alpha * op(b)^T * (the row of op(a)) + beta * the row of c.
+        const Transpose tv = (tb == TR::no) ? TR::yes : TR::no;
+        if (ta == TR::no) {
+            math::matrix::impl::gemv_kernel<T>(alpha, b, tv, a.row(0), beta, c.row(0), 1, is_parallel);
+            return true;
+        }
+        T *x = math::matrix::impl::gemm_try_scratch<T>(depth);
+        if (x == nullptr) return false;
+        for (size_t p = 0; p < depth; p++) x[p] = a(p, 0);
+        math::matrix::impl::gemv_kernel<T>(alpha, b, tv, x, beta, c.row(0), 1, is_parallel);
+        math::memory::free_scratch_memory(x);
+        return true;
+    }
+    // The column of c = alpha * op(a) * (the column of op(b)) + beta * the column of c.
+    const size_t x_size = (tb == TR::no) ? depth : 0;
+    T *scratch = math::matrix::impl::gemm_try_scratch<T>(m + x_size);
+    if (scratch == nullptr) return false;
+    for (size_t p = 0; p < x_size; p++) scratch[m + p] = b(p, 0);
+    if (beta != T(0)) for (size_t i = 0; i < m; i++) scratch[i] = c(i, 0);
+    math::matrix::impl::gemv_kernel<T>(alpha, a, ta, (tb == TR::no) ? scratch + m : b.row(0), beta, scratch, 1, is_parallel);
+    for (size_t i = 0; i < m; i++) c(i, 0) = scratch[i];
+    math::memory::free_scratch_memory(scratch);
+    return true;
+}
+
+/**
+ * @brief c = alpha * op(a) * op(b) + beta * c with packed panels and a register tiled micro kernel, sizes already checked.
+ * @param is_parallel Whether to split the work over a new thread team(false inside parallel regions and tasks).
+ * @throws std::bad_alloc If the packing scratch can not be allocated, c is untouched then.
+ * @note Falls back on gemm_direct when the product is small or even the narrowest panels don't fit the memory budget, a single row or column of c goes to gemv_kernel.
+ *       The row blocks of c go to the team, when there are fewer of them than threads the column strips are split as well.
+*/
+_MTEMPL_ inline void gemm_kernel(const T alpha, const MatrixView<const T> a, const Transpose ta, const MatrixView<const T> b, const Transpose tb,
+                                 const T beta, const MatrixView<T> c, bool is_parallel) {
+    constexpr size_t mr = gemm_register_rows, nr = gemm_register_columns<T>;
+    const size_t m = c.num_rows(), n = c.num_columns();
+    const size_t depth = (ta == TR::no) ? a.num_columns() : a.num_rows();
+    if (m == 0 || n == 0) return;
+    is_parallel = is_parallel && !omp_in_parallel() && (omp_get_max_threads() > 1) && (m * n * depth >= gemm_parallel_work);
+    if ((depth == 0) || (alpha == T(0))) {
+        #pragma omp parallel for schedule(static) if(is_parallel)
+        for (size_t i = 0; i < m; i++) math::matrix::impl::gemm_scale<T>(c, beta, i, i + 1);
+        return;
+    }
+    if (m * n * depth < gemm_direct_work) {
+        math::matrix::impl::gemm_direct<T>(alpha, a, ta, b, tb, beta, c, depth, is_parallel);
+        return;
+    }
+    if (((m == 1) || (n == 1)) && math::matrix::impl::gemm_as_gemv<T>(alpha, a, ta, b, tb, beta, c, depth, is_parallel)) return;
+
+    const size_t threads = is_parallel ? static_cast<size_t>(omp_get_max_threads()) : 1;
+    size_t kc = std::min(depth, gemm_block_depth);
+    size_t nc = std::min((n + nr - 1) / nr * nr, gemm_block_columns);
+    // Enough row blocks for the team when possible, each a whole number of register strips.
+    const size_t mc = std::min(gemm_block_rows, std::max(mr, ((m + threads - 1) / threads + mr - 1) / mr * mr));
+    GemmPacking<T> packing;
+    // Short of budget, narrower panels of op(b) are tried first, then shallower ones.
+    while (!packing.try_allocate(threads, mc * kc, kc * nc)) {
+        if (nc > nr) nc = std::max(nr, nc / 2 / nr * nr);
+        else if (kc > gemm_min_block_depth) kc = std::max(gemm_min_block_depth, kc / 2);
+        else {
+            math::matrix::impl::gemm_direct<T>(alpha, a, ta, b, tb, beta, c, depth, is_parallel);
+            return;
+        }
+    }
+    T *const packed_b = packing.packed_b;
+    const size_t row_blocks = (m + mc - 1) / mc;
+
+    #pragma omp parallel if(is_parallel)
+    {
+        T *const packed_a = packing.packed_a[omp_get_thread_num()];
+        for (size_t jc = 0; jc < n; jc += nc) {
+            const size_t columns = std::min(nc, n - jc);
+            const size_t strips = (columns + nr - 1) / nr;
+            const size_t groups = std::min(strips, (static_cast<size_t>(omp_get_num_threads()) + row_blocks - 1) / row_blocks);
+            for (size_t pc = 0; pc < depth; pc += kc) {
+                const size_t panel_depth = std::min(kc, depth - pc);
+                const T beta_now = (pc == 0) ? beta : T(1);
+                {
+                    _TRACE_SPAN_(pack, "gemm_pack_b")
+                    #pragma omp for schedule(static)
+                    for (size_t s = 0; s < strips; s++) math::matrix::impl::gemm_pack_b<T>(packed_b, b, tb, pc, panel_depth, jc, columns, s);
+                }
+                _TRACE_SPAN_(compute, "gemm_tile")
+                #pragma omp for schedule(static)
+                for (size_t unit = 0; unit < row_blocks * groups; unit++) {
+                    const size_t ic = (unit / groups) * mc, group = unit % groups;
+                    const size_t rows = std::min(mc, m - ic);
+                    const size_t first_strip = strips * group / groups, end_strip = strips * (group + 1) / groups;
+                    math::matrix::impl::gemm_pack_a<T>(packed_a, a, ta, ic, rows, pc, panel_depth);
+                    for (size_t s = first_strip; s < end_strip; s++) {
+                        const size_t j0 = s * nr;
+                        const size_t width = std::min(nr, columns - j0);
+                        for (size_t ir = 0; ir < rows; ir += mr)
+                            math::matrix::impl::gemm_micro_kernel<T>(panel_depth, packed_a + ir * panel_depth, packed_b + j0 * panel_depth, c,
+                                ic + ir, jc + j0, std::min(mr, rows - ir), width, alpha, beta_now);
+                    }
+                } // The implicit barrier keeps packed_b alive until every thread is done with it.
+            }
+        }
+    }
+}
+
+/**
+ * @brief gemm_kernel for callers that can't throw(tiles of parallel loops and tasks), without memory for the packing scratch gemm_direct takes over.
+*/
+_MTEMPL_ inline void gemm_nothrow(const T alpha, const MatrixView<const T> a, const Transpose ta, const MatrixView<const T> b, const Transpose tb,
+                                  const T beta, const MatrixView<T> c, const bool is_parallel) noexcept {
+    try { math::matrix::impl::gemm_kernel<T>(alpha, a, ta, b, tb, beta, c, is_parallel); }
+    catch(...) {
+        const size_t depth = (ta == TR::no) ? a.num_columns() : a.num_rows();
+        math::matrix::impl::gemm_direct<T>(alpha, a, ta, b, tb, beta, c, depth, is_parallel && !omp_in_parallel());
+    }
+}
+}
+
+namespace math {
+/**
+ * @brief General matrix product accumulated into caller owned storage: c = alpha * op(a) * op(b) + beta * c.
+ * @param alpha Scale of the product.
+ * @param a Left operand, op(a) is m x k.
+ * @param ta Whether op(a) is a or its transpose, read in place.
+ * @param b Right operand, op(b) is k x n.
+ * @param tb Whether op(b) is b or its transpose, read in place.
+ * @param beta Scale of the old c, zero overwrites c without reading it.
+ * @param c Result, m x n, must not overlap a or b(T is deduced from it).
+ * @throws std::invalid_argument If the sizes don't match.
+ * @throws std::bad_alloc If the packing scratch can not be allocated.
+ * @note The only allocations are the packing buffers(one block of op(a) per thread and one panel of op(b), about 4.3 MiB of doubles for 1 thread),
+ *       taken from the pool of the calling thread so that repeated products reuse them, skipped for small products and narrowed to fit the memory budget.
+*/
+template <math::matrix::GemmScalar T>
+inline void gemm(const std::type_identity_t<T> alpha, const std::type_identity_t<math::matrix::MatrixView<const T>> a, const math::matrix::Transpose ta,
+                 const std::type_identity_t<math::matrix::MatrixView<const T>> b, const math::matrix::Transpose tb, const std::type_identity_t<T> beta,
+                 const math::matrix::MatrixView<T> c) {
+    const bool ta_no = (ta == math::matrix::TR::no), tb_no = (tb == math::matrix::TR::no);
+    const size_t m = c.num_rows(), n = c.num_columns();
+    const size_t depth = ta_no ? a.num_columns() : a.num_rows();
+    if (((ta_no ? a.num_rows() : a.num_columns()) != m) || ((tb_no ? b.num_columns() : b.num_rows()) != n) || ((tb_no ? b.num_rows() : b.num_columns()) != depth))
+        throw std::invalid_argument("Cannot multiply the matrices because op(a) is not m x k, op(b) k x n and c m x n.");
+    _OP_SCOPE_(multiply, m, n, depth)
+    math::matrix::impl::gemm_kernel<T>(alpha, a, ta, b, tb, beta, c, true);
+}
+}
\ No newline at end of file
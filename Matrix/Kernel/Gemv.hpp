@@ -0,0 +1,153 @@
+// Gemv.hpp
+#pragma once
+#include "../Helper/MatrixUtils.hpp"
+#include "../../Profile/OpCounters.hpp"
+
+namespace math::matrix::impl {
+inline constexpr const size_t gemv_row_group = 4;         // Rows of a sharing every load of x(or every update of y when transposed).
+inline constexpr const size_t gemv_column_tile = 2048;    // Columns of y updated per pass over a group of rows when transposed, they stay in L1.
+inline constexpr const size_t gemv_parallel_work = 1 << 15;
+
+// y = beta * y + alpha * dot, a zero beta overwrites without reading y.
+_MTEMPL_ _NODISC_ inline T gemv_blend(const T alpha, const T dot, const T beta, const T y) noexcept {
+    return beta == T(0) ? alpha * dot : beta * y + alpha * dot;
+}
+
+/**
+ * @brief y_v = alpha * a * x_v + beta * y_v for count vectors, every group of rows of a is read once for all of them.
+ * @param x count vectors of a.num_columns() elements back to back.
+ * @param y count vectors of a.num_rows() elements back to back.
+*/
+_MTEMPL_ inline void gemv_rows(const T alpha, const MatrixView<const T> a, const T *const x, const T beta, T *const y, const size_t count, const bool is_parallel) noexcept {
+    constexpr size_t g = gemv_row_group;
+    const size_t m = a.num_rows(), n = a.num_columns();
+    const size_t groups = (m + g - 1) / g;
+    #pragma omp parallel if(is_parallel)
+    {
+        _TRACE_SPAN_(compute, "gemv_rows")
+        #pragma omp for schedule(static) nowait
+        for (size_t group = 0; group < groups; group++) {
+            const size_t i0 = group * g, height = std::min(g, m - i0);
+            // Short groups repeat their last row rather than branching in the inner loop.
+            const T *const r0 = a.row(i0), *const r1 = a.row(i0 + std::min<size_t>(1, height - 1));
+            const T *const r2 = a.row(i0 + std::min<size_t>(2, height - 1)), *const r3 = a.row(i0 + std::min<size_t>(3, height - 1));
+            for (size_t v = 0; v < count; v++) {
+                const T *const xv = x + v * n;
+                T s0 = T(0), s1 = T(0), s2 = T(0), s3 = T(0);
+                #pragma omp simd reduction(+:s0, s1, s2, s3)
+                for (size_t j = 0; j < n; j++) {
+                    const T xj = xv[j];
+                    s0 += r0[j] * xj;
+                    s1 += r1[j] * xj;
+                    s2 += r2[j] * xj;
+                    s3 += r3[j] * xj;
+                }
+                const T sums[g] = { s0, s1, s2, s3 };
+                T *const yv = y + v * m + i0;
+                for (size_t i = 0; i < height; i++) yv[i] = math::matrix::impl::gemv_blend<T>(alpha, sums[i], beta, yv[i]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief y_v = alpha * a^T * x_v + beta * y_v for count vectors, the columns are split over the team so every thread owns its part of y.
+ * @param x count vectors of a.num_rows() elements back to back.
+ * @param y count vectors of a.num_columns() elements back to back.
+*/
+_MTEMPL_ inline void gemv_columns(const T alpha, const MatrixView<const T> a, const T *const x, const T beta, T *const y, const size_t count, const bool is_parallel) noexcept {
+    constexpr size_t g = gemv_row_group;
+    const size_t m = a.num_rows(), n = a.num_columns();
+    #pragma omp parallel if(is_parallel)
+    {
+        _TRACE_SPAN_(compute, "gemv_columns")
+        const size_t threads = static_cast<size_t>(omp_get_num_threads()), thread = static_cast<size_t>(omp_get_thread_num());
+        const size_t share = ((n + threads - 1) / threads + 7) / 8 * 8; // Whole cache lines of doubles per thread.
+        const size_t first = std::min(n, thread * share), end = std::min(n, first + share);
+        for (size_t j0 = first; j0 < end; j0 += gemv_column_tile) {
+            const size_t width = std::min(gemv_column_tile, end - j0);
+            for (size_t v = 0; v < count; v++) {
+                T *const yv = y + v * n + j0;
+                if (beta == T(0)) std::fill_n(yv, width, T(0));
+                else if (beta != T(1)) {
+                    #pragma omp simd
+                    for (size_t j = 0; j < width; j++) yv[j] *= beta;
+                }
+            }
+            for (size_t i0 = 0; i0 < m; i0 += g) {
+                const size_t height = std::min(g, m - i0);
+                const T *const r0 = a.row(i0) + j0, *const r1 = a.row(i0 + std::min<size_t>(1, height - 1)) + j0;
+                const T *const r2 = a.row(i0 + std::min<size_t>(2, height - 1)) + j0, *const r3 = a.row(i0 + std::min<size_t>(3, height - 1)) + j0;
+                for (size_t v = 0; v < count; v++) {
+                    const T *const xv = x + v * m + i0;
+                    // Repeated rows of a short group get a zero weight.
+                    const T w0 = alpha * xv[0], w1 = height > 1 ? alpha * xv[1] : T(0), w2 = height > 2 ? alpha * xv[2] : T(0), w3 = height > 3 ? alpha * xv[3] : T(0);
+                    T *const yv = y + v * n + j0;
+                    #pragma omp simd
+                    for (size_t j = 0; j < width; j++) yv[j] += w0 * r0[j] + w1 * r1[j] + w2 * r2[j] + w3 * r3[j];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief y_v = alpha * op(a) * x_v + beta * y_v for count vectors stored back to back, sizes already checked.
+*/
+_MTEMPL_ inline void gemv_kernel(const T alpha, const MatrixView<const T> a, const Transpose ta, const T *const x, const T beta, T *const y,
+                                 const size_t count, bool is_parallel) noexcept {
+    const size_t m = a.num_rows(), n = a.num_columns();
+    const size_t out = (ta == TR::no) ? m : n;
+    if (out == 0 || count == 0) return;
+    is_parallel = is_parallel && !omp_in_parallel() && (omp_get_max_threads() > 1) && (m * n * count >= gemv_parallel_work);
+    if (m == 0 || n == 0 || alpha == T(0)) {
+        for (size_t i = 0; i < out * count; i++) y[i] = beta == T(0) ? T(0) : beta * y[i];
+        return;
+    }
+    if (ta == TR::no) math::matrix::impl::gemv_rows<T>(alpha, a, x, beta, y, count, is_parallel);
+    else math::matrix::impl::gemv_columns<T>(alpha, a, x, beta, y, count, is_parallel);
+}
+
+template <typename U>
+inline void gemv_check(const MatrixView<U> a, const Transpose ta, const size_t x_size, const size_t y_size, const size_t count) {
+    const size_t in = (ta == TR::no) ? a.num_columns() : a.num_rows(), out = (ta == TR::no) ? a.num_rows() : a.num_columns();
+    if ((x_size != in * count) || (y_size != out * count))
+        throw std::invalid_argument("Cannot multiply the matrix by the vectors because x doesn't hold the columns and y the rows of op(a) for every vector.");
+}
+}
+
+namespace math {
+/**
+ * @brief Matrix-vector product accumulated into caller owned storage: y = alpha * op(a) * x + beta * y.
+ * @param alpha Scale of the product.
+ * @param a The matrix, read in place when transposed.
+ * @param ta Whether op(a) is a or its transpose.
+ * @param x Contiguous vector of the columns of op(a).
+ * @param beta Scale of the old y, zero overwrites y without reading it.
+ * @param y Contiguous vector of the rows of op(a), must not overlap x.
+ * @throws std::invalid_argument If the sizes don't match.
+ * @note Vectorised dot products over groups of 4 rows, split by rows over the team. The transpose splits the columns of a instead, so that y needs no reduction.
+*/
+template <typename U, typename T = std::remove_const_t<U>> requires math::matrix::GemmScalar<T>
+inline void gemv(const std::type_identity_t<T> alpha, const math::matrix::MatrixView<U> a, const math::matrix::Transpose ta, const std::type_identity_t<std::span<const T>> x,
+                 const std::type_identity_t<T> beta, const std::type_identity_t<std::span<T>> y) {
+    math::matrix::impl::gemv_check(a, ta, x.size(), y.size(), 1);
+    _OP_SCOPE_(multiply, y.size(), 1, x.size())
+    math::matrix::impl::gemv_kernel<T>(alpha, a, ta, x.data(), beta, y.data(), 1, true);
+}
+
+/**
+ * @brief Batched matrix-vector product y_v = alpha * op(a) * x_v + beta * y_v, with a streamed from memory once for all the vectors.
+ * @param x count vectors of the columns of op(a), back to back.
+ * @param y count vectors of the rows of op(a), back to back, must not overlap x.
+ * @param count Number of vectors.
+ * @throws std::invalid_argument If the sizes don't match.
+*/
+template <typename U, typename T = std::remove_const_t<U>> requires math::matrix::GemmScalar<T>
+inline void gemv_batched(const std::type_identity_t<T> alpha, const math::matrix::MatrixView<U> a, const math::matrix::Transpose ta, const std::type_identity_t<std::span<const T>> x,
+                         const std::type_identity_t<T> beta, const std::type_identity_t<std::span<T>> y, const size_t count) {
+    math::matrix::impl::gemv_check(a, ta, x.size(), y.size(), count);
+    _OP_SCOPE_(multiply, count == 0 ? 0 : y.size() / count, count, count == 0 ? 0 : x.size() / count)
+    math::matrix::impl::gemv_kernel<T>(alpha, a, ta, x.data(), beta, y.data(), count, true);
+}
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+// Ger.hpp
+#pragma once
+#include "Gemv.hpp"
+
+namespace math::matrix::impl {
+/**
+ * @brief a += alpha * sum_v x_v * y_v^T for count pairs of vectors back to back, sizes already checked.
+ * @note Every row of a is read and written once per gemv_column_tile columns, with 4 updates folded into each pass.
+ *       Rows and column tiles are split over the team, no two threads touch the same element.
+*/
+_MTEMPL_ inline void ger_kernel(const T alpha, const T *const x, const T *const y, const MatrixView<T> a, const size_t count, bool is_parallel) noexcept {
+    constexpr size_t g = gemv_row_group;
+    const size_t m = a.num_rows(), n = a.num_columns();
+    if (m == 0 || n == 0 || count == 0 || alpha == T(0)) return;
+    const size_t tiles = (n + gemv_column_tile - 1) / gemv_column_tile;
+    is_parallel = is_parallel && !omp_in_parallel() && (omp_get_max_threads() > 1) && (m * n * count >= gemv_parallel_work);
+    #pragma omp parallel for collapse(2) schedule(static) if(is_parallel)
+    for (size_t i = 0; i < m; i++)
+        for (size_t tile = 0; tile < tiles; tile++) {
+            const size_t j0 = tile * gemv_column_tile, width = std::min(gemv_column_tile, n - j0);
+            T *const a_row = a.row(i) + j0;
+            for (size_t v0 = 0; v0 < count; v0 += g) {
+                const size_t height = std::min(g, count - v0);
+                const T *const y0 = y + v0 * n + j0, *const y1 = y + (v0 + std::min<size_t>(1, height - 1)) * n + j0;
+                const T *const y2 = y + (v0 + std::min<size_t>(2, height - 1)) * n + j0, *const y3 = y + (v0 + std::min<size_t>(3, height - 1)) * n + j0;
+                // Repeated vectors of a short group get a zero weight.
+                const T w0 = alpha * x[v0 * m + i], w1 = height > 1 ? alpha * x[(v0 + 1) * m + i] : T(0);
+                const T w2 = height > 2 ? alpha * x[(v0 + 2) * m + i] : T(0), w3 = height > 3 ? alpha * x[(v0 + 3) * m + i] : T(0);
+                #pragma omp simd
+                for (size_t j = 0; j < width; j++) a_row[j] += w0 * y0[j] + w1 * y1[j] + w2 * y2[j] + w3 * y3[j];
+            }
+        }
+}
+
+inline void ger_check(const size_t rows, const size_t columns, const size_t x_size, const size_t y_size, const size_t count) {
+    if ((x_size != rows * count) || (y_size != columns * count))
+        throw std::invalid_argument("Cannot update the matrix because x doesn't hold its rows and y its columns for every pair of vectors.");
+}
+}
+
+namespace math {
+/**
+ * @brief Rank-1 update in place: a += alpha * x * y^T.
+ * @param alpha Scale of the outer product.
+ * @param x Contiguous vector of the rows of a.
+ * @param y Contiguous vector of the columns of a.
+ * @param a The matrix updated, must not overlap x or y(T is deduced from it).
+ * @throws std::invalid_argument If the sizes don't match.
+ * @note Allocates nothing, vectorised along the rows and split over the team by rows.
+*/
+template <math::matrix::GemmScalar T>
+inline void ger(const std::type_identity_t<T> alpha, const std::type_identity_t<std::span<const T>> x, const std::type_identity_t<std::span<const T>> y,
+                const math::matrix::MatrixView<T> a) {
+    math::matrix::impl::ger_check(a.num_rows(), a.num_columns(), x.size(), y.size(), 1);
+    _OP_SCOPE_(multiply, a.num_rows(), a.num_columns(), 1)
+    math::matrix::impl::ger_kernel<T>(alpha, x.data(), y.data(), a, 1, true);
+}
+
+/**
+ * @brief Rank-k update in place: a += alpha * sum_v x_v * y_v^T over count pairs of vectors, a is streamed once for all of them.
+ * @param x count vectors of the rows of a, back to back(X^T of the product a += alpha * X * Y^T).
+ * @param y count vectors of the columns of a, back to back.
+ * @param count Number of pairs.
+ * @throws std::invalid_argument If the sizes don't match.
+*/
+template <math::matrix::GemmScalar T>
+inline void ger_batched(const std::type_identity_t<T> alpha, const std::type_identity_t<std::span<const T>> x, const std::type_identity_t<std::span<const T>> y,
+                        const math::matrix::MatrixView<T> a, const size_t count) {
+    math::matrix::impl::ger_check(a.num_rows(), a.num_columns(), x.size(), y.size(), count);
+    _OP_SCOPE_(multiply, a.num_rows(), a.num_columns(), count)
+    math::matrix::impl::ger_kernel<T>(alpha, x.data(), y.data(), a, count, true);
+}
+}
\ No newline at end of file
@@ -0,0 +1,220 @@
+// Power.hpp
+#pragma once
+#include "../Helper/MatrixUtils.hpp"
+#include "../../Profile/OpCounters.hpp"
+
+namespace math::matrix::impl {
+inline constexpr const size_t expm_parallel_rows = 256; // Sums of powers with at least this many rows are split over the team.
+
+// Padé degrees of the scaling and squaring exponential, and the largest norm of A each one is accurate to double precision for(Higham, 2005).
+inline constexpr const size_t expm_degrees[] = { 3, 5, 7, 9, 13 };
+inline constexpr const double expm_theta[] = { 1.495585217958292e-2, 2.539398330063230e-1, 9.504178996162932e-1, 2.097847961257068e0, 5.371920351148152e0 };
+// Coefficients b_0 to b_m of the [m / m] Padé approximant of exp, for every degree above.
+inline constexpr const double expm_coefficients[][14] = {
+    { 120.0, 60.0, 12.0, 1.0 },
+    { 30240.0, 15120.0, 3360.0, 420.0, 30.0, 1.0 },
+    { 17297280.0, 8648640.0, 1995840.0, 277200.0, 25200.0, 1512.0, 56.0, 1.0 },
+    { 17643225600.0, 8821612800.0, 2075673600.0, 302702400.0, 30270240.0, 2162160.0, 110880.0, 3960.0, 90.0, 1.0 },
+    { 64764752532480000.0, 32382376266240000.0, 7771770303897600.0, 1187353796428800.0, 129060195264000.0, 10559470521600.0, 670442572800.0,
+      33522128640.0, 1323241920.0, 40840800.0, 960960.0, 16380.0, 182.0, 1.0 },
+};
+
+// Largest absolute row sum, the norm bounding the truncation error of the Padé approximants.
+template <std::floating_point T>
+_NODISC_ inline double expm_norm(const MatrixView<const T> a) noexcept {
+    double norm = 0.0;
+    for (size_t i = 0; i < a.num_rows(); i++) {
+        const T *const row = a.row(i);
+        double sum = 0.0;
+        for (size_t j = 0; j < a.num_columns(); j++) sum += static_cast<double>(std::abs(row[j]));
+        norm = std::max(norm, sum);
+    }
+    return norm;
+}
+
+/**
+ * @brief Index in expm_degrees of the cheapest approximant accurate for a Matrix of the given norm, and the squarings it needs.
+ * @note Below the last threshold no squaring is needed, above it A is scaled by 2^-squarings back under it.
+*/
+_NODISC_ inline size_t expm_degree(const double norm, size_t &squarings) noexcept {
+    squarings = 0;
+    for (size_t index = 0; index < std::size(expm_degrees); index++)
+        if (norm <= expm_theta[index]) return index;
+    if (std::isfinite(norm)) squarings = static_cast<size_t>(std::max(0.0, std::ceil(std::log2(norm / expm_theta[std::size(expm_degrees) - 1]))));
+    return std::size(expm_degrees) - 1;
+}
+
+// out = diagonal * I + the sum of coefficient * view over the terms, or out += that with accumulate.
+template <std::floating_point T>
+inline void expm_combine(const MatrixView<T> out, const bool accumulate, const T diagonal, const std::pair<T, MatrixView<const T>> *const terms, const size_t count) noexcept {
+    const size_t n = out.num_rows();
+    #pragma omp parallel for schedule(static) if((n > expm_parallel_rows) && !omp_in_parallel())
+    for (size_t i = 0; i < n; i++) {
+        T *const row = out.row(i);
+        if (!accumulate) std::fill_n(row, n, T(0));
+        row[i] += diagonal;
+        for (size_t t = 0; t < count; t++) {
+            const T coefficient = terms[t].first;
+            const T *const source = terms[t].second.row(i);
+            for (size_t j = 0; j < n; j++) row[j] += coefficient * source[j];
+        }
+    }
+}
+
+/**
+ * @brief The denominator V - U of the [m / m] Padé approximant of exp(a) in u and its numerator V + U in x, exp(a) ~ (V - U)^-1 * (V + U).
+ * @param degree Index in expm_degrees, a4 and a6 are only used from degree 5 and 7 on and x is scratch until the end.
+ * @param multiply Called as multiply(c, a, b) for c = a * b, MatrixView<T> c and MatrixView<const T> a and b, c never aliasing them.
+ * @note Degree 13 evaluates its odd and even parts with A^2, A^4 and A^6 only, so no degree takes more than 6 products.
+*/
+template <std::floating_point T, typename Multiply>
+inline void expm_pade(const MatrixView<const T> a, const size_t degree, const MatrixView<T> a2, const MatrixView<T> a4, const MatrixView<T> a6,
+                      const MatrixView<T> u, const MatrixView<T> v, const MatrixView<T> x, Multiply &&multiply) {
+    _TRACE_SPAN_(compute, "expm_pade")
+    using Term = std::pair<T, MatrixView<const T>>;
+    const double *const b = expm_coefficients[degree];
+    const auto c = [b](size_t k) { return static_cast<T>(b[k]); };
+    const size_t n = a.num_rows(), m = expm_degrees[degree];
+    multiply(a2, a, a);
+    if (m >= 5) multiply(a4, a2, a2);
+    if (m >= 7) multiply(a6, a4, a2);
+    if (m == 13) {
+        const Term odd_high[] = { { c(13), a6 }, { c(11), a4 }, { c(9), a2 } }, odd_low[] = { { c(7), a6 }, { c(5), a4 }, { c(3), a2 } };
+        const Term even_high[] = { { c(12), a6 }, { c(10), a4 }, { c(8), a2 } }, even_low[] = { { c(6), a6 }, { c(4), a4 }, { c(2), a2 } };
+        math::matrix::impl::expm_combine<T>(v, false, T(0), odd_high, 3);
+        multiply(x, a6, v);
+        math::matrix::impl::expm_combine<T>(x, true, c(1), odd_low, 3);
+        multiply(u, a, x);
+        math::matrix::impl::expm_combine<T>(v, false, T(0), even_high, 3);
+        multiply(x, a6, v);
+        math::matrix::impl::expm_combine<T>(x, true, c(0), even_low, 3);
+    }
+    else {
+        // Powers A^2 to A^(m - 1) by twos, A^8 of degree 9 held in x.
+        if (m == 9) multiply(x, a6, a2);
+        const MatrixView<const T> powers[] = { a2, a4, a6, x };
+        Term odd[4], even[4];
+        const size_t count = (m - 1) / 2;
+        for (size_t k = 0; k < count; k++) {
+            odd[k] = { c(2 * k + 3), powers[k] };
+            even[k] = { c(2 * k + 2), powers[k] };
+        }
+        math::matrix::impl::expm_combine<T>(v, false, c(1), odd, count);
+        multiply(u, a, v);
+        math::matrix::impl::expm_combine<T>(v, false, c(0), even, count);
+    }
+    // V is in x for degree 13, each element read before V + U is written over it.
+    const MatrixView<const T> even_part = (m == 13) ? MatrixView<const T>(x) : MatrixView<const T>(v);
+    #pragma omp parallel for schedule(static) if((n > expm_parallel_rows) && !omp_in_parallel())
+    for (size_t i = 0; i < n; i++) {
+        T *const p = u.row(i), *const q = x.row(i);
+        const T *const e = even_part.row(i);
+        for (size_t j = 0; j < n; j++) {
+            const T odd = p[j], even = e[j];
+            q[j] = even + odd;
+            p[j] = even - odd;
+        }
+    }
+}
+
+// FLOPs per element of the exponential of order n: the products of the approximant and of the squarings, and the solve.
+_NODISC_ inline size_t expm_flops_per_element(const size_t n, const size_t degree, const size_t squarings) noexcept {
+    constexpr size_t products[] = { 2, 3, 4, 5, 6 };
+    return 2 * n * (products[degree] + squarings) + 8 * n / 3;
+}
+
+// Products of the binary exponentiation to the power exponent, a squaring per bit past the first and a product per other set bit.
+_NODISC_ inline size_t power_products(const size_t exponent) noexcept {
+    return (exponent == 0) ? 0 : static_cast<size_t>(std::bit_width(exponent) + std::popcount(exponent)) - 2;
+}
+
+// c = a * b for the N x N row major a, b and c, c not aliasing them.
+template <math::matrix::GemmScalar T, size_t N>
+inline void power_multiply(const T *const a, const T *const b, T *const c) noexcept {
+    for (size_t i = 0; i < N; i++) {
+        T *const row = c + i * N;
+        for (size_t j = 0; j < N; j++) row[j] = a[i * N] * b[j];
+        for (size_t k = 1; k < N; k++) {
+            const T scale = a[i * N + k];
+            const T *const other = b + k * N;
+            for (size_t j = 0; j < N; j++) row[j] += scale * other[j];
+        }
+    }
+}
+
+/**
+ * @brief out = a^exponent for the N x N row major a by binary exponentiation from the highest set bit down, out never aliasing a.
+ * @note The partial product lives in out and one scratch buffer on the stack, each product goes to the other one and the pointers are swapped,
+ *       a single copy back to out at the end if the product ended up in the scratch.
+*/
+template <math::matrix::GemmScalar T, size_t N>
+inline void power_small(const T *const a, T *const out, const size_t exponent) noexcept {
+    if (exponent == 0) {
+        for (size_t i = 0; i < N * N; i++) out[i] = (i % (N + 1) == 0) ? T(1) : T(0);
+        return;
+    }
+    std::array<T, N * N> scratch;
+    T *result = out, *spare = scratch.data();
+    std::copy_n(a, N * N, result);
+    for (size_t bit = static_cast<size_t>(std::bit_width(exponent)) - 1; bit-- > 0;) {
+        math::matrix::impl::power_multiply<T, N>(result, result, spare);
+        std::swap(result, spare);
+        if ((exponent >> bit) & 1) {
+            math::matrix::impl::power_multiply<T, N>(result, a, spare);
+            std::swap(result, spare);
+        }
+    }
+    if (result != out) std::copy_n(result, N * N, out);
+}
+
+/**
+ * @brief out = exp(a) for the N x N row major a by scaling and squaring of a Padé approximant, like the Matrix one but all on the stack.
+ * @note The approximant's denominator is solved by Gaussian elimination with partial pivoting, out never aliasing a.
+*/
+template <std::floating_point T, size_t N>
+inline void expm_small(const T *const a, T *const out) noexcept {
+    std::array<T, 6 * N * N> storage;
+    std::array<T*, 7 * N> rows;
+    for (size_t b = 0; b < 7; b++)
+        for (size_t i = 0; i < N; i++) rows[b * N + i] = ((b < 6) ? storage.data() + b * N * N : out) + i * N;
+    const auto view = [&rows](size_t b) { return MatrixView<T>(rows.data() + b * N, N, N); };
+    const auto data = [&storage](size_t b) { return storage.data() + b * N * N; };
+    std::copy_n(a, N * N, data(0));
+    size_t squarings = 0;
+    const size_t degree = math::matrix::impl::expm_degree(math::matrix::impl::expm_norm<T>(view(0)), squarings);
+    if (squarings != 0)
+        for (size_t i = 0; i < N * N; i++) data(0)[i] = std::ldexp(data(0)[i], -static_cast<int>(squarings));
+    const auto multiply = [&](MatrixView<T> c, MatrixView<const T> x, MatrixView<const T> y) {
+        math::matrix::impl::power_multiply<T, N>(x.row(0), y.row(0), c.row(0));
+    };
+    math::matrix::impl::expm_pade<T>(view(0), degree, view(1), view(2), view(3), view(4), view(5), view(6), multiply);
+    // (V - U) * X = V + U, V - U in the fifth buffer.
+    T *const p = data(4);
+    for (size_t k = 0; k < N; k++) {
+        size_t pivot = k;
+        for (size_t i = k + 1; i < N; i++)
+            if (std::abs(p[i * N + k]) > std::abs(p[pivot * N + k])) pivot = i;
+        if (pivot != k) {
+            std::swap_ranges(p + k * N, p + (k + 1) * N, p + pivot * N);
+            std::swap_ranges(out + k * N, out + (k + 1) * N, out + pivot * N);
+        }
+        for (size_t i = k + 1; i < N; i++) {
+            const T factor = p[i * N + k] / p[k * N + k];
+            for (size_t j = k; j < N; j++) p[i * N + j] -= factor * p[k * N + j];
+            for (size_t j = 0; j < N; j++) out[i * N + j] -= factor * out[k * N + j];
+        }
+    }
+    for (size_t k = N; k-- > 0; ) {
+        for (size_t i = k + 1; i < N; i++)
+            for (size_t j = 0; j < N; j++) out[k * N + j] -= p[k * N + i] * out[i * N + j];
+        for (size_t j = 0; j < N; j++) out[k * N + j] /= p[k * N + k];
+    }
+    // Squared back, the result bouncing between out and the buffer of A^2.
+    T *current = out, *spare = data(1);
+    for (size_t s = 0; s < squarings; s++) {
+        math::matrix::impl::power_multiply<T, N>(current, current, spare);
+        std::swap(current, spare);
+    }
+    if (current != out) std::copy_n(current, N * N, out);
+}
+}
\ No newline at end of file
@@ -0,0 +1,367 @@
+// Sparse.hpp
+#pragma once
+#include "Gemv.hpp"
+
+namespace math::matrix::impl {
+inline constexpr const size_t sparse_parallel_work = 1 << 15;  // Products over fewer stored elements(times the dense columns) stay on one thread.
+inline constexpr const size_t sparse_sort_majors = 64;         // Rows(or columns) handed out at once when the builder sorts them.
+inline constexpr const size_t spgemm_dense_ratio = 16;         // Product rows with more partial products than a sixteenth of the columns accumulate densely,
+inline constexpr const size_t spgemm_dense_bytes = 1 << 21;    // as long as the dense array(and its stamps) of a thread stays within this many bytes.
+inline constexpr const size_t spgemm_insertion_sort = 32;      // Hashed product rows of at most this many columns are sorted by insertion rather than radix.
+
+/**
+ * @brief First major of part p out of parts of [0, majors), the parts holding about the same work, a stored element or a major counting one each.
+ * @note The offsets already are the prefix sum of the work, so a bound is one binary search however uneven the majors are.
+*/
+template <std::unsigned_integral Index>
+_NODISC_ inline size_t sparse_bound(const Index *const offsets, const size_t majors, const size_t p, const size_t parts) noexcept {
+    if (p >= parts) return majors;
+    const size_t target = (static_cast<size_t>(offsets[majors]) + majors) / parts * p;
+    size_t low = 0, high = majors;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (static_cast<size_t>(offsets[middle]) + middle < target) low = middle + 1;
+        else high = middle;
+    }
+    return low;
+}
+
+// Runs body(first, last) over the parts of sparse_bound, one per thread of the team, or once over all the majors.
+template <std::unsigned_integral Index, typename Body>
+inline void sparse_for_parts(const Index *const offsets, const size_t majors, const bool is_parallel, Body &&body) noexcept {
+    if (!is_parallel) {
+        body(size_t(0), majors);
+        return;
+    }
+    #pragma omp parallel
+    {
+        _TRACE_SPAN_(compute, "sparse_part")
+        const size_t parts = static_cast<size_t>(omp_get_num_threads()), p = static_cast<size_t>(omp_get_thread_num());
+        body(math::matrix::impl::sparse_bound<Index>(offsets, majors, p, parts), math::matrix::impl::sparse_bound<Index>(offsets, majors, p + 1, parts));
+    }
+}
+
+/**
+ * @brief y = alpha * A * x + beta * y for the compressed A whose majors are the elements of y, a gathered dot product per major.
+ * @note A zero beta overwrites y without reading it.
+*/
+template <typename T, std::unsigned_integral Index>
+inline void spmv_gather(const T alpha, const Index *const offsets, const Index *const indices, const T *const values, const size_t majors,
+                        const T *const x, const T beta, T *const y, const bool is_parallel) noexcept {
+    math::matrix::impl::sparse_for_parts<Index>(offsets, majors, is_parallel, [&](const size_t first, const size_t last) noexcept {
+        for (size_t i = first; i < last; i++) {
+            const size_t end = offsets[i + 1];
+            T dot = T(0);
+            #pragma omp simd reduction(+:dot)
+            for (size_t k = offsets[i]; k < end; k++) dot += values[k] * x[indices[k]];
+            y[i] = math::matrix::impl::gemv_blend<T>(alpha, dot, beta, y[i]);
+        }
+    });
+}
+
+/**
+ * @brief y = alpha * A^T * x + beta * y for the compressed A whose majors are the elements of x, every stored element scattered into y.
+ * @param scratch Room for a copy of y per thread of the team when parallel, the copies being summed into y at the end.
+*/
+template <typename T, std::unsigned_integral Index>
+inline void spmv_scatter(const T alpha, const Index *const offsets, const Index *const indices, const T *const values, const size_t majors,
+                         const T *const x, const T beta, T *const y, const size_t out, T *const scratch, const bool is_parallel) noexcept {
+    const auto scatter = [&](T *const target, const size_t first, const size_t last) noexcept {
+        for (size_t j = first; j < last; j++) {
+            const T scale = alpha * x[j];
+            const size_t end = offsets[j + 1];
+            for (size_t k = offsets[j]; k < end; k++) target[indices[k]] += values[k] * scale;
+        }
+    };
+    if (!is_parallel) {
+        for (size_t i = 0; i < out; i++) y[i] = (beta == T(0)) ? T(0) : beta * y[i];
+        scatter(y, 0, majors);
+        return;
+    }
+    #pragma omp parallel
+    {
+        _TRACE_SPAN_(compute, "spmv_scatter")
+        const size_t parts = static_cast<size_t>(omp_get_num_threads()), p = static_cast<size_t>(omp_get_thread_num());
+        T *const own = scratch + p * out;
+        std::fill_n(own, out, T(0));
+        scatter(own, math::matrix::impl::sparse_bound<Index>(offsets, majors, p, parts), math::matrix::impl::sparse_bound<Index>(offsets, majors, p + 1, parts));
+        #pragma omp barrier
+        #pragma omp for schedule(static)
+        for (size_t i = 0; i < out; i++) {
+            T sum = (beta == T(0)) ? T(0) : beta * y[i];
+            for (size_t t = 0; t < parts; t++) sum += scratch[t * out + i];
+            y[i] = sum;
+        }
+    }
+}
+
+/**
+ * @brief c = alpha * A * b + beta * c for the compressed A whose majors are the rows of c, each stored element adding a scaled row of b.
+ * @note The rows of b and c are contiguous, so the inner loop is a vectorised axpy. A zero beta overwrites c without reading it.
+*/
+template <typename T, std::unsigned_integral Index>
+inline void spmm_gather(const T alpha, const Index *const offsets, const Index *const indices, const T *const values, const size_t majors,
+                        const MatrixView<const T> b, const T beta, const MatrixView<T> c, const bool is_parallel) noexcept {
+    const size_t n = c.num_columns();
+    math::matrix::impl::sparse_for_parts<Index>(offsets, majors, is_parallel, [&](const size_t first, const size_t last) noexcept {
+        for (size_t i = first; i < last; i++) {
+            T *const row = c.row(i);
+            if (beta == T(0)) std::fill_n(row, n, T(0));
+            else if (beta != T(1))
+                for (size_t j = 0; j < n; j++) row[j] *= beta;
+            const size_t end = offsets[i + 1];
+            for (size_t k = offsets[i]; k < end; k++) {
+                const T scale = alpha * values[k];
+                const T *const source = b.row(indices[k]);
+                #pragma omp simd
+                for (size_t j = 0; j < n; j++) row[j] += scale * source[j];
+            }
+        }
+    });
+}
+
+/**
+ * @brief The compressed storage of A^T from the one of A(CSR to CSC of the same matrix and back), by a counting sort on the minors.
+ * @param out_offsets minors + 1 elements, out_indices and out_values one per stored element. The minors come out ascending.
+*/
+template <typename T, std::unsigned_integral Index>
+inline void sparse_transpose(const size_t majors, const size_t minors, const Index *const offsets, const Index *const indices, const T *const values,
+                             Index *const out_offsets, Index *const out_indices, T *const out_values) {
+    _TRACE_SPAN_(compute, "sparse_transpose")
+    std::fill_n(out_offsets, minors + 1, Index(0));
+    const size_t count = offsets[majors];
+    for (size_t k = 0; k < count; k++) ++out_offsets[static_cast<size_t>(indices[k]) + 1];
+    for (size_t j = 0; j < minors; j++) out_offsets[j + 1] += out_offsets[j];
+    // out_offsets[j] is the next free slot of minor j while scattering, the end of j once done, shifted back after.
+    for (size_t i = 0; i < majors; i++) {
+        const size_t end = offsets[i + 1];
+        for (size_t k = offsets[i]; k < end; k++) {
+            const size_t at = out_offsets[indices[k]]++;
+            out_indices[at] = static_cast<Index>(i);
+            out_values[at] = values[k];
+        }
+    }
+    for (size_t j = minors; j > 0; j--) out_offsets[j] = out_offsets[j - 1];
+    out_offsets[0] = Index(0);
+}
+
+// Compressed storage of the operands of a sparse product, A by rows and B by rows.
+template <typename T, std::unsigned_integral Index>
+struct SpgemmOperands {
+    const Index *a_offsets, *a_indices;
+    const T *a_values;
+    const Index *b_offsets, *b_indices;
+    const T *b_values;
+};
+
+/**
+ * @brief Per thread accumulator of the rows of a sparse product, picked by row: a dense array of the columns stamped with the row,
+ *        or an open addressing hash table sized to twice the partial products of the row(so cleared in as many steps).
+ * @note The stamps of the numeric pass are offset by the rows, so the dense array is never cleared between the passes.
+*/
+template <typename T, std::unsigned_integral Index>
+struct SpgemmAccumulator {
+    size_t *stamps;
+    T *dense;
+    Index *keys;
+    T *hashed;
+
+    // Marks a free slot of the hash table, spgemm_kernel rejects products whose columns reach it.
+    static constexpr const Index empty = std::numeric_limits<Index>::max();
+
+    // Wider products hash every row, the dense arrays of the team would take threads * columns * (sizeof(size_t) + sizeof(T)) bytes.
+    _NODISC_ static bool is_dense(const size_t products, const size_t columns) noexcept {
+        return (columns <= spgemm_dense_bytes / (sizeof(size_t) + sizeof(T))) && (products * spgemm_dense_ratio >= columns);
+    }
+    // Slots of the hash table of a row, a power of two at least twice its partial products.
+    _NODISC_ static size_t slots(const size_t products) noexcept {
+        return std::bit_ceil(2 * products);
+    }
+    _NODISC_ static size_t hash(const Index column, const size_t mask) noexcept {
+        return static_cast<size_t>((static_cast<std::uint64_t>(column) * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+    }
+    // Slot of column in the table, either holding it or the empty one it goes to.
+    _NODISC_ size_t probe(const Index column, const size_t mask) const noexcept {
+        size_t slot = SpgemmAccumulator::hash(column, mask);
+        while ((keys[slot] != column) && (keys[slot] != empty)) slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    // Distinct columns of row i of A * B.
+    _NODISC_ size_t count(const SpgemmOperands<T, Index> &op, const size_t i, const size_t products, const size_t columns) const noexcept {
+        size_t found = 0;
+        const bool is_dense = SpgemmAccumulator::is_dense(products, columns);
+        const size_t mask = is_dense ? 0 : SpgemmAccumulator::slots(products) - 1;
+        if (!is_dense) std::fill_n(keys, mask + 1, empty);
+        for (size_t k = op.a_offsets[i]; k < op.a_offsets[i + 1]; k++) {
+            const size_t r = op.a_indices[k];
+            const Index *const last = op.b_indices + op.b_offsets[r + 1];
+            for (const Index *column = op.b_indices + op.b_offsets[r]; column != last; ++column) {
+                if (is_dense) {
+                    if (stamps[*column] == i + 1) continue;
+                    stamps[*column] = i + 1;
+                    found++;
+                    continue;
+                }
+                const size_t slot = this->probe(*column, mask);
+                if (keys[slot] != empty) continue;
+                keys[slot] = *column;
+                found++;
+            }
+        }
+        return found;
+    }
+
+    /**
+     * @brief Row i of A * B into its found columns, ascending, and their values, stamp telling the dense array apart from the counting pass.
+     * @note Dense rows come out sorted by a scan of their stamps. Hashed rows are gathered from the table, then sorted by an LSD radix
+     *       sort on the bytes of the columns(insertion sort when short), the table being free by then to hold the other half of each pass.
+    */
+    void fill(const SpgemmOperands<T, Index> &op, const size_t i, const size_t products, const size_t columns, const size_t stamp,
+              Index *const out_columns, T *const out_values, const size_t found) const noexcept {
+        const bool is_dense = SpgemmAccumulator::is_dense(products, columns);
+        const size_t mask = is_dense ? 0 : SpgemmAccumulator::slots(products) - 1;
+        if (!is_dense) std::fill_n(keys, mask + 1, empty);
+        for (size_t k = op.a_offsets[i]; k < op.a_offsets[i + 1]; k++) {
+            const size_t r = op.a_indices[k];
+            const T scale = op.a_values[k];
+            const size_t first = op.b_offsets[r], last = op.b_offsets[r + 1];
+            for (size_t q = first; q < last; q++) {
+                const Index column = op.b_indices[q];
+                const T product = scale * op.b_values[q];
+                if (is_dense) {
+                    if (stamps[column] == stamp) dense[column] += product;
+                    else {
+                        stamps[column] = stamp;
+                        dense[column] = product;
+                    }
+                    continue;
+                }
+                const size_t slot = this->probe(column, mask);
+                if (keys[slot] != empty) hashed[slot] += product;
+                else {
+                    keys[slot] = column;
+                    hashed[slot] = product;
+                }
+            }
+        }
+        size_t at = 0;
+        if (is_dense) {
+            for (size_t j = 0; at < found; j++) {
+                if (stamps[j] != stamp) continue;
+                out_columns[at] = static_cast<Index>(j);
+                out_values[at++] = dense[j];
+            }
+            return;
+        }
+        for (size_t slot = 0; slot <= mask; slot++) {
+            if (keys[slot] == empty) continue;
+            out_columns[at] = keys[slot];
+            out_values[at++] = hashed[slot];
+        }
+        if (found <= spgemm_insertion_sort) {
+            for (size_t q = 1; q < found; q++) {
+                const Index column = out_columns[q];
+                const T value = out_values[q];
+                size_t to = q;
+                for (; (to > 0) && (out_columns[to - 1] > column); to--) {
+                    out_columns[to] = out_columns[to - 1];
+                    out_values[to] = out_values[to - 1];
+                }
+                out_columns[to] = column;
+                out_values[to] = value;
+            }
+            return;
+        }
+        Index *from_columns = out_columns, *to_columns = keys;
+        T *from_values = out_values, *to_values = hashed;
+        const size_t passes = (static_cast<size_t>(std::bit_width(columns - 1)) + 7) / 8;
+        for (size_t pass = 0; pass < passes; pass++) {
+            const size_t shift = 8 * pass;
+            size_t buckets[257] = {};
+            for (size_t q = 0; q < found; q++) buckets[((static_cast<size_t>(from_columns[q]) >> shift) & 255) + 1]++;
+            for (size_t b = 0; b < 256; b++) buckets[b + 1] += buckets[b];
+            for (size_t q = 0; q < found; q++) {
+                const size_t to = buckets[(static_cast<size_t>(from_columns[q]) >> shift) & 255]++;
+                to_columns[to] = from_columns[q];
+                to_values[to] = from_values[q];
+            }
+            std::swap(from_columns, to_columns);
+            std::swap(from_values, to_values);
+        }
+        if (from_columns != out_columns) {
+            std::copy_n(from_columns, found, out_columns);
+            std::copy_n(from_values, found, out_values);
+        }
+    }
+};
+
+/**
+ * @brief Gustavson's row by row sparse product C = A * B of compressed storage, A holding m majors and B n minors, C as A.
+ * @param c_offsets, c_indices, c_values Resized to the exact size of the product.
+ * @throws std::invalid_argument If n columns would reach the empty key of the hash tables, or the stored elements of C don't fit in Index.
+ * @throws std::bad_alloc If the accumulators or C can not be allocated.
+ * @note A symbolic pass counts the distinct columns of every row of C, their prefix sum sizing C exactly before a numeric pass fills it,
+ *       so nothing is over allocated however uneven the rows are. Both passes split the rows over the team into parts of equal partial
+ *       products(plus one per row), each thread owning one accumulator. The columns of every row of C are sorted once filled.
+*/
+template <typename T, std::unsigned_integral Index>
+inline void spgemm_kernel(const size_t m, const size_t n, const SpgemmOperands<T, Index> &op,
+                          std::vector<Index> &c_offsets, std::vector<Index> &c_indices, std::vector<T> &c_values) {
+    _TRACE_SPAN_(compute, "spgemm_kernel")
+    using Accumulator = SpgemmAccumulator<T, Index>;
+    if (n > static_cast<size_t>(Accumulator::empty)) throw std::invalid_argument("Cannot multiply the SparseMatrix objects as the last column of the product is the empty key of the index type.");
+    // Partial products of every row, prefix summed, they are both the work of the partition and the bound of the hash tables.
+    std::vector<size_t> work(m + 1, 0);
+    size_t hash_products = 0;
+    bool any_dense = false;
+    #pragma omp parallel for schedule(static) reduction(max:hash_products) reduction(||:any_dense) if((m >= sparse_parallel_work) && !omp_in_parallel())
+    for (size_t i = 0; i < m; i++) {
+        size_t products = 0;
+        for (size_t k = op.a_offsets[i]; k < op.a_offsets[i + 1]; k++) products += static_cast<size_t>(op.b_offsets[op.a_indices[k] + 1] - op.b_offsets[op.a_indices[k]]);
+        work[i + 1] = products;
+        if (products == 0) continue;
+        if (Accumulator::is_dense(products, n)) any_dense = true;
+        else hash_products = std::max(hash_products, products);
+    }
+    for (size_t i = 0; i < m; i++) work[i + 1] += work[i];
+    _OP_SCOPE_(multiply, work[m], 1, 1)
+    const bool is_parallel = (work[m] >= sparse_parallel_work) && (omp_get_max_threads() > 1) && !omp_in_parallel();
+    const size_t threads = is_parallel ? static_cast<size_t>(omp_get_max_threads()) : 1;
+    const size_t capacity = (hash_products == 0) ? 0 : Accumulator::slots(hash_products), columns = any_dense ? n : 0;
+    std::vector<size_t> stamps(threads * columns, 0);
+    std::vector<T> dense(threads * columns), hashed(threads * capacity);
+    std::vector<Index> keys(threads * capacity);
+    const auto run = [&](auto &&row) noexcept {
+        if (!is_parallel) {
+            const Accumulator own{ stamps.data(), dense.data(), keys.data(), hashed.data() };
+            for (size_t i = 0; i < m; i++)
+                if (work[i + 1] != work[i]) row(own, i);
+            return;
+        }
+        #pragma omp parallel num_threads(threads)
+        {
+            _TRACE_SPAN_(compute, "spgemm_part")
+            const size_t parts = static_cast<size_t>(omp_get_num_threads()), p = static_cast<size_t>(omp_get_thread_num());
+            const Accumulator own{ stamps.data() + p * columns, dense.data() + p * columns, keys.data() + p * capacity, hashed.data() + p * capacity };
+            const size_t last = math::matrix::impl::sparse_bound<size_t>(work.data(), m, p + 1, parts);
+            for (size_t i = math::matrix::impl::sparse_bound<size_t>(work.data(), m, p, parts); i < last; i++)
+                if (work[i + 1] != work[i]) row(own, i);
+        }
+    };
+
+    std::vector<size_t> counts(m + 1, 0);
+    run([&](const Accumulator &own, const size_t i) noexcept {
+        counts[i + 1] = own.count(op, i, work[i + 1] - work[i], n);
+    });
+    for (size_t i = 0; i < m; i++) counts[i + 1] += counts[i];
+    if (counts[m] > std::numeric_limits<Index>::max()) throw std::invalid_argument("Cannot multiply the SparseMatrix objects as the non zero elements of the product don't fit in the index type.");
+    c_offsets.resize(m + 1);
+    for (size_t i = 0; i <= m; i++) c_offsets[i] = static_cast<Index>(counts[i]);
+    c_indices.resize(counts[m]);
+    c_values.resize(counts[m]);
+    run([&](const Accumulator &own, const size_t i) noexcept {
+        own.fill(op, i, work[i + 1] - work[i], n, m + i + 1, c_indices.data() + counts[i], c_values.data() + counts[i], counts[i + 1] - counts[i]);
+    });
+}
+}
\ No newline at end of file
@@ -0,0 +1,280 @@
+// Strassen.hpp
+#pragma once
+#include "../Helper/MatrixUtils.hpp"
+#include "../../Memory/MemoryAlloc.hpp"
+#include "../../Profile/Trace.hpp"
+#include "Gemm.hpp"
+
+namespace math::matrix::impl {
+inline std::atomic<size_t> strassen_crossover{512};
+
+/**
+ * @brief c = a * b with the packed gemm kernel, split over the thread team when called outside of a parallel region.
+ * @note The recursion can't throw from inside its tasks, so without memory for the packing scratch the unpacked kernel takes over.
+*/
+template <std::floating_point T>
+inline void multiply_leaf(const MatrixView<T> c, const MatrixView<const T> a, const MatrixView<const T> b) noexcept {
+    _TRACE_SPAN_(compute, "strassen_leaf")
+    math::matrix::impl::gemm_nothrow<T>(T(1), a, TR::no, b, TR::no, T(0), c, true);
+}
+
+// d(i, j) = f(v(i, j)...) over the whole of d, the operands may alias d.
+template <typename T, typename F, typename ...Views>
+inline void for_each_element(const MatrixView<T> d, const F &f, const Views &...views) noexcept {
+    const size_t n = d.num_columns();
+    for (size_t i = 0; i < d.num_rows(); i++) {
+        T *const out = d.row(i);
+        #pragma omp simd
+        for (size_t j = 0; j < n; j++) out[j] = f(views.row(i)[j]...);
+    }
+}
+
+// Scratch square blocks carved out of one allocation, with their row pointers.
+template <typename T>
+struct StrassenScratch {
+    T *data = nullptr;
+    T **rows = nullptr;
+
+    _NODISC_ MatrixView<T> take(const size_t n) noexcept {
+        for (size_t i = 0; i < n; i++) rows[i] = data + i * n;
+        const MatrixView<T> view(rows, n, n);
+        data += n * n;
+        rows += n;
+        return view;
+    }
+};
+
+struct StrassenScratchSize {
+    size_t elements = 0;
+    size_t rows = 0;
+};
+
+/**
+ * @brief Scratch needed by the recursion on an n x n product.
+ * @param n Size of the product.
+ * @param crossover Size at which the recursion stops.
+ * @param parallel_levels Number of top levels that run their 7 products as tasks(each needing its own blocks).
+*/
+_NODISC_ inline StrassenScratchSize strassen_scratch_size(const size_t n, const size_t crossover, const size_t parallel_levels) noexcept {
+    if (n <= crossover || n < 2) return {};
+    const size_t h = (n & ~static_cast<size_t>(1)) / 2;
+    const StrassenScratchSize child = strassen_scratch_size(h, crossover, parallel_levels == 0 ? 0 : parallel_levels - 1);
+    if (parallel_levels != 0) return StrassenScratchSize{ 11 * h * h + 7 * child.elements, 11 * h + 7 * child.rows };
+    return StrassenScratchSize{ 3 * h * h + child.elements, 3 * h + child.rows };
+}
+
+/**
+ * @brief The last row and column of an odd sized product, on top of the recursion over the even leading block.
+ * @param m Size of the even leading block(n - 1).
+*/
+template <std::floating_point T>
+inline void strassen_peel(const MatrixView<T> c, const MatrixView<const T> a, const MatrixView<const T> b, const size_t m) noexcept {
+    const size_t n = m + 1;
+    const T *const b_last_row = b.row(m);
+    for (size_t i = 0; i < m; i++) {
+        T *const c_row = c.row(i);
+        const T *const a_row = a.row(i);
+        const T a_im = a_row[m];
+        #pragma omp simd
+        for (size_t j = 0; j < m; j++) c_row[j] += a_im * b_last_row[j]; // c11 += a12 * b21
+        T dot = T(0);
+        for (size_t k = 0; k < n; k++) dot += a_row[k] * b.row(k)[m];
+        c_row[m] = dot; // c12 = [A11 a12] * [b12; b22]
+    }
+    T *const c_last_row = c.row(m);
+    const T *const a_last_row = a.row(m);
+    std::fill_n(c_last_row, n, T(0));
+    for (size_t k = 0; k < n; k++) {
+        const T a_mk = a_last_row[k];
+        const T *const b_row = b.row(k);
+        #pragma omp simd
+        for (size_t j = 0; j < n; j++) c_last_row[j] += a_mk * b_row[j]; // [c21 c22] = [a21 a22] * B
+    }
+}
+
+template <std::floating_point T>
+void strassen_node(MatrixView<T> c, MatrixView<const T> a, MatrixView<const T> b, size_t crossover, size_t parallel_levels, StrassenScratch<T> scratch) noexcept;
+
+/**
+ * @brief One Strassen-Winograd level with the schedule of Douglas et al., 3 scratch blocks and C's quadrants hold the 7 products in turn.
+*/
+template <std::floating_point T>
+inline void strassen_sequential_step(const MatrixView<T> c, const MatrixView<const T> a, const MatrixView<const T> b, const size_t h,
+                                     const size_t crossover, StrassenScratch<T> scratch) noexcept {
+    const MatrixView<const T> a11 = a.block(0, 0, h, h), a12 = a.block(0, h, h, h), a21 = a.block(h, 0, h, h), a22 = a.block(h, h, h, h);
+    const MatrixView<const T> b11 = b.block(0, 0, h, h), b12 = b.block(0, h, h, h), b21 = b.block(h, 0, h, h), b22 = b.block(h, h, h, h);
+    const MatrixView<T> c11 = c.block(0, 0, h, h), c12 = c.block(0, h, h, h), c21 = c.block(h, 0, h, h), c22 = c.block(h, h, h, h);
+    const MatrixView<T> x = scratch.take(h), y = scratch.take(h), z = scratch.take(h);
+    const auto add = [](const T u, const T v) noexcept { return u + v; };
+    const auto sub = [](const T u, const T v) noexcept { return u - v; };
+
+    math::matrix::impl::for_each_element(x, sub, a11, a21);                                   // S3 = A11 - A21
+    math::matrix::impl::for_each_element(y, sub, b22, b12);                                   // T3 = B22 - B12
+    math::matrix::impl::strassen_node<T>(c21, x, y, crossover, 0, scratch);                   // P7 = S3 * T3
+    math::matrix::impl::for_each_element(x, add, a21, a22);                                   // S1 = A21 + A22
+    math::matrix::impl::for_each_element(y, sub, b12, b11);                                   // T1 = B12 - B11
+    math::matrix::impl::strassen_node<T>(c22, x, y, crossover, 0, scratch);                   // P5 = S1 * T1
+    math::matrix::impl::for_each_element(x, sub, MatrixView<const T>(x), a11);                // S2 = S1 - A11
+    math::matrix::impl::for_each_element(y, sub, b22, MatrixView<const T>(y));                // T2 = B22 - T1
+    math::matrix::impl::strassen_node<T>(c12, x, y, crossover, 0, scratch);                   // P6 = S2 * T2
+    math::matrix::impl::for_each_element(x, sub, a12, MatrixView<const T>(x));                // S4 = A12 - S2
+    math::matrix::impl::strassen_node<T>(c11, x, b22, crossover, 0, scratch);                 // P3 = S4 * B22
+    math::matrix::impl::strassen_node<T>(z, a11, b11, crossover, 0, scratch);                 // P1 = A11 * B11
+    math::matrix::impl::for_each_element(c12, add, MatrixView<const T>(c12), MatrixView<const T>(z));   // U2 = P1 + P6
+    math::matrix::impl::for_each_element(c21, add, MatrixView<const T>(c21), MatrixView<const T>(c12)); // U3 = U2 + P7
+    math::matrix::impl::for_each_element(c12, add, MatrixView<const T>(c12), MatrixView<const T>(c22)); // U4 = U2 + P5
+    math::matrix::impl::for_each_element(c22, add, MatrixView<const T>(c22), MatrixView<const T>(c21)); // U7 = U3 + P5
+    math::matrix::impl::for_each_element(c12, add, MatrixView<const T>(c12), MatrixView<const T>(c11)); // U5 = U4 + P3
+    math::matrix::impl::for_each_element(y, sub, MatrixView<const T>(y), b21);                // T4 = T2 - B21
+    math::matrix::impl::strassen_node<T>(c11, a22, y, crossover, 0, scratch);                 // P4 = A22 * T4
+    math::matrix::impl::for_each_element(c21, sub, MatrixView<const T>(c21), MatrixView<const T>(c11)); // U6 = U3 - P4
+    math::matrix::impl::strassen_node<T>(c11, a12, b21, crossover, 0, scratch);               // P2 = A12 * B21
+    math::matrix::impl::for_each_element(c11, add, MatrixView<const T>(c11), MatrixView<const T>(z));   // U1 = P1 + P2
+}
+
+/**
+ * @brief One Strassen-Winograd level whose 7 products run as independent tasks, every operand sum is rebuilt from A and B inside its task.
+*/
+template <std::floating_point T>
+inline void strassen_parallel_step(const MatrixView<T> c, const MatrixView<const T> a, const MatrixView<const T> b, const size_t h,
+                                   const size_t crossover, const size_t parallel_levels, StrassenScratch<T> scratch) noexcept {
+    const MatrixView<const T> a11 = a.block(0, 0, h, h), a12 = a.block(0, h, h, h), a21 = a.block(h, 0, h, h), a22 = a.block(h, h, h, h);
+    const MatrixView<const T> b11 = b.block(0, 0, h, h), b12 = b.block(0, h, h, h), b21 = b.block(h, 0, h, h), b22 = b.block(h, h, h, h);
+    const MatrixView<T> c11 = c.block(0, 0, h, h), c12 = c.block(0, h, h, h), c21 = c.block(h, 0, h, h), c22 = c.block(h, h, h, h);
+    const MatrixView<T> p1 = scratch.take(h), p6 = scratch.take(h), p7 = scratch.take(h);
+    const MatrixView<T> s1 = scratch.take(h), s2 = scratch.take(h), s3 = scratch.take(h), s4 = scratch.take(h);
+    const MatrixView<T> t1 = scratch.take(h), t2 = scratch.take(h), t3 = scratch.take(h), t4 = scratch.take(h);
+    const StrassenScratchSize child_size = math::matrix::impl::strassen_scratch_size(h, crossover, parallel_levels - 1);
+    StrassenScratch<T> child[7];
+    for (StrassenScratch<T> &slice : child) {
+        slice = scratch;
+        scratch.data += child_size.elements;
+        scratch.rows += child_size.rows;
+    }
+    const size_t next = parallel_levels - 1;
+
+    #pragma omp task
+    math::matrix::impl::strassen_node<T>(p1, a11, b11, crossover, next, child[0]); // P1 = A11 * B11
+    #pragma omp task
+    math::matrix::impl::strassen_node<T>(c11, a12, b21, crossover, next, child[1]); // P2 = A12 * B21
+    #pragma omp task
+    {
+        math::matrix::impl::for_each_element(s4, [](const T u11, const T u12, const T u21, const T u22) noexcept { return u12 - u21 - u22 + u11; }, a11, a12, a21, a22);
+        math::matrix::impl::strassen_node<T>(c12, s4, b22, crossover, next, child[2]); // P3 = S4 * B22
+    }
+    #pragma omp task
+    {
+        math::matrix::impl::for_each_element(t4, [](const T v11, const T v12, const T v21, const T v22) noexcept { return v22 - v12 + v11 - v21; }, b11, b12, b21, b22);
+        math::matrix::impl::strassen_node<T>(c21, a22, t4, crossover, next, child[3]); // P4 = A22 * T4
+    }
+    #pragma omp task
+    {
+        math::matrix::impl::for_each_element(s1, [](const T u21, const T u22) noexcept { return u21 + u22; }, a21, a22);
+        math::matrix::impl::for_each_element(t1, [](const T v11, const T v12) noexcept { return v12 - v11; }, b11, b12);
+        math::matrix::impl::strassen_node<T>(c22, s1, t1, crossover, next, child[4]); // P5 = S1 * T1
+    }
+    #pragma omp task
+    {
+        math::matrix::impl::for_each_element(s2, [](const T u11, const T u21, const T u22) noexcept { return u21 + u22 - u11; }, a11, a21, a22);
+        math::matrix::impl::for_each_element(t2, [](const T v11, const T v12, const T v22) noexcept { return v22 - v12 + v11; }, b11, b12, b22);
+        math::matrix::impl::strassen_node<T>(p6, s2, t2, crossover, next, child[5]); // P6 = S2 * T2
+    }
+    #pragma omp task
+    {
+        math::matrix::impl::for_each_element(s3, [](const T u11, const T u21) noexcept { return u11 - u21; }, a11, a21);
+        math::matrix::impl::for_each_element(t3, [](const T v12, const T v22) noexcept { return v22 - v12; }, b12, b22);
+        math::matrix::impl::strassen_node<T>(p7, s3, t3, crossover, next, child[6]); // P7 = S3 * T3
+    }
+    #pragma omp taskwait
+
+    _TRACE_SPAN_(reduce, "strassen_combine")
+    #pragma omp taskloop grainsize(16)
+    for (size_t i = 0; i < h; i++) {
+        T *const r11 = c11.row(i), *const r12 = c12.row(i), *const r21 = c21.row(i), *const r22 = c22.row(i);
+        const T *const q1 = p1.row(i), *const q6 = p6.row(i), *const q7 = p7.row(i);
+        #pragma omp simd
+        for (size_t j = 0; j < h; j++) {
+            const T u2 = q1[j] + q6[j], u3 = u2 + q7[j], p5 = r22[j];
+            r11[j] += q1[j];          // U1 = P2 + P1
+            r12[j] += u2 + p5;        // U5 = P3 + U2 + P5
+            r21[j] = u3 - r21[j];     // U6 = U3 - P4
+            r22[j] = u3 + p5;         // U7 = U3 + P5
+        }
+    }
+}
+
+template <std::floating_point T>
+inline void strassen_node(const MatrixView<T> c, const MatrixView<const T> a, const MatrixView<const T> b, const size_t crossover,
+                          const size_t parallel_levels, const StrassenScratch<T> scratch) noexcept {
+    const size_t n = c.num_rows();
+    if (n <= crossover || n < 2) {
+        math::matrix::impl::multiply_leaf<T>(c, a, b);
+        return;
+    }
+    const size_t m = n & ~static_cast<size_t>(1);
+    const size_t h = m / 2;
+    if (parallel_levels != 0) math::matrix::impl::strassen_parallel_step<T>(c, a, b, h, crossover, parallel_levels, scratch);
+    else math::matrix::impl::strassen_sequential_step<T>(c, a, b, h, crossover, scratch);
+    if (m != n) math::matrix::impl::strassen_peel<T>(c, a, b, m); // Peeling, not padding: the recursion only ever sees the even leading block.
+}
+}
+
+namespace math::matrix {
+/**
+ * @brief Setting the size at which the Strassen-Winograd recursion hands over to the gemm kernel.
+ * @param crossover Square products larger than this recurse(Matrix::operator* of floating point matrices included), 0 turns the recursion off.
+*/
+inline void set_strassen_crossover(const size_t crossover) noexcept {
+    impl::strassen_crossover.store(crossover, std::memory_order_relaxed);
+}
+
+_NODISC_ inline size_t strassen_crossover() noexcept {
+    return impl::strassen_crossover.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief c = a * b of square matrices with the Strassen-Winograd recursion(7 products and 15 sums per level), down to blocks of at most crossover rows.
+ * @param c Result, written over.
+ * @param a Left operand, must not alias c.
+ * @param b Right operand, must not alias c.
+ * @param crossover Size at which the recursion hands over to the gemm kernel(at least 1).
+ * @throws std::invalid_argument If the views are not all of the same square size.
+ * @throws std::bad_alloc If the scratch can not be allocated.
+ * @return Whether the product was computed, false(c untouched) if not even one level of scratch fits the memory budget.
+ * @note Up to log7(threads) top levels run their products as OpenMP tasks, if their scratch fits the budget. Below that the scratch is 3 blocks per level(about n^2 elements in all).
+ *       The rounding differs from the classic product, the error bound grows with the number of levels.
+*/
+template <std::floating_point T>
+inline bool strassen_multiply(const MatrixView<T> c, const MatrixView<const T> a, const MatrixView<const T> b, size_t crossover = strassen_crossover()) {
+    const size_t n = c.num_rows();
+    if (!c.is_square() || !a.is_square() || !b.is_square() || a.num_rows() != n || b.num_rows() != n)
+        throw std::invalid_argument("Strassen multiplication needs square matrices of the same size.");
+    crossover = std::max<size_t>(crossover, 1);
+    size_t parallel_levels = 0;
+    for (size_t tasks = 1; tasks < static_cast<size_t>(omp_get_max_threads()) && !omp_in_parallel(); tasks *= 7) ++parallel_levels;
+
+    // Fall back on fewer parallel levels, then on fewer levels, until the scratch fits the budget.
+    impl::StrassenScratchSize size = impl::strassen_scratch_size(n, crossover, parallel_levels);
+    const auto fits = [](const impl::StrassenScratchSize &s) noexcept {
+        return s.elements * sizeof(T) + s.rows * sizeof(T*) <= math::memory::memory_budget_available();
+    };
+    while (!fits(size) && parallel_levels != 0) size = impl::strassen_scratch_size(n, crossover, --parallel_levels);
+    while (!fits(size) && n > crossover) size = impl::strassen_scratch_size(n, crossover *= 2, 0);
+    if (n <= crossover) return false;
+
+    T *data = math::memory::allocate_memory<T>(size.elements);
+    T **rows;
+    try { rows = math::memory::allocate_memory<T*>(size.rows); }
+    catch(...) { math::memory::free_memory(data, 0); throw; }
+    const impl::StrassenScratch<T> scratch{ data, rows };
+    if (parallel_levels != 0) {
+        #pragma omp parallel
+        #pragma omp single
+        impl::strassen_node<T>(c, a, b, crossover, parallel_levels, scratch);
+    }
+    else impl::strassen_node<T>(c, a, b, crossover, 0, scratch);
+    math::memory::free_memory(rows, 0);
+    math::memory::free_memory(data, 0);
+    return true;
+}
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+// Syrk.hpp
+#pragma once
+#include "Gemm.hpp"
+
+namespace math::matrix::impl {
+inline constexpr const size_t syrk_block = 128;    // Rows of the square tiles of c, the unit of work of the team.
+inline constexpr const size_t syrk_diagonal = 16;  // Rows of the small triangles left on the diagonal of a diagonal tile.
+
+// Rows [first, first + count) of op(a) as an operand of gemm(the transposition flag travels separately).
+_MTEMPL_ _NODISC_ inline MatrixView<const T> syrk_rows(const MatrixView<const T> a, const Transpose ta, const size_t first, const size_t count) noexcept {
+    const size_t depth = (ta == TR::no) ? a.num_columns() : a.num_rows();
+    return (ta == TR::no) ? a.block(first, 0, count, depth) : a.block(0, first, depth, count);
+}
+
+/**
+ * @brief The triangle of the size x size diagonal tile of c at (d, d), as rectangles through gemm and syrk_diagonal sized triangles computed in place.
+*/
+_MTEMPL_ inline void syrk_diagonal_tile(const T alpha, const MatrixView<const T> a, const Transpose ta, const T beta, const MatrixView<T> c,
+                                        const Triangle triangle, const size_t d, const size_t size) noexcept {
+    constexpr size_t s = syrk_diagonal;
+    const Transpose tb = (ta == TR::no) ? TR::yes : TR::no;
+    const size_t depth = (ta == TR::no) ? a.num_columns() : a.num_rows();
+    for (size_t r = 0; r < size; r += s) {
+        const size_t rows = std::min(s, size - r), i0 = d + r;
+        const size_t rest = (triangle == TRI::lower) ? r : size - r - rows; // Columns of the rectangle beside the small triangle.
+        if (rest != 0) {
+            const size_t j0 = (triangle == TRI::lower) ? d : i0 + rows;
+            math::matrix::impl::gemm_nothrow<T>(alpha, math::matrix::impl::syrk_rows<T>(a, ta, i0, rows), ta,
+                math::matrix::impl::syrk_rows<T>(a, ta, j0, rest), tb, beta, c.block(i0, j0, rows, rest), false);
+        }
+        T acc[s * s] = {};
+        if (ta == TR::no)
+            for (size_t i = 0; i < rows; i++)
+                for (size_t j = (triangle == TRI::lower) ? 0 : i; j < ((triangle == TRI::lower) ? i + 1 : rows); j++) {
+                    const T *const u = a.row(i0 + i), *const v = a.row(i0 + j);
+                    T dot = T(0);
+                    #pragma omp simd reduction(+:dot)
+                    for (size_t p = 0; p < depth; p++) dot += u[p] * v[p];
+                    acc[i * s + j] = dot;
+                }
+        else
+            for (size_t p = 0; p < depth; p++) {
+                const T *const u = a.row(p) + i0;
+                for (size_t i = 0; i < rows; i++)
+                    for (size_t j = (triangle == TRI::lower) ? 0 : i; j < ((triangle == TRI::lower) ? i + 1 : rows); j++) acc[i * s + j] += u[i] * u[j];
+            }
+        for (size_t i = 0; i < rows; i++) {
+            T *const c_row = c.row(i0 + i) + i0;
+            for (size_t j = (triangle == TRI::lower) ? 0 : i; j < ((triangle == TRI::lower) ? i + 1 : rows); j++)
+                c_row[j] = (beta == T(0)) ? alpha * acc[i * s + j] : beta * c_row[j] + alpha * acc[i * s + j];
+        }
+    }
+}
+
+/**
+ * @brief The chosen triangle of c = alpha * op(a) * op(a)^T + beta * c, sizes already checked.
+ * @note The tiles of the triangle(diagonal ones through syrk_diagonal_tile, the others through gemm) are dealt to the team dynamically.
+*/
+_MTEMPL_ inline void syrk_kernel(const T alpha, const MatrixView<const T> a, const Transpose ta, const T beta, const MatrixView<T> c,
+                                 const Triangle triangle, bool is_parallel) noexcept {
+    const size_t n = c.num_rows();
+    const size_t depth = (ta == TR::no) ? a.num_columns() : a.num_rows();
+    const size_t tiles = (n + syrk_block - 1) / syrk_block;
+    const Transpose tb = (ta == TR::no) ? TR::yes : TR::no;
+    is_parallel = is_parallel && !omp_in_parallel() && (omp_get_max_threads() > 1) && (tiles > 1) && (n * n * depth >= 2 * gemm_parallel_work);
+    #pragma omp parallel for schedule(dynamic) if(is_parallel)
+    for (size_t t = 0; t < tiles * (tiles + 1) / 2; t++) {
+        _TRACE_SPAN_(compute, "syrk_tile")
+        // Tile t of the lower triangle in row major order, mirrored for the upper one.
+        size_t ti = static_cast<size_t>((std::sqrt(8.0 * static_cast<double>(t) + 1.0) - 1.0) / 2.0);
+        while (ti * (ti + 1) / 2 > t) --ti;
+        while ((ti + 1) * (ti + 2) / 2 <= t) ++ti;
+        const size_t tj = t - ti * (ti + 1) / 2;
+        const size_t i0 = ((triangle == TRI::lower) ? ti : tj) * syrk_block, j0 = ((triangle == TRI::lower) ? tj : ti) * syrk_block;
+        const size_t rows = std::min(syrk_block, n - i0), columns = std::min(syrk_block, n - j0);
+        if (i0 == j0) math::matrix::impl::syrk_diagonal_tile<T>(alpha, a, ta, beta, c, triangle, i0, rows);
+        else math::matrix::impl::gemm_nothrow<T>(alpha, math::matrix::impl::syrk_rows<T>(a, ta, i0, rows), ta,
+            math::matrix::impl::syrk_rows<T>(a, ta, j0, columns), tb, beta, c.block(i0, j0, rows, columns), false);
+    }
+}
+
+// Copies the given triangle of the square c over the other one.
+_MTEMPL_ inline void mirror_triangle(const MatrixView<T> c, const Triangle triangle, const bool is_parallel) noexcept {
+    const size_t n = c.num_rows();
+    #pragma omp parallel for schedule(dynamic, 16) if(is_parallel && !omp_in_parallel() && (n >= 512))
+    for (size_t i = 0; i < n; i++) {
+        T *const c_row = c.row(i);
+        if (triangle == TRI::lower) for (size_t j = i + 1; j < n; j++) c_row[j] = c(j, i);
+        else for (size_t j = 0; j < i; j++) c_row[j] = c(j, i);
+    }
+}
+}
+
+namespace math {
+/**
+ * @brief Symmetric rank-k update of one triangle: c = alpha * op(a) * op(a)^T + beta * c, that is a * a^T(ta no) or a^T * a(ta yes).
+ * @param alpha Scale of the product.
+ * @param a The operand, read in place either way.
+ * @param ta Whether op(a) is a or its transpose.
+ * @param beta Scale of the old c, zero overwrites c without reading it.
+ * @param c Square result with a side of the rows of op(a), must not overlap a(T is deduced from it).
+ * @param triangle The triangle computed, the other one is left untouched unless mirrored.
+ * @param mirror Whether to copy the computed triangle over the other one afterwards.
+ * @throws std::invalid_argument If c is not square with a side of the rows of op(a).
+ * @note About half the FLOPs of the full product and no transposed copy. The only allocation is gemm's packing scratch.
+*/
+template <math::matrix::GemmScalar T>
+inline void syrk(const std::type_identity_t<T> alpha, const std::type_identity_t<math::matrix::MatrixView<const T>> a, const math::matrix::Transpose ta,
+                 const std::type_identity_t<T> beta, const math::matrix::MatrixView<T> c, const math::matrix::Triangle triangle, const bool mirror = false) {
+    const size_t n = (ta == math::matrix::TR::no) ? a.num_rows() : a.num_columns();
+    [[maybe_unused]] const size_t depth = (ta == math::matrix::TR::no) ? a.num_columns() : a.num_rows(); // Only counted, _OP_SCOPE_ can be compiled out.
+    if (!c.is_square() || (c.num_rows() != n))
+        throw std::invalid_argument("Cannot compute the symmetric product because c is not square with a side of the rows of op(a).");
+    _OP_SCOPE_(multiply, n, (n + 1) / 2, depth) // Counted as the product with half of c.
+    math::matrix::impl::syrk_kernel<T>(alpha, a, ta, beta, c, triangle, true);
+    if (mirror) math::matrix::impl::mirror_triangle<T>(c, triangle, true);
+}
+}
\ No newline at end of file
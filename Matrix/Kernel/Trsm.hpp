@@ -0,0 +1,230 @@
+// Trsm.hpp
+#pragma once
+#include "Gemm.hpp"
+
+namespace math::matrix::impl {
+inline constexpr const size_t trsm_block = 64;   // Side of the diagonal blocks solved by substitution, the blocks beside them go through gemm.
+inline constexpr const size_t trsm_chunk = 256;  // Right hand sides per unit of work of the team.
+inline constexpr const size_t trsv_block = 256;  // Side of the diagonal blocks of a single vector solve, the blocks beside them go through gemv.
+
+// The rows x columns block of op(a) at (row, column), as an operand of gemm or gemv with the flag ta.
+_MTEMPL_ _NODISC_ inline MatrixView<const T> trsm_operand(const MatrixView<const T> a, const Transpose ta, const size_t row, const size_t column,
+                                                           const size_t rows, const size_t columns) noexcept {
+    return (ta == TR::no) ? a.block(row, column, rows, columns) : a.block(column, row, columns, rows);
+}
+
+// Whether op(a) is lower triangular, the triangle referenced swapping sides with the transposition.
+_NODISC_ inline bool trsm_is_lower(const Triangle triangle, const Transpose ta) noexcept {
+    return (triangle == TRI::lower) != (ta == TR::yes);
+}
+
+/**
+ * @brief b = op(a)^-1 * b for a small diagonal block a, as operations on whole rows of b.
+*/
+_MTEMPL_ inline void trsm_left_unblocked(const MatrixView<const T> a, const Transpose ta, const bool is_lower, const Diagonal diagonal, const MatrixView<T> b) noexcept {
+    const size_t n = a.num_rows(), p = b.num_columns();
+    for (size_t step = 0; step < n; step++) {
+        const size_t i = is_lower ? step : n - 1 - step;
+        T *const r = b.row(i);
+        const size_t q0 = is_lower ? 0 : i + 1, q1 = is_lower ? i : n;
+        for (size_t q = q0; q < q1; q++) {
+            const T f = (ta == TR::no) ? a(i, q) : a(q, i);
+            if (f == T(0)) continue; // Often the case when inverting, the right hand sides start as unit vectors.
+            const T *const u = b.row(q);
+            #pragma omp simd
+            for (size_t c = 0; c < p; c++) r[c] -= f * u[c];
+        }
+        if (diagonal == DG::unit) continue;
+        const T d = a(i, i);
+        #pragma omp simd
+        for (size_t c = 0; c < p; c++) r[c] /= d;
+    }
+}
+
+/**
+ * @brief b = b * op(a)^-1 for a small diagonal block a, every row of b on its own.
+*/
+_MTEMPL_ inline void trsm_right_unblocked(const MatrixView<const T> a, const Transpose ta, const bool is_lower, const Diagonal diagonal, const MatrixView<T> b) noexcept {
+    const size_t n = a.num_rows();
+    for (size_t i = 0; i < b.num_rows(); i++) {
+        T *const x = b.row(i);
+        // Solved upwards for a lower op(a), downwards for an upper one.
+        for (size_t step = 0; step < n; step++) {
+            const size_t q = is_lower ? n - 1 - step : step;
+            if (ta == TR::yes) {
+                // Column q of op(a) is row q of a: x_q is a dot product with the solved part.
+                const size_t p0 = is_lower ? q + 1 : 0, p1 = is_lower ? n : q;
+                const T *const r = a.row(q);
+                T dot = T(0);
+                #pragma omp simd reduction(+:dot)
+                for (size_t p = p0; p < p1; p++) dot += x[p] * r[p];
+                x[q] = (diagonal == DG::unit) ? x[q] - dot : (x[q] - dot) / r[q];
+            }
+            else {
+                // Row q of op(a) is row q of a: x_q is final, it is pushed into the unknowns left to solve.
+                const T *const r = a.row(q);
+                if (diagonal == DG::non_unit) x[q] /= r[q];
+                const T x_q = x[q];
+                const size_t j0 = is_lower ? 0 : q + 1, j1 = is_lower ? q : n;
+                #pragma omp simd
+                for (size_t j = j0; j < j1; j++) x[j] -= x_q * r[j];
+            }
+        }
+    }
+}
+
+/**
+ * @brief b = op(a)^-1 * b by trsm_block rows: every solved block reaches the rows still to solve through gemm.
+*/
+_MTEMPL_ inline void trsm_left(const MatrixView<const T> a, const Transpose ta, const bool is_lower, const Diagonal diagonal, const MatrixView<T> b,
+                               const bool is_parallel) noexcept {
+    const size_t n = a.num_rows(), p = b.num_columns(), blocks = (n + trsm_block - 1) / trsm_block;
+    for (size_t step = 0; step < blocks; step++) {
+        const size_t i0 = (is_lower ? step : blocks - 1 - step) * trsm_block, rows = std::min(trsm_block, n - i0), i_end = i0 + rows;
+        const MatrixView<T> x = b.block(i0, 0, rows, p);
+        math::matrix::impl::trsm_left_unblocked<T>(a.block(i0, i0, rows, rows), ta, is_lower, diagonal, x);
+        if (is_lower && i_end < n)
+            math::matrix::impl::gemm_nothrow<T>(T(-1), math::matrix::impl::trsm_operand<T>(a, ta, i_end, i0, n - i_end, rows), ta, x, TR::no,
+                T(1), b.block(i_end, 0, n - i_end, p), is_parallel);
+        else if (!is_lower && i0 != 0)
+            math::matrix::impl::gemm_nothrow<T>(T(-1), math::matrix::impl::trsm_operand<T>(a, ta, 0, i0, i0, rows), ta, x, TR::no,
+                T(1), b.block(0, 0, i0, p), is_parallel);
+    }
+}
+
+/**
+ * @brief b = b * op(a)^-1 by trsm_block columns: every solved block reaches the columns still to solve through gemm.
+*/
+_MTEMPL_ inline void trsm_right(const MatrixView<const T> a, const Transpose ta, const bool is_lower, const Diagonal diagonal, const MatrixView<T> b,
+                                const bool is_parallel) noexcept {
+    const size_t n = a.num_rows(), m = b.num_rows(), blocks = (n + trsm_block - 1) / trsm_block;
+    for (size_t step = 0; step < blocks; step++) {
+        const size_t j0 = (is_lower ? blocks - 1 - step : step) * trsm_block, columns = std::min(trsm_block, n - j0), j_end = j0 + columns;
+        const MatrixView<T> x = b.block(0, j0, m, columns);
+        math::matrix::impl::trsm_right_unblocked<T>(a.block(j0, j0, columns, columns), ta, is_lower, diagonal, x);
+        if (!is_lower && j_end < n)
+            math::matrix::impl::gemm_nothrow<T>(T(-1), x, TR::no, math::matrix::impl::trsm_operand<T>(a, ta, j0, j_end, columns, n - j_end), ta,
+                T(1), b.block(0, j_end, m, n - j_end), is_parallel);
+        else if (is_lower && j0 != 0)
+            math::matrix::impl::gemm_nothrow<T>(T(-1), x, TR::no, math::matrix::impl::trsm_operand<T>(a, ta, j0, 0, columns, j0), ta,
+                T(1), b.block(0, 0, m, j0), is_parallel);
+    }
+}
+
+/**
+ * @brief b = alpha * op(a)^-1 * b(side left) or alpha * b * op(a)^-1(side right) for a triangular a, sizes already checked.
+ * @note The right hand sides(columns of b on the left, rows on the right) are dealt to the team by trsm_chunk,
+ *       a single chunk keeps the team for its gemm updates instead. No pivot is checked: a zero one yields infinities.
+*/
+_MTEMPL_ inline void trsm_kernel(const T alpha, const MatrixView<const T> a, const Side side, const Triangle triangle, const Transpose ta, const Diagonal diagonal,
+                                 const MatrixView<T> b, bool is_parallel) noexcept {
+    const size_t m = b.num_rows(), p = b.num_columns();
+    if (m == 0 || p == 0) return;
+    const bool is_lower = math::matrix::impl::trsm_is_lower(triangle, ta);
+    const size_t rhs = (side == SD::left) ? p : m, chunks = (rhs + trsm_chunk - 1) / trsm_chunk;
+    is_parallel = is_parallel && !omp_in_parallel() && (omp_get_max_threads() > 1);
+    const bool is_split = is_parallel && (chunks > 1);
+    #pragma omp parallel for schedule(dynamic) if(is_split)
+    for (size_t chunk = 0; chunk < chunks; chunk++) {
+        _TRACE_SPAN_(compute, "trsm_chunk")
+        const size_t first = chunk * trsm_chunk, count = std::min(trsm_chunk, rhs - first);
+        const MatrixView<T> x = (side == SD::left) ? b.block(0, first, m, count) : b.block(first, 0, count, p);
+        if (alpha != T(1))
+            for (size_t i = 0; i < x.num_rows(); i++) {
+                T *const r = x.row(i);
+                #pragma omp simd
+                for (size_t c = 0; c < x.num_columns(); c++) r[c] = (alpha == T(0)) ? T(0) : alpha * r[c];
+            }
+        if (alpha == T(0)) continue;
+        if (side == SD::left) math::matrix::impl::trsm_left<T>(a, ta, is_lower, diagonal, x, is_parallel && !is_split);
+        else math::matrix::impl::trsm_right<T>(a, ta, is_lower, diagonal, x, is_parallel && !is_split);
+    }
+}
+
+/**
+ * @brief x = op(a)^-1 * x for a small diagonal block a and a contiguous x, through dot products or updates along the rows of a.
+*/
+_MTEMPL_ inline void trsv_unblocked(const MatrixView<const T> a, const Transpose ta, const bool is_lower, const Diagonal diagonal, T *const x) noexcept {
+    const size_t n = a.num_rows();
+    for (size_t step = 0; step < n; step++) {
+        const size_t i = is_lower ? step : n - 1 - step;
+        const T *const r = a.row(i);
+        if (ta == TR::no) {
+            // Row i of op(a) is row i of a: x_i is a dot product with the solved part.
+            const size_t q0 = is_lower ? 0 : i + 1, q1 = is_lower ? i : n;
+            T dot = T(0);
+            #pragma omp simd reduction(+:dot)
+            for (size_t q = q0; q < q1; q++) dot += r[q] * x[q];
+            x[i] = (diagonal == DG::unit) ? x[i] - dot : (x[i] - dot) / r[i];
+        }
+        else {
+            // Row i of a is column i of op(a): x_i is final, it is pushed into the unknowns left to solve.
+            if (diagonal == DG::non_unit) x[i] /= r[i];
+            const T x_i = x[i];
+            const size_t q0 = is_lower ? i + 1 : 0, q1 = is_lower ? n : i;
+            #pragma omp simd
+            for (size_t q = q0; q < q1; q++) x[q] -= x_i * r[q];
+        }
+    }
+}
+
+/**
+ * @brief x = op(a)^-1 * x for a triangular a and a contiguous x, sizes already checked, by trsv_block rows updated through gemv.
+*/
+_MTEMPL_ inline void trsv_kernel(const MatrixView<const T> a, const Triangle triangle, const Transpose ta, const Diagonal diagonal, T *const x,
+                                 const bool is_parallel) noexcept {
+    const size_t n = a.num_rows(), blocks = (n + trsv_block - 1) / trsv_block;
+    const bool is_lower = math::matrix::impl::trsm_is_lower(triangle, ta);
+    for (size_t step = 0; step < blocks; step++) {
+        const size_t i0 = (is_lower ? step : blocks - 1 - step) * trsv_block, rows = std::min(trsv_block, n - i0), i_end = i0 + rows;
+        math::matrix::impl::trsv_unblocked<T>(a.block(i0, i0, rows, rows), ta, is_lower, diagonal, x + i0);
+        if (is_lower && i_end < n)
+            math::matrix::impl::gemv_kernel<T>(T(-1), math::matrix::impl::trsm_operand<T>(a, ta, i_end, i0, n - i_end, rows), ta, x + i0,
+                T(1), x + i_end, 1, is_parallel);
+        else if (!is_lower && i0 != 0)
+            math::matrix::impl::gemv_kernel<T>(T(-1), math::matrix::impl::trsm_operand<T>(a, ta, 0, i0, i0, rows), ta, x + i0, T(1), x, 1, is_parallel);
+    }
+}
+}
+
+namespace math {
+/**
+ * @brief Triangular solve with many right hand sides in place: b = alpha * op(a)^-1 * b(side left) or alpha * b * op(a)^-1(side right).
+ * @param alpha Scale of the right hand sides.
+ * @param a Square, only its triangle(and diagonal unless unit) is read.
+ * @param side Whether op(a) stands left or right of the unknowns.
+ * @param triangle The triangle of a referenced.
+ * @param ta Whether op(a) is a or its transpose.
+ * @param diagonal Whether the diagonal of a is read or taken as ones.
+ * @param b The right hand sides, overwritten by the solutions, must not overlap a(T is deduced from it).
+ * @throws std::invalid_argument If a is not square or doesn't match b on its side.
+ * @note Diagonal blocks of trsm_block are solved by substitution and the blocks beside them updated through gemm.
+ *       The right hand sides are split over the team.
+*/
+template <std::floating_point T>
+inline void trsm(const std::type_identity_t<T> alpha, const std::type_identity_t<math::matrix::MatrixView<const T>> a, const math::matrix::Side side,
+                 const math::matrix::Triangle triangle, const math::matrix::Transpose ta, const math::matrix::Diagonal diagonal, const math::matrix::MatrixView<T> b) {
+    if (!a.is_square() || (a.num_rows() != ((side == math::matrix::SD::left) ? b.num_rows() : b.num_columns())))
+        throw std::invalid_argument("Cannot solve the triangular system because a is not square with a side of the rows(left) or columns(right) of b.");
+    _OP_SCOPE_(multiply, b.num_rows(), b.num_columns(), (a.num_rows() + 1) / 2) // Counted as the product with half of a.
+    math::matrix::impl::trsm_kernel<T>(alpha, a, side, triangle, ta, diagonal, b, true);
+}
+
+/**
+ * @brief Triangular solve with a single right hand side in place: x = op(a)^-1 * x.
+ * @param a Square, only its triangle(and diagonal unless unit) is read.
+ * @param triangle The triangle of a referenced.
+ * @param ta Whether op(a) is a or its transpose.
+ * @param diagonal Whether the diagonal of a is read or taken as ones.
+ * @param x Contiguous vector of the rows of a, overwritten by the solution.
+ * @throws std::invalid_argument If a is not square or x doesn't have its rows.
+*/
+template <typename U, typename T = std::remove_const_t<U>> requires std::floating_point<T>
+inline void trsv(const math::matrix::MatrixView<U> a, const math::matrix::Triangle triangle, const math::matrix::Transpose ta,
+                 const math::matrix::Diagonal diagonal, const std::type_identity_t<std::span<T>> x) {
+    if (!a.is_square() || (a.num_rows() != x.size()))
+        throw std::invalid_argument("Cannot solve the triangular system because a is not square with a side of the size of x.");
+    _OP_SCOPE_(multiply, x.size(), 1, (x.size() + 1) / 2)
+    math::matrix::impl::trsv_kernel<T>(a, triangle, ta, diagonal, x.data(), true);
+}
+}
\ No newline at end of file
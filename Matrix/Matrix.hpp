@@ -1,14 +1,24 @@
 // Matrix.hpp
 #pragma once
 
-#include "Helper\MatrixUtils.hpp"
-#include "..\Helper\Helper.hpp"
-#include "..\Memory\TwoDCstrHelper.hpp"
+#include "Helper/MatrixUtils.hpp"
+#include "../Helper/Helper.hpp"
+#include "../Memory/TwoDCstrHelper.hpp"
+#include "../Profile/OpCounters.hpp"
+#include "Kernel/Gemm.hpp"
+#include "Kernel/Syrk.hpp"
+#include "Kernel/Ger.hpp"
+#include "Kernel/Trsm.hpp"
+#include "Kernel/Bareiss.hpp"
+#include "Kernel/Power.hpp"
+#include "Kernel/Strassen.hpp"
 
 #define _ROW_COL_ const size_t row = m_order.row(); const size_t col = m_order.column();
 #define _ORD_ZERO_RET_ if (m_order.is_zero()) return;
 
 namespace math {
+template <std::floating_point T> class LU;
+
 // Make your type no_throw_destructible first.
 _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
     public:
@@ -24,6 +34,15 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
         Matrix(const size_t size) : m_order(order_t(size, size)) {
             _ORD_ZERO_RET_ _ZERO_EXISTS_
             _NO_ZERO_COND_ throw std::logic_error("Cannot construct the Matrix for this type because neither zero value is stored and neither is it default constructible.");
+            _ALLOC_TAG_(construct) _HUGE_PAGE_SCOPE_(m_order.size())
+            if constexpr (std::is_nothrow_copy_constructible_v<T>) if (zero_exists) {
+                m_data = math::memory::allocate_2d_first_touch_fill<T>(size, size, _GET_ZERO_);
+                return;
+            }
+            if constexpr (std::is_nothrow_default_constructible_v<T>) if (!zero_exists) {
+                m_data = math::memory::allocate_2d_first_touch_valcon<T>(size, size);
+                return;
+            }
             m_data = math::memory::allocate_memory<T*>(size);
             if (zero_exists)
                 for (size_t i = 0; i < size; i++) {
@@ -170,6 +189,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
     public:
         Matrix(const order_t &order, const math::matrix::ConstructAllocateRule construct_rule = math::matrix::CAR::zero) : m_order(order) {
             _ORD_ZERO_RET_ _ROW_COL_ _ZERO_EXISTS_
+            _ALLOC_TAG_(construct) _HUGE_PAGE_SCOPE_(m_order.size())
             if (construct_rule == math::matrix::CAR::possible_garbage) {
                 if constexpr (!(std::is_trivially_constructible_v<T> || DfltCtor<T>))
                     if (!zero_exists)
@@ -184,6 +204,10 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
             else {
                 if (!zero_exists)
                     throw std::logic_error("The zero value is not stored of this type in zero_vals hence can't zero construct the Matrix.");
+                if constexpr (std::is_nothrow_copy_constructible_v<T>) {
+                    m_data = math::memory::allocate_2d_first_touch_fill<T>(row, col, _GET_ZERO_);
+                    return;
+                }
                 m_data = math::memory::allocate_memory<T*>(row);
                 for (size_t i = 0; i < row; i++) {
                     math::memory::allocate_mem_2d_safe_continuous<T>(m_data, i, col);
@@ -197,6 +221,11 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
         Matrix(const order_t &order, const T &to_copy)
         requires CpyCtor<T> : m_order(order) {
             _ORD_ZERO_RET_ _ROW_COL_
+            _ALLOC_TAG_(construct) _HUGE_PAGE_SCOPE_(m_order.size())
+            if constexpr (std::is_nothrow_copy_constructible_v<T>) {
+                m_data = math::memory::allocate_2d_first_touch_fill<T>(row, col, to_copy);
+                return;
+            }
             m_data = math::memory::allocate_memory<T*>(row);
             for (size_t i = 0; i < row; i++) {
                 math::memory::allocate_mem_2d_safe_continuous<T>(m_data, i, col);
@@ -480,6 +509,11 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
         Matrix(read_ptr2d<T> data, const order_t &order)
         requires CpyCtor<T> : m_order(order) {
             _ORD_ZERO_RET_ _ROW_COL_
+            _ALLOC_TAG_(construct) _HUGE_PAGE_SCOPE_(m_order.size())
+            if constexpr (std::is_nothrow_copy_constructible_v<T>) {
+                m_data = math::memory::allocate_2d_first_touch_copy<T>(data, row, col);
+                return;
+            }
             m_data = math::memory::allocate_memory<T*>(row);
             for (size_t i = 0; i < row; i++) {
                 math::memory::allocate_mem_2d_safe_continuous<T>(m_data, i, col);
@@ -612,7 +646,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
             _ORD_ZERO_RET_ _ROW_COL_ size_t j;
             m_data = math::memory::allocate_memory<T*>(row);
             for (size_t i = 0; i < row; i++) {
-                math::memory::allocate_mem_2d_safe_continuous<T>(m_data, i, column);
+                math::memory::allocate_mem_2d_safe_continuous<T>(m_data, i, col);
                 if constexpr ( noexcept(t_creation) ) { for (j = 0; j < col; j++) std::construct_at(m_data[i] + j, t_creation(i, j)); }
                 else _TRY_CONSTRUCT_AT_LOOP_(j, (j < col), (j++), m_data[i], t_creation(i, j)) _CATCH_DES_DATA_CONT_(m_data, i, j, col)
             }
@@ -663,11 +697,21 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
             return m_data[row][column];
         }
 
+    public:
+        // How much of the storage got transparent/explicit huge pages(see math::memory::set_huge_page_policy and math::memory::HugePageScope).
+        _NODISC_ math::memory::HugePageReport huge_page_report() const {
+            return math::memory::huge_page_report<T>(m_data, m_order.row(), m_order.column());
+        }
+
     public:
         void swap(Matrix &other) noexcept {
             m_order.swap(other.m_order);
             std::swap(m_data, other.m_data);
         }
+        // Exchanging two rows only swaps their pointers, whatever the number of columns, no bounds are checked.
+        void swap_rows(const size_t first, const size_t second) noexcept {
+            std::swap(m_data[first], m_data[second]);
+        }
 
     public:
         _NODISC_ order_t order() const noexcept {
@@ -698,6 +742,12 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
         read_ptr2d<T> data() const noexcept {
             return m_data;
         }
+        math::matrix::MatrixView<T> view() noexcept {
+            return math::matrix::MatrixView<T>(m_data, m_order.row(), m_order.column());
+        }
+        math::matrix::MatrixView<const T> view() const noexcept {
+            return math::matrix::MatrixView<const T>(m_data, m_order.row(), m_order.column());
+        }
         const_ptr<T> operator[](const size_t row) noexcept {
             return m_data[row];
         }
@@ -758,12 +808,16 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
         Matrix &operator+=(const Matrix &other)
         requires compoundAddition<T> {
             if (!is_same_dimension(other)) throw std::invalid_argument("Cannot add matrices of unequal order parameters.");
-            _ROW_COL_
-            if constexpr ( noexcept( std::declval<std::decay_t<T>>() += std::declval<std::decay_t<T>>() ) ) {
-                #pragma omp parallel for collapse(2) schedule(static)
-                for (size_t i = 0; i < row; i++)
-                    for (size_t j = 0; j < col; j++)
-                        m_data[i][j] += other.m_data[i][j];
+            _ROW_COL_ _ALLOC_TAG_(add) _OP_SCOPE_(add, row, col, 0)
+            if constexpr ( noexcept( std::declval<T&>() += std::declval<const T&>() ) ) {
+                #pragma omp parallel
+                {
+                    _TRACE_SPAN_(compute, "add_tile")
+                    #pragma omp for collapse(2) schedule(static) nowait
+                    for (size_t i = 0; i < row; i++)
+                        for (size_t j = 0; j < col; j++)
+                            m_data[i][j] += other.m_data[i][j];
+                }
             }
             else {
                 T **result;
@@ -795,6 +849,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
 
         _NODISC_ Matrix operator+(const Matrix &other) const
         requires compoundAddition<T> {
+            _ALLOC_TAG_(add) _OP_SCOPE_(add, m_order.row(), m_order.column(), 0)
             Matrix temp(*this);
             temp += other;
             return temp;
@@ -803,12 +858,16 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
         Matrix &operator-=(const Matrix &other)
         requires compoundSubtraction<T> {
             if (!is_same_dimension(other)) throw std::invalid_argument("Cannot subtract matrices of unequal order parameters.");
-            _ROW_COL_
-            if constexpr ( noexcept( std::declval<std::decay_t<T>>() -= std::declval<std::decay_t<T>>() ) ) {
-                #pragma omp parallel for collapse(2) schedule(static)
-                for (size_t i = 0; i < row; i++)
-                    for (size_t j = 0; j < col; j++)
-                        m_data[i][j] -= other.m_data[i][j];
+            _ROW_COL_ _ALLOC_TAG_(subtract) _OP_SCOPE_(subtract, row, col, 0)
+            if constexpr ( noexcept( std::declval<T&>() -= std::declval<const T&>() ) ) {
+                #pragma omp parallel
+                {
+                    _TRACE_SPAN_(compute, "subtract_tile")
+                    #pragma omp for collapse(2) schedule(static) nowait
+                    for (size_t i = 0; i < row; i++)
+                        for (size_t j = 0; j < col; j++)
+                            m_data[i][j] -= other.m_data[i][j];
+                }
             }
             else {
                 T **result;
@@ -840,12 +899,61 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
 
         _NODISC_ Matrix operator-(const Matrix &other) const
         requires compoundSubtraction<T> {
+            _ALLOC_TAG_(subtract) _OP_SCOPE_(subtract, m_order.row(), m_order.column(), 0)
             Matrix temp(*this);
             return (temp -= other);
         }
 
         Matrix &operator*=(const Matrix &other)
         requires compoundMultiplication<T> && compoundAddition<T> {
+            _ALLOC_TAG_(multiply) _OP_SCOPE_(multiply, m_order.row(), other.m_order.column(), m_order.column())
+            if constexpr (math::matrix::GemmScalar<T>) {
+                // When the product doesn't fit the memory budget, multiply in place a panel of rows at a time(rows i of the product only need rows i of *this),
+                // each panel goes through the packed kernel into scratch rows that are then swapped in.
+                const size_t row = m_order.row();
+                const size_t column = m_order.column();
+                const size_t panel_rows = math::memory::budget_fit(row, 1, column * sizeof(T) + sizeof(T*));
+                if ((this != &other) && (other.m_order.row() == column) && (other.m_order.column() == column) && (row != 0) && (column != 0) && (panel_rows < row)) {
+                    Matrix panel;
+                    for (size_t rows = std::max<size_t>(panel_rows, 1);; rows >>= 1) { // budget_fit can't see the rounding of the allocator, halve until the panel fits.
+                        try {
+                            panel = Matrix(rows, column, math::matrix::CAR::possible_garbage);
+                            break;
+                        }
+                        catch(const math::memory::memory_budget_exceeded&) { if (rows == 1) throw; }
+                    }
+                    const size_t rows = panel.m_order.row();
+                    for (size_t i = 0; i < row; i += rows) {
+                        const size_t count = std::min(rows, row - i);
+                        math::matrix::impl::gemm_nothrow<T>(T(1), this->view().block(i, 0, count, column), math::matrix::TR::no, other.view(), math::matrix::TR::no,
+                                                            T(0), panel.view().block(0, 0, count, column), true);
+                        for (size_t r = 0; r < count; r++) std::swap(m_data[i + r], panel.m_data[r]);
+                    }
+                    return *this;
+                }
+            }
+            else if constexpr (noexcept(_DECL_ * _DECL_) && noexcept(std::declval<T&>() += _DECL_) && std::is_nothrow_copy_assignable_v<T> && std::is_nothrow_copy_constructible_v<T>) {
+                // When the product doesn't fit the memory budget but one row does, multiply in place row by row(row i of the product only needs row i of *this).
+                const size_t row = m_order.row();
+                const size_t column = m_order.column();
+                if ((this != &other) && (other.m_order.row() == column) && (other.m_order.column() == column) && (row != 0) && (column != 0) &&
+                    (math::memory::budget_fit(row, 1, column * sizeof(T)) < row)) {
+                    T *scratch = math::memory::allocate_memory<T>(column);
+                    std::uninitialized_copy_n(m_data[0], column, scratch);
+                    for (size_t i = 0; i < row; i++) {
+                        const T *const data = m_data[i];
+                        for (size_t j = 0; j < column; j++) scratch[j] = data[0] * other.m_data[0][j];
+                        for (size_t k = 1; k < column; k++) {
+                            const T &cached = data[k];
+                            const T *const other_cached = other.m_data[k];
+                            for (size_t j = 0; j < column; j++) scratch[j] += cached * other_cached[j];
+                        }
+                        std::swap(m_data[i], scratch);
+                    }
+                    math::memory::free_memory(scratch, column);
+                    return *this;
+                }
+            }
             *this = *this * other;
             return *this;
         }
@@ -858,38 +966,62 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
             const size_t row = m_order.row();
             const size_t column = other.m_order.column();
             const size_t this_column = m_order.column();
-            T *to_transfer = math::memory::allocate_memory<T*>(row);
+            _ALLOC_TAG_(multiply) _HUGE_PAGE_SCOPE_(row * column) _OP_SCOPE_(multiply, row, column, this_column)
+            if constexpr (math::matrix::GemmScalar<T>) {
+                Matrix product(row, column, math::matrix::CAR::possible_garbage); // Both paths write every element(beta = 0 never reads c).
+                if constexpr (std::floating_point<T>) {
+                    // Large square products go through the Strassen-Winograd recursion, unless not even one level of its scratch fits the memory budget.
+                    const size_t crossover = math::matrix::strassen_crossover();
+                    if ((row == column) && (row == this_column) && (crossover != 0) && (row > crossover) &&
+                        math::matrix::strassen_multiply<T>(product.view(), this->view(), other.view(), crossover)) return product;
+                }
+                math::matrix::impl::gemm_kernel<T>(T(1), this->view(), math::matrix::TR::no, other.view(), math::matrix::TR::no, T(0), product.view(), true);
+                return product;
+            }
+            T **to_transfer = math::memory::allocate_memory<T*>(row);
             size_t d = 0;
-            for (size_t i = 0; i < row; i++) {
-                math::memory::allocate_mem_2d_safe_continuous<T>(to_transfer, i, column);
-                const T &cached = m_data[i][0];
-                const T *const cache_data = other.m_data[0];
-                T *const data = to_transfer[i];
-                if constexpr ( noexcept(_DECL_ * _DECL_) ) for (d = 0; d < column; d++) std::construct_at(data + d, cached * cache_data[d]);
-                else _TRY_CONSTRUCT_AT_LOOP_(d, (d < column), (d++), data, cached * cache_data[d]) _CATCH_DES_DATA_CONT_(to_transfer, i, d, column)
+            {
+                _TRACE_SPAN_(allocate, "multiply_allocate") // Serial, every row is allocated and set to the k = 0 term.
+                for (size_t i = 0; i < row; i++) {
+                    math::memory::allocate_mem_2d_safe_continuous<T>(to_transfer, i, column);
+                    const T &cached = m_data[i][0];
+                    const T *const cache_data = other.m_data[0];
+                    T *const data = to_transfer[i];
+                    if constexpr ( noexcept(_DECL_ * _DECL_) ) for (d = 0; d < column; d++) std::construct_at(data + d, cached * cache_data[d]);
+                    else _TRY_CONSTRUCT_AT_LOOP_(d, (d < column), (d++), data, cached * cache_data[d]) _CATCH_DES_DATA_CONT_(to_transfer, i, d, column)
+                }
             }
             // it is fine till here if an exception is called and the destructor of result is called because the order is zero and hence it wouldn't try to free memory.
             std::swap(result.m_data, to_transfer); // m_data was nullptr before this.
             result.m_order = order_t(row, column);
             if (result.is_wide()) {
-                for (size_t i = 0; i < row; i++) {
-                    T *const data = result.m_data[i];
-                    for (size_t k = 1; k < this_column; k++) {
-                        const T &cached = m_data[i][k];
-                        const T *const other_cached = other.m_data[k];
-                        #pragma omp parallel for
-                        for (size_t j = 0; j < column; j++) data[j] += cached * other_cached[j];
+                // Few rows, so the columns are split instead, schedule(static) hands every thread the same columns for each k so nowait is safe.
+                #pragma omp parallel
+                {
+                    _TRACE_SPAN_(compute, "multiply_tile")
+                    for (size_t i = 0; i < row; i++) {
+                        T *const data = result.m_data[i];
+                        for (size_t k = 1; k < this_column; k++) {
+                            const T &cached = m_data[i][k];
+                            const T *const other_cached = other.m_data[k];
+                            #pragma omp for schedule(static) nowait
+                            for (size_t j = 0; j < column; j++) data[j] += cached * other_cached[j];
+                        }
                     }
                 }
             }
             else {
-                #pragma omp parallel for collapse(2)
-                for (size_t i = 0; i < row; i++) {
-                    for (size_t k = 1; k < this_column; k++) {
-                        const T &cached = m_data[i][k];
-                        const T *other_cached = other.m_data[k];
+                #pragma omp parallel
+                {
+                    _TRACE_SPAN_(compute, "multiply_tile")
+                    #pragma omp for schedule(static) nowait // Rows only, each k accumulates into the same row.
+                    for (size_t i = 0; i < row; i++) {
                         T *const data = result.m_data[i];
-                        for (size_t j = 0; j < column; j++) data[j] += cached * other_cached[j];
+                        for (size_t k = 1; k < this_column; k++) {
+                            const T &cached = m_data[i][k];
+                            const T *other_cached = other.m_data[k];
+                            for (size_t j = 0; j < column; j++) data[j] += cached * other_cached[j];
+                        }
                     }
                 }
             }
@@ -945,13 +1077,20 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
             Matrix result;
             if (m_order.is_zero()) return result;
             _ROW_COL_
-            T *to_transfer = math::memory::allocate_memory<T*>(row);
-            size_t j;
-            for (size_t i = 0; i < row; i++) {
-                math::memory::allocate_mem_2d_safe_continuous<T>(to_transfer, i, col);
-                T* data = to_transfer[i];
-                for (j = 0; j < col; j++)
-                    math::memory::mem_2d_safe_construct_at_continuous<T>(data + j, m_data, i, col, m_data[j][i]);
+            _ALLOC_TAG_(transpose) _HUGE_PAGE_SCOPE_(m_order.size()) _OP_SCOPE_(transpose, row, col, 0)
+            T **to_transfer;
+            if constexpr (std::is_nothrow_copy_constructible_v<T>)
+                to_transfer = math::memory::allocate_2d_first_touch<T>(col, row, [this, row](T *data, const size_t i) noexcept {
+                    for (size_t j = 0; j < row; j++) std::construct_at(data + j, m_data[j][i]);
+                });
+            else {
+                to_transfer = math::memory::allocate_memory<T*>(col);
+                for (size_t i = 0; i < col; i++) {
+                    math::memory::allocate_mem_2d_safe_continuous<T>(to_transfer, i, row);
+                    T* data = to_transfer[i];
+                    for (size_t j = 0; j < row; j++)
+                        math::memory::mem_2d_safe_construct_at_continuous<T>(data + j, to_transfer, i, row, m_data[j][i]);
+                }
             }
             std::swap(result.m_data, to_transfer); // Automatically sets to_transfer to nullptr.
             result.m_order = m_order.transpose();
@@ -961,6 +1100,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
         Matrix &transpose_in_place()
         requires (CpyCtor<T> || std::is_nothrow_swappable_v<T>) {
             if (m_order.is_zero()) return *this;
+            _OP_SCOPE_(transpose, m_order.row(), m_order.column(), 0)
             if constexpr (std::is_nothrow_swappable_v<T>) {
                 if (m_order.is_square()) {
                     const size_t size = m_order.row();
@@ -989,6 +1129,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
                 else return T{};
             }
             const size_t size = m_order.row();
+            _OP_SCOPE_(reduction, size, 1, 0)
             if constexpr (CpyCtor<T>) {
                 if (zero_exists) {
                     T result(_GET_ZERO_);
@@ -1042,20 +1183,155 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
         _NODISC_ size_t count(const T &to_find) const
         requires isEqualityOperationPossible<T> {
             size_t result{};
-            _ROW_COL_
-            #pragma omp parallel for collapse(2) schedule(static) reduction(+:result)
-            for (size_t i = 0; i < row; i++)
-                for (size_t j = 0; j < col; j++)
-                    result += is_equal(to_find, m_data[i][j]);
+            _ROW_COL_ _OP_SCOPE_(reduction, row, col, 0)
+            #pragma omp parallel reduction(+:result)
+            {
+                _TRACE_SPAN_(reduce, "count_tile")
+                #pragma omp for collapse(2) schedule(static) nowait
+                for (size_t i = 0; i < row; i++)
+                    for (size_t j = 0; j < col; j++)
+                        result += is_equal(to_find, m_data[i][j]);
+            }
+            return result;
+        }
+
+    public:
+        /**
+         * @brief Determinant of a square Matrix, through the pivoted LU decomposition for floating point T and fraction-free
+         *        Bareiss elimination for signed integers(exact, no division leaves a remainder), both parallel for large sizes.
+         * @throws std::logic_error If the Matrix is not square.
+         * @throws std::overflow_error For integers, if the determinant(or a minor on the way) does not fit in T.
+        */
+        _NODISC_ T determinant() const
+        requires std::floating_point<T> || std::signed_integral<T> {
+            if (!(this->is_square())) throw std::logic_error("Cannot find the determinant of a non square Matrix.");
+            if constexpr (std::floating_point<T>) return math::LU<T>(*this).determinant();
+            else {
+                const size_t size = m_order.row();
+                _OP_SCOPE_(factorize, size, size, size)
+                Matrix work(*this);
+                return math::matrix::impl::bareiss_determinant<T>(work.m_data, size);
+            }
+        }
+
+        /**
+         * @brief Inverse of a square Matrix, through the pivoted LU decomposition for floating point T and fraction-free
+         *        Bareiss(Gauss-Jordan) elimination for signed integers, which yields det * A^-1 exactly.
+         * @throws std::logic_error If the Matrix is not square.
+         * @throws std::domain_error If the Matrix is singular, or for integers if its determinant is not 1 or -1(its inverse is not integral).
+         * @throws std::overflow_error For integers, if a minor on the way does not fit in T.
+        */
+        _NODISC_ Matrix inverse() const
+        requires std::floating_point<T> || std::signed_integral<T> {
+            if (!(this->is_square())) throw std::logic_error("Cannot find the inverse of a non square Matrix.");
+            if constexpr (std::floating_point<T>) return math::LU<T>(*this).inverse();
+            else {
+                const size_t size = m_order.row();
+                _OP_SCOPE_(factorize, size, size, 9 * size / 2)
+                Matrix work(*this), result(size);
+                for (size_t i = 0; i < size; i++) result.m_data[i][i] = T(1);
+                const T determinant = math::matrix::impl::bareiss_gauss_jordan<T>(work.m_data, result.m_data, size, size);
+                if (determinant == T(0)) throw std::domain_error("Cannot find the inverse of a singular Matrix.");
+                if (determinant != T(1) && determinant != T(-1))
+                    throw std::domain_error("Cannot find the inverse of an integer Matrix whose determinant is neither 1 nor -1, as it is not integral.");
+                if (determinant == T(-1)) {
+                    #pragma omp parallel for schedule(static) if((size > math::matrix::impl::bareiss_parallel_rows) && !omp_in_parallel())
+                    for (size_t i = 0; i < size; i++) {
+                        T *const data = result.m_data[i];
+                        for (size_t j = 0; j < size; j++) data[j] = -data[j];
+                    }
+                }
+                return result;
+            }
+        }
+
+        // Replaces the Matrix by its inverse, the LU factors of floating point T are its only copy. Unchanged if it throws(see inverse()).
+        Matrix &inverse_in_place()
+        requires std::floating_point<T> || std::signed_integral<T> {
+            if (!(this->is_square())) throw std::logic_error("Cannot find the inverse of a non square Matrix.");
+            if constexpr (std::floating_point<T>) {
+                const math::LU<T> lu(*this);
+                lu.inverse_into(this->view());
+            }
+            else {
+                Matrix result = this->inverse();
+                this->swap(result);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief The Matrix to the power exponent(the identity for zero) by binary exponentiation, through the same products as operator*.
+         * @note From the highest set bit down, a squaring per bit and a product by the Matrix itself per set bit, bouncing between the result
+         *       and one scratch Matrix(pointer swaps only), so only two matrices of its size are ever allocated.
+         * @throws std::logic_error If the Matrix is not square.
+        */
+        _NODISC_ Matrix pow(const size_t exponent) const
+        requires math::matrix::GemmScalar<T> {
+            if (!(this->is_square())) throw std::logic_error("Cannot raise a non square Matrix to a power.");
+            const size_t size = m_order.row();
+            if (exponent == 0 || size == 0) {
+                Matrix identity(size);
+                for (size_t i = 0; i < size; i++) identity.m_data[i][i] = T(1);
+                return identity;
+            }
+            if (exponent == 1) return *this;
+            _ALLOC_TAG_(multiply) _OP_SCOPE_(multiply, size, size, size * math::matrix::impl::power_products(exponent))
+            Matrix result(*this), spare(size, size, math::matrix::CAR::possible_garbage);
+            for (size_t bit = static_cast<size_t>(std::bit_width(exponent)) - 1; bit-- != 0;) {
+                Matrix::square_product(spare.view(), result.view(), result.view());
+                result.swap(spare);
+                if ((exponent >> bit) & 1) {
+                    Matrix::square_product(spare.view(), result.view(), this->view());
+                    result.swap(spare);
+                }
+            }
             return result;
         }
 
+        /**
+         * @brief The exponential e^A of a square Matrix, by scaling and squaring of a Padé approximant of degree 3 to 13(Higham, 2005).
+         * @note A is scaled by a power of two until the approximant chosen from its norm is accurate to double precision, the approximant
+         *       is solved through the LU decomposition, then squared back bouncing between two matrices. Every product goes through gemm.
+         * @throws std::logic_error If the Matrix is not square.
+         * @throws std::domain_error If the denominator of the approximant is singular, which takes non finite elements.
+        */
+        _NODISC_ Matrix expm() const
+        requires std::floating_point<T> {
+            if (!(this->is_square())) throw std::logic_error("Cannot find the exponential of a non square Matrix.");
+            const size_t size = m_order.row();
+            if (size == 0) return Matrix();
+            size_t squarings = 0;
+            const size_t degree = math::matrix::impl::expm_degree(math::matrix::impl::expm_norm<T>(this->view()), squarings);
+            _ALLOC_TAG_(multiply) _OP_SCOPE_(multiply, size, size, math::matrix::impl::expm_flops_per_element(size, degree, squarings))
+            Matrix a(*this), a2(size, size, math::matrix::CAR::possible_garbage), u(size, size, math::matrix::CAR::possible_garbage),
+                   v(size, size, math::matrix::CAR::possible_garbage), x(size, size, math::matrix::CAR::possible_garbage), a4, a6;
+            if (degree >= 1) a4 = Matrix(size, size, math::matrix::CAR::possible_garbage);
+            if (degree >= 2) a6 = Matrix(size, size, math::matrix::CAR::possible_garbage);
+            if (squarings != 0) {
+                const int exponent = -static_cast<int>(squarings);
+                #pragma omp parallel for schedule(static) if((size > math::matrix::impl::expm_parallel_rows) && !omp_in_parallel())
+                for (size_t i = 0; i < size; i++)
+                    for (size_t j = 0; j < size; j++) a.m_data[i][j] = std::ldexp(a.m_data[i][j], exponent);
+            }
+            const auto multiply = [](math::matrix::MatrixView<T> c, math::matrix::MatrixView<const T> left, math::matrix::MatrixView<const T> right) {
+                Matrix::square_product(c, left, right);
+            };
+            math::matrix::impl::expm_pade<T>(a.view(), degree, a2.view(), a4.view(), a6.view(), u.view(), v.view(), x.view(), multiply);
+            x = math::LU<T>(std::move(u)).solve(x);
+            for (size_t s = 0; s < squarings; s++) {
+                Matrix::square_product(v.view(), x.view(), x.view());
+                x.swap(v);
+            }
+            return x;
+        }
+
     public:
         _NODISC_ bool operator==(const Matrix &other) const {
             if (m_order != other.m_order) return false;
             if (m_order.is_zero()) return true;
             if (this == &other) return true;
-            _ROW_COL_
+            _ROW_COL_ _OP_SCOPE_(compare, row, col, 0)
             for (size_t r = 0; r < row; r++) {
                 const T *const this_cache_data = m_data[r];
                 const T *const other_cache_data = other.m_data[r];
@@ -1071,7 +1347,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
 
     public:
         void shrink_columns_by(const size_t shrink_amount) noexcept {
-            _ROW_COL_
+            _ROW_COL_ _ALLOC_TAG_(shrink)
             if (shrink_amount < col) {
                 const size_t new_num_elements = col - shrink_amount;
                 for (size_t i = 0; i < row; i++) math::memory::reallocate_memory<T>(m_data[i], col, new_num_elements);
@@ -1083,7 +1359,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
         void extend_columns_by(const size_t extend_amount)
         requires CpyCtor<T> || DfltCtor<T> {
             if (extend_amount == 0 || m_order.row() == 0) return;
-            _ZERO_EXISTS_
+            _ZERO_EXISTS_ _ALLOC_TAG_(extend)
             _NO_ZERO_COND_ throw std::logic_error("Cannot extend the columns of this matrix without any arguments provided because the zero value(either being default constructible or a value being stored in zero_vals) (or is not being able to copied if its zero value is stored) for this type does not exist.");
             _ROW_COL_
             const size_t new_col = col + extend_amount;
@@ -1094,7 +1370,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
                 for (size_t i = 0; i < row; i++) {
                     math::memory::reallocate_memory(m_data[i], col, new_col);
                     if constexpr (std::is_nothrow_copy_constructible_v<T>) std::uninitialized_fill_n(m_data[i] + col, extend_amount, zero);
-                    else _TRY_CONSTRUCT_AT_LOOP_(j, (j < extend_amount), (j++), m_data[i], zero) _CATCH_REW_RLC_(m_data, i, col, new_col, j)
+                    else _TRY_CONSTRUCT_AT_LOOP_(j, (j < extend_amount), (j++), (m_data[i] + col), zero) _CATCH_REW_RLC_(m_data, i, col, new_col, j)
                 }
                 m_order.set_column(new_col);
                 return;
@@ -1105,7 +1381,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
                 for (size_t i = 0; i < row; i++) {
                     math::memory::reallocate_memory(m_data[i], col, new_col);
                     if constexpr (std::is_nothrow_default_constructible_v<T>) std::uninitialized_value_construct_n(m_data[i] + col, extend_amount);
-                    else _TRY_CONSTRUCT_AT_LOOP_(j, (j < extend_amount), (j++), m_data[i]) _CATCH_REW_RLC_(m_data, i, col, new_col, j)
+                    else _TRY_CONSTRUCT_AT_LOOP_(j, (j < extend_amount), (j++), (m_data[i] + col)) _CATCH_REW_RLC_(m_data, i, col, new_col, j)
                 }
                 m_order.set_column(new_col);
                 return;
@@ -1114,7 +1390,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
         void extend_columns_by(const size_t extend_amount, const T &copy_val)
         requires CpyCtor<T> {
             if (extend_amount == 0 || m_order.row() == 0) return;
-            _ROW_COL_
+            _ROW_COL_ _ALLOC_TAG_(extend)
             const size_t new_col = col + extend_amount;
             size_t j;
             for (size_t i = 0; i < row; i++) {
@@ -1128,7 +1404,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
     public:
         void shrink_rows_by(const size_t shrink_amount) noexcept {
             if (shrink_amount < m_order.row()) {
-                _ROW_COL_
+                _ROW_COL_ _ALLOC_TAG_(shrink)
                 for (size_t i = row - shrink_amount; i < row; i++) math::memory::free_memory<T>(m_data[i], col);
                 math::memory::reallocate_memory<T*>(m_data, row, row - shrink_amount); // It is better to free the memory first because T* is trivially destructible and would not destroy the memory by itself.
                 m_order.set_row(row - shrink_amount);
@@ -1139,24 +1415,27 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
         void extend_rows_by(const size_t extend_amount) 
         requires CpyCtor<T> || DfltCtor<T> {
             if (extend_amount == 0 || m_order.column() == 0) return;
-            _ZERO_EXISTS_
+            _ZERO_EXISTS_ _ALLOC_TAG_(extend)
             _ROW_COL_
             const size_t new_row = row + extend_amount;
             size_t j;
             _NO_ZERO_COND_ throw std::logic_error("Cannot extend the rows of this matrix without any arguments provided because the zero value(either being default constructible or a value being stored in zero_vals) (or is not being able to copied if its zero value is stored) for this type does not exist.");
             math::memory::reallocate_memory<T*>(m_data, row, new_row);
+            std::fill(m_data + row, m_data + new_row, nullptr);
             for (size_t i = row; i < new_row; i++) {
+                j = 0;
+                try { m_data[i] = math::memory::allocate_memory<T>(col); } _CATCH_REW_RLR_(m_data, i, row, new_row, j, col)
                 if constexpr (CpyCtor<T>) {
                     if (!zero_exists) goto DEFAULT_CASE;
                     const T &zero_val = _GET_ZERO_;
                     if constexpr (std::is_nothrow_copy_constructible_v<T>) std::uninitialized_fill_n(m_data[i], col, zero_val);
-                    else _TRY_CONSTRUCT_AT_LOOP_(j, (j < col), (j++), m_data[i], zero_val) _CATCH_REW_RLR_(m_data, i, row, new_row, col, j)
+                    else _TRY_CONSTRUCT_AT_LOOP_(j, (j < col), (j++), m_data[i], zero_val) _CATCH_REW_RLR_(m_data, i, row, new_row, j, col)
                 }
                 else goto DEFAULT_CASE;
                 continue;
                 DEFAULT_CASE:
                     if constexpr (std::is_nothrow_default_constructible_v<T>) std::uninitialized_value_construct_n(m_data[i], col);
-                    else _TRY_CONSTRUCT_AT_LOOP_(j, (j < col), (j++), m_data[i]) _CATCH_REW_RLR_(m_data, i, row, new_row, col, j)
+                    else _TRY_CONSTRUCT_AT_LOOP_(j, (j < col), (j++), m_data[i]) _CATCH_REW_RLR_(m_data, i, row, new_row, j, col)
             }
             m_order.set_row(new_row);
         }
@@ -1164,13 +1443,16 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
         void extend_rows_by(const size_t extend_amount, const T &copy_val)
         requires CpyCtor<T> {
             if (extend_amount == 0 || m_order.column() == 0) return;
-            _ROW_COL_
+            _ROW_COL_ _ALLOC_TAG_(extend)
             const size_t new_row = row + extend_amount;
             size_t j;
             math::memory::reallocate_memory<T*>(m_data, row, new_row);
+            std::fill(m_data + row, m_data + new_row, nullptr);
             for (size_t i = row; i < new_row; i++) {
+                j = 0;
+                try { m_data[i] = math::memory::allocate_memory<T>(col); } _CATCH_REW_RLR_(m_data, i, row, new_row, j, col)
                 if constexpr (std::is_nothrow_copy_constructible_v<T>) std::uninitialized_fill_n(m_data[i], col, copy_val);
-                else _TRY_CONSTRUCT_AT_LOOP_(j, (j < col), (j++), m_data[i], copy_val) _CATCH_REW_RLR_(m_data, i, row, new_row, col, j)
+                else _TRY_CONSTRUCT_AT_LOOP_(j, (j < col), (j++), m_data[i], copy_val) _CATCH_REW_RLR_(m_data, i, row, new_row, j, col)
             }
             m_order.set_row(new_row);
         }
@@ -1178,7 +1460,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
     public:
         void shrink_by(const size_t row_shrink_amount, const size_t col_shrink_amount) noexcept {
             this->shrink_rows_by(row_shrink_amount);
-            this>shrink_columns_by(col_shrink_amount);
+            this->shrink_columns_by(col_shrink_amount);
         }
 
         void shrink_by(const size_t shrink_amount) noexcept {
@@ -1188,6 +1470,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
     public:
         void extend_by(const size_t row_extend_amount, const size_t col_extend_amount)
         requires DfltCtor<T> || CpyCtor<T> {
+            _ALLOC_TAG_(extend)
             if (!m_order.is_zero()) {
                 this->extend_columns_by(col_extend_amount);
                 try { this->extend_rows_by(row_extend_amount); } catch(...) { this->shrink_columns_by(col_extend_amount); throw; }
@@ -1202,8 +1485,9 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
 
         void extend_by(const size_t row_extend_amount, const size_t col_extend_amount, const T &copy_val)
         requires CpyCtor<T> {
+            _ALLOC_TAG_(extend)
             if (!m_order.is_zero()) {
-                this->extend_columns_by(row_extend_amount, copy_val);
+                this->extend_columns_by(col_extend_amount, copy_val);
                 try { this->extend_rows_by(row_extend_amount, copy_val); } catch(...) { this->shrink_columns_by(col_extend_amount); throw; }
             }
             else *this = Matrix(order_t(row_extend_amount, col_extend_amount), copy_val);
@@ -1216,6 +1500,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
 
         void extend_by(const size_t row_extend_amount, const size_t col_extend_amount, const T &row_extend_val, const T &col_extend_val)
         requires CpyCtor<T> {
+            _ALLOC_TAG_(extend)
             if (!m_order.is_zero()) {
                 this->extend_columns_by(col_extend_amount, col_extend_val);
                 try { this->extend_rows_by(row_extend_amount, row_extend_val); } catch(...) { this->shrink_columns_by(col_extend_amount); throw; }
@@ -1230,24 +1515,30 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
 
         void extend_by(const size_t row_extend_amount, const size_t col_extend_amount, const T &row_extend_val, const T &col_extend_val, const T &common_extend_val)
         requires CpyCtor<T> {
+            _ALLOC_TAG_(extend)
             if (!m_order.is_zero()) {
                 this->extend_columns_by(col_extend_amount, col_extend_val);
                 if (row_extend_amount != 0) try {
                     _ROW_COL_
-                    const size_t new_col = col + col_extend_amount;
+                    const size_t new_col = col; // Columns are already extended.
+                    const size_t old_col = col - col_extend_amount;
                     const size_t new_row = row + row_extend_amount;
                     size_t j;
                     math::memory::reallocate_memory<T*>(m_data, row, new_row);
+                    std::fill(m_data + row, m_data + new_row, nullptr);
                     for (size_t i = row; i < new_row; i++) {
+                        j = 0;
+                        try { m_data[i] = math::memory::allocate_memory<T>(new_col); } _CATCH_REW_RLR_(m_data, i, row, new_row, j, new_col)
                         if constexpr (std::is_nothrow_copy_constructible_v<T>) {
-                            std::uninitialized_fill_n(m_data[i], col, row_extend_val);
-                            std::uninitialized_fill_n(m_data[i] + col, col_extend_amount, common_extend_val);
+                            std::uninitialized_fill_n(m_data[i], old_col, row_extend_val);
+                            std::uninitialized_fill_n(m_data[i] + old_col, col_extend_amount, common_extend_val);
                         }
                         else try {
-                            for (j = 0; j < col; j++) std::construct_at(m_data[i] + j, col_extend_val);
+                            for (j = 0; j < old_col; j++) std::construct_at(m_data[i] + j, row_extend_val);
                             for (; j < new_col; j++) std::construct_at(m_data[i] + j, common_extend_val);
-                        } _CATCH_REW_RLR_(m_data, i, row, new_row, col, j)
+                        } _CATCH_REW_RLR_(m_data, i, row, new_row, j, new_col)
                     }
+                    m_order.set_row(new_row);
                 } catch(...) { this->shrink_columns_by(col_extend_amount); throw; }
             }
             else *this = Matrix(order_t(row_extend_amount, col_extend_amount), row_extend_val);
@@ -1257,6 +1548,102 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix {
         requires CpyCtor<T> {
             this->extend_by(extend_amount, extend_amount, row_extend_val, col_extend_val, common_extend_val);
         }
+
+    private:
+        // c = a * b of square matrices of the same size, through Strassen-Winograd past the crossover for floating point T like operator*.
+        static void square_product(const math::matrix::MatrixView<T> c, const math::matrix::MatrixView<const T> a, const math::matrix::MatrixView<const T> b)
+        requires math::matrix::GemmScalar<T> {
+            if constexpr (std::floating_point<T>) {
+                const size_t crossover = math::matrix::strassen_crossover();
+                if ((crossover != 0) && (c.num_rows() > crossover) && math::matrix::strassen_multiply<T>(c, a, b, crossover)) return;
+            }
+            math::matrix::impl::gemm_kernel<T>(T(1), a, math::matrix::TR::no, b, math::matrix::TR::no, T(0), c, true);
+        }
 };
 
-}
\ No newline at end of file
+/**
+ * @brief c = alpha * op(a) * op(b) + beta * c into an existing Matrix, without allocating a result(see the MatrixView overload).
+ * @throws std::invalid_argument If the sizes don't match or c is a or b.
+*/
+template <math::matrix::GemmScalar T>
+inline void gemm(const std::type_identity_t<T> alpha, const Matrix<T> &a, const math::matrix::Transpose ta, const Matrix<T> &b, const math::matrix::Transpose tb,
+                 const std::type_identity_t<T> beta, Matrix<T> &c) {
+    if ((&c == &a) || (&c == &b)) throw std::invalid_argument("Cannot accumulate the product into one of its own operands.");
+    math::gemm<T>(alpha, a.view(), ta, b.view(), tb, beta, c.view());
+}
+
+/**
+ * @brief y = alpha * op(a) * x + beta * y over contiguous vectors(see the MatrixView overload).
+ * @throws std::invalid_argument If the sizes don't match.
+*/
+template <math::matrix::GemmScalar T>
+inline void gemv(const std::type_identity_t<T> alpha, const Matrix<T> &a, const math::matrix::Transpose ta, const std::type_identity_t<std::span<const T>> x,
+                 const std::type_identity_t<T> beta, const std::type_identity_t<std::span<T>> y) {
+    math::gemv(alpha, a.view(), ta, x, beta, y);
+}
+
+/**
+ * @brief y_v = alpha * op(a) * x_v + beta * y_v for count vectors back to back, a is streamed once(see the MatrixView overload).
+ * @throws std::invalid_argument If the sizes don't match.
+*/
+template <math::matrix::GemmScalar T>
+inline void gemv_batched(const std::type_identity_t<T> alpha, const Matrix<T> &a, const math::matrix::Transpose ta, const std::type_identity_t<std::span<const T>> x,
+                         const std::type_identity_t<T> beta, const std::type_identity_t<std::span<T>> y, const size_t count) {
+    math::gemv_batched(alpha, a.view(), ta, x, beta, y, count);
+}
+
+/**
+ * @brief One triangle of c = alpha * op(a) * op(a)^T + beta * c, mirrored on request(see the MatrixView overload).
+ * @throws std::invalid_argument If c is not square with a side of the rows of op(a), or c is a.
+*/
+template <math::matrix::GemmScalar T>
+inline void syrk(const std::type_identity_t<T> alpha, const Matrix<T> &a, const math::matrix::Transpose ta, const std::type_identity_t<T> beta, Matrix<T> &c,
+                 const math::matrix::Triangle triangle, const bool mirror = false) {
+    if (&c == &a) throw std::invalid_argument("Cannot accumulate the product into one of its own operands.");
+    math::syrk<T>(alpha, a.view(), ta, beta, c.view(), triangle, mirror);
+}
+
+/**
+ * @brief a += alpha * x * y^T in place(see the MatrixView overload).
+ * @throws std::invalid_argument If the sizes don't match.
+*/
+template <math::matrix::GemmScalar T>
+inline void ger(const std::type_identity_t<T> alpha, const std::type_identity_t<std::span<const T>> x, const std::type_identity_t<std::span<const T>> y, Matrix<T> &a) {
+    math::ger<T>(alpha, x, y, a.view());
+}
+
+/**
+ * @brief a += alpha * sum_v x_v * y_v^T in place over count pairs of vectors back to back(see the MatrixView overload).
+ * @throws std::invalid_argument If the sizes don't match.
+*/
+template <math::matrix::GemmScalar T>
+inline void ger_batched(const std::type_identity_t<T> alpha, const std::type_identity_t<std::span<const T>> x, const std::type_identity_t<std::span<const T>> y,
+                        Matrix<T> &a, const size_t count) {
+    math::ger_batched<T>(alpha, x, y, a.view(), count);
+}
+
+/**
+ * @brief b = alpha * op(a)^-1 * b or alpha * b * op(a)^-1 in place for a triangular a(see the MatrixView overload).
+ * @throws std::invalid_argument If the sizes don't match or b is a.
+*/
+template <std::floating_point T>
+inline void trsm(const std::type_identity_t<T> alpha, const Matrix<T> &a, const math::matrix::Side side, const math::matrix::Triangle triangle,
+                 const math::matrix::Transpose ta, const math::matrix::Diagonal diagonal, Matrix<T> &b) {
+    if (&b == &a) throw std::invalid_argument("Cannot solve the triangular system in place of its own matrix.");
+    math::trsm<T>(alpha, a.view(), side, triangle, ta, diagonal, b.view());
+}
+
+/**
+ * @brief x = op(a)^-1 * x in place for a triangular a and a contiguous x(see the MatrixView overload).
+ * @throws std::invalid_argument If the sizes don't match.
+*/
+template <std::floating_point T>
+inline void trsv(const Matrix<T> &a, const math::matrix::Triangle triangle, const math::matrix::Transpose ta, const math::matrix::Diagonal diagonal,
+                 const std::type_identity_t<std::span<T>> x) {
+    math::trsv(a.view(), triangle, ta, diagonal, x);
+}
+
+}
+
+// After the whole Matrix, which it builds upon, for determinant() and inverse() of floating point types.
+#include "Decomposition/LU.hpp"
\ No newline at end of file
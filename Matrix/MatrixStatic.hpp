@@ -1,7 +1,8 @@
 // MatrixStatic.hpp
 #pragma once
 
-#include "..\Helper\Helper.hpp"
+#include "../Helper/Helper.hpp"
+#include "Kernel/Power.hpp"
 
 namespace math {
 _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix2x2 {
@@ -42,7 +43,14 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix2x2 {
             } catch(...) { if constexpr (!TrvDtor<T>) std::destroy_n(m_ptr, i); throw; }
         }
 
-        Matrix2x2(T *data) requires CpyCtor<T> {
+        Matrix2x2(const T &a, const T &b, const T &c, const T &d) requires CpyCtor<T> {
+            const T *const data[4] = { &a, &b, &c, &d };
+            unsigned char i = 0;
+            try { for (; i < 4; i++) std::construct_at(m_ptr + i, *data[i]); }
+            catch(...) { if constexpr (!TrvDtor<T>) std::destroy_n(m_ptr, i); throw; }
+        }
+
+        Matrix2x2(const T *data) requires CpyCtor<T> {
             if constexpr (!std::is_nothrow_copy_constructible_v<T>) {
                 unsigned char i = 0;
                 try { for (; i < 4; i++) std::construct_at(m_ptr + i, data[i]); }
@@ -137,7 +145,7 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix2x2 {
         }
 
     public:
-        _NODISC_ Matrix2x2 square() requires math::isAdditive<T> && math::isMultiplicative<T> { // Assuming commutative-ness.
+        _NODISC_ Matrix2x2 square() const requires math::isAdditive<T> && math::isMultiplicative<T> { // Assuming commutative-ness.
             // Better than normal multiplication as it has 5 multiplication and 3 addition instead of the normal 8 multiplication and 4 addition.
             const T bc = m_ptr[1] * m_ptr[2];
             const T apd = m_ptr[0] + m_ptr[3];
@@ -165,11 +173,31 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix2x2 {
             return *this;
         }
 
-        _NODISC_ T trace() requires math::isAdditive<T> {
+        // The Matrix to the power exponent(the identity for zero) by binary exponentiation over square_in_place, nothing is allocated.
+        _NODISC_ Matrix2x2 pow(size_t exponent) const requires math::isAdditive<T> && math::isMultiplicative<T> && std::constructible_from<T, int> {
+            if (exponent == 0) return Matrix2x2(T(1), T(0), T(0), T(1));
+            Matrix2x2 base(*this);
+            for (; (exponent & 1) == 0; exponent >>= 1) base.square_in_place();
+            Matrix2x2 result(base);
+            while ((exponent >>= 1) != 0) {
+                base.square_in_place();
+                if (exponent & 1) result *= base;
+            }
+            return result;
+        }
+
+        // The exponential e^A by scaling and squaring of a Padé approximant, like Matrix::expm().
+        _NODISC_ Matrix2x2 expm() const requires std::floating_point<T> {
+            T result[4];
+            math::matrix::impl::expm_small<T, 2>(m_ptr, result);
+            return Matrix2x2(static_cast<const T*>(result));
+        }
+
+        _NODISC_ T trace() const requires math::isAdditive<T> {
             return m_ptr[0] + m_ptr[3];
         }
 
-        _NODISC_ T determinant() requires math::isMultiplicative<T> && math::isSubtractible<T> {
+        _NODISC_ T determinant() const requires math::isMultiplicative<T> && math::isSubtractible<T> {
             return m_ptr[0] * m_ptr[3] - m_ptr[1] * m_ptr[2];
         }
 
@@ -189,13 +217,13 @@ _MTEMPL_ requires NothrDtor<T> class _NODISC_ Matrix2x2 {
         }
 
     public:
-        _NODISC_ bool operator==(const Matrix2x2 &other) requires math::isEqualityOperationPossible<T> {
+        _NODISC_ bool operator==(const Matrix2x2 &other) const requires math::isEqualityOperationPossible<T> {
             return  math::is_equal(m_ptr[0], other.m_ptr[0]) &&
                     math::is_equal(m_ptr[1], other.m_ptr[1]) &&
                     math::is_equal(m_ptr[2], other.m_ptr[2]) &&
                     math::is_equal(m_ptr[3], other.m_ptr[3]);
         }
-        _NODISC_ bool operator!=(const Matrix2x2 &other) requires math::isEqualityOperationPossible<T> {
+        _NODISC_ bool operator!=(const Matrix2x2 &other) const requires math::isEqualityOperationPossible<T> {
             return !(*this == other);
         }
 
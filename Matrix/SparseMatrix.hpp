@@ -0,0 +1,459 @@
+// SparseMatrix.hpp
+#pragma once
+#include "Matrix.hpp"
+#include "Kernel/Sparse.hpp"
+
+namespace math::matrix::impl {
+inline constexpr const size_t sparse_parallel_rows = 1024;  // Dense conversions of at least this many rows split them over the team.
+
+/**
+ * @brief Compressed storage of count (major, minor, value) triplets in any order, duplicates summed in the order they were added.
+ * @note The triplets are bucketed by major through a histogram and a scatter with atomic cursors, every bucket is then sorted
+ *       by (minor, position) on its own, so the result does not depend on the schedule. A sum of duplicates is kept even when zero.
+ * @throws std::invalid_argument If the compressed elements don't fit in Index.
+ * @throws std::bad_alloc If the scratch can not be allocated.
+*/
+template <typename T, std::unsigned_integral Index>
+inline void sparse_compress(const size_t majors, const Index *const major_of, const Index *const minor_of, const std::vector<T> &values,
+                            std::vector<Index> &offsets, std::vector<Index> &indices, std::vector<T> &out_values) {
+    _TRACE_SPAN_(compute, "sparse_compress")
+    const size_t count = values.size();
+    const bool is_parallel = (count >= sparse_parallel_work) && !omp_in_parallel();
+    std::vector<size_t> starts(majors + 1, 0);
+    #pragma omp parallel for schedule(static) if(is_parallel)
+    for (size_t e = 0; e < count; e++) std::atomic_ref<size_t>(starts[static_cast<size_t>(major_of[e]) + 1]).fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < majors; i++) starts[i + 1] += starts[i];
+    std::vector<size_t> order(count), cursor(starts.begin(), starts.end() - 1);
+    #pragma omp parallel for schedule(static) if(is_parallel)
+    for (size_t e = 0; e < count; e++) order[std::atomic_ref<size_t>(cursor[major_of[e]]).fetch_add(1, std::memory_order_relaxed)] = e;
+    // Merged elements are first written at the start of their bucket, then packed once the compressed counts are known.
+    std::vector<Index> merged_indices(count);
+    std::vector<T> merged_values(values);
+    std::vector<size_t> kept(majors + 1, 0);
+    #pragma omp parallel for schedule(dynamic, sparse_sort_majors) if(is_parallel)
+    for (size_t i = 0; i < majors; i++) {
+        const auto first = order.begin() + static_cast<std::ptrdiff_t>(starts[i]), last = order.begin() + static_cast<std::ptrdiff_t>(starts[i + 1]);
+        std::sort(first, last, [minor_of](const size_t a, const size_t b) noexcept {
+            return (minor_of[a] != minor_of[b]) ? (minor_of[a] < minor_of[b]) : (a < b);
+        });
+        size_t out = starts[i];
+        for (auto it = first; it != last; out++) {
+            const Index minor = minor_of[*it];
+            T sum = values[*it];
+            for (++it; (it != last) && (minor_of[*it] == minor); ++it) sum += values[*it];
+            merged_indices[out] = minor;
+            merged_values[out] = std::move(sum);
+        }
+        kept[i + 1] = out - starts[i];
+    }
+    for (size_t i = 0; i < majors; i++) kept[i + 1] += kept[i];
+    if (kept[majors] > std::numeric_limits<Index>::max()) throw std::invalid_argument("Cannot build the SparseMatrix as its non zero elements don't fit in the index type.");
+    offsets.resize(majors + 1);
+    for (size_t i = 0; i <= majors; i++) offsets[i] = static_cast<Index>(kept[i]);
+    indices.resize(kept[majors]);
+    out_values.assign(merged_values.begin(), merged_values.begin() + static_cast<std::ptrdiff_t>(kept[majors]));
+    #pragma omp parallel for schedule(static) if(is_parallel)
+    for (size_t i = 0; i < majors; i++) {
+        const size_t from = starts[i], to = kept[i], length = kept[i + 1] - kept[i];
+        std::copy_n(merged_indices.begin() + static_cast<std::ptrdiff_t>(from), length, indices.begin() + static_cast<std::ptrdiff_t>(to));
+        std::copy_n(merged_values.begin() + static_cast<std::ptrdiff_t>(from), length, out_values.begin() + static_cast<std::ptrdiff_t>(to));
+    }
+}
+}
+
+namespace math {
+template <typename T, std::unsigned_integral Index = std::uint32_t> requires NothrDtor<T> && CpyCtor<T> class SparseMatrix;
+
+template <typename T, std::unsigned_integral Index> requires math::matrix::GemmScalar<T>
+inline void spmv(const std::type_identity_t<T> alpha, const SparseMatrix<T, Index> &a, const math::matrix::Transpose ta, const std::type_identity_t<std::span<const T>> x,
+                 const std::type_identity_t<T> beta, const std::type_identity_t<std::span<T>> y);
+template <typename T, std::unsigned_integral Index> requires math::matrix::GemmScalar<T>
+inline void spmm(const std::type_identity_t<T> alpha, const SparseMatrix<T, Index> &a, const math::matrix::Transpose ta, const Matrix<T> &b,
+                 const std::type_identity_t<T> beta, Matrix<T> &c);
+template <typename T, std::unsigned_integral Index> requires math::matrix::GemmScalar<T>
+_NODISC_ inline SparseMatrix<T, Index> spgemm(const SparseMatrix<T, Index> &a, const SparseMatrix<T, Index> &b);
+
+/**
+ * @brief Sparse matrix compressed by rows(CSR) or by columns(CSC): the minor indices and values of every major stored back to back,
+ *        offsets[i] to offsets[i + 1] delimiting major i. The minors of a major are ascending and unique.
+ * @note Elements that are not stored are the zero of the type, the one in math::zero_vals or else the default constructed one, as for Matrix.
+ *       Index bounds the dimensions and the number of stored elements, 32 bits halve the index traffic of the products.
+*/
+template <typename T, std::unsigned_integral Index> requires NothrDtor<T> && CpyCtor<T>
+class _NODISC_ SparseMatrix {
+    public:
+        using index_t = Index;
+        using format_t = matrix::SparseFormat;
+
+    private:
+        std::vector<Index> m_offsets = std::vector<Index>(1, Index(0));
+        std::vector<Index> m_indices;
+        std::vector<T> m_values;
+        size_t m_rows = 0, m_columns = 0;
+        format_t m_format = format_t::csr;
+
+    public:
+        SparseMatrix() = default;
+
+        // All zero, nothing is stored.
+        SparseMatrix(const size_t rows, const size_t columns, const format_t format = format_t::csr) : m_rows(rows), m_columns(columns), m_format(format) {
+            SparseMatrix::check_extent(rows, columns, 0);
+            m_offsets.assign(this->num_majors() + 1, Index(0));
+        }
+
+        /**
+         * @brief Takes over compressed arrays as they are.
+         * @throws std::invalid_argument If offsets don't have one element per major and one more, don't rise from zero to the number of indices
+         *         and values, or the minors of a major are not ascending, unique and within the matrix.
+        */
+        SparseMatrix(const size_t rows, const size_t columns, const format_t format, std::vector<Index> offsets, std::vector<Index> indices, std::vector<T> values)
+            : m_offsets(std::move(offsets)), m_indices(std::move(indices)), m_values(std::move(values)), m_rows(rows), m_columns(columns), m_format(format) {
+            SparseMatrix::check_extent(rows, columns, m_values.size());
+            const size_t majors = this->num_majors(), minors = this->num_minors();
+            if ((m_offsets.size() != majors + 1) || (m_offsets.front() != Index(0)) || (m_offsets.back() != m_indices.size()) || (m_indices.size() != m_values.size()))
+                throw std::invalid_argument("Cannot construct the SparseMatrix as the offsets don't delimit the indices and values of every row(or column).");
+            for (size_t i = 0; i < majors; i++)
+                if (m_offsets[i] > m_offsets[i + 1]) throw std::invalid_argument("Cannot construct the SparseMatrix as its offsets are decreasing.");
+            for (size_t i = 0; i < majors; i++)
+                for (size_t k = m_offsets[i]; k < m_offsets[i + 1]; k++)
+                    if ((m_indices[k] >= minors) || ((k > m_offsets[i]) && (m_indices[k - 1] >= m_indices[k])))
+                        throw std::invalid_argument("Cannot construct the SparseMatrix as the indices of a row(or column) are not ascending, unique and within bounds.");
+        }
+
+        /**
+         * @brief Stores the elements of dense that are not equal to the zero of the type.
+         * @throws std::logic_error If the type has no zero value(stored in zero_vals or default construction).
+         * @throws std::invalid_argument If the dimensions or the number of non zero elements don't fit in Index.
+         * @note Rows are counted, then filled, over the team. CSC goes through the CSR storage and a counting sort.
+        */
+        explicit SparseMatrix(const Matrix<T> &dense, const format_t format = format_t::csr)
+        requires isEqualityOperationPossible<T> : m_rows(dense.num_rows()), m_columns(dense.num_columns()), m_format(format) {
+            _ZERO_EXISTS_
+            _NO_ZERO_COND_ throw std::logic_error("Cannot construct the SparseMatrix for this type because neither zero value is stored and neither is it default constructible.");
+            const T &zero = zero_exists ? _GET_ZERO_ : T{};
+            const size_t row = m_rows, col = m_columns;
+            SparseMatrix::check_extent(row, col, 0);
+            _OP_SCOPE_(compare, row, col, 0)
+            std::vector<size_t> counts(row + 1, 0);
+            #pragma omp parallel for schedule(static) if((row >= math::matrix::impl::sparse_parallel_rows) && !omp_in_parallel())
+            for (size_t i = 0; i < row; i++) {
+                size_t found = 0;
+                for (size_t j = 0; j < col; j++) found += !is_equal(zero, dense(i, j));
+                counts[i + 1] = found;
+            }
+            for (size_t i = 0; i < row; i++) counts[i + 1] += counts[i];
+            SparseMatrix::check_extent(row, col, counts[row]);
+            std::vector<Index> offsets(row + 1), indices(counts[row]);
+            std::vector<T> values(counts[row], zero);
+            for (size_t i = 0; i <= row; i++) offsets[i] = static_cast<Index>(counts[i]);
+            #pragma omp parallel for schedule(static) if((row >= math::matrix::impl::sparse_parallel_rows) && !omp_in_parallel())
+            for (size_t i = 0; i < row; i++) {
+                size_t at = counts[i];
+                for (size_t j = 0; j < col; j++) {
+                    if (is_equal(zero, dense(i, j))) continue;
+                    indices[at] = static_cast<Index>(j);
+                    values[at++] = dense(i, j);
+                }
+            }
+            if (format == format_t::csr) {
+                m_offsets = std::move(offsets);
+                m_indices = std::move(indices);
+                m_values = std::move(values);
+                return;
+            }
+            m_offsets.resize(col + 1);
+            m_indices.resize(counts[row]);
+            m_values.assign(counts[row], zero);
+            math::matrix::impl::sparse_transpose<T, Index>(row, col, offsets.data(), indices.data(), values.data(), m_offsets.data(), m_indices.data(), m_values.data());
+        }
+
+    public:
+        /**
+         * @brief The dense Matrix holding the same elements.
+         * @throws std::logic_error If the type has no zero value(stored in zero_vals or default construction).
+        */
+        _NODISC_ Matrix<T> to_dense() const {
+            Matrix<T> dense(m_rows, m_columns);
+            const size_t majors = this->num_majors();
+            const bool is_csr = m_format == format_t::csr;
+            // Majors own disjoint elements whether they are rows or columns.
+            #pragma omp parallel for schedule(static) if((majors >= math::matrix::impl::sparse_parallel_rows) && !omp_in_parallel())
+            for (size_t i = 0; i < majors; i++)
+                for (size_t k = m_offsets[i]; k < m_offsets[i + 1]; k++) {
+                    if (is_csr) dense(i, m_indices[k]) = m_values[k];
+                    else dense(m_indices[k], i) = m_values[k];
+                }
+            return dense;
+        }
+
+        // The same matrix stored in format, recompressed through a counting sort when the format changes.
+        _NODISC_ SparseMatrix converted(const format_t format) const {
+            if (format == m_format) return *this;
+            SparseMatrix result;
+            result.m_rows = m_rows;
+            result.m_columns = m_columns;
+            result.m_format = format;
+            result.m_offsets.resize(this->num_minors() + 1);
+            result.m_indices.resize(m_indices.size());
+            result.m_values = m_values;
+            math::matrix::impl::sparse_transpose<T, Index>(this->num_majors(), this->num_minors(), m_offsets.data(), m_indices.data(), m_values.data(),
+                                                           result.m_offsets.data(), result.m_indices.data(), result.m_values.data());
+            return result;
+        }
+
+        // The CSR storage of a matrix is the CSC storage of its transpose, so transposing only swaps the dimensions and the format.
+        _NODISC_ SparseMatrix transpose() const {
+            SparseMatrix result(*this);
+            result.transpose_in_place();
+            return result;
+        }
+        void transpose_in_place() noexcept {
+            std::swap(m_rows, m_columns);
+            m_format = (m_format == format_t::csr) ? format_t::csc : format_t::csr;
+        }
+
+        void swap(SparseMatrix &other) noexcept {
+            m_offsets.swap(other.m_offsets);
+            m_indices.swap(other.m_indices);
+            m_values.swap(other.m_values);
+            std::swap(m_rows, other.m_rows);
+            std::swap(m_columns, other.m_columns);
+            std::swap(m_format, other.m_format);
+        }
+
+    public:
+        /**
+         * @brief Element at (row, column), a binary search among the stored minors of its major, no bounds are checked.
+         * @throws std::logic_error If the element is not stored and the type has no zero value.
+        */
+        _NODISC_ T operator()(const size_t row, const size_t column) const {
+            const size_t major = (m_format == format_t::csr) ? row : column, minor = (m_format == format_t::csr) ? column : row;
+            const auto first = m_indices.begin() + static_cast<std::ptrdiff_t>(m_offsets[major]), last = m_indices.begin() + static_cast<std::ptrdiff_t>(m_offsets[major + 1]);
+            const auto found = std::lower_bound(first, last, static_cast<Index>(minor));
+            if ((found != last) && (*found == minor)) return m_values[static_cast<size_t>(found - m_indices.begin())];
+            _ZERO_EXISTS_
+            _NO_ZERO_COND_ throw std::logic_error("Cannot read an element that is not stored as the zero value(stored in zero_vals or defautlt construction for the type) is not defined.");
+            return zero_exists ? _GET_ZERO_ : T{};
+        }
+        _NODISC_ T at(const size_t row, const size_t column) const {
+            if ((row >= m_rows) || (column >= m_columns)) throw std::out_of_range("Provided index does not exist within the bounds of this SparseMatrix.");
+            return (*this)(row, column);
+        }
+
+        /**
+         * @brief Sparse-dense product op(this) * b.
+         * @throws std::invalid_argument If the columns of op(this) are not the rows of b.
+        */
+        _NODISC_ Matrix<T> operator*(const Matrix<T> &b) const
+        requires math::matrix::GemmScalar<T> {
+            Matrix<T> product(m_rows, b.num_columns(), math::matrix::CAR::possible_garbage);
+            math::spmm<T, Index>(T(1), *this, math::matrix::TR::no, b, T(0), product);
+            return product;
+        }
+
+        /**
+         * @brief Sparse-sparse product, in the format of this.
+         * @throws std::invalid_argument If the columns of this are not the rows of b, or the stored elements of the product don't fit in Index.
+        */
+        _NODISC_ SparseMatrix operator*(const SparseMatrix &b) const
+        requires math::matrix::GemmScalar<T> {
+            return math::spgemm<T, Index>(*this, b);
+        }
+
+        // Sparse matrix-vector product, the vector holding the columns of this.
+        template <typename V>
+        requires std::convertible_to<const V&, std::span<const T>> && (!std::same_as<V, Matrix<T>>) && math::matrix::GemmScalar<T>
+        _NODISC_ std::vector<T> operator*(const V &vector) const {
+            std::vector<T> product(m_rows);
+            math::spmv<T, Index>(T(1), *this, math::matrix::TR::no, vector, T(0), product);
+            return product;
+        }
+
+    public:
+        _NODISC_ size_t num_rows() const noexcept {
+            return m_rows;
+        }
+        _NODISC_ size_t num_columns() const noexcept {
+            return m_columns;
+        }
+        _NODISC_ size_t non_zeros() const noexcept {
+            return m_values.size();
+        }
+        _NODISC_ format_t format() const noexcept {
+            return m_format;
+        }
+        // Rows for CSR, columns for CSC.
+        _NODISC_ size_t num_majors() const noexcept {
+            return (m_format == format_t::csr) ? m_rows : m_columns;
+        }
+        _NODISC_ size_t num_minors() const noexcept {
+            return (m_format == format_t::csr) ? m_columns : m_rows;
+        }
+
+        _NODISC_ std::span<const Index> offsets() const noexcept {
+            return m_offsets;
+        }
+        _NODISC_ std::span<const Index> indices() const noexcept {
+            return m_indices;
+        }
+        _NODISC_ std::span<const T> values() const noexcept {
+            return m_values;
+        }
+        // Stored values may be changed in place, the pattern may not.
+        _NODISC_ std::span<T> values() noexcept {
+            return m_values;
+        }
+
+    private:
+        static void check_extent(const size_t rows, const size_t columns, const size_t count) {
+            constexpr size_t limit = std::numeric_limits<Index>::max();
+            if ((rows > limit) || (columns > limit) || (count > limit))
+                throw std::invalid_argument("Cannot index the SparseMatrix with its index type as a dimension or the number of non zero elements doesn't fit in it.");
+        }
+};
+
+/**
+ * @brief Collects (row, column, value) triplets in any order and compresses them into a SparseMatrix, duplicates being summed.
+ * @note Holds Index sized coordinates, so a triplet of doubles takes 16 bytes with the default 32 bit Index.
+*/
+template <typename T, std::unsigned_integral Index = std::uint32_t> requires NothrDtor<T> && CpyCtor<T>
+class _NODISC_ SparseBuilder {
+    private:
+        std::vector<Index> m_row_of, m_column_of;
+        std::vector<T> m_values;
+        size_t m_rows = 0, m_columns = 0;
+
+    public:
+        /**
+         * @throws std::invalid_argument If a dimension doesn't fit in Index.
+        */
+        SparseBuilder(const size_t rows, const size_t columns) : m_rows(rows), m_columns(columns) {
+            constexpr size_t limit = std::numeric_limits<Index>::max();
+            if ((rows > limit) || (columns > limit)) throw std::invalid_argument("Cannot index the SparseBuilder with its index type as a dimension doesn't fit in it.");
+        }
+
+        void reserve(const size_t count) {
+            m_row_of.reserve(count);
+            m_column_of.reserve(count);
+            m_values.reserve(count);
+        }
+
+        /**
+         * @throws std::out_of_range If (row, column) is not within the matrix.
+        */
+        void add(const size_t row, const size_t column, const T &value) {
+            if ((row >= m_rows) || (column >= m_columns)) throw std::out_of_range("Provided index does not exist within the bounds of this SparseBuilder.");
+            m_row_of.push_back(static_cast<Index>(row));
+            m_column_of.push_back(static_cast<Index>(column));
+            m_values.push_back(value);
+        }
+
+        void clear() noexcept {
+            m_row_of.clear();
+            m_column_of.clear();
+            m_values.clear();
+        }
+
+        // Number of triplets added, duplicates included.
+        _NODISC_ size_t size() const noexcept {
+            return m_values.size();
+        }
+
+        /**
+         * @brief The SparseMatrix of the triplets in format, duplicates summed in the order they were added, the builder is left as it is.
+         * @throws std::invalid_argument If the merged elements don't fit in Index.
+         * @throws std::bad_alloc If the scratch can not be allocated.
+         * @note Bucketing and sorting run over the team, each row(or column) being sorted on its own.
+        */
+        _NODISC_ SparseMatrix<T, Index> build(const matrix::SparseFormat format = matrix::SF::csr) const
+        requires compoundAddition<T> {
+            const bool is_csr = format == matrix::SF::csr;
+            std::vector<Index> offsets, indices;
+            std::vector<T> values;
+            math::matrix::impl::sparse_compress<T, Index>(is_csr ? m_rows : m_columns, is_csr ? m_row_of.data() : m_column_of.data(),
+                                                          is_csr ? m_column_of.data() : m_row_of.data(), m_values, offsets, indices, values);
+            return SparseMatrix<T, Index>(m_rows, m_columns, format, std::move(offsets), std::move(indices), std::move(values));
+        }
+};
+
+/**
+ * @brief Sparse matrix-vector product accumulated into caller owned storage: y = alpha * op(a) * x + beta * y.
+ * @param alpha Scale of the product.
+ * @param a The sparse matrix, read in place in either format when transposed.
+ * @param ta Whether op(a) is a or its transpose.
+ * @param x Contiguous vector of the columns of op(a).
+ * @param beta Scale of the old y, zero overwrites y without reading it.
+ * @param y Contiguous vector of the rows of op(a), must not overlap x.
+ * @throws std::invalid_argument If the sizes don't match.
+ * @throws std::bad_alloc If the per thread copies of y can not be allocated.
+ * @note When the majors of a are the rows of op(a)(CSR, or CSC transposed) every element of y is a vectorised gathered dot product,
+ *       the majors being split over the team into parts of equal stored elements, so a few dense rows don't leave threads idle.
+ *       Otherwise a is scattered into a copy of y per thread, summed at the end.
+*/
+template <typename T, std::unsigned_integral Index> requires math::matrix::GemmScalar<T>
+inline void spmv(const std::type_identity_t<T> alpha, const SparseMatrix<T, Index> &a, const math::matrix::Transpose ta, const std::type_identity_t<std::span<const T>> x,
+                 const std::type_identity_t<T> beta, const std::type_identity_t<std::span<T>> y) {
+    const bool is_no = ta == math::matrix::TR::no;
+    if ((x.size() != (is_no ? a.num_columns() : a.num_rows())) || (y.size() != (is_no ? a.num_rows() : a.num_columns())))
+        throw std::invalid_argument("Cannot multiply the SparseMatrix by the vector because x doesn't hold the columns and y the rows of op(a).");
+    _OP_SCOPE_(multiply, a.non_zeros(), 1, 1)
+    const bool is_parallel = (a.non_zeros() >= math::matrix::impl::sparse_parallel_work) && (omp_get_max_threads() > 1) && !omp_in_parallel();
+    const Index *const offsets = a.offsets().data(), *const indices = a.indices().data();
+    const T *const values = a.values().data();
+    if ((a.format() == math::matrix::SF::csr) == is_no) {
+        math::matrix::impl::spmv_gather<T, Index>(alpha, offsets, indices, values, a.num_majors(), x.data(), beta, y.data(), is_parallel);
+        return;
+    }
+    std::vector<T> scratch(is_parallel ? static_cast<size_t>(omp_get_max_threads()) * y.size() : 0);
+    math::matrix::impl::spmv_scatter<T, Index>(alpha, offsets, indices, values, a.num_majors(), x.data(), beta, y.data(), y.size(), scratch.data(), is_parallel);
+}
+
+/**
+ * @brief Sparse-dense product accumulated into caller owned storage: c = alpha * op(a) * b + beta * c.
+ * @param b Dense Matrix of the columns of op(a) rows.
+ * @param beta Scale of the old c, zero overwrites c without reading it.
+ * @param c Dense Matrix of the rows of op(a) rows and the columns of b, must not be b.
+ * @throws std::invalid_argument If the sizes don't match or c is b.
+ * @throws std::bad_alloc If a has to be recompressed and the copy can not be allocated.
+ * @note Each stored element adds a scaled row of b to a row of c, a vectorised axpy, the rows of c being split over the team into parts of
+ *       equal stored elements. When the majors of a are not the rows of op(a) it is recompressed in the other format first, O(nnz).
+*/
+template <typename T, std::unsigned_integral Index> requires math::matrix::GemmScalar<T>
+inline void spmm(const std::type_identity_t<T> alpha, const SparseMatrix<T, Index> &a, const math::matrix::Transpose ta, const Matrix<T> &b,
+                 const std::type_identity_t<T> beta, Matrix<T> &c) {
+    const bool is_no = ta == math::matrix::TR::no;
+    if ((b.num_rows() != (is_no ? a.num_columns() : a.num_rows())) || (c.num_rows() != (is_no ? a.num_rows() : a.num_columns())) || (c.num_columns() != b.num_columns()))
+        throw std::invalid_argument("Cannot multiply the SparseMatrix by the Matrix because b doesn't hold the columns and c the rows of op(a) with the columns of b.");
+    if (&b == &c) throw std::invalid_argument("Cannot multiply the SparseMatrix by the Matrix into the same Matrix.");
+    _OP_SCOPE_(multiply, a.non_zeros(), b.num_columns(), 1)
+    const bool is_parallel = (a.non_zeros() * std::max<size_t>(b.num_columns(), 1) >= math::matrix::impl::sparse_parallel_work) && (omp_get_max_threads() > 1) && !omp_in_parallel();
+    const auto gather = [&](const SparseMatrix<T, Index> &s) noexcept {
+        math::matrix::impl::spmm_gather<T, Index>(alpha, s.offsets().data(), s.indices().data(), s.values().data(), s.num_majors(), b.view(), beta, c.view(), is_parallel);
+    };
+    if ((a.format() == math::matrix::SF::csr) == is_no) gather(a);
+    else gather(a.converted((a.format() == math::matrix::SF::csr) ? math::matrix::SF::csc : math::matrix::SF::csr));
+}
+
+/**
+ * @brief Sparse-sparse product a * b, in the format of a.
+ * @throws std::invalid_argument If the columns of a are not the rows of b, or the stored elements of the product don't fit in Index.
+ * @throws std::bad_alloc If the accumulators or the product can not be allocated.
+ * @note Gustavson's algorithm in two passes, symbolic then numeric, so the product is allocated to its exact size. Every thread accumulates
+ *       its rows in a dense array or a hash table, whichever suits the partial products of the row, the rows being split over the team into
+ *       parts of equal partial products. b is recompressed to the format of a when they differ, and CSC operands go through the transposes,
+ *       the CSC storage of (a * b) being the CSR storage of b^T * a^T. Sums cancelling to zero are kept as stored elements.
+*/
+template <typename T, std::unsigned_integral Index> requires math::matrix::GemmScalar<T>
+_NODISC_ inline SparseMatrix<T, Index> spgemm(const SparseMatrix<T, Index> &a, const SparseMatrix<T, Index> &b) {
+    if (a.num_columns() != b.num_rows()) throw std::invalid_argument("Cannot multiply the SparseMatrix objects because the columns of a are not the rows of b.");
+    if (a.format() != b.format()) return math::spgemm<T, Index>(a, b.converted(a.format()));
+    const bool is_csr = a.format() == math::matrix::SF::csr;
+    const SparseMatrix<T, Index> &left = is_csr ? a : b, &right = is_csr ? b : a;
+    std::vector<Index> offsets, indices;
+    std::vector<T> values;
+    const math::matrix::impl::SpgemmOperands<T, Index> operands{ left.offsets().data(), left.indices().data(), left.values().data(),
+                                                                 right.offsets().data(), right.indices().data(), right.values().data() };
+    math::matrix::impl::spgemm_kernel<T, Index>(left.num_majors(), right.num_minors(), operands, offsets, indices, values);
+    return SparseMatrix<T, Index>(a.num_rows(), b.num_columns(), a.format(), std::move(offsets), std::move(indices), std::move(values));
+}
+}
\ No newline at end of file
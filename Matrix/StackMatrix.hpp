@@ -1,7 +1,8 @@
 // StackMatrix.hpp
 #pragma once
 
-#include "Helper\Static.hpp"
+#include "Helper/Static.hpp"
+#include "Kernel/Power.hpp"
 
 namespace math {
 template <typename T, size_t R, size_t C> requires NothrDtor<T>
@@ -25,17 +26,17 @@ class _NODISC_ MatrixS {
         }
 
         template <typename ...Args>
-        requires allSameType<T, ...Args> && (sizeof...(Args) == R * C)
-        constexpr MatrixS(Args&& ...args) noexcept ( std::is_nothrow_constructible_v<T> ) {
-            math::matrix::impl::variadic_construct(m_data, 0, std::forward<T>(args)...);
+        requires allSameType<T, Args...> && (sizeof...(Args) == R * C)
+        constexpr MatrixS(Args&& ...args) noexcept ( std::is_nothrow_copy_constructible_v<T> ) {
+            math::matrix::impl::variadic_construct(m_data, 0, std::forward<Args>(args)...);
         }
 
         template <typename ...Args>
-        requires allSameType<T, ...Args> && (sizeof...(Args) < R * C)
+        requires allSameType<T, Args...> && (sizeof...(Args) < R * C)
         constexpr MatrixS(Args&& ...args) {
             _ZERO_EXISTS_
             _NO_ZERO_COND_ throw std::logic_error("Cannot construct the Matrix for this type because neither zero value is stored and neither is it default constructible.");
-            math::matrix::impl::variadic_construct(m_data, 0, std::forward<T>(args)...);
+            math::matrix::impl::variadic_construct(m_data, 0, std::forward<Args>(args)...);
             math::matrix::impl::zero_construct(m_data, sizeof...(Args), R * C);
         }
 
@@ -46,7 +47,7 @@ class _NODISC_ MatrixS {
 
         constexpr MatrixS(read_ptr<T> data, size_t buffer_size) requires CpyCtor<T> {
             math::matrix::impl::copy_construct(m_data, data, 0, std::min(R * C, buffer_size));
-            if (buffer_size < R * C) zero_construct(m_data, buffer_size, R * C);
+            if (buffer_size < R * C) math::matrix::impl::zero_construct(m_data, buffer_size, R * C);
         }
 
         constexpr MatrixS(read_ptr2d<T> data) requires CpyCtor<T> {
@@ -60,13 +61,13 @@ class _NODISC_ MatrixS {
             }
             const size_t min_size = std::min(R, rows);
             for (size_t i = 0; i < min_size; i++) math::matrix::impl::copy_construct(m_data, data[i], i * C, (i + 1) * C);
-            if (R > rows) zero_construct(m_data, rows * C, R * C);
+            if (R > rows) math::matrix::impl::zero_construct(m_data, rows * C, R * C);
         }
 
     public:
         constexpr MatrixS(const MatrixS &other) : MatrixS(other.m_data) {}
-        constexpr MatrixS(MatrixS &&other) noexcept {
-            std::swap(m_data, other.m_data);
+        constexpr MatrixS(MatrixS &&other) noexcept requires std::is_nothrow_move_constructible_v<T> {
+            std::uninitialized_move_n(other.m_data, R * C, m_data);
         }
         constexpr MatrixS &operator=(const MatrixS &other) {
             if (this != &other) {
@@ -75,7 +76,7 @@ class _NODISC_ MatrixS {
             }
             return *this;
         }
-        constexpr MatrixS &operator=(Matrix &&other) {
+        constexpr MatrixS &operator=(MatrixS &&other) noexcept requires std::is_nothrow_swappable_v<T> {
             if (this != &other) this->swap(other);
             return *this;
         }
@@ -103,30 +104,51 @@ class _NODISC_ MatrixS {
             return m_data[row * C + col];
         }
         
-        _NODISC_ constexpr T &at()(const size_t row, const size_t col) {
+        _NODISC_ constexpr T &at(const size_t row, const size_t col) {
             if (row >= R || col >= C) throw std::out_of_range("Provided index does not exist within the bounds of this Matrix.");
             return m_data[row * C + col];
         }
-        _NODISC_ constexpr const T &at()(const size_t row, const size_t col) const {
+        _NODISC_ constexpr const T &at(const size_t row, const size_t col) const {
             if (row >= R || col >= C) throw std::out_of_range("Provided index does not exist within the bounds of this Matrix.");
             return m_data[row * C + col];
         }
 
     public:
-        constexpr MatrixS &operator+=(const MatrixS &other) {
-            if constexpr ( std::declval<T&> += _DECL_ ) {
-                #pragma omp parallel for schedule(static)
-                for (size_t i = 0; i < R * C; i++) m_data[i] += other.m_data[i];
+        constexpr MatrixS &operator+=(const MatrixS &other) requires math::compoundAddition<T> {
+            if constexpr (noexcept( std::declval<T&>() += _DECL_ )) {
+                if constexpr (R * C >= 16384) { // Waking the thread team costs more than adding a small matrix.
+                    #pragma omp parallel for schedule(static)
+                    for (size_t i = 0; i < R * C; i++) m_data[i] += other.m_data[i];
+                }
+                else for (size_t i = 0; i < R * C; i++) m_data[i] += other.m_data[i];
             }
             else {
-
+                MatrixS temp(*this);
+                for (size_t i = 0; i < R * C; i++) temp.m_data[i] += other.m_data[i];
+                this->swap(temp);
             }
+            return *this;
         }
-        _NODISC_ constexpr MatrixS operator+(const MatrixS &other) const {
+        _NODISC_ constexpr MatrixS operator+(const MatrixS &other) const requires math::compoundAddition<T> {
             MatrixS result(*this);
             return (result += other);
         }
 
+    public:
+        // The square Matrix to the power exponent(the identity for zero) by binary exponentiation, with two scratch matrices on the stack.
+        _NODISC_ MatrixS pow(const size_t exponent) const requires (R == C) && math::matrix::GemmScalar<T> {
+            MatrixS result;
+            math::matrix::impl::power_small<T, R>(m_data, result.m_data, exponent);
+            return result;
+        }
+
+        // The exponential e^A by scaling and squaring of a Padé approximant, like Matrix::expm(), its scratch(6 matrices) on the stack.
+        _NODISC_ MatrixS expm() const requires (R == C) && std::floating_point<T> {
+            MatrixS result;
+            math::matrix::impl::expm_small<T, R>(m_data, result.m_data);
+            return result;
+        }
+
     private:
         T m_data[R * C];
 };
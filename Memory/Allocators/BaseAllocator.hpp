@@ -1,7 +1,7 @@
 // BaseAllocator.hpp
 #pragma once
 
-#include "..\..\Helper\Headers.hpp"
+#include "../../Helper/Headers.hpp"
 
 namespace math::memory {
 _MTEMPL_ class base_allocator {
@@ -1,7 +1,7 @@
 // CAllocate.hpp
 #pragma once
 
-#include "..\..\Helper\Headers.hpp"
+#include "../../Helper/Headers.hpp"
 
 namespace math::memory::impl {
 using aligned_alloc_t = void* (*)(size_t, size_t);
@@ -0,0 +1,134 @@
+// HugePageAllocator.hpp
+#pragma once
+
+#include "../HugePage.hpp"
+
+namespace math::memory::impl {
+// Stored right before the memory handed out, so deallocate knows how much was mapped and how.
+struct HugeBlockHeader {
+    void *mapping;
+    size_t mapped_bytes;
+    HugePagePolicy obtained;
+};
+
+/**
+ * @brief Mapping a block backed by huge pages.
+ * @param bytes Size of the block in bytes(including the header).
+ * @param policy HPP::explicit_pages tries MAP_HUGETLB first and falls back to transparent huge pages.
+ * @param header_size Bytes reserved in front of the returned memory.
+ * @return Pointer to the memory after the header or nullptr.
+*/
+_NODISC_ inline void *map_huge_block(const size_t bytes, const HugePagePolicy policy, const size_t header_size) noexcept {
+#if defined(__linux__)
+    const size_t length = round_up_huge(bytes);
+    if (length < bytes) return nullptr;
+    void *mapping = MAP_FAILED;
+    HugePagePolicy obtained = HPP::transparent;
+    #if defined(MAP_HUGETLB)
+    if (policy == HPP::explicit_pages) {
+        mapping = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mapping != MAP_FAILED) obtained = HPP::explicit_pages;
+    }
+    #endif
+    size_t mapped_bytes = length;
+    if (mapping == MAP_FAILED) {
+        mapping = math::memory::impl::map_huge_aligned(length);
+        if (mapping == nullptr) return nullptr;
+    }
+    HugeBlockHeader *header = reinterpret_cast<HugeBlockHeader*>(static_cast<unsigned char*>(mapping) + header_size - sizeof(HugeBlockHeader));
+    header->mapping = mapping;
+    header->mapped_bytes = mapped_bytes;
+    header->obtained = obtained;
+    return static_cast<unsigned char*>(mapping) + header_size;
+#else
+    (void)bytes; (void)policy; (void)header_size;
+    return nullptr;
+#endif
+}
+
+_NODISC_ inline const HugeBlockHeader *huge_block_header(const void *ptr) noexcept {
+    return reinterpret_cast<const HugeBlockHeader*>(ptr) - 1;
+}
+
+inline void unmap_huge_block(void *ptr) noexcept {
+#if defined(__linux__)
+    const HugeBlockHeader *header = huge_block_header(ptr);
+    ::munmap(header->mapping, header->mapped_bytes);
+#else
+    (void)ptr;
+#endif
+}
+}
+
+namespace math::memory {
+// Allocator hook for large buffers, every block is mapped on its own and starts on a huge page.
+_MTEMPL_ class huge_page_allocator {
+    private:
+        static constexpr const size_t header_size = std::max(alignof(T), static_cast<size_t>(64)); // Keeps the elements aligned and the header on its own cache line.
+
+    public:
+        constexpr huge_page_allocator(const HugePagePolicy policy = HPP::transparent) noexcept : m_policy(policy == HPP::none ? HPP::transparent : policy) {}
+        _MTMPLU_ constexpr huge_page_allocator(const huge_page_allocator<U> &other) noexcept : m_policy(other.policy()) {}
+
+    public:
+        _NODISC_ T *allocate(const size_t num_elements) const {
+            static constexpr const size_t size(sizeof(T));
+            if (num_elements > ((static_cast<size_t>(~0) - header_size - huge_page_size) / size)) throw std::bad_alloc{};
+            void *ptr = math::memory::impl::map_huge_block(size * num_elements + header_size, m_policy, header_size);
+            if (ptr) [[likely]] return static_cast<T*>(ptr);
+            else throw std::bad_alloc{};
+        }
+
+        void deallocate(T *&memory, const size_t created_items) const noexcept {
+            if (memory) {
+                if constexpr (!TrvDtor<T>) std::destroy_n(memory, created_items);
+                math::memory::impl::unmap_huge_block(memory);
+                memory = nullptr;
+            }
+        }
+
+    public:
+        /**
+         * @brief Reporting whether a block from this allocator got huge pages.
+         * @param memory Pointer returned by allocate.
+         * @param num_elements Number of elements the block was allocated for.
+         * @return The report, explicit pages are always huge while transparent ones are measured from /proc/self/smaps(so only touched memory counts).
+        */
+        _NODISC_ static HugePageReport report(const T *memory, const size_t num_elements) {
+            HugePageReport report;
+            if (memory == nullptr) return report;
+            report.bytes = num_elements * sizeof(T);
+            report.backing = math::memory::impl::huge_block_header(memory)->obtained;
+            if (report.backing == HPP::explicit_pages) report.huge_bytes = report.bytes;
+            else {
+                report.huge_bytes = math::memory::huge_page_report<T>(&memory, 1, num_elements).huge_bytes;
+                if (report.huge_bytes == 0) report.backing = HPP::none; // THP was requested but the kernel has not collapsed any of it(yet).
+            }
+            return report;
+        }
+
+        _NODISC_ constexpr HugePagePolicy policy() const noexcept {
+            return m_policy;
+        }
+
+    public:
+        _MTMPLU_ _NODISC_ constexpr bool operator==(const huge_page_allocator<U> &other) const noexcept {
+            return true; // Every block carries its own mapping size, so any instance can free it.
+        }
+
+        _MTMPLU_ _NODISC_ constexpr bool operator!=(const huge_page_allocator<U> &other) const noexcept {
+            return false;
+        }
+
+    private:
+        HugePagePolicy m_policy;
+};
+
+_MTEMPL_ struct allocator_traits<T, huge_page_allocator<T>> {
+    using value_type = T;
+    using propagate_on_copy_assignment = std::true_type;
+    using propagate_on_move_assignment = std::true_type;
+    using propagate_on_copy_construct  = std::true_type;
+    using propagate_on_move_construct  = std::true_type;
+};
+}
\ No newline at end of file
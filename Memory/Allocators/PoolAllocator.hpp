@@ -0,0 +1,45 @@
+// PoolAllocator.hpp
+#pragma once
+
+#include "../Pool.hpp"
+
+namespace math::memory {
+// Allocator hook for small and medium buffers that are made and released often, served from the size class pool of the calling thread.
+_MTEMPL_ requires (alignof(T) <= alignof(std::max_align_t))
+class pool_allocator {
+    public:
+        constexpr pool_allocator() noexcept = default;
+        _MTMPLU_ constexpr pool_allocator(const pool_allocator<U>&) noexcept {}
+
+    public:
+        _NODISC_ T *allocate(const size_t num_elements) const {
+            if (num_elements > (static_cast<size_t>(~0) / sizeof(T))) throw std::bad_alloc{};
+            return static_cast<T*>(math::memory::pool_allocate(sizeof(T) * num_elements));
+        }
+
+        void deallocate(T *&memory, const size_t created_items) const noexcept {
+            if (memory) {
+                if constexpr (!TrvDtor<T>) std::destroy_n(memory, created_items);
+                math::memory::pool_free(memory);
+                memory = nullptr;
+            }
+        }
+
+    public:
+        _MTMPLU_ _NODISC_ constexpr bool operator==(const pool_allocator<U> &other) const noexcept {
+            return true; // Every block knows its owning cache, so any instance on any thread can free it.
+        }
+
+        _MTMPLU_ _NODISC_ constexpr bool operator!=(const pool_allocator<U> &other) const noexcept {
+            return false;
+        }
+};
+
+_MTEMPL_ struct allocator_traits<T, pool_allocator<T>> {
+    using value_type = T;
+    using propagate_on_copy_assignment = std::true_type;
+    using propagate_on_move_assignment = std::true_type;
+    using propagate_on_copy_construct  = std::true_type;
+    using propagate_on_move_construct  = std::true_type;
+};
+}
\ No newline at end of file
@@ -0,0 +1,298 @@
+// HugePage.hpp
+#pragma once
+#include "../Helper/Headers.hpp"
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+#endif
+
+namespace math::memory {
+enum class HugePagePolicy : char {
+    none, transparent, explicit_pages
+};
+using HPP = HugePagePolicy;
+
+inline constexpr const size_t huge_page_size = static_cast<size_t>(2) << 20; // 2 MiB, the x86-64/aarch64 PMD page size.
+
+// How much of an allocation is actually backed by huge pages, and which kind of huge pages it got(not the policy it asked for).
+struct HugePageReport {
+    size_t bytes = 0;
+    size_t huge_bytes = 0;
+    HugePagePolicy backing = HPP::none;
+
+    _NODISC_ bool is_huge() const noexcept {
+        return (huge_bytes != 0);
+    }
+};
+}
+
+namespace math::memory::impl {
+inline std::atomic<HugePagePolicy> huge_page_policy{HPP::none};
+inline std::atomic<size_t> huge_page_threshold{static_cast<size_t>(64) << 20}; // 64 MiB.
+inline thread_local HugePagePolicy scope_huge_page_policy = HPP::none;
+
+_NODISC_ inline constexpr size_t round_up_huge(const size_t bytes) noexcept {
+    return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+}
+
+/**
+ * @brief Marking a range the caller owns as eligible for transparent huge pages.
+ * @param ptr Pointer to the start of the range, on a huge page boundary.
+ * @param bytes Size of the range in bytes, a multiple of huge_page_size.
+ * @note Only ever called on whole huge pages the allocator owns, advising the pages around a smaller block would mark memory of other blocks.
+*/
+inline void advise_huge_range(void *ptr, const size_t bytes) noexcept {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    ::madvise(ptr, bytes, MADV_HUGEPAGE); // Failure only means the hint is ignored.
+#else
+    (void)ptr; (void)bytes;
+#endif
+}
+
+/**
+ * @brief Mapping anonymous memory that starts on a huge page boundary, advised for transparent huge pages.
+ * @param bytes Size of the mapping in bytes, a multiple of huge_page_size.
+ * @return Pointer to the mapping(released with munmap) or nullptr.
+*/
+_NODISC_ inline void *map_huge_aligned(const size_t bytes) noexcept {
+#if defined(__linux__)
+    // Over-map by one huge page and trim so the mapping starts on a huge page boundary.
+    if (bytes > static_cast<size_t>(~0) - huge_page_size) return nullptr;
+    void *raw = ::mmap(nullptr, bytes + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+    const uintptr_t raw_begin = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = (raw_begin + huge_page_size - 1) & ~(huge_page_size - 1);
+    if (aligned != raw_begin) ::munmap(raw, aligned - raw_begin);
+    if (const size_t tail = (raw_begin + bytes + huge_page_size) - (aligned + bytes)) ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    math::memory::impl::advise_huge_range(reinterpret_cast<void*>(aligned), bytes);
+    return reinterpret_cast<void*>(aligned);
+#else
+    (void)bytes;
+    return nullptr;
+#endif
+}
+
+/**
+ * @brief Huge page aligned mapping the blocks smaller than a huge page(the rows of a huge page Matrix) are carved from, one per thread
+ *        so that the rows a thread first touches land on its own huge pages. Freed blocks are not reused, the mapping goes with its last block.
+*/
+struct HugeArena {
+    std::atomic<size_t> live{1}; // Blocks carved and not freed yet, plus one while it is the arena of a thread.
+    size_t used = 0;             // Bytes handed out from the start of the mapping, only touched by the thread of the arena.
+};
+inline constexpr const size_t huge_arena_size = 4 * huge_page_size;
+inline constexpr const size_t huge_arena_prefix = alignof(std::max_align_t); // Before every carved block, its arena.
+inline constexpr const size_t huge_arena_header = (sizeof(HugeArena) + huge_arena_prefix - 1) / huge_arena_prefix * huge_arena_prefix;
+
+inline thread_local HugeArena *huge_arena = nullptr;
+inline thread_local bool huge_arena_retired = false;
+
+inline void huge_arena_release(HugeArena *arena) noexcept {
+#if defined(__linux__)
+    if (arena->live.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    arena->~HugeArena();
+    ::munmap(arena, huge_arena_size);
+#else
+    (void)arena;
+#endif
+}
+
+struct HugeArenaHandle {
+    ~HugeArenaHandle() {
+        if (huge_arena != nullptr) huge_arena_release(huge_arena);
+        huge_arena = nullptr;
+        huge_arena_retired = true; // Blocks asked for by later thread_local destructors are not carved.
+    }
+};
+
+/**
+ * @brief Carving a block from the arena of the calling thread, mapping a new arena when it is full.
+ * @param bytes Size of the block in bytes, less than huge_page_size.
+ * @return Pointer to the block(aligned to alignof(std::max_align_t), freed with huge_arena_free) or nullptr.
+*/
+_NODISC_ inline void *huge_arena_allocate(const size_t bytes) noexcept {
+    if (huge_arena_retired) return nullptr;
+    const size_t step = huge_arena_prefix + (bytes + huge_arena_prefix - 1) / huge_arena_prefix * huge_arena_prefix;
+    HugeArena *arena = huge_arena;
+    if (arena == nullptr || arena->used + step > huge_arena_size) {
+        void *mapping = math::memory::impl::map_huge_aligned(huge_arena_size);
+        if (mapping == nullptr) return nullptr;
+        HugeArena *fresh = ::new (mapping) HugeArena;
+        fresh->used = huge_arena_header;
+        if (arena != nullptr) math::memory::impl::huge_arena_release(arena);
+        else {
+            static thread_local HugeArenaHandle handle;
+            (void)handle;
+        }
+        huge_arena = arena = fresh;
+    }
+    unsigned char *const block = reinterpret_cast<unsigned char*>(arena) + arena->used + huge_arena_prefix;
+    *reinterpret_cast<HugeArena**>(block - huge_arena_prefix) = arena;
+    arena->used += step;
+    arena->live.fetch_add(1, std::memory_order_relaxed);
+    return block;
+}
+
+// Freeing a block of huge_arena_allocate, from any thread.
+inline void huge_arena_free(void *ptr) noexcept {
+    math::memory::impl::huge_arena_release(*reinterpret_cast<HugeArena**>(static_cast<unsigned char*>(ptr) - huge_arena_prefix));
+}
+
+/**
+ * @brief Finding the huge page policy that applies to an allocation of the given size.
+ * @param bytes Size of the allocation in bytes.
+ * @return The policy of the innermost HugePageScope, else the global policy if the allocation reaches the global threshold, else HPP::none.
+*/
+_NODISC_ inline HugePagePolicy active_huge_page_policy(const size_t bytes) noexcept {
+    if (scope_huge_page_policy != HPP::none) return scope_huge_page_policy;
+    const HugePagePolicy policy = huge_page_policy.load(std::memory_order_relaxed);
+    if (policy != HPP::none && bytes >= huge_page_threshold.load(std::memory_order_relaxed)) return policy;
+    return HPP::none;
+}
+
+/**
+ * @brief Allocating at least one huge page which can still be released with std::free and resized with std::realloc.
+ * @param bytes Size of the allocation in bytes.
+ * @return Pointer to the allocated memory or nullptr.
+ * @note Blocks of at least one huge page are 2 MiB aligned and rounded up to whole huge pages, all of which are advised. Smaller blocks
+ *       are left to malloc unadvised, as their huge page would be shared with other blocks(huge_page_allocate carves them instead).
+*/
+_NODISC_ inline void *huge_page_malloc(const size_t bytes) noexcept {
+#if defined(__linux__)
+    if (bytes < huge_page_size) return std::malloc(bytes);
+    const size_t length = round_up_huge(bytes);
+    if (length < bytes) return nullptr;
+    void *ptr = std::aligned_alloc(huge_page_size, length);
+    if (ptr) advise_huge_range(ptr, length);
+    return ptr;
+#else
+    return std::malloc(bytes);
+#endif
+}
+
+/**
+ * @brief Allocating a block under a huge page policy, carved from the arena of the thread when smaller than a huge page.
+ * @param bytes Size of the block in bytes.
+ * @param is_carved Set to whether the block was carved, it is then freed with huge_arena_free instead of std::free and can't be resized in place.
+ * @return Pointer to the block or nullptr.
+*/
+_NODISC_ inline void *huge_page_allocate(const size_t bytes, bool &is_carved) noexcept {
+    is_carved = false;
+    if (bytes < huge_page_size) {
+        if (void *ptr = math::memory::impl::huge_arena_allocate(bytes)) {
+            is_carved = true;
+            return ptr;
+        }
+    }
+    return math::memory::impl::huge_page_malloc(bytes);
+}
+
+struct VmaHugeInfo {
+    uintptr_t begin, end;
+    size_t anon_huge_bytes;
+    bool is_hugetlb; // Mapped from hugetlbfs(MAP_HUGETLB), which AnonHugePages does not count.
+};
+
+/**
+ * @brief Reading the AnonHugePages of every mapping of this process from /proc/self/smaps.
+ * @return The mappings sorted by address, empty if smaps is unavailable.
+*/
+_NODISC_ inline std::vector<VmaHugeInfo> read_smaps_huge_info() {
+    std::vector<VmaHugeInfo> result;
+#if defined(__linux__)
+    std::FILE *file = std::fopen("/proc/self/smaps", "r");
+    if (file == nullptr) return result;
+    char line[512];
+    unsigned long long begin, end, kb;
+    while (std::fgets(line, sizeof(line), file)) {
+        if (std::sscanf(line, "%llx-%llx ", &begin, &end) == 2) result.push_back({static_cast<uintptr_t>(begin), static_cast<uintptr_t>(end), 0, false});
+        else if (result.empty()) continue;
+        else if (std::sscanf(line, "AnonHugePages: %llu kB", &kb) == 1) result.back().anon_huge_bytes = static_cast<size_t>(kb) << 10;
+        else if (std::sscanf(line, "KernelPageSize: %llu kB", &kb) == 1) result.back().is_hugetlb = (kb >= (huge_page_size >> 10));
+    }
+    std::fclose(file);
+#endif
+    return result;
+}
+}
+
+namespace math::memory {
+/**
+ * @brief Setting the global huge page policy, used by every allocation of at least threshold bytes.
+ * @param policy The policy to use, HPP::explicit_pages falls back to HPP::transparent outside of huge_page_allocator because std::free must be able to release the memory.
+ * @param threshold Minimum size in bytes of a block(or of a whole Matrix) for the policy to apply.
+*/
+inline void set_huge_page_policy(const HugePagePolicy policy, const size_t threshold = static_cast<size_t>(64) << 20) noexcept {
+    impl::huge_page_threshold.store(threshold, std::memory_order_relaxed);
+    impl::huge_page_policy.store(policy, std::memory_order_relaxed);
+}
+
+_NODISC_ inline HugePagePolicy huge_page_policy() noexcept {
+    return impl::huge_page_policy.load(std::memory_order_relaxed);
+}
+
+_NODISC_ inline size_t huge_page_threshold() noexcept {
+    return impl::huge_page_threshold.load(std::memory_order_relaxed);
+}
+
+// Every allocation made by this thread while the scope is alive uses the given policy, regardless of its size(used to select huge pages for a single Matrix).
+class HugePageScope {
+    public:
+        explicit HugePageScope(const HugePagePolicy policy) noexcept : m_previous(impl::scope_huge_page_policy) {
+            if (policy != HPP::none) impl::scope_huge_page_policy = policy;
+        }
+        ~HugePageScope() noexcept {
+            impl::scope_huge_page_policy = m_previous;
+        }
+        HugePageScope(const HugePageScope&) = delete;
+        HugePageScope &operator=(const HugePageScope&) = delete;
+
+    private:
+        HugePagePolicy m_previous;
+};
+
+/**
+ * @brief Finding the policy a whole 2D allocation(a Matrix) should be built with.
+ * @param total_bytes Size of all the rows together in bytes.
+ * @return The global policy if the total reaches the global threshold, else HPP::none.
+*/
+_NODISC_ inline HugePagePolicy huge_page_policy_for(const size_t total_bytes) noexcept {
+    const HugePagePolicy policy = impl::huge_page_policy.load(std::memory_order_relaxed);
+    return (policy != HPP::none && total_bytes >= impl::huge_page_threshold.load(std::memory_order_relaxed)) ? policy : HPP::none;
+}
+
+/**
+ * @brief Reporting how much of a 2D allocation is backed by transparent huge pages.
+ * @tparam T Type of the elements.
+ * @param rows Pointer to the row pointers.
+ * @param num_rows Number of rows.
+ * @param row_size Number of elements in each row.
+ * @return The report, huge_bytes is measured per mapping(the AnonHugePages of every mapping touched by a row, or the whole mapping for hugetlbfs) and capped to the size of the rows,
+ *         backing is HPP::explicit_pages if a row lives in a hugetlbfs mapping, else HPP::transparent if any transparent huge page was found, else HPP::none.
+*/
+_MTEMPL_ _NODISC_ inline HugePageReport huge_page_report(read_ptr2d<T> rows, const size_t num_rows, const size_t row_size) {
+    HugePageReport report;
+    report.bytes = num_rows * row_size * sizeof(T);
+    if (rows == nullptr || report.bytes == 0) return report;
+    const std::vector<impl::VmaHugeInfo> vmas = impl::read_smaps_huge_info();
+    std::vector<bool> counted(vmas.size(), false);
+    for (size_t i = 0; i < num_rows; i++) {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(rows[i]);
+        auto loc = std::upper_bound(vmas.begin(), vmas.end(), address, [](const uintptr_t a, const impl::VmaHugeInfo &vma) { return a < vma.end; });
+        if (loc == vmas.end() || loc->begin > address) continue;
+        const size_t index = loc - vmas.begin();
+        if (counted[index]) continue;
+        counted[index] = true;
+        if (loc->is_hugetlb) {
+            report.backing = HPP::explicit_pages;
+            report.huge_bytes += loc->end - loc->begin;
+        }
+        else report.huge_bytes += loc->anon_huge_bytes;
+    }
+    report.huge_bytes = std::min(report.huge_bytes, report.bytes);
+    if (report.backing == HPP::none && report.huge_bytes != 0) report.backing = HPP::transparent;
+    return report;
+}
+}
+
+#define _HUGE_PAGE_SCOPE_(num_elements) math::memory::HugePageScope huge_page_scope(math::memory::huge_page_policy_for((num_elements) * sizeof(T)));
\ No newline at end of file
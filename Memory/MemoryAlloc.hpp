@@ -1,6 +1,9 @@
 // MemoryAlloc.hpp
 #pragma once
-#include "..\Helper\Headers.hpp"
+#include "HugePage.hpp"
+#include "MemoryStats.hpp"
+#include "MemoryBudget.hpp"
+#include "Pool.hpp"
 
 namespace math::memory::impl {
 using aligned_alloc_t = void* (*)(size_t, size_t);
@@ -10,35 +13,173 @@ using free_t = void(*)(void*);
     inline void *msc_aligned_alloc(size_t alignment, size_t size) {
         return _aligned_malloc(size, alignment);
     }
-    aligned_alloc_t aligned_allocate = msc_aligned_alloc;
-    free_t free = _aligned_free;
+    inline aligned_alloc_t aligned_allocate = msc_aligned_alloc;
+    inline free_t free = _aligned_free;
 #else
-    aligned_alloc_t aligned_allocate = std::aligned_alloc;
-    free_t free = std::free;
+    inline aligned_alloc_t aligned_allocate = std::aligned_alloc;
+    inline free_t free = std::free;
 #endif
 }
 
+namespace math::memory::impl {
+// Whether allocate_memory<T> serves T from the pool(see Pool.hpp), over-aligned types always bypass it.
+_MTEMPL_ inline constexpr const bool uses_pool =
+#if defined(MATH_USE_POOL_ALLOCATOR)
+    (alignof(T) <= alignof(std::max_align_t));
+#else
+    false;
+#endif
+
+// Stored right before every block of allocate_memory, so that whichever thread frees the block counts it the way it was counted when allocated.
+struct BlockStamp {
+    BudgetAccount *account;    // Thread budget the block is charged to, nullptr if none.
+    uint64_t bytes : 54;       // As counted by the statistics and budgets.
+    uint64_t is_process : 1;   // Whether the block is charged to the process budget.
+    uint64_t is_carved : 1;    // Whether the block was carved from a huge page arena(see huge_page_allocate).
+    uint64_t allocated_as : 8; // Tag the allocation was counted under.
+
+    _NODISC_ BudgetCharge charge() const noexcept {
+        return BudgetCharge{account, is_process != 0};
+    }
+};
+
+// Room kept for the stamp, a multiple of the alignment of the elements so that they stay aligned.
+_MTEMPL_ inline constexpr const size_t stamp_size = (sizeof(BlockStamp) + std::max(alignof(T), alignof(std::max_align_t)) - 1) / std::max(alignof(T), alignof(std::max_align_t)) * std::max(alignof(T), alignof(std::max_align_t));
+
+_MTEMPL_ _NODISC_ inline void *block_base(const T *ptr) noexcept {
+    return const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(ptr)) - stamp_size<T>;
+}
+
+_MTEMPL_ _NODISC_ inline BlockStamp *block_stamp(const T *ptr) noexcept {
+    return static_cast<BlockStamp*>(math::memory::impl::block_base<T>(ptr));
+}
+
+// Usable bytes after the stamp of a block the system(or the pool) handed out, 0 when the platform can't tell(or the block was carved).
+template <typename T, bool Pooled = uses_pool<T>>
+_NODISC_ inline size_t block_size(const void *base) noexcept {
+    size_t bytes;
+    if constexpr (Pooled) bytes = math::memory::pool_block_size(base);
+    else bytes = math::memory::impl::usable_size<T>(base);
+    return bytes > stamp_size<T> ? bytes - stamp_size<T> : 0;
+}
+
+/**
+ * @brief Accounting a new block in the memory statistics and budgets and stamping it.
+ * @tparam T Type of the elements of the block.
+ * @param base Pointer to the block as the system(or the pool) handed it out.
+ * @param charge What budget_reserve charged for the block.
+ * @param requested_bytes Bytes charged to the budgets before the allocation.
+ * @param is_carved Whether the block was carved from a huge page arena, it then holds exactly requested_bytes.
+ * @return Pointer to the elements of the block, right after the stamp.
+ * @note Pooled tells whether the block came from the pool, always true for scratch memory(see allocate_scratch_memory).
+*/
+template <typename T, bool Pooled = uses_pool<T>>
+_NODISC_ inline T *on_allocated(void *base, const BudgetCharge &charge, const size_t requested_bytes, const bool is_carved = false) noexcept {
+    size_t bytes = is_carved ? 0 : math::memory::impl::block_size<T, Pooled>(base);
+    if (bytes == 0) bytes = requested_bytes;
+    math::memory::impl::budget_adjust(charge, static_cast<int64_t>(bytes) - static_cast<int64_t>(requested_bytes));
+    BlockStamp *stamp = static_cast<BlockStamp*>(base);
+    stamp->account = charge.account;
+    stamp->bytes = bytes;
+    stamp->is_process = charge.is_process;
+    stamp->is_carved = is_carved;
+    stamp->allocated_as = static_cast<uint64_t>(math::memory::impl::record_allocation(bytes));
+    return reinterpret_cast<T*>(static_cast<unsigned char*>(base) + stamp_size<T>);
+}
+
+/**
+ * @brief Accounting a block that is about to be freed in the memory statistics and budgets.
+ * @tparam T Type of the elements of the block.
+ * @param ptr Pointer to the elements of the block.
+ * @return Pointer to the block as the system(or the pool) handed it out, what has to be freed.
+*/
+_MTEMPL_ _NODISC_ inline void *on_freed(const T *ptr) noexcept {
+    const BlockStamp *stamp = math::memory::impl::block_stamp<T>(ptr);
+    math::memory::impl::budget_release(stamp->charge(), stamp->bytes);
+    math::memory::impl::record_free(stamp->bytes, static_cast<AllocTag>(stamp->allocated_as));
+    return math::memory::impl::block_base<T>(ptr);
+}
+
+/**
+ * @brief std::realloc that keeps the memory statistics and budgets in line with the block it returns.
+ * @tparam T Type of the elements to reallocate memory for.
+ * @param mem_ptr Pointer to the memory to reallocate, updated on success.
+ * @param num_elements Number of elements to reallocate memory for.
+ * @throws math::memory::memory_budget_exceeded If growing the block does not fit the memory budget.
+ * @throws std::bad_alloc If the memory reallocation fails(mem_ptr is left untouched).
+ * @return Pointer to the reallocated memory.
+ * @note A grown block is charged to the calling thread(its old charge is given back), a shrunk block keeps its charge so shrinking never throws the budget.
+*/
+_MTEMPL_ inline T *stats_realloc(T* &mem_ptr, const size_t num_elements) {
+    if (num_elements > ((static_cast<size_t>(~0) - stamp_size<T>) / sizeof(T))) throw std::bad_alloc{};
+    const size_t bytes = sizeof(T) * num_elements;
+    const BlockStamp old_stamp = *math::memory::impl::block_stamp<T>(mem_ptr);
+    const BudgetCharge old_charge = old_stamp.charge();
+    const size_t old_bytes = old_stamp.bytes;
+    const bool is_growing = bytes > old_bytes;
+    BudgetCharge charge = old_charge;
+    if (is_growing) {
+        math::memory::impl::budget_adjust(old_charge, -static_cast<int64_t>(old_bytes));
+        try { charge = math::memory::impl::budget_reserve(bytes); }
+        catch(...) { math::memory::impl::budget_adjust(old_charge, static_cast<int64_t>(old_bytes)); throw; }
+    }
+    void *base = math::memory::impl::block_base<T>(mem_ptr);
+    bool is_carved = false;
+    if constexpr (uses_pool<T>) base = math::memory::impl::pool_try_reallocate(base, stamp_size<T> + bytes);
+    else if (old_stamp.is_carved) [[unlikely]] {
+        // Carved blocks shrink in place and grow into a new block of the arena(or of their own).
+        is_carved = true;
+        if (is_growing) {
+            void *grown = math::memory::impl::huge_page_allocate(stamp_size<T> + bytes, is_carved);
+            if (grown) {
+                std::memcpy(grown, base, stamp_size<T> + old_bytes);
+                math::memory::impl::huge_arena_free(base);
+            }
+            base = grown;
+        }
+    }
+    else base = std::realloc(base, stamp_size<T> + bytes);
+    if (!base) {
+        if (is_growing) {
+            math::memory::impl::budget_release(charge, bytes);
+            math::memory::impl::budget_adjust(old_charge, static_cast<int64_t>(old_bytes));
+        }
+        throw std::bad_alloc{};
+    }
+    if (is_growing) math::memory::impl::budget_account_release(old_charge.account);
+    math::memory::impl::record_free(old_bytes, static_cast<AllocTag>(old_stamp.allocated_as));
+    return (mem_ptr = math::memory::impl::on_allocated<T>(base, charge, is_growing ? bytes : old_bytes, is_carved));
+}
+}
+
 // Destructor of the math::Classes are noexcept(true) because the class itself can only be made if the std::is_nothrow_destructible_v<T> type_trait is true and hence the free mem function is fine being noexcept
 namespace math::memory {
 /**
  * @brief Allocating row memory, a C++ wrapper on malloc.
  * @tparam T Type of the elements to allocate memory for.
  * @param num_elements Number of elements to allocate memory for.
+ * @throws math::memory::memory_budget_exceeded If the allocation does not fit the memory budget.
  * @throws std::bad_alloc If the memory allocation fails.
  * @return Pointer to the allocated memory.
 */
 _MTEMPL_ _NODISC_ inline T *allocate_memory(const size_t num_elements) {
     static constexpr const size_t align(alignof(T));
     static constexpr const size_t size(sizeof(T) == 0 ? 1 : sizeof(T));
-    if (num_elements > (static_cast<size_t>(~0) / size)) throw std::bad_alloc{};
+    static constexpr const size_t stamp(math::memory::impl::stamp_size<T>);
+    if (num_elements > ((static_cast<size_t>(~0) - stamp - align) / size)) throw std::bad_alloc{};
     size_t bytes = size * num_elements;
     if (bytes == 0) bytes = 1;
-    T *ptr;
-    if (bytes == 1) ptr = static_cast<T*>(std::malloc(1));
-    else if constexpr (align > alignof(std::max_align_t)) ptr = static_cast<T*>(math::memory::impl::aligned_allocate(align, bytes));
-    else ptr = static_cast<T*>(std::malloc(bytes));        
-    if (ptr) [[likely]] return ptr;
-    else throw std::bad_alloc{};
+    const size_t total = stamp + (align > alignof(std::max_align_t) ? (bytes + align - 1) / align * align : bytes); // std::aligned_alloc wants a multiple of the alignment.
+    const math::memory::impl::BudgetCharge charge = math::memory::impl::budget_reserve(bytes);
+    void *base;
+    bool is_carved = false;
+    if constexpr (math::memory::impl::uses_pool<T>) base = math::memory::impl::pool_try_allocate(total);
+    else if ((align <= alignof(std::max_align_t)) && (math::memory::impl::active_huge_page_policy(bytes) != HPP::none)) [[unlikely]] base = math::memory::impl::huge_page_allocate(total, is_carved);
+    else if constexpr (align > alignof(std::max_align_t)) base = math::memory::impl::aligned_allocate(align, total);
+    else base = std::malloc(total);
+    if (base) [[likely]] return math::memory::impl::on_allocated<T>(base, charge, bytes, is_carved);
+    math::memory::impl::budget_release(charge, bytes);
+    throw std::bad_alloc{};
 }
 
 /**
@@ -52,8 +193,12 @@ _MTEMPL_ requires NothrDtor<T>
 inline void free_memory(T* &memory, const size_t created_items) noexcept {
     if (memory != nullptr) {
         if constexpr (!TrvDtor<T>) std::destroy_n(memory, created_items);
-        if constexpr (alignof(T) > alignof(std::max_align_t)) math::memory::impl::free(memory);
-        else std::free(memory);
+        const bool is_carved = math::memory::impl::block_stamp<T>(memory)->is_carved;
+        void *base = math::memory::impl::on_freed<T>(memory);
+        if constexpr (math::memory::impl::uses_pool<T>) math::memory::impl::pool_free_block(base);
+        else if constexpr (alignof(T) > alignof(std::max_align_t)) math::memory::impl::free(base);
+        else if (is_carved) [[unlikely]] math::memory::impl::huge_arena_free(base);
+        else std::free(base);
         memory = nullptr;
     }
 }
@@ -77,15 +222,9 @@ requires ((std::is_nothrow_move_constructible_v<T> || CpyCtor<T> || std::is_triv
     }
     if (num_elements < old_num_elements) {
         if constexpr (!TrvDtor<T>) std::destroy_n(mem_ptr + num_elements, old_num_elements - num_elements);
-        T *temp = static_cast<T*>(std::realloc(mem_ptr, sizeof(T) * num_elements));
-        if (!temp) throw std::bad_alloc{};
-        return (mem_ptr = temp);
-    }
-    if constexpr (std::is_trivially_copyable_v<T> && TrvDtor<T>) {
-        T *temp = static_cast<T*>(std::realloc(mem_ptr, sizeof(T) * num_elements));
-        if (!temp) throw std::bad_alloc{};
-        return (mem_ptr = temp);
+        return math::memory::impl::stats_realloc(mem_ptr, num_elements);
     }
+    if constexpr (std::is_trivially_copyable_v<T> && TrvDtor<T>) return math::memory::impl::stats_realloc(mem_ptr, num_elements);
     T *temp = allocate_memory<T>(num_elements);
     if constexpr (std::is_nothrow_move_constructible_v<T>)
         std::uninitialized_move_n(mem_ptr, old_num_elements, temp);
@@ -98,6 +237,34 @@ requires ((std::is_nothrow_move_constructible_v<T> || CpyCtor<T> || std::is_triv
     free_memory(mem_ptr, old_num_elements);
     return (mem_ptr = temp);
 }
+/**
+ * @brief Allocating scratch memory of a kernel from the pool of the calling thread(with or without MATH_USE_POOL_ALLOCATOR), so that repeated calls reuse it.
+ * @tparam T Type of the elements, trivially destructible and not over-aligned.
+ * @param num_elements Number of elements to allocate memory for.
+ * @throws math::memory::memory_budget_exceeded If the allocation does not fit the memory budget.
+ * @throws std::bad_alloc If the memory allocation fails.
+ * @return Pointer to the uninitialised memory, freed with free_scratch_memory.
+*/
+_MTEMPL_ requires (TrvDtor<T> && (alignof(T) <= alignof(std::max_align_t)))
+_NODISC_ inline T *allocate_scratch_memory(const size_t num_elements) {
+    static constexpr const size_t stamp(math::memory::impl::stamp_size<T>);
+    if (num_elements > ((static_cast<size_t>(~0) - stamp) / sizeof(T))) throw std::bad_alloc{};
+    const size_t bytes = std::max<size_t>(1, sizeof(T) * num_elements);
+    const math::memory::impl::BudgetCharge charge = math::memory::impl::budget_reserve(bytes);
+    void *base = math::memory::impl::pool_try_allocate(stamp + bytes);
+    if (base) [[likely]] return math::memory::impl::on_allocated<T, true>(base, charge, bytes);
+    math::memory::impl::budget_release(charge, bytes);
+    throw std::bad_alloc{};
+}
+
+// Freeing scratch memory of allocate_scratch_memory, from any thread.
+_MTEMPL_ requires (TrvDtor<T> && (alignof(T) <= alignof(std::max_align_t)))
+inline void free_scratch_memory(T* &memory) noexcept {
+    if (memory != nullptr) {
+        math::memory::impl::pool_free_block(math::memory::impl::on_freed<T>(memory));
+        memory = nullptr;
+    }
+}
 #define _TRY_CONSTRUCT_AT_(ptr, ...) try { std::construct_at(ptr, ##__VA_ARGS__); }
 #define _TRY_CONSTRUCT_AT_LOOP_(loop_var, loop_end_condition, loop_increment_cond, ptr, ...) try { for (loop_var = 0; loop_end_condition; loop_increment_cond) std::construct_at(ptr + loop_var, ##__VA_ARGS__); }
 }
\ No newline at end of file
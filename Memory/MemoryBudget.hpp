@@ -0,0 +1,196 @@
+// MemoryBudget.hpp
+#pragma once
+#include "../Helper/Headers.hpp"
+
+namespace math::memory {
+enum class BudgetScope : char {
+    process, thread
+};
+using BS = BudgetScope;
+
+// Thrown before asking the system for memory that would not fit the budget, still a std::bad_alloc so every existing cleanup path handles it.
+class memory_budget_exceeded : public std::bad_alloc {
+    public:
+        memory_budget_exceeded(const BudgetScope scope, const size_t requested, const size_t available) noexcept
+            : m_scope(scope), m_requested(requested), m_available(available) {}
+
+    public:
+        const char *what() const noexcept override {
+            return m_scope == BS::process ? "Allocation would exceed the process memory budget." : "Allocation would exceed the thread memory budget.";
+        }
+        _NODISC_ BudgetScope scope() const noexcept {
+            return m_scope;
+        }
+        _NODISC_ size_t requested() const noexcept {
+            return m_requested;
+        }
+        _NODISC_ size_t available() const noexcept {
+            return m_available;
+        }
+
+    private:
+        BudgetScope m_scope;
+        size_t m_requested;
+        size_t m_available;
+};
+}
+
+namespace math::memory::impl {
+// Memory charged to the budget of one thread, shared with the blocks it charged so that whichever thread frees a block credits the budget it came from.
+struct BudgetAccount {
+    std::atomic<int64_t> used{0};
+    std::atomic<size_t> references{1}; // The thread that owns it, plus one per block still charged to it.
+};
+
+// What a block was charged to, kept with the block until it is freed(see BlockStamp in MemoryAlloc.hpp).
+struct BudgetCharge {
+    BudgetAccount *account = nullptr; // nullptr if no thread budget was set.
+    bool is_process = false;          // Whether the process budget was set.
+};
+
+inline std::atomic<size_t> process_budget{0}; // 0 means unlimited.
+inline std::atomic<int64_t> process_budget_used{0};
+inline thread_local size_t thread_budget = 0;
+inline thread_local BudgetAccount *thread_budget_account = nullptr;
+
+inline void budget_account_release(BudgetAccount *account) noexcept {
+    if (account != nullptr && account->references.fetch_sub(1, std::memory_order_acq_rel) == 1) delete account;
+}
+
+// Drops the reference of an exiting thread, its account lives on until the last block charged to it is freed.
+struct BudgetAccountHandle {
+    ~BudgetAccountHandle() {
+        thread_budget = 0;
+        budget_account_release(thread_budget_account);
+        thread_budget_account = nullptr;
+    }
+};
+
+_NODISC_ inline size_t budget_left(const size_t budget, const int64_t used) noexcept {
+    return static_cast<size_t>(used) >= budget ? 0 : budget - static_cast<size_t>(used); // used can't go below 0, every free credits only what its block was charged.
+}
+
+/**
+ * @brief Charging an allocation to the budgets before it is made.
+ * @param bytes Size of the allocation in bytes.
+ * @throws math::memory::memory_budget_exceeded If the allocation does not fit the thread or the process budget.
+ * @return What the allocation was charged to, handed back to budget_adjust and budget_release.
+*/
+_NODISC_ inline BudgetCharge budget_reserve(const size_t bytes) {
+    BudgetCharge charge;
+    if (thread_budget != 0) {
+        // Checked and charged in one step, so the threads of a team charging the same account can't all pass on the same bytes.
+        std::atomic<int64_t> &used = thread_budget_account->used;
+        int64_t seen = used.load(std::memory_order_relaxed);
+        do {
+            if (bytes > budget_left(thread_budget, seen)) [[unlikely]] throw memory_budget_exceeded(BS::thread, bytes, budget_left(thread_budget, seen));
+        } while (!used.compare_exchange_weak(seen, seen + static_cast<int64_t>(bytes), std::memory_order_relaxed));
+        charge.account = thread_budget_account;
+    }
+    const size_t budget = process_budget.load(std::memory_order_relaxed);
+    if (budget != 0) {
+        const int64_t used = process_budget_used.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+        if (bytes > budget_left(budget, used)) [[unlikely]] {
+            process_budget_used.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+            if (charge.account != nullptr) charge.account->used.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+            throw memory_budget_exceeded(BS::process, bytes, budget_left(budget, used));
+        }
+        charge.is_process = true;
+    }
+    if (charge.account != nullptr) charge.account->references.fetch_add(1, std::memory_order_relaxed);
+    return charge;
+}
+
+// Correcting a charge, negative amounts give memory back.
+inline void budget_adjust(const BudgetCharge &charge, const int64_t bytes) noexcept {
+    if (charge.account != nullptr) charge.account->used.fetch_add(bytes, std::memory_order_relaxed);
+    if (charge.is_process) process_budget_used.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+// Giving back all the bytes of a charge, from any thread.
+inline void budget_release(const BudgetCharge &charge, const size_t bytes) noexcept {
+    math::memory::impl::budget_adjust(charge, -static_cast<int64_t>(bytes));
+    math::memory::impl::budget_account_release(charge.account);
+}
+
+// Charges the allocations of this thread to the budget of another thread while alive, used by the team building the rows of the caller(see allocate_2d_first_touch).
+class BudgetAccountScope {
+    public:
+        BudgetAccountScope(const size_t budget, BudgetAccount *account) noexcept : m_budget(thread_budget), m_account(thread_budget_account) {
+            thread_budget = budget;
+            thread_budget_account = account;
+        }
+        ~BudgetAccountScope() noexcept {
+            thread_budget = m_budget;
+            thread_budget_account = m_account;
+        }
+        BudgetAccountScope(const BudgetAccountScope&) = delete;
+        BudgetAccountScope &operator=(const BudgetAccountScope&) = delete;
+
+    private:
+        size_t m_budget;
+        BudgetAccount *m_account;
+};
+}
+
+namespace math::memory {
+/**
+ * @brief Setting the budget of memory allocated through math::memory by the whole process.
+ * @param bytes The budget, 0 removes it.
+ * @note Only memory allocated while a budget is set is counted(until it is freed, even if the budget was removed and set again in between).
+*/
+inline void set_process_memory_budget(const size_t bytes) noexcept {
+    impl::process_budget.store(bytes, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Setting the budget of memory allocated through math::memory by the calling thread.
+ * @param bytes The budget, 0 removes it.
+ * @throws std::bad_alloc If the first budget of the thread can't be set up.
+ * @note Memory is charged to the thread that allocated it and credited back to that thread whichever thread frees it, rows built by the thread team(see allocate_2d_first_touch) are charged to the caller.
+ * @note Only memory allocated while a budget is set is counted.
+*/
+inline void set_thread_memory_budget(const size_t bytes) {
+    if (bytes != 0 && impl::thread_budget_account == nullptr) {
+        static thread_local impl::BudgetAccountHandle handle;
+        (void)handle;
+        impl::thread_budget_account = new impl::BudgetAccount;
+    }
+    impl::thread_budget = bytes;
+}
+
+_NODISC_ inline size_t process_memory_budget() noexcept {
+    return impl::process_budget.load(std::memory_order_relaxed);
+}
+
+_NODISC_ inline size_t thread_memory_budget() noexcept {
+    return impl::thread_budget;
+}
+
+/**
+ * @brief Finding how much the calling thread can still allocate.
+ * @return The smaller of what is left in the thread and process budgets, SIZE_MAX if neither is set.
+*/
+_NODISC_ inline size_t memory_budget_available() noexcept {
+    size_t result = std::numeric_limits<size_t>::max();
+    if (impl::thread_budget != 0) result = impl::budget_left(impl::thread_budget, impl::thread_budget_account->used.load(std::memory_order_relaxed));
+    const size_t budget = impl::process_budget.load(std::memory_order_relaxed);
+    if (budget != 0) result = std::min(result, impl::budget_left(budget, impl::process_budget_used.load(std::memory_order_relaxed)));
+    return result;
+}
+
+/**
+ * @brief Sizing a scratch buffer to the budget, for kernels that can trade memory for passes.
+ * @param preferred_units Number of units(rows, panels, tiles) the kernel would like.
+ * @param minimum_units Number of units the kernel can't work without.
+ * @param bytes_per_unit Size of one unit in bytes.
+ * @return The largest count in [minimum_units, preferred_units] that fits what is available(halving from preferred_units), 0 if not even minimum_units fit.
+*/
+_NODISC_ inline size_t budget_fit(size_t preferred_units, const size_t minimum_units, const size_t bytes_per_unit) noexcept {
+    const size_t available = memory_budget_available();
+    if (bytes_per_unit == 0 || available == std::numeric_limits<size_t>::max()) return preferred_units;
+    const size_t max_units = available / bytes_per_unit;
+    while (preferred_units > max_units && preferred_units > minimum_units) preferred_units = std::max(preferred_units >> 1, minimum_units);
+    return preferred_units <= max_units ? preferred_units : 0;
+}
+}
\ No newline at end of file
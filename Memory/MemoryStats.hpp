@@ -0,0 +1,328 @@
+// MemoryStats.hpp
+#pragma once
+#include "../Helper/Headers.hpp"
+
+#if defined(_MSC_VER) || defined(__MINGW32__) || defined(__MINGW64__)
+    #include <malloc.h>
+#elif defined(__APPLE__)
+    #include <malloc/malloc.h>
+#elif defined(__linux__)
+    #include <malloc.h>
+#endif
+
+// Define MATH_NO_MEMORY_STATS to compile the counting out of every allocation.
+
+namespace math::memory {
+enum class AllocTag : char {
+    untagged, construct, add, subtract, multiply, transpose, extend, shrink, variable
+};
+using AT = AllocTag;
+
+inline constexpr const size_t alloc_tag_count = 9;
+inline constexpr const size_t alloc_histogram_buckets = 8 * sizeof(size_t); // Bucket k counts the sizes in [2^k, 2^(k+1)).
+
+_NODISC_ inline constexpr const char *alloc_tag_name(const AllocTag tag) noexcept {
+    switch (tag) {
+        case AT::construct: return "construct";
+        case AT::add:       return "add";
+        case AT::subtract:  return "subtract";
+        case AT::multiply:  return "multiply";
+        case AT::transpose: return "transpose";
+        case AT::extend:    return "extend";
+        case AT::shrink:    return "shrink";
+        case AT::variable:  return "variable";
+        default:            return "untagged";
+    }
+}
+
+struct AllocTagStats {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytes_allocated = 0;
+    uint64_t bytes_freed = 0;
+    uint64_t histogram[alloc_histogram_buckets] = {};
+};
+
+// A snapshot of every thread's counters, taken by math::memory::memory_stats().
+struct MemoryStats {
+    AllocTagStats tags[alloc_tag_count];
+    int64_t bytes_live = 0;
+    int64_t peak_bytes = 0; // Accurate to within (number of threads * publish granularity).
+
+    _NODISC_ const AllocTagStats &of(const AllocTag tag) const noexcept {
+        return tags[static_cast<size_t>(tag)];
+    }
+    _NODISC_ uint64_t allocations() const noexcept {
+        uint64_t result = 0;
+        for (const AllocTagStats &tag : tags) result += tag.allocations;
+        return result;
+    }
+};
+}
+
+namespace math::memory::impl {
+inline constexpr const int64_t stats_publish_granularity = static_cast<int64_t>(64) << 10;
+
+// Written only by its own thread(relaxed load + store, no read-modify-write), read by anyone.
+struct ThreadMemoryStats {
+    struct Tag {
+        std::atomic<uint64_t> allocations{0}, frees{0}, bytes_allocated{0}, bytes_freed{0};
+        std::atomic<uint64_t> histogram[alloc_histogram_buckets] = {};
+    } tags[alloc_tag_count];
+    int64_t unpublished_bytes = 0;
+    ThreadMemoryStats *previous = nullptr, *next = nullptr; // Links of MemoryStatsRegistry::threads, so registering never allocates.
+
+    ThreadMemoryStats() noexcept;
+    ~ThreadMemoryStats();
+};
+
+struct MemoryStatsRegistry {
+    std::mutex lock;
+    ThreadMemoryStats *threads = nullptr; // Intrusive list, a thread whose first call is a free(in a noexcept destructor) registers without allocating.
+    MemoryStats retired; // Counters of the threads that already exited.
+    std::atomic<int64_t> bytes_live{0};
+    std::atomic<int64_t> peak_bytes{0};
+
+    static MemoryStatsRegistry &instance() noexcept {
+        static MemoryStatsRegistry registry;
+        return registry;
+    }
+};
+
+inline thread_local AllocTag current_alloc_tag = AT::untagged;
+inline thread_local bool thread_memory_stats_retired = false;
+
+inline void bump(std::atomic<uint64_t> &counter, const uint64_t amount) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+inline void publish_bytes(ThreadMemoryStats &stats) noexcept {
+    MemoryStatsRegistry &registry = MemoryStatsRegistry::instance();
+    const int64_t live = registry.bytes_live.fetch_add(stats.unpublished_bytes, std::memory_order_relaxed) + stats.unpublished_bytes;
+    stats.unpublished_bytes = 0;
+    int64_t peak = registry.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !registry.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+}
+
+inline ThreadMemoryStats::ThreadMemoryStats() noexcept {
+    MemoryStatsRegistry &registry = MemoryStatsRegistry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    next = registry.threads;
+    if (next != nullptr) next->previous = this;
+    registry.threads = this;
+}
+
+inline ThreadMemoryStats::~ThreadMemoryStats() {
+    MemoryStatsRegistry &registry = MemoryStatsRegistry::instance();
+    publish_bytes(*this);
+    std::lock_guard<std::mutex> guard(registry.lock);
+    for (size_t t = 0; t < alloc_tag_count; t++) {
+        AllocTagStats &to = registry.retired.tags[t];
+        const Tag &from = tags[t];
+        to.allocations += from.allocations.load(std::memory_order_relaxed);
+        to.frees += from.frees.load(std::memory_order_relaxed);
+        to.bytes_allocated += from.bytes_allocated.load(std::memory_order_relaxed);
+        to.bytes_freed += from.bytes_freed.load(std::memory_order_relaxed);
+        for (size_t b = 0; b < alloc_histogram_buckets; b++) to.histogram[b] += from.histogram[b].load(std::memory_order_relaxed);
+    }
+    if (previous != nullptr) previous->next = next;
+    else registry.threads = next;
+    if (next != nullptr) next->previous = previous;
+    thread_memory_stats_retired = true; // Blocks freed by later thread_local(or static) destructors are counted by retired_record.
+}
+
+/**
+ * @brief Getting the counters of the calling thread.
+ * @return The counters, nullptr once they were destroyed at thread exit.
+*/
+_NODISC_ inline ThreadMemoryStats *thread_memory_stats() noexcept {
+    if (thread_memory_stats_retired) [[unlikely]] return nullptr;
+    static thread_local ThreadMemoryStats stats;
+    return &stats;
+}
+
+_NODISC_ inline size_t histogram_bucket(const size_t bytes) noexcept {
+    return bytes == 0 ? 0 : static_cast<size_t>(std::bit_width(bytes) - 1);
+}
+
+/**
+ * @brief Counting an allocation or a free of a thread whose counters are gone straight into the totals of the exited threads.
+ * @param allocated_as Tag of the block.
+ * @param bytes Size of the block in bytes, negative for a free.
+*/
+inline void retired_record(const AllocTag allocated_as, const int64_t bytes) noexcept {
+    MemoryStatsRegistry &registry = MemoryStatsRegistry::instance();
+    const size_t size = static_cast<size_t>(bytes < 0 ? -bytes : bytes);
+    {
+        std::lock_guard<std::mutex> guard(registry.lock);
+        AllocTagStats &tag = registry.retired.tags[static_cast<size_t>(allocated_as)];
+        if (bytes < 0) {
+            tag.frees++;
+            tag.bytes_freed += size;
+        }
+        else {
+            tag.allocations++;
+            tag.bytes_allocated += size;
+            tag.histogram[histogram_bucket(size)]++;
+        }
+    }
+    registry.bytes_live.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Size the allocator really handed out for a block, so that allocation and free agree on the bytes counted.
+ * @tparam T Type of the elements of the block(decides how an over-aligned block is queried on Windows).
+ * @param ptr Pointer to the block.
+ * @return Usable size of the block in bytes, 0 when the platform can't tell.
+*/
+_MTEMPL_ _NODISC_ inline size_t usable_size(const void *ptr) noexcept {
+    if (ptr == nullptr) return 0;
+#if defined(_MSC_VER) || defined(__MINGW32__) || defined(__MINGW64__)
+    if constexpr (alignof(T) > alignof(std::max_align_t)) return ::_aligned_msize(const_cast<void*>(ptr), alignof(T), 0);
+    else return ::_msize(const_cast<void*>(ptr));
+#elif defined(__APPLE__)
+    return ::malloc_size(ptr);
+#elif defined(__linux__)
+    return ::malloc_usable_size(const_cast<void*>(ptr));
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Counting an allocation.
+ * @param bytes Size of the allocation in bytes.
+ * @param allocated_as Tag to count it under, the current tag of the calling thread by default.
+ * @return The tag it was counted under, to be kept with the block and handed back to record_free.
+*/
+inline AllocTag record_allocation(const size_t bytes, const AllocTag allocated_as = current_alloc_tag) noexcept {
+#if !defined(MATH_NO_MEMORY_STATS)
+    ThreadMemoryStats *const thread = thread_memory_stats();
+    if (thread == nullptr) [[unlikely]] {
+        retired_record(allocated_as, static_cast<int64_t>(bytes));
+        return allocated_as;
+    }
+    ThreadMemoryStats &stats = *thread;
+    ThreadMemoryStats::Tag &tag = stats.tags[static_cast<size_t>(allocated_as)];
+    bump(tag.allocations, 1);
+    bump(tag.bytes_allocated, bytes);
+    bump(tag.histogram[histogram_bucket(bytes)], 1);
+    if ((stats.unpublished_bytes += static_cast<int64_t>(bytes)) >= stats_publish_granularity) publish_bytes(stats);
+#else
+    (void)bytes;
+#endif
+    return allocated_as;
+}
+
+/**
+ * @brief Counting a free against the tag its block was allocated under(not the tag current at the free).
+ * @param bytes Size of the block in bytes, as counted by record_allocation.
+ * @param allocated_as Tag returned by record_allocation for the block.
+*/
+inline void record_free(const size_t bytes, const AllocTag allocated_as) noexcept {
+#if !defined(MATH_NO_MEMORY_STATS)
+    ThreadMemoryStats *const thread = thread_memory_stats();
+    if (thread == nullptr) [[unlikely]] return retired_record(allocated_as, -static_cast<int64_t>(bytes));
+    ThreadMemoryStats &stats = *thread;
+    ThreadMemoryStats::Tag &tag = stats.tags[static_cast<size_t>(allocated_as)];
+    bump(tag.frees, 1);
+    bump(tag.bytes_freed, bytes);
+    if ((stats.unpublished_bytes -= static_cast<int64_t>(bytes)) <= -stats_publish_granularity) publish_bytes(stats);
+#else
+    (void)bytes; (void)allocated_as;
+#endif
+}
+
+_MTEMPL_ inline AllocTag record_allocation_of(const T *ptr) noexcept {
+#if !defined(MATH_NO_MEMORY_STATS)
+    return record_allocation(usable_size<T>(ptr));
+#else
+    (void)ptr;
+    return current_alloc_tag;
+#endif
+}
+
+_MTEMPL_ inline void record_free_of(const T *ptr, const AllocTag allocated_as) noexcept {
+#if !defined(MATH_NO_MEMORY_STATS)
+    record_free(usable_size<T>(ptr), allocated_as);
+#else
+    (void)ptr; (void)allocated_as;
+#endif
+}
+}
+
+namespace math::memory {
+// Attributes the allocations of this thread to an operation while alive, the outermost scope wins so Matrix::operator+ stays "add" through its inner copy.
+class AllocTagScope {
+    public:
+        explicit AllocTagScope(const AllocTag tag) noexcept : m_previous(impl::current_alloc_tag) {
+            if (m_previous == AT::untagged) impl::current_alloc_tag = tag;
+        }
+        ~AllocTagScope() noexcept {
+            impl::current_alloc_tag = m_previous;
+        }
+        AllocTagScope(const AllocTagScope&) = delete;
+        AllocTagScope &operator=(const AllocTagScope&) = delete;
+
+    private:
+        AllocTag m_previous;
+};
+
+_NODISC_ inline AllocTag current_alloc_tag() noexcept {
+    return impl::current_alloc_tag;
+}
+
+/**
+ * @brief Aggregating the counters of every thread.
+ * @return The snapshot, counters of running threads are read without stopping them so it is only consistent per counter.
+*/
+_NODISC_ inline MemoryStats memory_stats() {
+    impl::MemoryStatsRegistry &registry = impl::MemoryStatsRegistry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    MemoryStats result = registry.retired;
+    for (const impl::ThreadMemoryStats *thread = registry.threads; thread != nullptr; thread = thread->next)
+        for (size_t t = 0; t < alloc_tag_count; t++) {
+            AllocTagStats &to = result.tags[t];
+            const impl::ThreadMemoryStats::Tag &from = thread->tags[t];
+            to.allocations += from.allocations.load(std::memory_order_relaxed);
+            to.frees += from.frees.load(std::memory_order_relaxed);
+            to.bytes_allocated += from.bytes_allocated.load(std::memory_order_relaxed);
+            to.bytes_freed += from.bytes_freed.load(std::memory_order_relaxed);
+            for (size_t b = 0; b < alloc_histogram_buckets; b++) to.histogram[b] += from.histogram[b].load(std::memory_order_relaxed);
+        }
+    for (const AllocTagStats &tag : result.tags) result.bytes_live += static_cast<int64_t>(tag.bytes_allocated - tag.bytes_freed);
+    result.peak_bytes = std::max(registry.peak_bytes.load(std::memory_order_relaxed), result.bytes_live);
+    return result;
+}
+
+/**
+ * @brief Dumping memory_stats() as JSON.
+ * @return {"bytes_live":..,"peak_bytes":..,"tags":{"<tag>":{"allocations":..,"frees":..,"bytes_allocated":..,"bytes_freed":..,"histogram":{"<bucket lower bound>":count}}}}
+*/
+_NODISC_ inline std::string memory_stats_json() {
+    const MemoryStats stats = memory_stats();
+    std::string json = "{\"bytes_live\":" + std::to_string(stats.bytes_live) + ",\"peak_bytes\":" + std::to_string(stats.peak_bytes) + ",\"tags\":{";
+    bool first_tag = true;
+    for (size_t t = 0; t < alloc_tag_count; t++) {
+        const AllocTagStats &tag = stats.tags[t];
+        if (tag.allocations == 0 && tag.frees == 0) continue;
+        if (!first_tag) json += ',';
+        first_tag = false;
+        json += '"'; json += alloc_tag_name(static_cast<AllocTag>(t));
+        json += "\":{\"allocations\":" + std::to_string(tag.allocations) + ",\"frees\":" + std::to_string(tag.frees) +
+                ",\"bytes_allocated\":" + std::to_string(tag.bytes_allocated) + ",\"bytes_freed\":" + std::to_string(tag.bytes_freed) + ",\"histogram\":{";
+        bool first_bucket = true;
+        for (size_t b = 0; b < alloc_histogram_buckets; b++) {
+            if (tag.histogram[b] == 0) continue;
+            if (!first_bucket) json += ',';
+            first_bucket = false;
+            json += '"' + std::to_string(static_cast<uint64_t>(1) << b) + "\":" + std::to_string(tag.histogram[b]);
+        }
+        json += "}}";
+    }
+    json += "}}";
+    return json;
+}
+}
+
+#define _ALLOC_TAG_(tag) math::memory::AllocTagScope alloc_tag_scope(math::memory::AT::tag);
\ No newline at end of file
@@ -0,0 +1,100 @@
+// Numa.hpp
+#pragma once
+#include "../Helper/Headers.hpp"
+
+#if defined(__linux__)
+    #include <unistd.h>
+    #include <sys/syscall.h>
+    #include <linux/mempolicy.h>
+#endif
+
+namespace math::memory {
+enum class NumaPlacement : char {
+    first_touch, interleave
+};
+using NP = NumaPlacement;
+}
+
+namespace math::memory::impl {
+inline std::atomic<NumaPlacement> numa_placement{NP::first_touch};
+inline std::atomic<size_t> first_touch_threshold{static_cast<size_t>(1) << 20}; // Below 1 MiB waking the thread team costs more than it saves.
+
+inline constexpr const size_t numa_max_nodes = 1024;
+struct NumaNodeMask {
+    unsigned long bits[numa_max_nodes / (8 * sizeof(unsigned long))] = {};
+    size_t num_nodes = 0;
+};
+
+/**
+ * @brief Reading the online NUMA nodes from /sys/devices/system/node/online(a list like "0-1,4").
+ * @return The node mask, with num_nodes = 0 if the file is not available.
+*/
+_NODISC_ inline NumaNodeMask read_online_nodes() noexcept {
+    NumaNodeMask mask;
+#if defined(__linux__)
+    std::FILE *file = std::fopen("/sys/devices/system/node/online", "r");
+    if (file == nullptr) return mask;
+    unsigned long first, last;
+    int separator;
+    while (std::fscanf(file, "%lu", &first) == 1) {
+        last = first;
+        separator = std::fgetc(file);
+        if (separator == '-') {
+            if (std::fscanf(file, "%lu", &last) != 1) break;
+            separator = std::fgetc(file);
+        }
+        for (unsigned long node = first; node <= last && node < numa_max_nodes; node++) {
+            mask.bits[node / (8 * sizeof(unsigned long))] |= (1UL << (node % (8 * sizeof(unsigned long))));
+            ++mask.num_nodes;
+        }
+        if (separator != ',') break;
+    }
+    std::fclose(file);
+#endif
+    return mask;
+}
+
+_NODISC_ inline const NumaNodeMask &online_nodes() noexcept {
+    static const NumaNodeMask mask = read_online_nodes();
+    return mask;
+}
+
+/**
+ * @brief Interleaving the pages of a block across all online NUMA nodes with mbind(MPOL_INTERLEAVE).
+ * @param ptr Pointer to the start of the block.
+ * @param bytes Size of the block in bytes.
+ * @note Has to run before the block is touched, pages that are already faulted keep their node. Pages shared with neighbouring allocations are interleaved too.
+*/
+inline void interleave_pages(const void *ptr, const size_t bytes) noexcept {
+#if defined(__linux__) && defined(SYS_mbind)
+    const NumaNodeMask &mask = online_nodes();
+    if (mask.num_nodes < 2 || bytes == 0) return;
+    static const uintptr_t page_size = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(ptr) & ~(page_size - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + bytes + page_size - 1) & ~(page_size - 1);
+    ::syscall(SYS_mbind, begin, end - begin, MPOL_INTERLEAVE, mask.bits, numa_max_nodes, 0); // Failure only means the default placement is kept.
+#else
+    (void)ptr; (void)bytes;
+#endif
+}
+}
+
+namespace math::memory {
+/**
+ * @brief Setting how the rows of newly built matrices are placed on NUMA nodes.
+ * @param placement NP::first_touch(default) lets the thread that initialises a row own it, NP::interleave spreads every row across all nodes.
+ * @param threshold Minimum size in bytes of a whole Matrix for its construction to be done by the thread team.
+*/
+inline void set_numa_placement(const NumaPlacement placement, const size_t threshold = static_cast<size_t>(1) << 20) noexcept {
+    impl::first_touch_threshold.store(threshold, std::memory_order_relaxed);
+    impl::numa_placement.store(placement, std::memory_order_relaxed);
+}
+
+_NODISC_ inline NumaPlacement numa_placement() noexcept {
+    return impl::numa_placement.load(std::memory_order_relaxed);
+}
+
+_NODISC_ inline size_t numa_node_count() noexcept {
+    return impl::online_nodes().num_nodes;
+}
+}
\ No newline at end of file
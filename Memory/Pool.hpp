@@ -0,0 +1,330 @@
+// Pool.hpp
+#pragma once
+#include "HugePage.hpp"
+
+// Define MATH_USE_POOL_ALLOCATOR to serve math::memory::allocate_memory(and so the rows of every Matrix) from the pool.
+
+namespace math::memory::impl {
+inline constexpr const size_t pool_min_block = 64;
+inline constexpr const size_t pool_max_block = static_cast<size_t>(8) << 20; // Bigger blocks go straight to the system, the gemm packing panels(4 MiB of doubles) still fit.
+inline constexpr const size_t pool_class_count = 69; // 64 B, then 4 classes per power of two up to 8 MiB(at most 25% wasted).
+inline constexpr const size_t pool_header_size = alignof(std::max_align_t);
+
+/**
+ * @brief Finding the size class of an allocation.
+ * @param bytes Size of the allocation in bytes, at most pool_max_block.
+ * @return Index of the smallest class holding bytes.
+*/
+_NODISC_ inline constexpr size_t pool_size_class(const size_t bytes) noexcept {
+    if (bytes <= pool_min_block) return 0;
+    const size_t width = static_cast<size_t>(std::bit_width(bytes - 1)); // 2^(width - 1) < bytes <= 2^width
+    const size_t step = static_cast<size_t>(1) << (width - 3);
+    return (width - 7) * 4 + (bytes - (static_cast<size_t>(1) << (width - 1)) + step - 1) / step;
+}
+
+_NODISC_ inline constexpr size_t pool_class_size(const size_t size_class) noexcept {
+    if (size_class == 0) return pool_min_block;
+    const size_t width = (size_class - 1) / 4 + 7;
+    return (static_cast<size_t>(1) << (width - 1)) + ((size_class - 1) % 4 + 1) * (static_cast<size_t>(1) << (width - 3));
+}
+static_assert(pool_class_size(pool_class_count - 1) == pool_max_block && pool_size_class(pool_max_block) == pool_class_count - 1);
+
+struct PoolThreadCache;
+
+// Stored right before every block, so any thread can send the block back to its owner.
+struct PoolBlockHeader {
+    PoolThreadCache *owner; // nullptr for blocks that came straight from the system, pool_carved for blocks carved from a huge page arena.
+    size_t capacity;
+};
+static_assert(sizeof(PoolBlockHeader) <= pool_header_size);
+
+// Owner of the blocks carved from a huge page arena(see huge_page_allocate), never dereferenced.
+inline PoolThreadCache *const pool_carved = reinterpret_cast<PoolThreadCache*>(alignof(std::max_align_t));
+
+struct PoolFreeBlock {
+    PoolFreeBlock *next;
+};
+
+// Free lists of one thread, only touched by that thread except for remote_frees which any thread pushes to.
+struct PoolThreadCache {
+    PoolFreeBlock *lists[pool_class_count] = {};
+    uint32_t counts[pool_class_count] = {};
+    uint32_t low_water[pool_class_count] = {}; // Smallest count since the last trim, the blocks below it went unused.
+    size_t cached_bytes = 0;
+    size_t frees_since_trim = 0;
+    size_t hits = 0, misses = 0; // Allocations served from the lists, and the ones that went to the system.
+    alignas(64) std::atomic<PoolFreeBlock*> remote_frees{nullptr};
+    std::atomic<size_t> remote_bytes{0}; // Capacity waiting in remote_frees, past the thread cache limit the freeing thread releases it.
+    std::atomic<bool> in_use{false};
+};
+
+// Caches are never destroyed, the cache of an exited thread is adopted by the next new thread so its late remote frees are not lost.
+struct PoolRegistry {
+    std::mutex lock;
+    std::vector<PoolThreadCache*> caches;
+
+    static PoolRegistry &instance() noexcept {
+        static PoolRegistry *registry = new PoolRegistry; // Leaked on purpose, threads may free blocks during static destruction.
+        return *registry;
+    }
+};
+
+inline std::atomic<size_t> pool_thread_cache_limit{static_cast<size_t>(16) << 20};
+inline std::atomic<size_t> pool_trim_interval{4096};
+inline thread_local PoolThreadCache *pool_cache = nullptr;
+inline thread_local bool pool_cache_retired = false;
+
+_NODISC_ inline PoolBlockHeader *pool_header(const void *ptr) noexcept {
+    return reinterpret_cast<PoolBlockHeader*>(const_cast<unsigned char*>(static_cast<const unsigned char*>(ptr)) - pool_header_size);
+}
+
+_NODISC_ inline void *pool_system_block(const size_t capacity, PoolThreadCache *owner, const bool is_huge) noexcept {
+    if (capacity > static_cast<size_t>(~0) - pool_header_size) return nullptr;
+    bool is_carved = false;
+    void *raw = is_huge ? math::memory::impl::huge_page_allocate(pool_header_size + capacity, is_carved) : std::malloc(pool_header_size + capacity);
+    if (raw == nullptr) return nullptr;
+    PoolBlockHeader *header = static_cast<PoolBlockHeader*>(raw);
+    header->owner = is_carved ? pool_carved : owner;
+    header->capacity = capacity;
+    return static_cast<unsigned char*>(raw) + pool_header_size;
+}
+
+inline void pool_release_block(void *ptr) noexcept {
+    if (pool_header(ptr)->owner == pool_carved) [[unlikely]] math::memory::impl::huge_arena_free(pool_header(ptr));
+    else std::free(pool_header(ptr));
+}
+
+inline void pool_push(PoolThreadCache &cache, void *ptr, const size_t size_class) noexcept {
+    PoolFreeBlock *block = static_cast<PoolFreeBlock*>(ptr);
+    block->next = cache.lists[size_class];
+    cache.lists[size_class] = block;
+    ++cache.counts[size_class];
+    cache.cached_bytes += pool_class_size(size_class);
+}
+
+_NODISC_ inline void *pool_pop(PoolThreadCache &cache, const size_t size_class) noexcept {
+    PoolFreeBlock *block = cache.lists[size_class];
+    cache.lists[size_class] = block->next;
+    if (--cache.counts[size_class] < cache.low_water[size_class]) cache.low_water[size_class] = cache.counts[size_class];
+    cache.cached_bytes -= pool_class_size(size_class);
+    return block;
+}
+
+// Moving the blocks other threads freed into the local lists.
+inline void pool_drain_remote(PoolThreadCache &cache) noexcept {
+    PoolFreeBlock *block = cache.remote_frees.exchange(nullptr, std::memory_order_acquire);
+    size_t bytes = 0;
+    while (block != nullptr) {
+        PoolFreeBlock *next = block->next;
+        bytes += pool_header(block)->capacity;
+        pool_push(cache, block, pool_size_class(pool_header(block)->capacity));
+        block = next;
+    }
+    if (bytes != 0) cache.remote_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+// Giving the blocks other threads freed to a cache back to the system, from any thread(for owners that stopped allocating).
+inline void pool_release_remote(PoolThreadCache &cache) noexcept {
+    PoolFreeBlock *block = cache.remote_frees.exchange(nullptr, std::memory_order_acquire);
+    size_t bytes = 0;
+    while (block != nullptr) {
+        PoolFreeBlock *next = block->next;
+        bytes += pool_header(block)->capacity;
+        std::free(pool_header(block));
+        block = next;
+    }
+    if (bytes != 0) cache.remote_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+inline void pool_release_blocks(PoolThreadCache &cache, const size_t size_class, size_t num_blocks) noexcept {
+    for (; num_blocks != 0 && cache.lists[size_class] != nullptr; num_blocks--) pool_release_block(pool_pop(cache, size_class));
+}
+
+/**
+ * @brief Giving cached blocks back to the system.
+ * @param cache The cache to trim.
+ * @param release_all Whether to empty the cache, else only the blocks unused since the last trim are released(and more if the cache is still over its limit).
+*/
+inline void pool_trim_cache(PoolThreadCache &cache, const bool release_all) noexcept {
+    pool_drain_remote(cache);
+    for (size_t c = 0; c < pool_class_count; c++) pool_release_blocks(cache, c, release_all ? cache.counts[c] : cache.low_water[c]);
+    const size_t limit = pool_thread_cache_limit.load(std::memory_order_relaxed);
+    for (size_t c = pool_class_count; c-- > 0 && cache.cached_bytes > limit / 2;) pool_release_blocks(cache, c, cache.counts[c]); // Largest classes first.
+    for (size_t c = 0; c < pool_class_count; c++) cache.low_water[c] = cache.counts[c];
+    cache.frees_since_trim = 0;
+}
+
+struct PoolThreadHandle {
+    ~PoolThreadHandle() {
+        if (pool_cache == nullptr) return;
+        pool_trim_cache(*pool_cache, true);
+        pool_cache->in_use.store(false, std::memory_order_release);
+        pool_cache = nullptr;
+        pool_cache_retired = true; // Blocks freed by later thread_local destructors go to the remote list of the retired cache.
+    }
+};
+
+/**
+ * @brief Getting the cache of the calling thread, adopting an abandoned one or making a new one on first use.
+ * @return The cache, nullptr while the thread is exiting or if no cache could be made.
+*/
+_NODISC_ inline PoolThreadCache *pool_thread_cache() noexcept {
+    if (pool_cache != nullptr) [[likely]] return pool_cache;
+    if (pool_cache_retired) return nullptr;
+    PoolRegistry &registry = PoolRegistry::instance();
+    try {
+        std::lock_guard<std::mutex> guard(registry.lock);
+        for (PoolThreadCache *cache : registry.caches) {
+            bool expected = false;
+            if (cache->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                pool_cache = cache;
+                break;
+            }
+        }
+        if (pool_cache == nullptr) {
+            registry.caches.reserve(registry.caches.size() + 1); // So that push_back can't throw after the cache is made.
+            PoolThreadCache *cache = new PoolThreadCache;
+            cache->in_use.store(true, std::memory_order_relaxed);
+            registry.caches.push_back(cache);
+            pool_cache = cache;
+        }
+    }
+    catch(...) { return nullptr; }
+    static thread_local PoolThreadHandle handle;
+    (void)handle;
+    return pool_cache;
+}
+
+/**
+ * @brief Allocating a block from the pool.
+ * @param bytes Size of the block in bytes.
+ * @return Pointer to the block(aligned to alignof(std::max_align_t)) or nullptr.
+*/
+_NODISC_ inline void *pool_try_allocate(const size_t bytes) noexcept {
+    if (bytes > pool_max_block) return pool_system_block(bytes, nullptr, math::memory::impl::active_huge_page_policy(bytes) != HPP::none);
+    if (math::memory::impl::active_huge_page_policy(bytes) != HPP::none) [[unlikely]] return pool_system_block(bytes, nullptr, true); // Rows of a huge Matrix are carved from huge pages.
+    const size_t size_class = pool_size_class(bytes);
+    PoolThreadCache *cache = pool_thread_cache();
+    if (cache == nullptr) [[unlikely]] return pool_system_block(pool_class_size(size_class), nullptr, false);
+    if (cache->lists[size_class] == nullptr) pool_drain_remote(*cache);
+    if (cache->lists[size_class] != nullptr) [[likely]] {
+        ++cache->hits;
+        return pool_pop(*cache, size_class);
+    }
+    ++cache->misses;
+    return pool_system_block(pool_class_size(size_class), cache, false);
+}
+
+/**
+ * @brief Giving a block back to the pool, to the cache of the calling thread if it owns the block else to the remote list of its owner.
+ * @param ptr Pointer to the block(can be nullptr).
+*/
+inline void pool_free_block(void *ptr) noexcept {
+    if (ptr == nullptr) return;
+    PoolThreadCache *owner = pool_header(ptr)->owner;
+    if (owner == nullptr || owner == pool_carved) return pool_release_block(ptr);
+    if (owner == pool_cache) [[likely]] {
+        PoolThreadCache &cache = *owner;
+        pool_push(cache, ptr, pool_size_class(pool_header(ptr)->capacity));
+        if ((++cache.frees_since_trim >= pool_trim_interval.load(std::memory_order_relaxed)) || (cache.cached_bytes > pool_thread_cache_limit.load(std::memory_order_relaxed))) [[unlikely]]
+            pool_trim_cache(cache, false);
+        return;
+    }
+    PoolFreeBlock *block = static_cast<PoolFreeBlock*>(ptr);
+    const size_t capacity = pool_header(ptr)->capacity;
+    PoolFreeBlock *head = owner->remote_frees.load(std::memory_order_relaxed);
+    do block->next = head;
+    while (!owner->remote_frees.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+    // An owner that never allocates again never drains its list, so past the cache limit the freeing thread hands the blocks back to the system.
+    if (owner->remote_bytes.fetch_add(capacity, std::memory_order_relaxed) + capacity > pool_thread_cache_limit.load(std::memory_order_relaxed)) [[unlikely]]
+        pool_release_remote(*owner);
+}
+
+/**
+ * @brief Resizing a block of the pool, keeping it when the new size falls in the same size class.
+ * @param ptr Pointer to the block.
+ * @param bytes New size of the block in bytes.
+ * @return Pointer to the resized block or nullptr(ptr is left untouched).
+*/
+_NODISC_ inline void *pool_try_reallocate(void *ptr, const size_t bytes) noexcept {
+    PoolBlockHeader *header = pool_header(ptr);
+    const size_t capacity = header->capacity;
+    if (header->owner == nullptr && capacity > pool_max_block && bytes > pool_max_block) {
+        if (bytes > static_cast<size_t>(~0) - pool_header_size) return nullptr;
+        void *raw = std::realloc(header, pool_header_size + bytes);
+        if (raw == nullptr) return nullptr;
+        static_cast<PoolBlockHeader*>(raw)->capacity = bytes;
+        return static_cast<unsigned char*>(raw) + pool_header_size;
+    }
+    if (bytes <= capacity && (capacity > pool_max_block || bytes > pool_max_block || pool_size_class(bytes) == pool_size_class(capacity))) return ptr;
+    void *result = pool_try_allocate(bytes);
+    if (result == nullptr) return nullptr;
+    std::memcpy(result, ptr, std::min(bytes, capacity));
+    pool_free_block(ptr);
+    return result;
+}
+}
+
+namespace math::memory {
+/**
+ * @brief Allocating a scratch buffer from the pool, O(1) and contention free when the calling thread recently freed a block of the same size class.
+ * @param bytes Size of the buffer in bytes.
+ * @throws std::bad_alloc If the memory allocation fails.
+ * @return Pointer to the buffer, aligned to alignof(std::max_align_t).
+*/
+_NODISC_ inline void *pool_allocate(const size_t bytes) {
+    void *ptr = math::memory::impl::pool_try_allocate(bytes == 0 ? 1 : bytes);
+    if (ptr) [[likely]] return ptr;
+    else throw std::bad_alloc{};
+}
+
+// Freeing a buffer from pool_allocate, from any thread.
+inline void pool_free(void *ptr) noexcept {
+    math::memory::impl::pool_free_block(ptr);
+}
+
+// Number of bytes usable in a buffer from pool_allocate.
+_NODISC_ inline size_t pool_block_size(const void *ptr) noexcept {
+    return ptr == nullptr ? 0 : math::memory::impl::pool_header(ptr)->capacity;
+}
+
+/**
+ * @brief Setting when the thread caches give memory back to the system.
+ * @param thread_cache_bytes Most bytes a thread keeps cached before it trims.
+ * @param trim_interval Number of frees between two trims, each trim releases the blocks that stayed unused since the previous one.
+*/
+inline void set_pool_limits(const size_t thread_cache_bytes = static_cast<size_t>(16) << 20, const size_t trim_interval = 4096) noexcept {
+    impl::pool_thread_cache_limit.store(thread_cache_bytes, std::memory_order_relaxed);
+    impl::pool_trim_interval.store(trim_interval == 0 ? 1 : trim_interval, std::memory_order_relaxed);
+}
+
+// Bytes cached by the calling thread, not counted by the memory statistics or budgets.
+_NODISC_ inline size_t pool_cached_bytes() noexcept {
+    return impl::pool_cache == nullptr ? 0 : impl::pool_cache->cached_bytes;
+}
+
+// Allocations of the calling thread served from its cache, the misses went to the system(blocks bigger than pool_max_block are not counted).
+_NODISC_ inline size_t pool_hits() noexcept {
+    return impl::pool_cache == nullptr ? 0 : impl::pool_cache->hits;
+}
+
+_NODISC_ inline size_t pool_misses() noexcept {
+    return impl::pool_cache == nullptr ? 0 : impl::pool_cache->misses;
+}
+
+// Releasing every block cached by the calling thread and by the caches of exited threads, and the blocks freed to the remote lists of running threads.
+inline void pool_trim() noexcept {
+    if (impl::pool_cache != nullptr) impl::pool_trim_cache(*impl::pool_cache, true);
+    impl::PoolRegistry &registry = impl::PoolRegistry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    for (impl::PoolThreadCache *cache : registry.caches) {
+        bool expected = false;
+        if (!cache->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            impl::pool_release_remote(*cache); // The local lists belong to the running owner, the remote list can be taken by anyone.
+            continue;
+        }
+        impl::pool_trim_cache(*cache, true);
+        cache->in_use.store(false, std::memory_order_release);
+    }
+}
+}
\ No newline at end of file
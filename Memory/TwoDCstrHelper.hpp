@@ -1,6 +1,8 @@
 // TwoDCstrHelper.hpp
 #pragma once
 #include "MemoryAlloc.hpp"
+#include "Numa.hpp"
+#include "../Profile/Trace.hpp"
 
 #define _PRE_INC_2_(x, y) ++x; ++y;
 
@@ -99,6 +101,101 @@ _MTEMPL_ inline T** allocate_2d_safe_memory(const size_t num_rows, const size_t
     return mem_ptr;
 }
 
+/**
+ * @brief Allocating and constructing a 2D array with every row first touched by the thread that owns it in the parallel kernels.
+ * @tparam T Type of the elements to allocate memory for.
+ * @tparam RowConstructor Callable as construct_row(T *row, size_t row_index) noexcept, constructing all the elements of the row.
+ * @param num_rows Number of rows in the 2D array.
+ * @param row_size Size of the rows of the 2D array.
+ * @param construct_row Constructor of a single row.
+ * @throws math::memory::memory_budget_exceeded If the whole 2D array does not fit the memory budget of the caller.
+ * @throws std::bad_alloc If the memory allocation of any row fails(every row already built is destroyed).
+ * @return Pointer to the allocated memory.
+ * @note The rows are charged to the budget of the calling thread, even the ones allocated by the rest of the team.
+ * @note Rows are split with the same schedule(static) partition as the Matrix kernels, so on a NUMA machine each row lands on the node of the thread that later works on it.
+*/
+template <typename T, typename RowConstructor>
+inline T** allocate_2d_first_touch(const size_t num_rows, const size_t row_size, const RowConstructor &construct_row) {
+    const size_t total_bytes = num_rows * row_size * sizeof(T);
+    math::memory::impl::budget_release(math::memory::impl::budget_reserve(total_bytes), total_bytes); // Fail before any row is built if the whole array can't fit.
+    T** mem_ptr = math::memory::allocate_memory<T*>(num_rows);
+    const bool is_parallel = (num_rows > 1) && (total_bytes >= math::memory::impl::first_touch_threshold.load(std::memory_order_relaxed));
+    const bool interleave = (math::memory::numa_placement() == NP::interleave);
+    const HugePagePolicy huge_policy = math::memory::impl::scope_huge_page_policy; // Thread locals, so they have to be handed to the team.
+    const AllocTag alloc_tag = math::memory::current_alloc_tag();
+    const size_t budget = math::memory::impl::thread_budget;
+    math::memory::impl::BudgetAccount *const budget_account = math::memory::impl::thread_budget_account;
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    #pragma omp parallel if(is_parallel)
+    {
+        HugePageScope huge_page_scope(huge_policy);
+        AllocTagScope alloc_tag_scope(alloc_tag);
+        math::memory::impl::BudgetAccountScope budget_account_scope(budget, budget_account); // The caller owns(and will free) the rows.
+        {
+            _TRACE_SPAN_(allocate, "allocate_rows")
+            #pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < num_rows; i++) {
+                try { mem_ptr[i] = math::memory::allocate_memory<T>(row_size); }
+                catch(...) {
+                    mem_ptr[i] = nullptr;
+                    if (!failed.exchange(true, std::memory_order_relaxed)) error = std::current_exception();
+                    continue;
+                }
+                if (interleave) math::memory::impl::interleave_pages(mem_ptr[i], row_size * sizeof(T));
+                construct_row(mem_ptr[i], i);
+            }
+        }
+    }
+    if (failed.load(std::memory_order_relaxed)) {
+        for (size_t i = 0; i < num_rows; i++) math::memory::free_memory(mem_ptr[i], mem_ptr[i] ? row_size : 0);
+        math::memory::free_memory(mem_ptr, 0);
+        std::rethrow_exception(error);
+    }
+    return mem_ptr;
+}
+
+/**
+ * @brief Allocating a 2D array filled with a value, in parallel(see allocate_2d_first_touch).
+ * @tparam T Type of the elements to allocate memory for.
+ * @param num_rows Number of rows in the 2D array.
+ * @param row_size Size of the rows of the 2D array.
+ * @param val Value to fill the memory with.
+ * @throws std::bad_alloc If the memory allocation fails.
+ * @return Pointer to the allocated memory.
+*/
+_MTEMPL_ inline T** allocate_2d_first_touch_fill(const size_t num_rows, const size_t row_size, const T &val)
+requires std::is_nothrow_copy_constructible_v<T> {
+    return math::memory::allocate_2d_first_touch<T>(num_rows, row_size, [&val, row_size](T *row, size_t) noexcept { std::uninitialized_fill_n(row, row_size, val); });
+}
+
+/**
+ * @brief Allocating a 2D array of value constructed elements, in parallel(see allocate_2d_first_touch).
+ * @tparam T Type of the elements to allocate memory for.
+ * @param num_rows Number of rows in the 2D array.
+ * @param row_size Size of the rows of the 2D array.
+ * @throws std::bad_alloc If the memory allocation fails.
+ * @return Pointer to the allocated memory.
+*/
+_MTEMPL_ inline T** allocate_2d_first_touch_valcon(const size_t num_rows, const size_t row_size)
+requires std::is_nothrow_default_constructible_v<T> {
+    return math::memory::allocate_2d_first_touch<T>(num_rows, row_size, [row_size](T *row, size_t) noexcept { std::uninitialized_value_construct_n(row, row_size); });
+}
+
+/**
+ * @brief Allocating a copy of a 2D array, in parallel(see allocate_2d_first_touch).
+ * @tparam T Type of the elements to allocate memory for.
+ * @param source Pointer to the rows to copy.
+ * @param num_rows Number of rows in the 2D array.
+ * @param row_size Size of the rows of the 2D array.
+ * @throws std::bad_alloc If the memory allocation fails.
+ * @return Pointer to the allocated memory.
+*/
+_MTEMPL_ inline T** allocate_2d_first_touch_copy(read_ptr2d<T> source, const size_t num_rows, const size_t row_size)
+requires std::is_nothrow_copy_constructible_v<T> {
+    return math::memory::allocate_2d_first_touch<T>(num_rows, row_size, [source, row_size](T *row, const size_t i) noexcept { std::uninitialized_copy_n(source[i], row_size, row); });
+}
+
 /**
  * @brief Allocating memory for a row in a 2D array(allocation and construction in a separate loop).
  * @tparam T Type of the elements to allocate memory for.
@@ -247,7 +344,7 @@ requires DfltCtor<T> {
  * @throws std::exception If the constructor throws an exception.
 */
 template <typename T, std::input_iterator Iter>
-inline void mem_2d_safe_uninit_copy_n(T* to_construct_at, const size_t size, Iter &it, T** &mem, const size_t curr_i, const size_t num_rows, const size_t row_size)
+inline void mem_2d_safe_uninit_copy_n(T* to_construct_at, const size_t size, Iter it, T** &mem, const size_t curr_i, const size_t num_rows, const size_t row_size)
 requires CpyCtor<T> && std::same_as<std::decay_t<T>, std::decay_t<decltype(*std::declval<Iter>())>> {
     if constexpr (!std::is_nothrow_copy_constructible_v<T>) {
         size_t created_items;
@@ -268,7 +365,7 @@ requires CpyCtor<T> && std::same_as<std::decay_t<T>, std::decay_t<decltype(*std:
  * @throws std::exception If the constructor throws an exception.
 */
 template <typename T, std::input_iterator Iter>
-inline void mem_2d_safe_uninit_copy_n_continuous(T* to_construct_at, const size_t size, Iter &it, T** &mem, const size_t curr_i, const size_t row_size)
+inline void mem_2d_safe_uninit_copy_n_continuous(T* to_construct_at, const size_t size, Iter it, T** &mem, const size_t curr_i, const size_t row_size)
 requires CpyCtor<T> && std::same_as<std::decay_t<T>, std::decay_t<decltype(*std::declval<Iter>())>> {
     if constexpr (!std::is_nothrow_copy_constructible_v<T>) {
         size_t created_items;
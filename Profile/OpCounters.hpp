@@ -0,0 +1,173 @@
+// OpCounters.hpp
+#pragma once
+#include "OpKind.hpp"
+#include "PerfCounters.hpp"
+#include "Trace.hpp"
+
+// Define MATH_ENABLE_OP_COUNTERS to compile the per operation FLOP/byte/time counting into the Matrix operations.
+
+namespace math::profile {
+inline constexpr const size_t op_log_capacity = 4096; // Most recent calls kept for the per call roofline.
+
+struct OpRecord {
+    OpKind kind;
+    size_t m, n, k;
+    double flops;
+    double bytes;
+    double seconds;
+};
+
+struct OpKindStats {
+    uint64_t calls = 0;
+    double flops = 0;
+    double bytes = 0;
+    double seconds = 0;
+};
+
+struct OpStats {
+    OpKindStats kinds[op_kind_count];
+    std::vector<OpRecord> recent; // Oldest first, at most op_log_capacity.
+
+    _NODISC_ const OpKindStats &of(const OpKind kind) const noexcept {
+        return kinds[static_cast<size_t>(kind)];
+    }
+};
+
+// Called after every counted operation(outside of any lock), on the thread that ran it.
+using OpHook = void (*)(const OpRecord &record, void *user_data);
+}
+
+namespace math::profile::impl {
+struct OpRegistry {
+    std::mutex lock;
+    OpKindStats kinds[op_kind_count];
+    std::vector<OpRecord> log;
+    size_t log_next = 0;
+    OpHook hook = nullptr;
+    void *hook_data = nullptr;
+    std::atomic<bool> enabled{true};
+
+    static OpRegistry &instance() noexcept {
+        static OpRegistry registry;
+        return registry;
+    }
+};
+
+inline thread_local unsigned op_scope_depth = 0;
+
+inline void record_op(const OpRecord &record) {
+    OpRegistry &registry = OpRegistry::instance();
+    OpHook hook;
+    void *hook_data;
+    {
+        std::lock_guard<std::mutex> guard(registry.lock); // An operation takes microseconds at least, an uncontended lock is noise.
+        OpKindStats &stats = registry.kinds[static_cast<size_t>(record.kind)];
+        ++stats.calls;
+        stats.flops += record.flops;
+        stats.bytes += record.bytes;
+        stats.seconds += record.seconds;
+        if (registry.log.size() < op_log_capacity) registry.log.push_back(record);
+        else registry.log[registry.log_next] = record;
+        registry.log_next = (registry.log_next + 1) % op_log_capacity;
+        hook = registry.hook;
+        hook_data = registry.hook_data;
+    }
+    if (hook) hook(record, hook_data);
+}
+}
+
+namespace math::profile {
+/**
+ * @brief Timing and counting an operation while alive, nested scopes on the same thread are not counted so Matrix::operator* stays one multiply through its inner copies.
+ * @note With MATH_ENABLE_PERF_COUNTERS the hardware counters of the thread are read around the operation too, with MATH_ENABLE_TRACING it is recorded as an operation span.
+*/
+class OpScope {
+    public:
+        OpScope(const OpKind kind, const size_t m, const size_t n, const size_t k, const size_t element_size) noexcept
+        : m_kind(kind), m_m(m), m_n(n), m_k(k), m_element_size(element_size), m_outermost(impl::op_scope_depth++ == 0) {
+            if (!m_outermost) return;
+#if defined(MATH_ENABLE_PERF_COUNTERS)
+            m_perf_start = impl::begin_perf();
+#endif
+            m_start = std::chrono::steady_clock::now();
+        }
+        ~OpScope() noexcept {
+            --impl::op_scope_depth;
+            if (!m_outermost) return;
+#if defined(MATH_ENABLE_PERF_COUNTERS)
+            impl::end_perf(m_kind, m_perf_start);
+#endif
+            const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+#if defined(MATH_ENABLE_TRACING)
+            if (tracing_enabled()) impl::record_span(SK::operation, op_kind_name(m_kind), m_start, end, m_m, m_n, m_k);
+#endif
+            if (!impl::OpRegistry::instance().enabled.load(std::memory_order_relaxed)) return;
+            const double seconds = std::chrono::duration<double>(end - m_start).count();
+            const OpCost cost = op_cost(m_kind, m_m, m_n, m_k, m_element_size);
+            try { impl::record_op(OpRecord{ m_kind, m_m, m_n, m_k, cost.flops, cost.bytes, seconds }); }
+            catch(...) {} // Counting must never turn a successful operation into a failure.
+        }
+        OpScope(const OpScope&) = delete;
+        OpScope &operator=(const OpScope&) = delete;
+
+    private:
+        OpKind m_kind;
+        size_t m_m, m_n, m_k, m_element_size;
+        bool m_outermost;
+        std::chrono::steady_clock::time_point m_start{};
+#if defined(MATH_ENABLE_PERF_COUNTERS)
+        PerfSample m_perf_start{};
+#endif
+};
+
+/**
+ * @brief Pausing or resuming the counting at runtime(on by default when compiled in).
+*/
+inline void set_op_counting(const bool enabled) noexcept {
+    impl::OpRegistry::instance().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Installing a hook called with every counted operation.
+ * @param hook Hook, nullptr removes it.
+ * @param user_data Passed back to the hook.
+*/
+inline void set_op_hook(const OpHook hook, void *const user_data = nullptr) {
+    impl::OpRegistry &registry = impl::OpRegistry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    registry.hook = hook;
+    registry.hook_data = user_data;
+}
+
+/**
+ * @brief Snapshot of the per operation totals and the most recent calls.
+*/
+_NODISC_ inline OpStats op_stats() {
+    impl::OpRegistry &registry = impl::OpRegistry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    OpStats result;
+    std::copy(std::begin(registry.kinds), std::end(registry.kinds), std::begin(result.kinds));
+    result.recent.reserve(registry.log.size());
+    if (registry.log.size() < op_log_capacity) result.recent = registry.log;
+    else {
+        result.recent.insert(result.recent.end(), registry.log.begin() + static_cast<std::ptrdiff_t>(registry.log_next), registry.log.end());
+        result.recent.insert(result.recent.end(), registry.log.begin(), registry.log.begin() + static_cast<std::ptrdiff_t>(registry.log_next));
+    }
+    return result;
+}
+
+inline void reset_op_stats() {
+    impl::OpRegistry &registry = impl::OpRegistry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    std::fill(std::begin(registry.kinds), std::end(registry.kinds), OpKindStats{});
+    registry.log.clear();
+    registry.log_next = 0;
+}
+}
+
+#if defined(MATH_ENABLE_OP_COUNTERS) || defined(MATH_ENABLE_PERF_COUNTERS) || defined(MATH_ENABLE_TRACING)
+    #define _OP_SCOPE_SIZED_(kind, m, n, k, element_size) math::profile::OpScope op_scope(math::profile::OK::kind, m, n, k, element_size);
+#else
+    #define _OP_SCOPE_SIZED_(kind, m, n, k, element_size)
+#endif
+#define _OP_SCOPE_(kind, m, n, k) _OP_SCOPE_SIZED_(kind, m, n, k, sizeof(T))
\ No newline at end of file
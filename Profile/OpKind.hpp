@@ -0,0 +1,53 @@
+// OpKind.hpp
+#pragma once
+#include "../Helper/Headers.hpp"
+
+namespace math::profile {
+enum class OpKind : char {
+    add, subtract, multiply, transpose, compare, reduction, variable, factorize
+};
+using OK = OpKind;
+
+inline constexpr const size_t op_kind_count = 8;
+
+_NODISC_ inline constexpr const char *op_kind_name(const OpKind kind) noexcept {
+    switch (kind) {
+        case OK::add:       return "add";
+        case OK::subtract:  return "subtract";
+        case OK::multiply:  return "multiply";
+        case OK::transpose: return "transpose";
+        case OK::compare:   return "compare";
+        case OK::variable:  return "variable";
+        case OK::factorize: return "factorize";
+        default:            return "reduction";
+    }
+}
+
+struct OpCost {
+    double flops;
+    double bytes; // Compulsory traffic: every operand read once and the result written once.
+};
+
+/**
+ * @brief Cost model of an operation on an m x n result(or operand) with inner dimension k.
+ * @param kind Operation.
+ * @param m Rows.
+ * @param n Columns.
+ * @param k Inner dimension(multiply), FLOPs per element of the operand(factorize).
+ * @param element_size Size of an element in bytes.
+ * @return FLOPs(a multiply-add counts as 2) and bytes moved.
+*/
+_NODISC_ inline constexpr OpCost op_cost(const OpKind kind, const size_t m, const size_t n, const size_t k, const size_t element_size) noexcept {
+    const double dm = static_cast<double>(m), dn = static_cast<double>(n), dk = static_cast<double>(k), e = static_cast<double>(element_size);
+    switch (kind) {
+        case OK::add:
+        case OK::subtract:  return OpCost{ dm * dn, 3 * dm * dn * e };
+        case OK::multiply:  return OpCost{ 2 * dm * dn * dk, (dm * dk + dk * dn + dm * dn) * e };
+        case OK::transpose: return OpCost{ 0, 2 * dm * dn * e };
+        case OK::compare:   return OpCost{ 0, 2 * dm * dn * e };
+        case OK::variable:  return OpCost{ 0, 2 * dm * dn * e }; // Name checked and copied, m is its length.
+        case OK::factorize: return OpCost{ dm * dn * dk, 2 * dm * dn * e }; // Factorised in place.
+        default:            return OpCost{ dm * dn, dm * dn * e };
+    }
+}
+}
\ No newline at end of file
@@ -0,0 +1,404 @@
+// PerfCounters.hpp
+#pragma once
+#include "OpKind.hpp"
+
+#if defined(__linux__)
+    #include <unistd.h>
+    #include <sys/syscall.h>
+    #include <linux/perf_event.h>
+#endif
+
+// Define MATH_ENABLE_PERF_COUNTERS to read the hardware counters(Linux perf_event_open) around every Matrix operation.
+// Counting the own threads in user space needs /proc/sys/kernel/perf_event_paranoid <= 2, events the CPU or the hypervisor does not expose are skipped.
+
+namespace math::profile {
+enum class PerfEvent : char {
+    cycles, instructions, llc_misses, dtlb_misses, branch_misses
+};
+using PE = PerfEvent;
+
+inline constexpr const size_t perf_event_count = 5;
+
+_NODISC_ inline constexpr const char *perf_event_name(const PerfEvent event) noexcept {
+    switch (event) {
+        case PE::cycles:       return "cycles";
+        case PE::instructions: return "instructions";
+        case PE::llc_misses:   return "llc_misses";
+        case PE::dtlb_misses:  return "dtlb_misses";
+        default:               return "branch_misses";
+    }
+}
+
+// Raw values of a counter group at one point in time.
+struct PerfSample {
+    uint64_t values[perf_event_count] = {};
+    uint64_t time_enabled = 0;
+    uint64_t time_running = 0; // Less than time_enabled when the kernel multiplexed the group out.
+    uint32_t mask = 0;         // Bit e set if PerfEvent e is counted.
+};
+
+// Counts between two samples, scaled up for the time the group was multiplexed out.
+struct PerfReading {
+    double values[perf_event_count] = {};
+    uint32_t mask = 0;
+
+    _NODISC_ bool has(const PerfEvent event) const noexcept { return (mask >> static_cast<unsigned>(event)) & 1; }
+    _NODISC_ double of(const PerfEvent event) const noexcept { return values[static_cast<size_t>(event)]; }
+
+    PerfReading &operator+=(const PerfReading &other) noexcept {
+        mask |= other.mask;
+        for (size_t e = 0; e < perf_event_count; e++) values[e] += other.values[e];
+        return *this;
+    }
+};
+
+/**
+ * @brief Counts between two samples of the same group.
+ * @return The scaled counts, with an empty mask if the group was never scheduled in between.
+*/
+_NODISC_ inline PerfReading perf_delta(const PerfSample &start, const PerfSample &end) noexcept {
+    PerfReading result;
+    if (end.time_running <= start.time_running) return result;
+    const double scale = static_cast<double>(end.time_enabled - start.time_enabled) / static_cast<double>(end.time_running - start.time_running);
+    result.mask = start.mask & end.mask;
+    for (size_t e = 0; e < perf_event_count; e++)
+        if ((result.mask >> e) & 1) result.values[e] = static_cast<double>(end.values[e] - start.values[e]) * scale;
+    return result;
+}
+}
+
+namespace math::profile::impl {
+#if defined(__linux__)
+struct PerfEventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+inline constexpr const PerfEventConfig perf_event_configs[perf_event_count] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+#endif
+}
+
+namespace math::profile {
+/**
+ * @brief The hardware counters of the calling thread, opened as one group so that a single read gives a consistent sample.
+ * @note The counters keep following the thread that opened them, so the group can be sampled from any thread.
+*/
+class PerfCounterGroup {
+    public:
+        PerfCounterGroup() noexcept {
+#if defined(__linux__) && defined(SYS_perf_event_open)
+            for (size_t e = 0; e < perf_event_count; e++) {
+                perf_event_attr attr{};
+                attr.type = impl::perf_event_configs[e].type;
+                attr.size = sizeof(attr);
+                attr.config = impl::perf_event_configs[e].config;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                const long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, m_fds[0] < 0 ? -1 : m_fds[0], PERF_FLAG_FD_CLOEXEC);
+                if (fd < 0) continue; // Not supported here, the rest of the group still counts.
+                m_fds[m_opened++] = static_cast<int>(fd);
+                m_mask |= 1u << e;
+            }
+#endif
+        }
+        ~PerfCounterGroup() noexcept {
+#if defined(__linux__)
+            for (size_t i = m_opened; i-- > 0;) ::close(m_fds[i]); // Members before the leader.
+#endif
+        }
+        PerfCounterGroup(const PerfCounterGroup&) = delete;
+        PerfCounterGroup &operator=(const PerfCounterGroup&) = delete;
+
+    public:
+        _NODISC_ bool available() const noexcept { return m_opened != 0; }
+        _NODISC_ bool has(const PerfEvent event) const noexcept { return (m_mask >> static_cast<unsigned>(event)) & 1; }
+        _NODISC_ uint32_t mask() const noexcept { return m_mask; }
+
+        /**
+         * @brief Reading every counter of the group at once.
+         * @return The sample, with an empty mask if nothing could be read.
+        */
+        _NODISC_ PerfSample sample() const noexcept {
+            PerfSample result;
+#if defined(__linux__)
+            if (m_opened == 0) return result;
+            uint64_t buffer[3 + perf_event_count];
+            const ssize_t bytes = ::read(m_fds[0], buffer, sizeof(buffer));
+            if (bytes < static_cast<ssize_t>((3 + m_opened) * sizeof(uint64_t)) || buffer[0] != m_opened) return result;
+            result.time_enabled = buffer[1];
+            result.time_running = buffer[2];
+            size_t slot = 3; // Values come in the order the events joined the group.
+            for (size_t e = 0; e < perf_event_count; e++) if ((m_mask >> e) & 1) result.values[e] = buffer[slot++];
+            result.mask = m_mask;
+#endif
+            return result;
+        }
+
+    private:
+        int m_fds[perf_event_count] = { -1, -1, -1, -1, -1 }; // m_fds[0] leads the group.
+        size_t m_opened = 0;
+        uint32_t m_mask = 0;
+};
+
+struct PerfKindStats {
+    uint64_t calls = 0;    // Operations run while the counting was on.
+    uint64_t measured = 0; // Of them, the ones the counters were scheduled for.
+    double values[perf_event_count] = {};
+    uint32_t mask = 0;
+
+    _NODISC_ bool has(const PerfEvent event) const noexcept { return (mask >> static_cast<unsigned>(event)) & 1; }
+    _NODISC_ double of(const PerfEvent event) const noexcept { return values[static_cast<size_t>(event)]; }
+    _NODISC_ double per_call(const PerfEvent event) const noexcept { return measured == 0 ? 0 : of(event) / static_cast<double>(measured); }
+    _NODISC_ double ipc() const noexcept { return of(PE::cycles) > 0 ? of(PE::instructions) / of(PE::cycles) : 0; }
+
+    PerfKindStats &operator+=(const PerfKindStats &other) noexcept {
+        calls += other.calls;
+        measured += other.measured;
+        mask |= other.mask;
+        for (size_t e = 0; e < perf_event_count; e++) values[e] += other.values[e];
+        return *this;
+    }
+};
+
+struct ThreadPerfStats {
+    size_t thread = 0; // In the order the threads first ran a counted operation.
+    long tid = 0;      // Kernel thread id, 0 if unknown.
+    bool exited = false;
+    PerfKindStats kinds[op_kind_count];
+
+    _NODISC_ const PerfKindStats &of(const OpKind kind) const noexcept { return kinds[static_cast<size_t>(kind)]; }
+};
+
+// A snapshot of every thread's counters, taken by math::profile::perf_stats().
+struct PerfStats {
+    std::vector<ThreadPerfStats> threads;
+    PerfKindStats kinds[op_kind_count]; // Summed over the threads.
+
+    _NODISC_ const PerfKindStats &of(const OpKind kind) const noexcept { return kinds[static_cast<size_t>(kind)]; }
+};
+}
+
+namespace math::profile::impl {
+// Written only by its own thread(relaxed load + store, no read-modify-write), read by anyone.
+struct ThreadPerfCounters {
+    struct Kind {
+        std::atomic<uint64_t> calls{0}, measured{0};
+        std::atomic<double> values[perf_event_count] = {};
+        std::atomic<uint32_t> mask{0};
+    } kinds[op_kind_count];
+    PerfCounterGroup group;
+    size_t thread = 0;
+    long tid = 0;
+
+    ThreadPerfCounters();
+    ~ThreadPerfCounters();
+    _NODISC_ ThreadPerfStats snapshot() const noexcept;
+};
+
+struct PerfRegistry {
+    std::mutex lock;
+    std::vector<ThreadPerfCounters*> threads;
+    std::vector<ThreadPerfStats> retired; // Counters of the threads that already exited.
+    size_t next_thread = 0;
+    std::atomic<bool> enabled{true};
+
+    static PerfRegistry &instance() noexcept {
+        static PerfRegistry registry;
+        return registry;
+    }
+};
+
+template <class T>
+inline void add_relaxed(std::atomic<T> &counter, const T amount) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+inline ThreadPerfCounters::ThreadPerfCounters() {
+#if defined(__linux__) && defined(SYS_gettid)
+    tid = ::syscall(SYS_gettid);
+#endif
+    PerfRegistry &registry = PerfRegistry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    thread = registry.next_thread++;
+    registry.threads.push_back(this);
+}
+
+inline ThreadPerfCounters::~ThreadPerfCounters() {
+    PerfRegistry &registry = PerfRegistry::instance();
+    ThreadPerfStats stats = snapshot();
+    stats.exited = true;
+    std::lock_guard<std::mutex> guard(registry.lock);
+    std::erase(registry.threads, this);
+    try { registry.retired.push_back(stats); }
+    catch(...) {} // Losing an exited thread's counters beats terminating.
+}
+
+inline ThreadPerfStats ThreadPerfCounters::snapshot() const noexcept {
+    ThreadPerfStats stats;
+    stats.thread = thread;
+    stats.tid = tid;
+    for (size_t k = 0; k < op_kind_count; k++) {
+        PerfKindStats &to = stats.kinds[k];
+        const Kind &from = kinds[k];
+        to.calls = from.calls.load(std::memory_order_relaxed);
+        to.measured = from.measured.load(std::memory_order_relaxed);
+        to.mask = from.mask.load(std::memory_order_relaxed);
+        for (size_t e = 0; e < perf_event_count; e++) to.values[e] = from.values[e].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+_NODISC_ inline ThreadPerfCounters *thread_perf_counters() noexcept {
+    try {
+        static thread_local ThreadPerfCounters counters;
+        return &counters;
+    }
+    catch(...) { return nullptr; } // Registration ran out of memory, this thread goes uncounted.
+}
+
+/**
+ * @brief Sampling the calling thread's counters at the start of an operation(opening them on the first call).
+ * @return The sample, with an empty mask if counting is off or not available.
+*/
+_NODISC_ inline PerfSample begin_perf() noexcept {
+    if (!PerfRegistry::instance().enabled.load(std::memory_order_relaxed)) return {};
+    const ThreadPerfCounters *counters = thread_perf_counters();
+    return counters ? counters->group.sample() : PerfSample{};
+}
+
+inline void end_perf(const OpKind kind, const PerfSample &start) noexcept {
+    if (start.mask == 0) return;
+    ThreadPerfCounters *counters = thread_perf_counters();
+    if (!counters) return;
+    const PerfReading reading = perf_delta(start, counters->group.sample());
+    ThreadPerfCounters::Kind &stats = counters->kinds[static_cast<size_t>(kind)];
+    add_relaxed<uint64_t>(stats.calls, 1);
+    if (reading.mask == 0) return;
+    add_relaxed<uint64_t>(stats.measured, 1);
+    stats.mask.store(stats.mask.load(std::memory_order_relaxed) | reading.mask, std::memory_order_relaxed);
+    for (size_t e = 0; e < perf_event_count; e++) add_relaxed(stats.values[e], reading.values[e]);
+}
+}
+
+namespace math::profile {
+/**
+ * @brief Pausing or resuming the hardware counting at runtime(on by default when compiled in).
+*/
+inline void set_perf_counting(const bool enabled) noexcept {
+    impl::PerfRegistry::instance().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Which hardware events can be counted on the calling thread.
+ * @return Bit e set if PerfEvent e can be counted, 0 if perf_event_open is refused or missing.
+*/
+_NODISC_ inline uint32_t available_perf_events() noexcept {
+    return PerfCounterGroup().mask();
+}
+
+/**
+ * @brief Snapshot of the per thread and per operation hardware counts.
+*/
+_NODISC_ inline PerfStats perf_stats() {
+    impl::PerfRegistry &registry = impl::PerfRegistry::instance();
+    PerfStats result;
+    {
+        std::lock_guard<std::mutex> guard(registry.lock);
+        result.threads = registry.retired;
+        for (const impl::ThreadPerfCounters *counters : registry.threads) result.threads.push_back(counters->snapshot());
+    }
+    std::sort(result.threads.begin(), result.threads.end(), [](const ThreadPerfStats &a, const ThreadPerfStats &b) { return a.thread < b.thread; });
+    for (const ThreadPerfStats &thread : result.threads)
+        for (size_t k = 0; k < op_kind_count; k++) result.kinds[k] += thread.kinds[k];
+    return result;
+}
+
+// Zeroes the counts of the live threads(racing with operations that are running) and forgets the exited ones.
+inline void reset_perf_stats() {
+    impl::PerfRegistry &registry = impl::PerfRegistry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    registry.retired.clear();
+    for (impl::ThreadPerfCounters *counters : registry.threads) {
+        for (impl::ThreadPerfCounters::Kind &kind : counters->kinds) {
+            kind.calls.store(0, std::memory_order_relaxed);
+            kind.measured.store(0, std::memory_order_relaxed);
+            kind.mask.store(0, std::memory_order_relaxed);
+            for (std::atomic<double> &value : kind.values) value.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Human readable per operation(and per thread when there are several) hardware counts, averaged per measured call.
+*/
+_NODISC_ inline std::string perf_report(const PerfStats &stats) {
+    std::string out;
+    char line[256];
+    const auto header = [&](const char *title) {
+        std::snprintf(line, sizeof(line), "%-24s %10s %10s %14s %14s %7s %12s %12s %12s\n", title, "calls", "measured", "cycles/call", "instr/call", "IPC", "LLC miss", "dTLB miss", "br miss");
+        out += line;
+    };
+    const auto row = [&](const PerfKindStats &s, const char *label) {
+        const auto cell = [&](const PerfEvent e) { return s.has(e) ? s.per_call(e) : std::numeric_limits<double>::quiet_NaN(); };
+        std::snprintf(line, sizeof(line), "%-24s %10llu %10llu %14.1f %14.1f %7.2f %12.2f %12.2f %12.2f\n", label,
+            static_cast<unsigned long long>(s.calls), static_cast<unsigned long long>(s.measured), cell(PE::cycles), cell(PE::instructions),
+            s.has(PE::cycles) && s.has(PE::instructions) ? s.ipc() : std::numeric_limits<double>::quiet_NaN(), cell(PE::llc_misses), cell(PE::dtlb_misses), cell(PE::branch_misses));
+        out += line;
+    };
+    header("operation");
+    for (size_t k = 0; k < op_kind_count; k++) if (stats.kinds[k].calls != 0) row(stats.kinds[k], op_kind_name(static_cast<OpKind>(k)));
+    if (stats.threads.size() < 2) return out;
+    for (const ThreadPerfStats &thread : stats.threads) {
+        char title[64];
+        std::snprintf(title, sizeof(title), "thread %zu (tid %ld)%s", thread.thread, thread.tid, thread.exited ? " exited" : "");
+        header(title);
+        for (size_t k = 0; k < op_kind_count; k++) if (thread.kinds[k].calls != 0) row(thread.kinds[k], op_kind_name(static_cast<OpKind>(k)));
+    }
+    return out;
+}
+
+/**
+ * @brief Dumping the hardware counts as JSON, events that were never counted are left out.
+ * @return {"kinds":[{"op":..,"calls":..,"measured":..,"<event>":<total>..}..],"threads":[{"thread":..,"tid":..,"exited":..,"kinds":[..]}..]}
+*/
+_NODISC_ inline std::string perf_json(const PerfStats &stats) {
+    const auto kinds_json = [](const PerfKindStats (&kinds)[op_kind_count]) {
+        std::string json = "[";
+        bool first = true;
+        for (size_t k = 0; k < op_kind_count; k++) {
+            const PerfKindStats &s = kinds[k];
+            if (s.calls == 0) continue;
+            char buffer[128];
+            std::snprintf(buffer, sizeof(buffer), "%s{\"op\":\"%s\",\"calls\":%llu,\"measured\":%llu", first ? "" : ",",
+                op_kind_name(static_cast<OpKind>(k)), static_cast<unsigned long long>(s.calls), static_cast<unsigned long long>(s.measured));
+            json += buffer;
+            first = false;
+            for (size_t e = 0; e < perf_event_count; e++) {
+                if (!s.has(static_cast<PerfEvent>(e))) continue;
+                std::snprintf(buffer, sizeof(buffer), ",\"%s\":%.17g", perf_event_name(static_cast<PerfEvent>(e)), s.values[e]);
+                json += buffer;
+            }
+            json += '}';
+        }
+        return json + ']';
+    };
+    std::string json = "{\"kinds\":" + kinds_json(stats.kinds) + ",\"threads\":[";
+    for (size_t t = 0; t < stats.threads.size(); t++) {
+        const ThreadPerfStats &thread = stats.threads[t];
+        char buffer[96];
+        std::snprintf(buffer, sizeof(buffer), "%s{\"thread\":%zu,\"tid\":%ld,\"exited\":%s,\"kinds\":", t == 0 ? "" : ",", thread.thread, thread.tid, thread.exited ? "true" : "false");
+        json += buffer;
+        json += kinds_json(thread.kinds);
+        json += '}';
+    }
+    json += "]}";
+    return json;
+}
+}
\ No newline at end of file
@@ -0,0 +1,249 @@
+// Roofline.hpp
+#pragma once
+#include "OpCounters.hpp"
+
+namespace math::profile {
+struct MachinePeak {
+    double gb_per_s = 0;
+    double gflop_per_s = 0;
+
+    // Arithmetic intensity(FLOP/byte) where the memory roof meets the compute roof.
+    _NODISC_ double ridge_intensity() const noexcept {
+        return gb_per_s > 0 ? gflop_per_s / gb_per_s : 0;
+    }
+};
+
+enum class Bound : char {
+    memory, compute
+};
+
+_NODISC_ inline constexpr const char *bound_name(const Bound bound) noexcept {
+    return bound == Bound::memory ? "memory" : "compute";
+}
+
+struct RooflinePoint {
+    OpKind kind;
+    size_t m, n, k;         // Shape of the call(of the last call for per kind points).
+    uint64_t calls;
+    double flops, bytes, seconds;
+    double intensity;       // FLOP/byte.
+    double gflop_per_s, gb_per_s;
+    double roof_gflop_per_s; // Attainable at this intensity.
+    double roof_fraction;    // Achieved over attainable, of bandwidth for memory bound points and of compute otherwise.
+    Bound bound;
+};
+}
+
+namespace math::profile::impl {
+/**
+ * @brief Best of a few STREAM triad passes(a = b + s * c) over arrays far larger than the caches, with first touch initialization by the team.
+*/
+_NODISC_ inline double measure_peak_bandwidth(const size_t bytes, const int threads) {
+    const size_t n = std::max<size_t>(bytes / (3 * sizeof(double)), 1024);
+    std::unique_ptr<double[]> a(new double[n]), b(new double[n]), c(new double[n]);
+    double *const pa = a.get(), *const pb = b.get(), *const pc = c.get();
+    #pragma omp parallel for schedule(static) num_threads(threads)
+    for (size_t i = 0; i < n; i++) {
+        pa[i] = 0.0;
+        pb[i] = 1.0;
+        pc[i] = 2.0;
+    }
+    volatile double opaque_scale = 3.0;
+    const double scale = opaque_scale;
+    double best = std::numeric_limits<double>::max();
+    for (int pass = 0; pass < 5; pass++) {
+        const auto start = std::chrono::steady_clock::now();
+        #pragma omp parallel for schedule(static) num_threads(threads)
+        for (size_t i = 0; i < n; i++) pa[i] = pb[i] + scale * pc[i];
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    volatile double sink = pa[n / 2];
+    (void)sink;
+    return 3.0 * static_cast<double>(n * sizeof(double)) / best * 1e-9;
+}
+
+/**
+ * @brief Multiply-add throughput of independent chains per thread, built with the same flags as the library so it is the peak the library can reach.
+*/
+_NODISC_ inline double measure_peak_compute(const double seconds, const int threads) {
+    static constexpr const size_t lanes = 32;
+    volatile double opaque_mul = 0.9999999, opaque_add = 1e-7;
+    const double mul = opaque_mul, add = opaque_add;
+    size_t iterations = 1 << 12;
+    for (;;) {
+        double sink = 0;
+        const auto start = std::chrono::steady_clock::now();
+        #pragma omp parallel num_threads(threads) reduction(+:sink)
+        {
+            double acc[lanes];
+            for (size_t j = 0; j < lanes; j++) acc[j] = 1.0 + static_cast<double>(j) * 1e-3;
+            for (size_t it = 0; it < iterations; it++) {
+                #pragma omp simd
+                for (size_t j = 0; j < lanes; j++) acc[j] = acc[j] * mul + add;
+            }
+            for (size_t j = 0; j < lanes; j++) sink += acc[j];
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        volatile double keep = sink;
+        (void)keep;
+        if (elapsed >= seconds) return 2.0 * lanes * static_cast<double>(iterations) * threads / elapsed * 1e-9;
+        iterations *= elapsed > 0 ? std::clamp<size_t>(static_cast<size_t>(seconds / elapsed * 1.5), 2, 16) : 16;
+    }
+}
+
+inline std::mutex machine_peak_lock;
+inline std::optional<MachinePeak> cached_machine_peak;
+}
+
+namespace math::profile {
+/**
+ * @brief Measuring the peak memory bandwidth(STREAM triad) and multiply-add throughput of this machine.
+ * @param stream_bytes Total size of the triad arrays, must be well beyond the last level cache.
+ * @param threads Threads to measure with.
+ * @return The measured peaks.
+*/
+_NODISC_ inline MachinePeak measure_machine_peak(const size_t stream_bytes = static_cast<size_t>(3) << 25, const int threads = omp_get_max_threads()) {
+    return MachinePeak{
+        math::profile::impl::measure_peak_bandwidth(stream_bytes, threads),
+        math::profile::impl::measure_peak_compute(0.05, threads),
+    };
+}
+
+/**
+ * @brief Peaks the roofline is drawn against, measured on first use unless set_machine_peak was called.
+*/
+_NODISC_ inline MachinePeak machine_peak() {
+    std::lock_guard<std::mutex> guard(impl::machine_peak_lock);
+    if (!impl::cached_machine_peak) impl::cached_machine_peak = math::profile::measure_machine_peak();
+    return *impl::cached_machine_peak;
+}
+
+// Overriding the measured peaks(e.g. with datasheet numbers).
+inline void set_machine_peak(const MachinePeak &peak) {
+    std::lock_guard<std::mutex> guard(impl::machine_peak_lock);
+    impl::cached_machine_peak = peak;
+}
+
+struct RooflinePlacement {
+    double intensity;        // FLOP/byte.
+    double roof_gflop_per_s; // Attainable at this intensity.
+    double roof_fraction;    // Achieved over attainable, of bandwidth for memory bound work and of compute otherwise.
+    Bound bound;
+};
+
+/**
+ * @brief Placing a measurement on the roofline.
+ * @return The placement, with the bound decided by which roof is lower at its intensity.
+ * @note The memory roof is the DRAM bandwidth, calls whose operands stay in cache can land above 100% of it.
+*/
+_NODISC_ inline RooflinePlacement place_on_roofline(const double flops, const double bytes, const double seconds, const MachinePeak &peak) noexcept {
+    RooflinePlacement placement{ bytes > 0 ? flops / bytes : 0, 0, 0, Bound::memory };
+    const double memory_roof = placement.intensity * peak.gb_per_s;
+    placement.bound = (bytes > 0 && memory_roof < peak.gflop_per_s) ? Bound::memory : Bound::compute;
+    placement.roof_gflop_per_s = placement.bound == Bound::memory ? memory_roof : peak.gflop_per_s;
+    if (seconds > 0) {
+        if (placement.bound == Bound::memory) placement.roof_fraction = peak.gb_per_s > 0 ? bytes / seconds * 1e-9 / peak.gb_per_s : 0;
+        else placement.roof_fraction = peak.gflop_per_s > 0 ? flops / seconds * 1e-9 / peak.gflop_per_s : 0;
+    }
+    return placement;
+}
+
+_NODISC_ inline RooflinePoint roofline_point(const OpKind kind, const size_t m, const size_t n, const size_t k, const uint64_t calls,
+                                             const double flops, const double bytes, const double seconds, const MachinePeak &peak) noexcept {
+    const RooflinePlacement placement = math::profile::place_on_roofline(flops, bytes, seconds, peak);
+    return RooflinePoint{
+        kind, m, n, k, calls, flops, bytes, seconds, placement.intensity,
+        seconds > 0 ? flops / seconds * 1e-9 : 0, seconds > 0 ? bytes / seconds * 1e-9 : 0,
+        placement.roof_gflop_per_s, placement.roof_fraction, placement.bound,
+    };
+}
+
+// One point per operation kind that was called, from the totals.
+_NODISC_ inline std::vector<RooflinePoint> roofline_by_kind(const OpStats &stats, const MachinePeak &peak) {
+    std::vector<RooflinePoint> points;
+    for (size_t i = 0; i < op_kind_count; i++) {
+        const OpKindStats &s = stats.kinds[i];
+        if (s.calls == 0) continue;
+        const OpKind kind = static_cast<OpKind>(i);
+        size_t m = 0, n = 0, k = 0;
+        for (auto it = stats.recent.rbegin(); it != stats.recent.rend(); ++it)
+            if (it->kind == kind) { m = it->m; n = it->n; k = it->k; break; }
+        points.push_back(math::profile::roofline_point(kind, m, n, k, s.calls, s.flops, s.bytes, s.seconds, peak));
+    }
+    return points;
+}
+
+// One point per recent call, oldest first.
+_NODISC_ inline std::vector<RooflinePoint> roofline_by_call(const OpStats &stats, const MachinePeak &peak) {
+    std::vector<RooflinePoint> points;
+    points.reserve(stats.recent.size());
+    for (const OpRecord &r : stats.recent) points.push_back(math::profile::roofline_point(r.kind, r.m, r.n, r.k, 1, r.flops, r.bytes, r.seconds, peak));
+    return points;
+}
+
+/**
+ * @brief Human readable roofline of the counted operations, per kind and then the slowest recent calls.
+ * @param stats Counters from op_stats().
+ * @param peak Peaks to draw the roofline against.
+ * @param max_calls Number of slowest calls to list.
+*/
+_NODISC_ inline std::string roofline_report(const OpStats &stats, const MachinePeak &peak, const size_t max_calls = 20) {
+    std::string out;
+    char line[256];
+    std::snprintf(line, sizeof(line), "peak %.2f GB/s, %.2f GFLOP/s, ridge at %.3f FLOP/byte\n", peak.gb_per_s, peak.gflop_per_s, peak.ridge_intensity());
+    out += line;
+    const auto row = [&](const RooflinePoint &p, const char *label) {
+        std::snprintf(line, sizeof(line), "%-28s %8llu %11.3e %9.3f %9.3f %9.3f %7.1f%%  %s\n", label, static_cast<unsigned long long>(p.calls),
+            p.seconds, p.intensity, p.gflop_per_s, p.gb_per_s, 100.0 * p.roof_fraction, bound_name(p.bound));
+        out += line;
+    };
+    std::snprintf(line, sizeof(line), "%-28s %8s %11s %9s %9s %9s %8s  %s\n", "operation", "calls", "seconds", "FLOP/B", "GFLOP/s", "GB/s", "of roof", "bound");
+    out += line;
+    for (const RooflinePoint &p : math::profile::roofline_by_kind(stats, peak)) row(p, op_kind_name(p.kind));
+
+    std::vector<RooflinePoint> calls = math::profile::roofline_by_call(stats, peak);
+    std::sort(calls.begin(), calls.end(), [](const RooflinePoint &a, const RooflinePoint &b) { return a.seconds > b.seconds; });
+    if (calls.size() > max_calls) calls.resize(max_calls);
+    if (!calls.empty()) out += "slowest calls:\n";
+    for (const RooflinePoint &p : calls) {
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s %zux%zu%s%s", op_kind_name(p.kind), p.m, p.n, p.k ? "x" : "", p.k ? std::to_string(p.k).c_str() : "");
+        row(p, label);
+    }
+    return out;
+}
+
+/**
+ * @brief Dumping the roofline as JSON.
+ * @return {"peak":{"gb_per_s":..,"gflop_per_s":..},"kinds":[point..],"calls":[point..]}
+*/
+_NODISC_ inline std::string roofline_json(const OpStats &stats, const MachinePeak &peak) {
+    const auto point_json = [](const RooflinePoint &p) {
+        char buffer[512];
+        std::snprintf(buffer, sizeof(buffer),
+            "{\"op\":\"%s\",\"m\":%zu,\"n\":%zu,\"k\":%zu,\"calls\":%llu,\"flops\":%.17g,\"bytes\":%.17g,\"seconds\":%.17g,\"intensity\":%.17g,"
+            "\"gflop_per_s\":%.17g,\"gb_per_s\":%.17g,\"roof_gflop_per_s\":%.17g,\"roof_fraction\":%.17g,\"bound\":\"%s\"}",
+            op_kind_name(p.kind), p.m, p.n, p.k, static_cast<unsigned long long>(p.calls), p.flops, p.bytes, p.seconds, p.intensity,
+            p.gflop_per_s, p.gb_per_s, p.roof_gflop_per_s, p.roof_fraction, bound_name(p.bound));
+        return std::string(buffer);
+    };
+    char head[128];
+    std::snprintf(head, sizeof(head), "{\"peak\":{\"gb_per_s\":%.17g,\"gflop_per_s\":%.17g},\"kinds\":[", peak.gb_per_s, peak.gflop_per_s);
+    std::string json = head;
+    bool first = true;
+    for (const RooflinePoint &p : math::profile::roofline_by_kind(stats, peak)) {
+        if (!first) json += ',';
+        first = false;
+        json += point_json(p);
+    }
+    json += "],\"calls\":[";
+    first = true;
+    for (const RooflinePoint &p : math::profile::roofline_by_call(stats, peak)) {
+        if (!first) json += ',';
+        first = false;
+        json += point_json(p);
+    }
+    json += "]}";
+    return json;
+}
+}
\ No newline at end of file
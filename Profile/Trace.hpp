@@ -0,0 +1,276 @@
+// Trace.hpp
+#pragma once
+#include "../Helper/Headers.hpp"
+
+#if defined(__linux__)
+    #include <unistd.h>
+    #include <sys/syscall.h>
+#endif
+
+// Define MATH_ENABLE_TRACING to record the Matrix operations and every thread's share of their parallel loops as timeline spans,
+// exported as Chrome trace JSON(open it in Perfetto or chrome://tracing).
+
+namespace math::profile {
+enum class SpanKind : char {
+    operation, allocate, pack, compute, reduce
+};
+using SK = SpanKind;
+
+inline constexpr const size_t trace_buffer_capacity = 16384; // Spans kept per thread, the oldest get overwritten.
+inline constexpr const size_t trace_retired_capacity = 8 * trace_buffer_capacity; // Spans kept of the threads that exited, the threads that exited first get dropped.
+
+_NODISC_ inline constexpr const char *span_kind_name(const SpanKind kind) noexcept {
+    switch (kind) {
+        case SK::operation: return "operation";
+        case SK::allocate:  return "allocate";
+        case SK::pack:      return "pack";
+        case SK::compute:   return "compute";
+        default:            return "reduce";
+    }
+}
+
+struct TraceEvent {
+    const char *name; // Has to outlive the trace, string literals only.
+    SpanKind kind;
+    uint64_t begin_ns; // Since the first span of the process.
+    uint64_t end_ns;
+    size_t m, n, k;    // Sizes of an operation, 0 if not relevant.
+};
+
+struct ThreadTrace {
+    size_t thread = 0;    // In the order the threads recorded their first span.
+    long tid = 0;         // Kernel thread id, 0 if unknown.
+    uint64_t dropped = 0; // Spans overwritten before the snapshot.
+    std::vector<TraceEvent> events; // Oldest first.
+};
+}
+
+namespace math::profile::impl {
+struct TraceSlot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<SpanKind> kind{SK::operation};
+    std::atomic<uint64_t> begin_ns{0}, end_ns{0}, m{0}, n{0}, k{0};
+};
+
+// Written only by its own thread. Readers copy without blocking it and drop the slots it may have been overwriting meanwhile(a seqlock per buffer).
+struct TraceBuffer {
+    std::unique_ptr<TraceSlot[]> slots;
+    std::atomic<uint64_t> writing{0}; // Spans whose slot has been claimed.
+    std::atomic<uint64_t> written{0}; // Spans whose slot is complete.
+    size_t thread = 0;
+    long tid = 0;
+
+    TraceBuffer();
+    ~TraceBuffer();
+
+    void push(const TraceEvent &event) noexcept {
+        const uint64_t index = written.load(std::memory_order_relaxed);
+        writing.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        TraceSlot &slot = slots[index % trace_buffer_capacity];
+        slot.name.store(event.name, std::memory_order_relaxed);
+        slot.kind.store(event.kind, std::memory_order_relaxed);
+        slot.begin_ns.store(event.begin_ns, std::memory_order_relaxed);
+        slot.end_ns.store(event.end_ns, std::memory_order_relaxed);
+        slot.m.store(event.m, std::memory_order_relaxed);
+        slot.n.store(event.n, std::memory_order_relaxed);
+        slot.k.store(event.k, std::memory_order_relaxed);
+        written.store(index + 1, std::memory_order_release);
+    }
+
+    _NODISC_ ThreadTrace snapshot() const {
+        ThreadTrace trace;
+        trace.thread = thread;
+        trace.tid = tid;
+        const uint64_t end = written.load(std::memory_order_acquire);
+        const uint64_t begin = end > trace_buffer_capacity ? end - trace_buffer_capacity : 0;
+        trace.events.reserve(static_cast<size_t>(end - begin));
+        for (uint64_t i = begin; i < end; i++) {
+            const TraceSlot &slot = slots[i % trace_buffer_capacity];
+            trace.events.push_back(TraceEvent{ slot.name.load(std::memory_order_relaxed), slot.kind.load(std::memory_order_relaxed),
+                slot.begin_ns.load(std::memory_order_relaxed), slot.end_ns.load(std::memory_order_relaxed),
+                slot.m.load(std::memory_order_relaxed), slot.n.load(std::memory_order_relaxed), slot.k.load(std::memory_order_relaxed) });
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t claimed = writing.load(std::memory_order_relaxed);
+        const uint64_t valid_from = claimed > trace_buffer_capacity ? claimed - trace_buffer_capacity : 0; // Older slots may be half rewritten.
+        const size_t torn = static_cast<size_t>(std::min(end, std::max(begin, valid_from)) - begin);
+        trace.events.erase(trace.events.begin(), trace.events.begin() + static_cast<std::ptrdiff_t>(torn));
+        trace.dropped = begin + torn;
+        return trace;
+    }
+};
+
+struct TraceRegistry {
+    std::mutex lock;
+    std::vector<TraceBuffer*> threads;
+    std::vector<ThreadTrace> retired; // Spans of the threads that already exited, in exit order and at most trace_retired_capacity of them.
+    size_t retired_spans = 0;
+    size_t next_thread = 0;
+    std::atomic<bool> enabled{true};
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    static TraceRegistry &instance() noexcept {
+        static TraceRegistry registry;
+        return registry;
+    }
+};
+
+inline TraceBuffer::TraceBuffer() : slots(std::make_unique<TraceSlot[]>(trace_buffer_capacity)) {
+#if defined(__linux__) && defined(SYS_gettid)
+    tid = ::syscall(SYS_gettid);
+#endif
+    TraceRegistry &registry = TraceRegistry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    thread = registry.next_thread++;
+    registry.threads.push_back(this);
+}
+
+inline TraceBuffer::~TraceBuffer() {
+    TraceRegistry &registry = TraceRegistry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    std::erase(registry.threads, this);
+    try {
+        registry.retired.push_back(snapshot());
+        registry.retired_spans += registry.retired.back().events.size();
+    }
+    catch(...) {} // Losing an exited thread's spans beats terminating.
+    // Programs that keep starting threads would otherwise grow the retired spans without bound.
+    size_t drop = 0;
+    for (; registry.retired_spans > trace_retired_capacity && drop < registry.retired.size(); drop++) registry.retired_spans -= registry.retired[drop].events.size();
+    registry.retired.erase(registry.retired.begin(), registry.retired.begin() + static_cast<std::ptrdiff_t>(drop));
+}
+
+_NODISC_ inline TraceBuffer *thread_trace_buffer() noexcept {
+    try {
+        static thread_local TraceBuffer buffer;
+        return &buffer;
+    }
+    catch(...) { return nullptr; } // No memory for the buffer, this thread goes untraced.
+}
+
+_NODISC_ inline uint64_t trace_ns(const std::chrono::steady_clock::time_point time) noexcept {
+    const auto since = time - TraceRegistry::instance().epoch;
+    return since.count() < 0 ? 0 : static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(since).count());
+}
+
+inline void record_span(const SpanKind kind, const char *name, const std::chrono::steady_clock::time_point begin, const std::chrono::steady_clock::time_point end,
+                        const size_t m = 0, const size_t n = 0, const size_t k = 0) noexcept {
+    if (TraceBuffer *buffer = thread_trace_buffer()) buffer->push(TraceEvent{ name, kind, trace_ns(begin), trace_ns(end), m, n, k });
+}
+}
+
+namespace math::profile {
+/**
+ * @brief Recording a span on the calling thread's timeline while alive.
+*/
+class TraceSpan {
+    public:
+        TraceSpan(const SpanKind kind, const char *name, const size_t m = 0, const size_t n = 0, const size_t k = 0) noexcept
+        : m_name(impl::TraceRegistry::instance().enabled.load(std::memory_order_relaxed) ? name : nullptr), m_kind(kind), m_m(m), m_n(n), m_k(k) {
+            if (m_name) m_begin = std::chrono::steady_clock::now();
+        }
+        ~TraceSpan() noexcept {
+            if (m_name) impl::record_span(m_kind, m_name, m_begin, std::chrono::steady_clock::now(), m_m, m_n, m_k);
+        }
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan &operator=(const TraceSpan&) = delete;
+
+    private:
+        const char *m_name;
+        SpanKind m_kind;
+        size_t m_m, m_n, m_k;
+        std::chrono::steady_clock::time_point m_begin{};
+};
+
+/**
+ * @brief Pausing or resuming the tracing at runtime(on by default when compiled in).
+*/
+inline void set_tracing(const bool enabled) noexcept {
+    impl::TraceRegistry::instance().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+_NODISC_ inline bool tracing_enabled() noexcept {
+    return impl::TraceRegistry::instance().enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Copy of every thread's spans, the live threads keep recording meanwhile.
+ * @note Of the threads that exited only the latest trace_retired_capacity spans(whole threads) are kept.
+*/
+_NODISC_ inline std::vector<ThreadTrace> trace_snapshot() {
+    impl::TraceRegistry &registry = impl::TraceRegistry::instance();
+    std::vector<ThreadTrace> result;
+    {
+        std::lock_guard<std::mutex> guard(registry.lock);
+        result = registry.retired;
+        for (const impl::TraceBuffer *buffer : registry.threads) result.push_back(buffer->snapshot());
+    }
+    std::sort(result.begin(), result.end(), [](const ThreadTrace &a, const ThreadTrace &b) { return a.thread < b.thread; });
+    return result;
+}
+
+// Forgets the spans of the exited threads, live threads are only cleared by overwriting.
+inline void reset_trace() {
+    impl::TraceRegistry &registry = impl::TraceRegistry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    registry.retired.clear();
+    registry.retired_spans = 0;
+}
+
+/**
+ * @brief The spans as Chrome trace JSON, every thread is a track named after its index and kernel id.
+ * @param threads Snapshot from trace_snapshot().
+ * @return {"displayTimeUnit":"ns","traceEvents":[..]} with complete("X") events in microseconds.
+*/
+_NODISC_ inline std::string chrome_trace_json(const std::vector<ThreadTrace> &threads) {
+#if defined(__linux__)
+    const long pid = static_cast<long>(::getpid());
+#else
+    const long pid = 1;
+#endif
+    std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    char buffer[320];
+    for (const ThreadTrace &thread : threads) {
+        const long tid = thread.tid != 0 ? thread.tid : static_cast<long>(thread.thread) + 1;
+        std::snprintf(buffer, sizeof(buffer), "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%ld,\"args\":{\"name\":\"math thread %zu\",\"dropped_spans\":%llu}},"
+            "\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%ld,\"args\":{\"sort_index\":%zu}}",
+            first ? "" : ",", pid, tid, thread.thread, static_cast<unsigned long long>(thread.dropped), pid, tid, thread.thread);
+        json += buffer;
+        first = false;
+        for (const TraceEvent &event : thread.events) {
+            const int length = std::snprintf(buffer, sizeof(buffer), ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%ld,\"tid\":%ld",
+                event.name ? event.name : "?", span_kind_name(event.kind), static_cast<double>(event.begin_ns) * 1e-3,
+                static_cast<double>(event.end_ns >= event.begin_ns ? event.end_ns - event.begin_ns : 0) * 1e-3, pid, tid);
+            json.append(buffer, static_cast<size_t>(length));
+            if (event.m != 0 || event.n != 0 || event.k != 0) {
+                std::snprintf(buffer, sizeof(buffer), ",\"args\":{\"m\":%zu,\"n\":%zu,\"k\":%zu}", event.m, event.n, event.k);
+                json += buffer;
+            }
+            json += '}';
+        }
+    }
+    json += "\n]}\n";
+    return json;
+}
+
+/**
+ * @brief Writing the current trace of every thread to a Chrome trace JSON file.
+ * @param path File to create.
+ * @return Whether the file could be written.
+*/
+inline bool write_chrome_trace(const char *path) {
+    const std::string json = math::profile::chrome_trace_json(math::profile::trace_snapshot());
+    std::FILE *file = std::fopen(path, "w");
+    if (file == nullptr) return false;
+    const bool ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    return (std::fclose(file) == 0) && ok;
+}
+}
+
+#if defined(MATH_ENABLE_TRACING)
+    #define _TRACE_SPAN_(kind, name) math::profile::TraceSpan trace_span(math::profile::SK::kind, name);
+#else
+    #define _TRACE_SPAN_(kind, name)
+#endif
\ No newline at end of file
@@ -0,0 +1,67 @@
+// CholeskyTest.cpp
+#include "Test.hpp"
+#include "../Matrix/Decomposition/Cholesky.hpp"
+#include <vector>
+
+namespace {
+// b * b^T + n * I, symmetric positive definite and well conditioned.
+template <typename T>
+math::Matrix<T> spd(const size_t n, const size_t seed) {
+    const math::Matrix<T> b = math::test::filled<T>(n, n, seed);
+    math::Matrix<T> a = math::test::naive_multiply(b, math::matrix::TR::no, b, math::matrix::TR::yes);
+    for (size_t i = 0; i < n; i++) a(i, i) += static_cast<T>(n);
+    return a;
+}
+
+template <typename T>
+void test_cholesky(const double tolerance) {
+    // Sizes around the 128 row tiles, only the lower triangle of A may be read.
+    for (const size_t n : { size_t(1), size_t(2), size_t(7), size_t(33), size_t(129), size_t(260) }) {
+        const math::Matrix<T> a = spd<T>(n, n);
+        math::Matrix<T> lower_only = a;
+        for (size_t i = 0; i < n; i++)
+            for (size_t j = i + 1; j < n; j++) lower_only(i, j) = std::numeric_limits<T>::quiet_NaN();
+        const math::Cholesky<T> cholesky(lower_only);
+        _CHECK_(cholesky.is_positive_definite() && (cholesky.size() == n));
+        const math::Matrix<T> &l = cholesky.factor();
+        _CHECK_(math::test::max_difference(math::test::naive_multiply(l, math::matrix::TR::no, l, math::matrix::TR::yes), a) <= tolerance * static_cast<double>(n * n));
+
+        std::vector<T> b(n);
+        for (size_t i = 0; i < n; i++) b[i] = math::test::value_at<T>(i, 0, 9);
+        const std::vector<T> x = cholesky.solve(b);
+        double residual = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            T sum = T(0);
+            for (size_t j = 0; j < n; j++) sum += a(i, j) * x[j];
+            residual = std::max(residual, std::fabs(static_cast<double>(sum - b[i])));
+        }
+        _CHECK_(residual <= tolerance * static_cast<double>(n * n));
+        const math::Matrix<T> bs = math::test::filled<T>(n, 2, 10);
+        _CHECK_(math::test::max_difference(math::test::naive_multiply(a, cholesky.solve(bs)), bs) <= tolerance * static_cast<double>(n * n));
+        _CHECK_(math::test::max_difference(math::test::naive_multiply(a, cholesky.inverse()), math::test::identity<T>(n)) <= tolerance * static_cast<double>(n));
+    }
+}
+
+void test_cholesky_edges() {
+    // The first column whose pivot isn't positive is reported, in the first tile and past it.
+    for (const size_t bad : { size_t(1), size_t(130) }) {
+        math::Matrix<double> a = spd<double>(140, 1);
+        a(bad, bad) = -1e6;
+        const math::Cholesky<double> cholesky(a);
+        _CHECK_(!cholesky.is_positive_definite() && (cholesky.status().failed_column == bad));
+        _CHECK_THROWS_(std::domain_error, cholesky.inverse());
+    }
+    const math::Matrix<double> diagonal(3, 3, [](size_t i, size_t j) { return i == j ? static_cast<double>(i + 1) : 0.0; });
+    _CHECK_(std::fabs(math::Cholesky<double>(diagonal).determinant() - 6.0) < 1e-14);
+    const math::Cholesky<double> empty{math::Matrix<double>()};
+    _CHECK_(empty.is_positive_definite() && (empty.size() == 0));
+    _CHECK_THROWS_(std::invalid_argument, math::Cholesky<double>(math::Matrix<double>(2, 3)));
+}
+}
+
+int main() {
+    test_cholesky<double>(1e-14);
+    test_cholesky<float>(1e-5);
+    test_cholesky_edges();
+    return math::test::finish("CholeskyTest");
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+// DeterminantTest.cpp
+#include "Test.hpp"
+
+namespace {
+// Rows shifted by one of L * D * U, L and U unit bidiagonal with entries in {-1, 0, 1}: the inverse stays small and the determinant is
+// (-1)^(n - 1) * (product of D), D being 2 every fifth, -1 every seventh and 1 elsewhere on the diagonal, or ones with is_unimodular.
+math::Matrix<long long> structured(const size_t n, const bool is_unimodular, const size_t seed, long long &determinant) {
+    const math::Matrix<long long> l(n, n, [seed](size_t i, size_t j) { return i == j ? 1LL : (i == j + 1 ? math::test::value_at<long long>(i, j, seed) % 2 : 0LL); });
+    const math::Matrix<long long> u(n, n, [seed](size_t i, size_t j) { return i == j ? 1LL : (j == i + 1 ? math::test::value_at<long long>(i, j, seed + 1) % 2 : 0LL); });
+    const math::Matrix<long long> d(n, n, [is_unimodular](size_t i, size_t j) {
+        if (i != j || is_unimodular) return i == j ? 1LL : 0LL;
+        return i % 5 == 0 ? 2LL : (i % 7 == 0 ? -1LL : 1LL);
+    });
+    const math::Matrix<long long> ldu = math::test::naive_multiply(math::test::naive_multiply(l, d), u);
+    determinant = (n % 2 == 1) ? 1 : -1;
+    for (size_t i = 0; i < n; i++) determinant *= d(i, i);
+    return math::Matrix<long long>(n, n, [&ldu, n](size_t i, size_t j) { return ldu((i + 1) % n, j); });
+}
+
+void test_integer() {
+    // Around the 128 rows from which Bareiss updates rows over the team: determinants are exact and unimodular inverses integral.
+    for (const size_t n : { size_t(1), size_t(2), size_t(7), size_t(33), size_t(130), size_t(200) }) {
+        long long expected;
+        const math::Matrix<long long> a = structured(n, false, n, expected);
+        _CHECK_(a.determinant() == expected);
+        long long sign;
+        const math::Matrix<long long> b = structured(n, true, n + 1, sign);
+        _CHECK_(b.determinant() == sign);
+        const math::Matrix<long long> inverse = b.inverse();
+        _CHECK_(math::test::naive_multiply(b, inverse) == math::test::identity<long long>(n));
+        math::Matrix<long long> c = b;
+        c.inverse_in_place();
+        _CHECK_(c == inverse);
+        if (expected != 1 && expected != -1) {
+            math::Matrix<long long> e = a;
+            _CHECK_THROWS_(std::domain_error, e.inverse_in_place());
+            _CHECK_(e == a);
+        }
+    }
+    math::Matrix<long long> singular = math::test::filled<long long>(7, 7, 3);
+    for (size_t j = 0; j < 7; j++) singular(4, j) = singular(1, j);
+    _CHECK_(singular.determinant() == 0);
+    _CHECK_THROWS_(std::domain_error, singular.inverse());
+    _CHECK_(math::Matrix<long long>().determinant() == 1);
+    _CHECK_THROWS_(std::logic_error, math::Matrix<long long>(2, 3).determinant());
+}
+
+void test_overflow() {
+    // Products wider than the element type are fine as long as the minors fit, a determinant(or minor) past it throws.
+    const math::Matrix<int> close(2, 2, [](size_t i, size_t j) { return 50000 - static_cast<int>(i + j); });
+    _CHECK_(close.determinant() == -1);
+    _CHECK_(close.inverse() == math::Matrix<int>(2, 2, [](size_t i, size_t j) { return i == j ? -49998 - 2 * static_cast<int>(i) : 49999; }));
+    const math::Matrix<int> wide(2, 2, [](size_t i, size_t j) { return i == j ? 65536 : 0; });
+    _CHECK_THROWS_(std::overflow_error, wide.determinant());
+    _CHECK_THROWS_(std::overflow_error, wide.inverse());
+    const math::Matrix<long long> wider(3, 3, [](size_t i, size_t j) { return i == j ? 1LL << 32 : 0LL; });
+    _CHECK_THROWS_(std::overflow_error, wider.determinant());
+    const math::Matrix<long long> fits(3, 3, [](size_t i, size_t j) { return i == j ? 1LL << 20 : 0LL; });
+    _CHECK_(fits.determinant() == (1LL << 60));
+}
+
+template <typename T>
+void test_floating(const double tolerance) {
+    // Around the 96 column panels of the LU both go through.
+    for (const size_t n : { size_t(1), size_t(2), size_t(7), size_t(33), size_t(97), size_t(200) }) {
+        long long expected;
+        const math::Matrix<long long> exact = structured(n, false, n, expected);
+        const math::Matrix<T> a(n, n, [&exact](size_t i, size_t j) { return static_cast<T>(exact(i, j)); });
+        _CHECK_(std::fabs(static_cast<double>(a.determinant()) / static_cast<double>(expected) - 1.0) <= tolerance * static_cast<double>(n));
+        const math::Matrix<T> f = math::test::filled<T>(n, n, n);
+        const math::Matrix<T> inverse = f.inverse();
+        _CHECK_(math::test::max_difference(math::test::naive_multiply(f, inverse), math::test::identity<T>(n)) <= tolerance * static_cast<double>(n * n));
+        math::Matrix<T> g = f;
+        g.inverse_in_place();
+        _CHECK_(math::test::max_difference(g, inverse) <= tolerance * static_cast<double>(n * n));
+    }
+    math::Matrix<T> singular = math::test::filled<T>(33, 33, 4);
+    for (size_t j = 0; j < 33; j++) singular(20, j) = singular(3, j);
+    const math::Matrix<T> kept = singular;
+    _CHECK_THROWS_(std::domain_error, singular.inverse_in_place());
+    _CHECK_(singular == kept);
+    _CHECK_THROWS_(std::logic_error, math::Matrix<T>(3, 2).inverse());
+}
+}
+
+int main() {
+    test_integer();
+    test_overflow();
+    test_floating<double>(1e-14);
+    test_floating<float>(1e-5);
+    return math::test::finish("DeterminantTest");
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+// GemmTest.cpp
+#include "Test.hpp"
+
+namespace {
+using math::matrix::TR;
+
+// alpha * op(a) * op(b) + beta * c0 by the naive product.
+template <typename T>
+math::Matrix<T> expected_gemm(const T alpha, const math::Matrix<T> &a, const TR ta, const math::Matrix<T> &b, const TR tb, const T beta, const math::Matrix<T> &c0) {
+    math::Matrix<T> result = math::test::naive_multiply(a, ta, b, tb);
+    for (size_t i = 0; i < result.num_rows(); i++)
+        for (size_t j = 0; j < result.num_columns(); j++) result(i, j) = alpha * result(i, j) + beta * c0(i, j);
+    return result;
+}
+
+template <typename T>
+void test_gemm(const double tolerance) {
+    // Past one block of rows(128) and of depth(256), single rows and columns(the gemv path) and products too small to pack.
+    const size_t shapes[][3] = { {1, 1, 1}, {2, 2, 1}, {1, 130, 7}, {130, 1, 33}, {7, 5, 300}, {33, 130, 2}, {131, 67, 257}, {130, 130, 130} };
+    const T scalars[][2] = { {T(1), T(0)}, {T(2), T(-1)}, {T(0), T(3)}, {T(1), T(1)} };
+    size_t seed = 0;
+    for (const auto &shape : shapes)
+        for (const TR ta : { TR::no, TR::yes })
+            for (const TR tb : { TR::no, TR::yes })
+                for (const auto &scalar : scalars) {
+                    const size_t m = shape[0], n = shape[1], k = shape[2];
+                    const math::Matrix<T> a = (ta == TR::no) ? math::test::filled<T>(m, k, ++seed) : math::test::filled<T>(k, m, ++seed);
+                    const math::Matrix<T> b = (tb == TR::no) ? math::test::filled<T>(k, n, ++seed) : math::test::filled<T>(n, k, ++seed);
+                    const math::Matrix<T> c0 = math::test::filled<T>(m, n, ++seed);
+                    math::Matrix<T> c = c0;
+                    math::gemm<T>(scalar[0], a, ta, b, tb, scalar[1], c);
+                    _CHECK_(math::test::max_difference(c, expected_gemm(scalar[0], a, ta, b, tb, scalar[1], c0)) <= tolerance * static_cast<double>(k));
+                }
+}
+
+template <typename T>
+void test_gemm_views() {
+    // Sub-blocks with a column offset, and empty products that leave c alone(k = 0 only scales it).
+    const math::Matrix<T> a = math::test::filled<T>(40, 50, 1), b = math::test::filled<T>(50, 60, 2);
+    math::Matrix<T> c = math::test::filled<T>(40, 60, 3);
+    const math::Matrix<T> c0 = c;
+    math::gemm<T>(T(1), a.view().block(3, 5, 33, 7), TR::no, b.view().block(5, 1, 7, 41), TR::no, T(0), c.view().block(2, 9, 33, 41));
+    bool is_equal = true, is_untouched = true;
+    for (size_t i = 0; i < 40; i++)
+        for (size_t j = 0; j < 60; j++) {
+            if (i >= 2 && i < 35 && j >= 9 && j < 50) {
+                T sum = T(0);
+                for (size_t p = 0; p < 7; p++) sum += a(3 + i - 2, 5 + p) * b(5 + p, 1 + j - 9);
+                is_equal = is_equal && (c(i, j) == sum);
+            }
+            else is_untouched = is_untouched && (c(i, j) == c0(i, j));
+        }
+    _CHECK_(is_equal);
+    _CHECK_(is_untouched);
+
+    c = c0;
+    math::gemm<T>(T(1), a.view().block(0, 0, 0, 5), TR::no, b.view().block(0, 0, 5, 60), TR::no, T(0), c.view().block(0, 0, 0, 60));
+    math::gemm<T>(T(1), a.view().block(0, 0, 40, 0), TR::no, b.view().block(0, 0, 0, 60), TR::no, T(2), c.view());
+    _CHECK_(c == expected_gemm(T(0), a, TR::no, b, TR::no, T(2), c0));
+    _CHECK_THROWS_(std::invalid_argument, math::gemm<T>(T(1), a, TR::no, b, TR::yes, T(0), c));
+    _CHECK_THROWS_(std::invalid_argument, math::gemm<T>(T(1), c, TR::no, b, TR::yes, T(0), c));
+}
+
+void test_gemm_budget() {
+    // Short of budget the packing scratch narrows its panels, and without room for the narrowest ones gemm_direct takes over, never throwing.
+    const math::Matrix<long long> a = math::test::filled<long long>(131, 300, 1), b = math::test::filled<long long>(300, 300, 2);
+    const math::Matrix<long long> expected = math::test::naive_multiply(a, TR::no, b, TR::no);
+    const std::pair<size_t, bool> budgets[] = { {static_cast<size_t>(400) << 10, true}, {static_cast<size_t>(4) << 10, false} }; // Whether narrower panels still fit.
+    for (const auto &[budget, is_packed] : budgets) {
+        math::Matrix<long long> c(131, 300);
+        math::memory::set_thread_memory_budget(budget);
+        const uint64_t allocations = math::memory::memory_stats().allocations();
+        bool is_thrown = false;
+        try { math::gemm<long long>(1, a, TR::no, b, TR::no, 0, c); } catch(...) { is_thrown = true; }
+        _CHECK_(!is_thrown && c == expected);
+        _CHECK_((math::memory::memory_stats().allocations() != allocations) == is_packed);
+        _CHECK_(math::memory::memory_budget_available() == budget);
+        math::memory::set_thread_memory_budget(0);
+    }
+}
+
+void test_gemm_pool() {
+    // The packing buffers come back from the pool of the caller, after the first product no buffer goes to the system again.
+    const math::Matrix<double> a = math::test::filled<double>(300, 300, 1), b = math::test::filled<double>(300, 2100, 2);
+    math::Matrix<double> c(300, 2100);
+    math::gemm<double>(1.0, a, TR::no, b, TR::no, 0.0, c);
+    const size_t hits = math::memory::pool_hits(), misses = math::memory::pool_misses();
+    for (size_t i = 0; i < 3; i++) math::gemm<double>(1.0, a, TR::no, b, TR::no, 0.0, c);
+    _CHECK_(math::memory::pool_misses() == misses);
+    _CHECK_(math::memory::pool_hits() - hits >= 3 * 3); // The panel of op(b), the table of the blocks of op(a) and at least one block.
+    _CHECK_(math::test::max_difference(c, math::test::naive_multiply(a, TR::no, b, TR::no)) <= 1e-14 * 300);
+}
+}
+
+int main() {
+    test_gemm<double>(1e-14);
+    test_gemm<float>(1e-5);
+    test_gemm<long long>(0.0);
+    test_gemm_views<long long>();
+    test_gemm_views<double>();
+    test_gemm_budget();
+    test_gemm_pool();
+    return math::test::finish("GemmTest");
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+// GemvTest.cpp
+#include "Test.hpp"
+#include <vector>
+
+namespace {
+using math::matrix::TR;
+
+template <typename T>
+void test_gemv(const double tolerance) {
+    // Rows in groups of 4 plus a remainder, single rows and columns, and batches that read a once for all the vectors.
+    const size_t shapes[][2] = { {1, 1}, {1, 130}, {130, 1}, {7, 5}, {33, 2}, {130, 301} };
+    size_t seed = 0;
+    for (const auto &shape : shapes)
+        for (const TR ta : { TR::no, TR::yes })
+            for (const size_t count : { size_t(1), size_t(3) }) {
+                const size_t m = shape[0], n = shape[1];
+                const size_t rows = (ta == TR::no) ? m : n, columns = (ta == TR::no) ? n : m;
+                const math::Matrix<T> a = math::test::filled<T>(m, n, ++seed);
+                const math::Matrix<T> xs = math::test::filled<T>(count, columns, ++seed), ys = math::test::filled<T>(count, rows, ++seed);
+                std::vector<T> x(count * columns), y(count * rows);
+                for (size_t v = 0; v < count; v++) {
+                    for (size_t j = 0; j < columns; j++) x[v * columns + j] = xs(v, j);
+                    for (size_t i = 0; i < rows; i++) y[v * rows + i] = ys(v, i);
+                }
+                const T alpha = T(2), beta = (count == 1) ? T(0) : T(-1);
+                if (count == 1) math::gemv<T>(alpha, a, ta, x, beta, y);
+                else math::gemv_batched<T>(alpha, a, ta, x, beta, y, count);
+                double error = 0.0;
+                for (size_t v = 0; v < count; v++)
+                    for (size_t i = 0; i < rows; i++) {
+                        T sum = T(0);
+                        for (size_t j = 0; j < columns; j++) sum += ((ta == TR::no) ? a(i, j) : a(j, i)) * xs(v, j);
+                        error = std::max(error, std::fabs(static_cast<double>(y[v * rows + i]) - static_cast<double>(alpha * sum + beta * ys(v, i))));
+                    }
+                _CHECK_(error <= tolerance * static_cast<double>(columns));
+            }
+}
+
+void test_gemv_edges() {
+    // A zero beta overwrites y without reading it(NaN stays out), and sizes are checked.
+    const math::Matrix<double> a = math::test::filled<double>(7, 5, 1);
+    std::vector<double> x(5, 1.0), y(7, std::numeric_limits<double>::quiet_NaN());
+    math::gemv<double>(1.0, a, TR::no, x, 0.0, y);
+    bool is_finite = true;
+    for (const double v : y) is_finite = is_finite && std::isfinite(v);
+    _CHECK_(is_finite);
+    _CHECK_THROWS_(std::invalid_argument, math::gemv<double>(1.0, a, TR::yes, x, 0.0, y));
+    _CHECK_THROWS_(std::invalid_argument, math::gemv_batched<double>(1.0, a, TR::no, x, 0.0, y, 2));
+}
+}
+
+int main() {
+    test_gemv<double>(1e-14);
+    test_gemv<float>(1e-5);
+    test_gemv<long long>(0.0);
+    test_gemv_edges();
+    return math::test::finish("GemvTest");
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+// GerTest.cpp
+#include "Test.hpp"
+#include <vector>
+
+namespace {
+using math::matrix::TR;
+
+template <typename T>
+void test_ger(const double tolerance) {
+    // Single rows and columns, odd and non-square shapes, rank 1 and batches of several pairs.
+    const size_t shapes[][2] = { {1, 1}, {1, 130}, {130, 1}, {7, 5}, {33, 2}, {130, 301} };
+    size_t seed = 0;
+    for (const auto &shape : shapes)
+        for (const size_t count : { size_t(1), size_t(2), size_t(5) }) {
+            const size_t m = shape[0], n = shape[1];
+            const math::Matrix<T> a0 = math::test::filled<T>(m, n, ++seed);
+            const math::Matrix<T> xs = math::test::filled<T>(count, m, ++seed), ys = math::test::filled<T>(count, n, ++seed);
+            std::vector<T> x(count * m), y(count * n);
+            for (size_t v = 0; v < count; v++) {
+                for (size_t i = 0; i < m; i++) x[v * m + i] = xs(v, i);
+                for (size_t j = 0; j < n; j++) y[v * n + j] = ys(v, j);
+            }
+            math::Matrix<T> a = a0;
+            if (count == 1) math::ger<T>(T(3), x, y, a);
+            else math::ger_batched<T>(T(3), x, y, a, count);
+            math::Matrix<T> expected = math::test::naive_multiply(xs, TR::yes, ys, TR::no);
+            for (size_t i = 0; i < m; i++)
+                for (size_t j = 0; j < n; j++) expected(i, j) = a0(i, j) + T(3) * expected(i, j);
+            _CHECK_(math::test::max_difference(a, expected) <= tolerance * static_cast<double>(count));
+        }
+}
+
+void test_ger_edges() {
+    math::Matrix<double> a = math::test::filled<double>(4, 3, 1);
+    const math::Matrix<double> a0 = a;
+    std::vector<double> x(4, 1.0), y(3, 1.0);
+    math::ger_batched<double>(1.0, std::span<const double>(), std::span<const double>(), a, 0); // No pairs leaves a alone.
+    _CHECK_(a == a0);
+    _CHECK_THROWS_(std::invalid_argument, math::ger<double>(1.0, y, x, a));
+    _CHECK_THROWS_(std::invalid_argument, math::ger_batched<double>(1.0, x, y, a, 2));
+}
+}
+
+int main() {
+    test_ger<double>(1e-14);
+    test_ger<float>(1e-5);
+    test_ger<long long>(0.0);
+    test_ger_edges();
+    return math::test::finish("GerTest");
+}
\ No newline at end of file
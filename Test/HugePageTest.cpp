@@ -0,0 +1,105 @@
+// HugePageTest.cpp
+#include "Test.hpp"
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace {
+using math::memory::HPP;
+
+// The mode the kernel hands out transparent huge pages in("always", "madvise" or "never").
+std::string thp_mode() {
+    std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string line;
+    std::getline(file, line);
+    const size_t begin = line.find('['), end = line.find(']');
+    return (begin == std::string::npos || end == std::string::npos) ? std::string("never") : line.substr(begin + 1, end - begin - 1);
+}
+
+// Whether a row was carved from a huge page arena, by the pool or by allocate_memory.
+bool is_carved(const double *row) {
+    const void *base = math::memory::impl::block_base<double>(row);
+    if constexpr (math::memory::impl::uses_pool<double>) return math::memory::impl::pool_header(base)->owner == math::memory::impl::pool_carved;
+    else return math::memory::impl::block_stamp<double>(row)->is_carved;
+}
+
+void test_policy() {
+    // Default off, the threshold decides for the global policy and a scope overrides it regardless of size.
+    _CHECK_(math::memory::huge_page_policy() == HPP::none);
+    _CHECK_(math::memory::huge_page_policy_for(static_cast<size_t>(1) << 40) == HPP::none);
+    math::memory::set_huge_page_policy(HPP::transparent, static_cast<size_t>(1) << 20);
+    _CHECK_(math::memory::huge_page_policy() == HPP::transparent && math::memory::huge_page_threshold() == (static_cast<size_t>(1) << 20));
+    _CHECK_(math::memory::huge_page_policy_for((static_cast<size_t>(1) << 20) - 1) == HPP::none);
+    _CHECK_(math::memory::huge_page_policy_for(static_cast<size_t>(1) << 20) == HPP::transparent);
+    _CHECK_(math::memory::impl::active_huge_page_policy(4096) == HPP::none);
+    _CHECK_(math::memory::impl::active_huge_page_policy(static_cast<size_t>(1) << 20) == HPP::transparent);
+    {
+        math::memory::HugePageScope scope(HPP::explicit_pages);
+        _CHECK_(math::memory::impl::active_huge_page_policy(1) == HPP::explicit_pages);
+        {
+            math::memory::HugePageScope none(HPP::none); // Keeps the policy of the outer scope.
+            _CHECK_(math::memory::impl::active_huge_page_policy(1) == HPP::explicit_pages);
+        }
+    }
+    _CHECK_(math::memory::impl::active_huge_page_policy(4096) == HPP::none);
+    math::memory::set_huge_page_policy(HPP::none);
+    _CHECK_(math::memory::huge_page_threshold() == (static_cast<size_t>(64) << 20));
+}
+
+void test_carved_rows() {
+    // Rows smaller than a huge page are carved from huge page aligned mappings of their own, never from the heap around other blocks.
+    const std::string mode = thp_mode();
+    const math::Matrix<double> before = math::test::filled<double>(64, 64, 1);
+    const int64_t live = math::memory::memory_stats().bytes_live;
+    math::memory::set_huge_page_policy(HPP::transparent, static_cast<size_t>(1) << 20);
+    math::Matrix<double> a(512, 512, 0.0);
+    math::memory::set_huge_page_policy(HPP::none);
+    const int64_t with_a = math::memory::memory_stats().bytes_live;
+    const math::Matrix<double> after = math::test::filled<double>(64, 64, 3);
+    const int64_t after_bytes = math::memory::memory_stats().bytes_live - with_a;
+    for (size_t i = 0; i < a.num_rows(); i++)
+        for (size_t j = 0; j < a.num_columns(); j++) a(i, j) = math::test::value_at<double>(i, j, 2);
+    for (size_t i = 0; i < a.num_rows(); i++) _CHECK_(is_carved(a.data()[i]));
+    _CHECK_(!is_carved(before.data()[0]) && !is_carved(after.data()[0]));
+
+    const math::memory::HugePageReport report = a.huge_page_report();
+    _CHECK_(report.bytes == 512 * 512 * sizeof(double) && report.huge_bytes <= report.bytes);
+    if (mode != "never") _CHECK_(report.is_huge() && report.backing == HPP::transparent);
+    if (mode == "madvise") _CHECK_(!before.huge_page_report().is_huge() && !after.huge_page_report().is_huge());
+
+    // Growing a carved row moves it to a new block with its values, shrinking keeps it in place.
+    a.extend_columns_by(3, 7.0);
+    bool is_kept = true;
+    for (size_t i = 0; i < a.num_rows(); i++)
+        for (size_t j = 0; j < a.num_columns(); j++) is_kept = is_kept && (a(i, j) == (j < 512 ? math::test::value_at<double>(i, j, 2) : 7.0));
+    _CHECK_(is_kept && a.num_columns() == 515);
+
+    // Rows freed by another thread release the mappings once the last of them is gone.
+    std::thread([&a]() { a = math::Matrix<double>(); }).join();
+    _CHECK_(math::memory::memory_stats().bytes_live == live + after_bytes);
+}
+
+void test_large_rows() {
+    // A row of at least a huge page is its own aligned block, a small Matrix under no policy reports nothing.
+    math::memory::set_huge_page_policy(HPP::transparent, math::memory::huge_page_size);
+    const math::Matrix<double> a(2, math::memory::huge_page_size / sizeof(double) + 1, 1.0);
+    math::memory::set_huge_page_policy(HPP::none);
+    for (size_t i = 0; i < a.num_rows(); i++) {
+        _CHECK_(!is_carved(a.data()[i]));
+        const void *base = math::memory::impl::block_base<double>(a.data()[i]);
+        if constexpr (math::memory::impl::uses_pool<double>) base = math::memory::impl::pool_header(base);
+        _CHECK_(reinterpret_cast<uintptr_t>(base) % math::memory::huge_page_size == 0);
+    }
+    _CHECK_(a.huge_page_report().bytes == 2 * (math::memory::huge_page_size + sizeof(double)));
+    if (thp_mode() != "never") _CHECK_(a.huge_page_report().is_huge());
+    const math::memory::HugePageReport empty = math::Matrix<double>().huge_page_report();
+    _CHECK_(empty.bytes == 0 && !empty.is_huge() && empty.backing == HPP::none);
+}
+}
+
+int main() {
+    test_policy();
+    test_carved_rows();
+    test_large_rows();
+    return math::test::finish("HugePageTest");
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+// LUTest.cpp
+#include "Test.hpp"
+#include <vector>
+
+namespace {
+template <typename T>
+void test_lu(const double tolerance) {
+    // Sizes around the 96 column panels, L * U has to give back the permuted rows and the solves small residuals.
+    for (const size_t n : { size_t(1), size_t(2), size_t(7), size_t(33), size_t(97), size_t(130), size_t(200) }) {
+        const math::Matrix<T> a = math::test::filled<T>(n, n, n);
+        const math::LU<T> lu(a);
+        _CHECK_(!lu.is_singular() && (lu.size() == n));
+        const math::Matrix<T> &f = lu.factors();
+        const math::Matrix<T> l(n, n, [&f](size_t i, size_t j) { return i == j ? T(1) : (j < i ? f(i, j) : T(0)); });
+        const math::Matrix<T> u(n, n, [&f](size_t i, size_t j) { return j >= i ? f(i, j) : T(0); });
+        const math::Matrix<T> pa(n, n, [&a, &lu](size_t i, size_t j) { return a(lu.permutation()[i], j); });
+        _CHECK_(math::test::max_difference(math::test::naive_multiply(l, u), pa) <= tolerance * static_cast<double>(n));
+
+        std::vector<T> b(n);
+        for (size_t i = 0; i < n; i++) b[i] = math::test::value_at<T>(i, 0, 7);
+        const std::vector<T> x = lu.solve(b);
+        double residual = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            T sum = T(0);
+            for (size_t j = 0; j < n; j++) sum += a(i, j) * x[j];
+            residual = std::max(residual, std::fabs(static_cast<double>(sum - b[i])));
+        }
+        _CHECK_(residual <= tolerance * static_cast<double>(n * n));
+
+        const math::Matrix<T> bs = math::test::filled<T>(n, 3, 8);
+        _CHECK_(math::test::max_difference(math::test::naive_multiply(a, lu.solve(bs)), bs) <= tolerance * static_cast<double>(n * n));
+        _CHECK_(math::test::max_difference(math::test::naive_multiply(a, lu.inverse()), math::test::identity<T>(n)) <= tolerance * static_cast<double>(n * n));
+    }
+}
+
+void test_lu_edges() {
+    // Known determinant with a row swap, a singular matrix, the empty matrix and a non-square one.
+    const math::Matrix<double> a(2, 2, [](size_t i, size_t j) { return (i == 0) ? (j == 0 ? 1.0 : 2.0) : (j == 0 ? 3.0 : 4.0); });
+    const math::LU<double> lu(a);
+    _CHECK_(std::fabs(lu.determinant() + 2.0) < 1e-15);
+    _CHECK_(lu.permutation()[0] == 1);
+    const math::LU<double> singular(math::Matrix<double>(3, 3, 1.0));
+    _CHECK_(singular.is_singular() && (singular.determinant() == 0.0));
+    _CHECK_THROWS_(std::domain_error, singular.solve(std::vector<double>(3, 1.0)));
+    const math::LU<double> empty{math::Matrix<double>()};
+    _CHECK_((empty.size() == 0) && (empty.determinant() == 1.0) && (empty.inverse().size() == 0));
+    _CHECK_THROWS_(std::invalid_argument, math::LU<double>(math::Matrix<double>(2, 3)));
+    _CHECK_THROWS_(std::invalid_argument, lu.solve(std::vector<double>(3, 1.0)));
+}
+}
+
+int main() {
+    test_lu<double>(1e-14);
+    test_lu<float>(1e-5);
+    test_lu_edges();
+    return math::test::finish("LUTest");
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+// MatrixTest.cpp
+#include "Test.hpp"
+
+namespace {
+using Mat = math::Matrix<long long>;
+
+void test_multiply() {
+    // Exact integer products through the generic path, tall, wide(split by columns) and square.
+    for (const size_t m : math::test::edge_sizes)
+        for (const size_t k : { size_t(1), size_t(5), size_t(33) })
+            for (const size_t n : { size_t(1), size_t(3), size_t(130) }) {
+                if (m == 0) continue; // A zero dimension makes the Matrix 0 x 0, checked below.
+                const Mat a = math::test::filled<long long>(m, k, 1), b = math::test::filled<long long>(k, n, 2);
+                _CHECK_((a * b) == math::test::naive_multiply(a, b));
+                Mat c = a;
+                if (k == n) {
+                    c *= b;
+                    _CHECK_(c == math::test::naive_multiply(a, b));
+                }
+            }
+    _CHECK_((Mat(size_t(0), size_t(3)) * Mat(size_t(0), size_t(5))).size() == 0);
+    _CHECK_THROWS_(std::invalid_argument, Mat(2, 3) * Mat(2, 3));
+}
+
+void test_transpose() {
+    for (const size_t m : math::test::edge_sizes)
+        for (const size_t n : { size_t(1), size_t(4), size_t(33) }) {
+            if (m == 0) continue;
+            const Mat a = math::test::filled<long long>(m, n, 3);
+            const Mat t = a.transpose();
+            _CHECK_((t.num_rows() == n) && (t.num_columns() == m));
+            bool is_equal = true;
+            for (size_t i = 0; i < m; i++)
+                for (size_t j = 0; j < n; j++) is_equal = is_equal && (t(j, i) == a(i, j));
+            _CHECK_(is_equal);
+            Mat b = a;
+            b.transpose_in_place();
+            _CHECK_(b == t);
+        }
+}
+
+void test_extend() {
+    const Mat a = math::test::filled<long long>(3, 4, 4);
+    Mat b = a;
+    b.extend_rows_by(2, 7);
+    _CHECK_((b.num_rows() == 5) && (b(4, 3) == 7) && (b(2, 3) == a(2, 3)));
+    b.extend_columns_by(3, -1);
+    _CHECK_((b.num_columns() == 7) && (b(0, 6) == -1) && (b(4, 4) == -1) && (b(1, 2) == a(1, 2)));
+    Mat c = a;
+    c.extend_by(2, 1, 5, 6, 9);
+    _CHECK_((c.num_rows() == 5) && (c.num_columns() == 5));
+    _CHECK_((c(4, 0) == 5) && (c(0, 4) == 6) && (c(4, 4) == 9) && (c(2, 3) == a(2, 3)));
+    c.shrink_by(2, 1);
+    _CHECK_(c == a);
+    Mat e;
+    e.extend_by(size_t(2), size_t(3), 4LL);
+    _CHECK_((e.num_rows() == 2) && (e.num_columns() == 3) && (e(1, 2) == 4));
+    Mat d = a;
+    d.extend_rows_by(1);
+    _CHECK_((d.num_rows() == 4) && (d(3, 0) == 0));
+}
+}
+
+int main() {
+    test_multiply();
+    test_transpose();
+    test_extend();
+    return math::test::finish("MatrixTest");
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+// MemoryTest.cpp
+#include "Test.hpp"
+#include <condition_variable>
+#include <thread>
+
+namespace {
+using Mat = math::Matrix<double>;
+
+void test_free_tag() {
+    // A block is freed under the tag it was allocated under, whatever the tag(and the thread) at the free.
+    const math::memory::MemoryStats before = math::memory::memory_stats();
+    Mat *product;
+    {
+        _ALLOC_TAG_(multiply)
+        product = new Mat(math::test::filled<double>(33, 7, 1));
+    }
+    std::thread([product]() {
+        _ALLOC_TAG_(add)
+        delete product;
+    }).join();
+    const math::memory::MemoryStats after = math::memory::memory_stats();
+    const math::memory::AllocTagStats &multiply = after.of(math::memory::AT::multiply), &multiply_before = before.of(math::memory::AT::multiply);
+    _CHECK_(multiply.allocations > multiply_before.allocations);
+    _CHECK_(multiply.frees - multiply_before.frees == multiply.allocations - multiply_before.allocations);
+    _CHECK_(multiply.bytes_freed - multiply_before.bytes_freed == multiply.bytes_allocated - multiply_before.bytes_allocated);
+    _CHECK_(after.of(math::memory::AT::add).frees == before.of(math::memory::AT::add).frees);
+}
+
+void test_reallocate() {
+    // Growing and shrinking a block keeps its elements and the statistics balanced.
+    const math::memory::MemoryStats before = math::memory::memory_stats();
+    {
+        Mat a = math::test::filled<double>(7, 5, 2);
+        Mat b = a;
+        b.extend_columns_by(130, 1.0);
+        b.shrink_by(0, 130);
+        _CHECK_(b == a);
+        b.extend_rows_by(33, 2.0);
+        _CHECK_((b.num_rows() == 40) && (b(39, 4) == 2.0));
+    }
+    const math::memory::MemoryStats after = math::memory::memory_stats();
+    _CHECK_(after.bytes_live == before.bytes_live);
+}
+
+void test_late_free() {
+    // A block freed by a thread_local destructor that runs after the counters of its thread are gone still balances the totals.
+    struct LateFree {
+        Mat *matrix = nullptr;
+        ~LateFree() { delete matrix; }
+    };
+    const math::memory::MemoryStats before = math::memory::memory_stats();
+    std::thread([]() {
+        static thread_local LateFree late; // Constructed before(so destroyed after) the counters of the thread.
+        late.matrix = new Mat(math::test::filled<double>(33, 7, 3));
+    }).join();
+    const math::memory::MemoryStats after = math::memory::memory_stats();
+    const math::memory::AllocTagStats &construct = after.of(math::memory::AT::construct), &construct_before = before.of(math::memory::AT::construct);
+    _CHECK_(construct.frees - construct_before.frees == construct.allocations - construct_before.allocations);
+    _CHECK_(after.bytes_live == before.bytes_live);
+}
+
+void test_budget_cross_thread() {
+    // A block freed by another thread credits the budget it was charged to, not the budget of the freeing thread.
+    const size_t budget = static_cast<size_t>(1) << 20;
+    math::memory::set_thread_memory_budget(budget);
+    Mat *a = new Mat(64, 64, 1.0);
+    const size_t available = math::memory::memory_budget_available();
+    _CHECK_(available < budget);
+    std::thread([a, budget]() {
+        math::memory::set_thread_memory_budget(budget);
+        delete a;
+        _CHECK_(math::memory::memory_budget_available() == budget);
+        math::memory::set_thread_memory_budget(0);
+    }).join();
+    _CHECK_(math::memory::memory_budget_available() == budget);
+    _CHECK_THROWS_(math::memory::memory_budget_exceeded, Mat(1024, 1024));
+    math::memory::set_thread_memory_budget(0);
+
+    // A block charged while a process budget was set is credited even after the budget was removed and set again.
+    math::memory::set_process_memory_budget(budget);
+    Mat *b = new Mat(64, 64, 1.0);
+    math::memory::set_process_memory_budget(0);
+    math::memory::set_process_memory_budget(budget);
+    delete b;
+    _CHECK_(math::memory::memory_budget_available() == budget);
+    math::memory::set_process_memory_budget(0);
+}
+
+void test_budget_team() {
+    // The threads of a team charging the same thread budget at once never overshoot it together.
+    const size_t budget = static_cast<size_t>(64) << 10, bytes = 1000;
+    math::memory::set_thread_memory_budget(budget);
+    math::memory::impl::BudgetAccount *const account = math::memory::impl::thread_budget_account;
+    std::atomic<size_t> charged{0};
+    #pragma omp parallel num_threads(4)
+    {
+        math::memory::impl::BudgetAccountScope scope(budget, account);
+        std::vector<math::memory::impl::BudgetCharge> charges;
+        try { while (true) charges.push_back(math::memory::impl::budget_reserve(bytes)); }
+        catch(const math::memory::memory_budget_exceeded&) {}
+        charged.fetch_add(charges.size());
+        #pragma omp barrier
+        for (const math::memory::impl::BudgetCharge &charge : charges) math::memory::impl::budget_release(charge, bytes);
+    }
+    _CHECK_(charged.load() == budget / bytes);
+    _CHECK_(math::memory::memory_budget_available() == budget);
+    math::memory::set_thread_memory_budget(0);
+}
+
+void test_budget_multiply() {
+    // When the product doesn't fit the budget, *= works a panel of rows at a time and still gets the product right.
+    for (const size_t n : { size_t(7), size_t(130) }) {
+        Mat a = math::test::filled<double>(n, n, 5);
+        const Mat b = math::test::filled<double>(n, n, 6), expected = math::test::naive_multiply(a, b);
+        math::memory::set_thread_memory_budget(n * n * sizeof(double) / 2);
+        a *= b;
+        math::memory::set_thread_memory_budget(0);
+        _CHECK_(math::test::max_difference(a, expected) < 1e-12 * static_cast<double>(n));
+    }
+}
+
+void test_first_touch_failure() {
+    // A thread budget running out partway through the team building the rows reaches the caller, and every row already built is given back.
+    const size_t rows = 256, columns = 1024, bytes = rows * columns * sizeof(double);
+    const int threads = omp_get_max_threads();
+    omp_set_num_threads(4);
+    for (const math::memory::NumaPlacement placement : {math::memory::NP::first_touch, math::memory::NP::interleave}) {
+        math::memory::set_numa_placement(placement);
+        math::memory::set_thread_memory_budget(bytes + rows * sizeof(double*) / 2); // The whole array fits, its row pointers push the last rows out.
+        const size_t available = math::memory::memory_budget_available();
+        const int64_t live = math::memory::memory_stats().bytes_live;
+        _CHECK_THROWS_(math::memory::memory_budget_exceeded, Mat(rows, columns, 1.0));
+        _CHECK_(math::memory::memory_stats().bytes_live == live);
+        _CHECK_(math::memory::memory_budget_available() == available);
+        math::memory::set_thread_memory_budget(0);
+        const Mat a(rows, columns, 2.0), zero(rows, columns);
+        bool is_built = true;
+        for (size_t i = 0; i < rows; i++)
+            for (size_t j = 0; j < columns; j++) is_built = is_built && (a(i, j) == 2.0) && (zero(i, j) == 0.0);
+        _CHECK_(is_built);
+    }
+    math::memory::set_numa_placement(math::memory::NP::first_touch);
+    omp_set_num_threads(threads);
+}
+
+void test_pool_remote_frees() {
+    // Blocks freed to an owner that never allocates again are handed back past the cache limit, and by pool_trim.
+    math::memory::set_pool_limits(static_cast<size_t>(64) << 10);
+    std::vector<void*> blocks;
+    math::memory::impl::PoolThreadCache *owner = nullptr;
+    std::mutex lock;
+    std::condition_variable done;
+    bool is_freed = false;
+    std::thread thread([&]() {
+        for (size_t i = 0; i < 64; i++) blocks.push_back(math::memory::pool_allocate(4096));
+        std::unique_lock<std::mutex> guard(lock);
+        owner = math::memory::impl::pool_cache;
+        done.wait(guard, [&]() { return is_freed; });
+    });
+    while (true) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (owner != nullptr) break;
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (size_t i = 0; i < 32; i++) math::memory::pool_free(blocks[i]);
+        _CHECK_(owner->remote_bytes.load() <= (static_cast<size_t>(64) << 10));
+        for (size_t i = 32; i < 40; i++) math::memory::pool_free(blocks[i]);
+        _CHECK_(owner->remote_bytes.load() != 0);
+        math::memory::pool_trim();
+        _CHECK_((owner->remote_bytes.load() == 0) && (owner->remote_frees.load() == nullptr));
+        for (size_t i = 40; i < 64; i++) math::memory::pool_free(blocks[i]);
+        is_freed = true;
+    }
+    done.notify_one();
+    thread.join();
+    math::memory::set_pool_limits();
+}
+}
+
+int main() {
+    test_free_tag();
+    test_reallocate();
+    test_late_free();
+    test_budget_cross_thread();
+    test_budget_team();
+    test_budget_multiply();
+    test_first_touch_failure();
+    test_pool_remote_frees();
+    return math::test::finish("MemoryTest");
+}
\ No newline at end of file
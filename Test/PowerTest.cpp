@@ -0,0 +1,71 @@
+// PowerTest.cpp
+#include "Test.hpp"
+#include "../Matrix/Decomposition/QR.hpp"
+
+namespace {
+using math::matrix::TR;
+
+// a^exponent by exponent - 1 textbook products.
+template <typename T>
+math::Matrix<T> naive_power(const math::Matrix<T> &a, const size_t exponent) {
+    math::Matrix<T> result = math::test::identity<T>(a.num_rows());
+    for (size_t i = 0; i < exponent; i++) result = math::test::naive_multiply(result, a);
+    return result;
+}
+
+void test_pow_integer() {
+    // Exact against the repeated product, for every pattern of bits up to 13 and through the packed blocks.
+    for (const size_t n : math::test::edge_sizes) {
+        if (n == 0) continue;
+        const math::Matrix<long long> a(n, n, [n](size_t i, size_t j) { return i == j ? 1LL : math::test::value_at<long long>(i, j, n) % 2 * ((i + j) % 3 == 0); });
+        for (size_t exponent = 0; exponent <= 13; exponent += (n > 33) ? 3 : 1) _CHECK_(a.pow(exponent) == naive_power(a, exponent));
+    }
+    _CHECK_(math::Matrix<long long>().pow(5).size() == 0);
+    _CHECK_THROWS_(std::logic_error, math::Matrix<long long>(2, 3).pow(2));
+}
+
+void test_pow_memory() {
+    // The result and one scratch Matrix whatever the exponent.
+    const math::Matrix<long long> a(33, 33, [](size_t i, size_t j) { return static_cast<long long>(j == (i + 1) % 33); });
+    const auto multiply_bytes = [&a](size_t exponent) {
+        const uint64_t before = math::memory::memory_stats().of(math::memory::AT::multiply).bytes_allocated;
+        const math::Matrix<long long> result = a.pow(exponent);
+        return math::memory::memory_stats().of(math::memory::AT::multiply).bytes_allocated - before;
+    };
+    const uint64_t squared = multiply_bytes(2);
+    _CHECK_((squared != 0) && (multiply_bytes(13) == squared) && (multiply_bytes(64) == squared));
+}
+
+template <typename T>
+void test_expm(const double tolerance) {
+    // Q * diag(d) * Q^T with Q orthogonal has the exponential Q * diag(e^d) * Q^T. The scales pick every degree of the approximant and squarings.
+    for (const size_t n : math::test::edge_sizes) {
+        if (n == 0) continue;
+        const math::Matrix<T> q = math::QR<T>(math::test::filled<T>(n, n, n)).q();
+        for (const double scale : { 1e-3, 0.1, 1.0, 4.0, 20.0 }) {
+            const auto spectral = [&](auto &&f) {
+                const math::Matrix<T> scaled(n, n, [&](size_t i, size_t j) { return q(i, j) * static_cast<T>(f(scale * math::test::value_at<double>(j, 0, n))); });
+                return math::test::naive_multiply(scaled, TR::no, q, TR::yes);
+            };
+            const math::Matrix<T> a = spectral([](double x) { return x; });
+            const math::Matrix<T> expected = spectral([](double x) { return std::exp(x); });
+            const double magnitude = std::exp(scale);
+            _CHECK_(math::test::max_difference(a.expm(), expected) <= tolerance * magnitude * static_cast<double>(n));
+        }
+    }
+    const math::Matrix<T> nilpotent(3, 3, [](size_t i, size_t j) { return j == i + 1 ? T(2) : T(0); });
+    // I + N + N^2 / 2 exactly, N^3 being zero.
+    const math::Matrix<T> series(3, 3, [](size_t i, size_t j) { return j < i ? T(0) : (j == i ? T(1) : T(2)); });
+    _CHECK_(math::test::max_difference(nilpotent.expm(), series) <= tolerance);
+    _CHECK_(math::Matrix<T>().expm().size() == 0);
+    _CHECK_THROWS_(std::logic_error, math::Matrix<T>(3, 2).expm());
+}
+}
+
+int main() {
+    test_pow_integer();
+    test_pow_memory();
+    test_expm<double>(1e-14);
+    test_expm<float>(1e-5);
+    return math::test::finish("PowerTest");
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+// QRTest.cpp
+#include "Test.hpp"
+#include "../Matrix/Decomposition/QR.hpp"
+#include <vector>
+
+namespace {
+// Largest element of A^T * (A * x - b), zero at the least squares solution.
+template <typename T>
+double normal_residual(const math::Matrix<T> &a, const math::Matrix<T> &x, const math::Matrix<T> &b) {
+    math::Matrix<T> r = math::test::naive_multiply(a, x);
+    for (size_t i = 0; i < r.num_rows(); i++)
+        for (size_t j = 0; j < r.num_columns(); j++) r(i, j) -= b(i, j);
+    const math::Matrix<T> g = math::test::naive_multiply(a, math::matrix::TR::yes, r, math::matrix::TR::no);
+    return math::test::max_difference(g, math::Matrix<T>(g.num_rows(), g.num_columns()));
+}
+
+template <typename T>
+void test_qr(const double tolerance) {
+    // Square, tall and wide shapes around the 64 reflector blocks.
+    const size_t shapes[][2] = { {1, 1}, {2, 1}, {7, 3}, {3, 7}, {33, 33}, {65, 64}, {130, 65}, {65, 130}, {200, 129} };
+    for (const auto &[m, n] : shapes) {
+        const math::Matrix<T> a = math::test::filled<T>(m, n, m + n);
+        const math::QR<T> qr(a);
+        const size_t k = std::min(m, n);
+        _CHECK_(qr.is_full_rank() && (qr.num_rows() == m) && (qr.num_columns() == n) && (qr.tau().size() == k));
+        const math::Matrix<T> q = qr.q(), r = qr.r();
+        _CHECK_((q.num_rows() == m) && (q.num_columns() == k) && (r.num_rows() == k) && (r.num_columns() == n));
+        _CHECK_(math::test::max_difference(math::test::naive_multiply(q, r), a) <= tolerance * static_cast<double>(m));
+        _CHECK_(math::test::max_difference(math::test::naive_multiply(q, math::matrix::TR::yes, q, math::matrix::TR::no), math::test::identity<T>(k)) <= tolerance * static_cast<double>(m));
+        const math::Matrix<T> full = qr.full_q();
+        _CHECK_(math::test::max_difference(math::test::naive_multiply(full, math::matrix::TR::yes, full, math::matrix::TR::no), math::test::identity<T>(m)) <= tolerance * static_cast<double>(m));
+
+        // Q^T then Q gives b back.
+        const math::Matrix<T> b = math::test::filled<T>(m, 3, 11);
+        math::Matrix<T> c = b;
+        qr.apply_qt(c);
+        qr.apply_q(c);
+        _CHECK_(math::test::max_difference(c, b) <= tolerance * static_cast<double>(m));
+        if (m < n) {
+            _CHECK_THROWS_(std::invalid_argument, qr.solve(b));
+            continue;
+        }
+        const math::Matrix<T> x = qr.solve(b);
+        _CHECK_(normal_residual(a, x, b) <= tolerance * static_cast<double>(m * m));
+        _CHECK_(math::test::max_difference(math::lstsq(a, b), x) <= tolerance * static_cast<double>(m * m));
+    }
+}
+
+template <typename T>
+void test_lstsq(const double tolerance) {
+    // Taller than a block of lstsq_rows, and than four of them with a column count that isn't a multiple of qr_block.
+    const size_t shapes[][2] = { {2049, 5}, {4500, 67}, {9000, 1} };
+    for (const auto &[m, n] : shapes) {
+        const math::Matrix<T> a = math::test::filled<T>(m, n, n), b = math::test::filled<T>(m, 2, 12);
+        const math::Matrix<T> x = math::lstsq(a, b);
+        _CHECK_(normal_residual(a, x, b) <= tolerance * static_cast<double>(m));
+        _CHECK_(math::test::max_difference(math::QR<T>(a).solve(b), x) <= tolerance * static_cast<double>(n));
+        std::vector<T> v(m);
+        for (size_t i = 0; i < m; i++) v[i] = b(i, 1);
+        const std::vector<T> y = math::lstsq(a, v);
+        _CHECK_((y.size() == n) && (std::fabs(static_cast<double>(y[n - 1] - x(n - 1, 1))) <= tolerance * static_cast<double>(n)));
+    }
+}
+
+void test_qr_edges() {
+    const math::QR<double> empty{math::Matrix<double>()};
+    _CHECK_(empty.is_full_rank() && (empty.q().size() == 0) && (math::lstsq(math::Matrix<double>(), math::Matrix<double>()).size() == 0));
+    math::Matrix<double> a = math::test::filled<double>(9, 4, 13);
+    for (size_t i = 0; i < 9; i++) a(i, 2) = 0.0; // R gets an exact zero on its diagonal.
+    const math::Matrix<double> b = math::test::filled<double>(9, 1, 14);
+    _CHECK_THROWS_(std::domain_error, math::QR<double>(a).solve(b));
+    _CHECK_THROWS_(std::invalid_argument, math::lstsq(math::Matrix<double>(3, 4), math::Matrix<double>(3, 1)));
+    _CHECK_THROWS_(std::invalid_argument, math::lstsq(math::Matrix<double>(4, 3), math::Matrix<double>(5, 1)));
+    math::Matrix<double> c(5, 1);
+    _CHECK_THROWS_(std::invalid_argument, math::QR<double>(math::Matrix<double>(4, 3)).apply_q(c));
+}
+}
+
+int main() {
+    test_qr<double>(1e-14);
+    test_qr<float>(1e-5);
+    test_lstsq<double>(1e-13);
+    test_lstsq<float>(1e-4);
+    test_qr_edges();
+    return math::test::finish("QRTest");
+}
\ No newline at end of file
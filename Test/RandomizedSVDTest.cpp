@@ -0,0 +1,75 @@
+// RandomizedSVDTest.cpp
+#include "Test.hpp"
+#include "../Matrix/Decomposition/RandomizedSVD.hpp"
+
+namespace {
+using math::matrix::TR;
+
+// U * diag(values) * V^T over the leading columns of u and v.
+template <typename T>
+math::Matrix<T> reconstruct(const math::Matrix<T> &u, const std::span<const T> values, const math::Matrix<T> &v) {
+    const math::Matrix<T> scaled(u.num_rows(), values.size(), [&](size_t i, size_t j) { return u(i, j) * values[j]; });
+    return math::test::naive_multiply(scaled, TR::no, v, TR::yes);
+}
+
+template <typename T>
+double orthonormal_error(const math::Matrix<T> &q) {
+    return math::test::max_difference(math::test::naive_multiply(q, TR::yes, q, TR::no), math::test::identity<T>(q.num_columns()));
+}
+
+template <typename T>
+void test_svd(const double tolerance) {
+    // Exact rank k with singular values 1, 1 / 2, 1 / 4...: the sample of rank + oversampling columns catches all of it, and the power
+    // iterations the leading triplets when fewer are asked for.
+    const size_t shapes[][3] = { {1, 1, 1}, {7, 5, 3}, {5, 7, 5}, {130, 33, 8}, {33, 130, 8}, {200, 65, 20} };
+    for (const auto &[m, n, k] : shapes) {
+        const math::Matrix<T> u0 = math::QR<T>(math::test::filled<T>(m, k, m)).q(), v0 = math::QR<T>(math::test::filled<T>(n, k, n)).q();
+        std::vector<T> s(k);
+        for (size_t i = 0; i < k; i++) s[i] = std::ldexp(T(1), -static_cast<int>(i));
+        const math::Matrix<T> a = reconstruct<T>(u0, s, v0);
+        const double bound = tolerance * static_cast<double>(m + n);
+        for (const size_t rank : { size_t(1), k }) {
+            const math::RandomizedSVD<T> svd(a, rank);
+            _CHECK_((svd.rank() == rank) && (svd.u().num_rows() == m) && (svd.v().num_rows() == n));
+            bool is_equal = true;
+            for (size_t i = 0; i < rank; i++) is_equal = is_equal && (std::fabs(static_cast<double>(svd.values()[i] - s[i])) <= bound);
+            _CHECK_(is_equal);
+            _CHECK_((orthonormal_error(svd.u()) <= bound) && (orthonormal_error(svd.v()) <= bound));
+            const math::Matrix<T> av = math::test::naive_multiply(a, svd.v());
+            _CHECK_(math::test::max_difference(av, reconstruct<T>(svd.u(), svd.values(), math::test::identity<T>(rank))) <= bound);
+            if (rank == k) _CHECK_(math::test::max_difference(reconstruct<T>(svd.u(), svd.values(), svd.v()), a) <= bound);
+        }
+
+        // Through a reader handing over the rows, the same seed gives the same decomposition.
+        size_t next = 0;
+        bool is_in_order = true;
+        auto read = [&](size_t first, math::matrix::MatrixView<T> block) {
+            is_in_order = is_in_order && (first == next % m);
+            next = first + block.num_rows();
+            for (size_t i = 0; i < block.num_rows(); i++) std::copy_n(a[first + i], n, block.row(i));
+        };
+        const math::RandomizedSVD<T> held(a, k, 4, 1, 7), streamed(m, n, read, k, 4, 1, 7);
+        _CHECK_(is_in_order);
+        _CHECK_(math::test::max_difference(held.u(), streamed.u()) <= bound && math::test::max_difference(held.v(), streamed.v()) <= bound);
+    }
+}
+
+void test_svd_edges() {
+    // A full rank Matrix decomposed to its full rank is reproduced, whatever its spectrum.
+    const math::Matrix<double> a = math::test::filled<double>(33, 9, 5);
+    const math::RandomizedSVD<double> svd(a, 9, 0, 0);
+    _CHECK_(std::is_sorted(svd.values().rbegin(), svd.values().rend()));
+    _CHECK_(math::test::max_difference(reconstruct<double>(svd.u(), svd.values(), svd.v()), a) <= 1e-12);
+    const math::RandomizedSVD<double> none(a, 0);
+    _CHECK_((none.rank() == 0) && (none.u().size() == 0));
+    _CHECK_THROWS_(std::invalid_argument, math::RandomizedSVD<double>(a, 10));
+    _CHECK_(math::RandomizedSVD<double>(math::Matrix<double>(), 0).rank() == 0);
+}
+}
+
+int main() {
+    test_svd<double>(1e-13);
+    test_svd<float>(1e-5);
+    test_svd_edges();
+    return math::test::finish("RandomizedSVDTest");
+}
\ No newline at end of file
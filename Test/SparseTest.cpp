@@ -0,0 +1,100 @@
+// SparseTest.cpp
+#include "Test.hpp"
+#include "../Matrix/SparseMatrix.hpp"
+#include <vector>
+
+namespace {
+using math::matrix::SF;
+using math::matrix::TR;
+
+// About one element in sixteen stored plus a full middle row to unbalance the parts.
+template <typename T>
+math::Matrix<T> sparse_dense(const size_t rows, const size_t columns, const size_t seed) {
+    return math::Matrix<T>(rows, columns, [=](size_t i, size_t j) {
+        const bool is_stored = (i == rows / 2) || (math::test::value_at<long long>(i, j, seed + 1) == 0);
+        return is_stored ? math::test::value_at<T>(i, j, seed) : T(0);
+    });
+}
+
+// Through the builder, every element added as two halves and the rows in reverse.
+template <typename T>
+math::SparseMatrix<T> built(const math::Matrix<T> &dense, const SF format) {
+    math::SparseBuilder<T> builder(dense.num_rows(), dense.num_columns());
+    for (size_t pass = 0; pass < 2; pass++)
+        for (size_t i = dense.num_rows(); i-- != 0;)
+            for (size_t j = 0; j < dense.num_columns(); j++)
+                if (dense(i, j) != T(0)) builder.add(i, j, pass == 0 ? dense(i, j) - dense(i, j) / T(2) : dense(i, j) / T(2));
+    return builder.build(format);
+}
+
+template <typename T>
+void test_sparse(const double tolerance) {
+    // Around and past sparse_parallel_work stored elements, so the products go through one thread and the team.
+    const size_t shapes[][2] = { {1, 1}, {1, 7}, {7, 1}, {7, 5}, {130, 33}, {33, 130}, {2000, 301} };
+    size_t seed = 0;
+    for (const auto &[m, n] : shapes)
+        for (const SF format : { SF::csr, SF::csc }) {
+            const math::Matrix<T> dense = sparse_dense<T>(m, n, ++seed);
+            const math::SparseMatrix<T> a = built(dense, format);
+            _CHECK_((a.format() == format) && (math::test::max_difference(a.to_dense(), dense) <= tolerance));
+            _CHECK_(math::SparseMatrix<T>(dense, format).to_dense() == dense);
+            _CHECK_(math::test::max_difference(a.converted(format == SF::csr ? SF::csc : SF::csr).to_dense(), dense) <= tolerance);
+            _CHECK_(math::test::max_difference(a.transpose().to_dense(), dense.transpose()) <= tolerance);
+            _CHECK_(math::test::max_difference(math::Matrix<T>(m, n, [&a](size_t i, size_t j) { return a(i, j); }), dense) <= tolerance);
+
+            for (const TR ta : { TR::no, TR::yes }) {
+                const bool is_no = ta == TR::no;
+                const size_t rows = is_no ? m : n, columns = is_no ? n : m;
+                const math::Matrix<T> x = math::test::filled<T>(columns, 3, ++seed);
+                const math::Matrix<T> expected = math::test::naive_multiply(dense, ta, x, TR::no);
+                const T beta = T(0.5);
+                const math::Matrix<T> y0 = math::test::filled<T>(rows, 3, ++seed);
+
+                // y = 2 * op(a) * x + beta * y, then beta zero over NaN which must not be read.
+                std::vector<T> xv(columns), yv(rows), zv(rows, std::numeric_limits<T>::quiet_NaN());
+                for (size_t i = 0; i < columns; i++) xv[i] = x(i, 0);
+                for (size_t i = 0; i < rows; i++) yv[i] = y0(i, 0);
+                math::spmv(T(2), a, ta, std::span<const T>(xv), beta, std::span<T>(yv));
+                math::spmv(T(1), a, ta, std::span<const T>(xv), T(0), std::span<T>(zv));
+                const math::Matrix<T> y(rows, 1, [&](size_t i, size_t) { return yv[i]; }), z(rows, 1, [&](size_t i, size_t) { return zv[i]; });
+                _CHECK_(math::test::max_difference(y, math::Matrix<T>(rows, 1, [&](size_t i, size_t) { return T(2) * expected(i, 0) + beta * y0(i, 0); })) <= tolerance * static_cast<double>(columns));
+                _CHECK_(math::test::max_difference(z, math::Matrix<T>(rows, 1, [&](size_t i, size_t) { return expected(i, 0); })) <= tolerance * static_cast<double>(columns));
+
+                math::Matrix<T> c = y0;
+                math::spmm(T(2), a, ta, x, beta, c);
+                _CHECK_(math::test::max_difference(c, math::Matrix<T>(rows, 3, [&](size_t i, size_t j) { return T(2) * expected(i, j) + beta * y0(i, j); })) <= tolerance * static_cast<double>(columns));
+                if (is_no) {
+                    _CHECK_(math::test::max_difference(a * x, expected) <= tolerance * static_cast<double>(columns));
+                    const std::vector<T> w = a * xv;
+                    _CHECK_((w.size() == m) && (std::fabs(static_cast<double>(w[m - 1] - expected(m - 1, 0))) <= tolerance * static_cast<double>(columns)));
+                }
+            }
+        }
+}
+
+void test_sparse_edges() {
+    // Duplicates are summed in the order added, unstored elements read as zero, and bad input throws.
+    math::SparseBuilder<double> builder(3, 4);
+    builder.add(2, 3, 1.0);
+    builder.add(0, 1, 2.0);
+    builder.add(2, 3, 4.0);
+    const math::SparseMatrix<double> a = builder.build();
+    _CHECK_((a.non_zeros() == 2) && (a(2, 3) == 5.0) && (a(0, 1) == 2.0) && (a(1, 1) == 0.0));
+    _CHECK_THROWS_(std::out_of_range, builder.add(3, 0, 1.0));
+    const math::SparseMatrix<double> empty(5, 3);
+    _CHECK_((empty.non_zeros() == 0) && (empty.to_dense() == math::Matrix<double>(5, 3)));
+    _CHECK_THROWS_(std::invalid_argument, math::SparseMatrix<double>(2, 2, SF::csr, { 0, 2, 2 }, { 1, 0 }, { 1.0, 2.0 }));
+    _CHECK_THROWS_(std::invalid_argument, math::SparseMatrix<double>(2, 2, SF::csr, { 0, 1 }, { 0 }, { 1.0 }));
+    std::vector<double> x(3), y(3);
+    _CHECK_THROWS_(std::invalid_argument, math::spmv(1.0, a, TR::no, std::span<const double>(x), 0.0, std::span<double>(y)));
+    math::Matrix<double> b(4, 2), c(2, 2);
+    _CHECK_THROWS_(std::invalid_argument, math::spmm(1.0, a, TR::no, b, 0.0, c));
+}
+}
+
+int main() {
+    test_sparse<double>(1e-14);
+    test_sparse<float>(1e-5);
+    test_sparse_edges();
+    return math::test::finish("SparseTest");
+}
\ No newline at end of file
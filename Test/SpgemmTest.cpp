@@ -0,0 +1,92 @@
+// SpgemmTest.cpp
+#include "Test.hpp"
+#include "../Matrix/SparseMatrix.hpp"
+
+namespace {
+using math::matrix::SF;
+
+// About one element in density stored.
+template <typename T>
+math::Matrix<T> sparse_dense(const size_t rows, const size_t columns, const size_t density, const size_t seed) {
+    return math::Matrix<T>(rows, columns, [=](size_t i, size_t j) {
+        return (math::test::value_at<T>(i, j, seed + 1) + T(1)) * static_cast<T>(density) < T(2) ? math::test::value_at<T>(i, j, seed) : T(0);
+    });
+}
+
+template <typename T>
+void test_spgemm(const double tolerance) {
+    // Dense and hashed rows, short rows sorted by insertion and long ones by radix over one and two bytes, in every pair of formats.
+    const size_t shapes[][4] = { {1, 1, 1, 1}, {7, 5, 3, 2}, {33, 130, 7, 4}, {130, 33, 301, 16}, {40, 100, 1000, 50}, {32, 200, 3000, 100}, {300, 150, 400, 8} };
+    size_t seed = 0;
+    for (const auto &[m, k, n, density] : shapes) {
+        const math::Matrix<T> a = sparse_dense<T>(m, k, density, ++seed), b = sparse_dense<T>(k, n, density, ++seed);
+        const math::Matrix<T> expected = math::test::naive_multiply(a, b);
+        // Every element reached by a partial product is stored, none else.
+        size_t stored = 0;
+        for (size_t i = 0; i < m; i++)
+            for (size_t j = 0; j < n; j++) {
+                bool is_reached = false;
+                for (size_t p = 0; p < k && !is_reached; p++) is_reached = (a(i, p) != T(0)) && (b(p, j) != T(0));
+                stored += is_reached;
+            }
+        for (const SF left : { SF::csr, SF::csc })
+            for (const SF right : { SF::csr, SF::csc }) {
+                const math::SparseMatrix<T> c = math::spgemm(math::SparseMatrix<T>(a, left), math::SparseMatrix<T>(b, right));
+                _CHECK_((c.format() == left) && (c.non_zeros() == stored));
+                _CHECK_(math::test::max_difference(c.to_dense(), expected) <= tolerance * static_cast<double>(k));
+            }
+    }
+}
+
+void test_spgemm_wide() {
+    // Far too many columns for a dense array per thread, the rows hash even when their partial products would cover it.
+    using Accumulator = math::matrix::impl::SpgemmAccumulator<double, std::uint32_t>;
+    const size_t columns = math::matrix::impl::spgemm_dense_bytes / 8;
+    _CHECK_(!Accumulator::is_dense(columns, columns) && Accumulator::is_dense(64, 1024));
+    math::SparseBuilder<double> a_builder(2, 3), b_builder(3, columns);
+    for (size_t j = 0; j < 3; j++) a_builder.add(0, j, 1.0);
+    a_builder.add(1, 1, 2.0);
+    for (size_t i = 0; i < 3; i++)
+        for (size_t j = i; j < columns; j += 3 * (i + 1)) b_builder.add(i, j, static_cast<double>(i + 1));
+    const math::SparseMatrix<double> a = a_builder.build(), b = b_builder.build();
+    const math::SparseMatrix<double> c = a * b;
+    bool is_equal = (c.num_rows() == 2) && (c.num_columns() == columns);
+    for (size_t j = 0; j < columns && is_equal; j += 7) {
+        const double expected = b(0, j) + b(1, j) + b(2, j);
+        is_equal = (c(0, j) == expected) && (c(1, j) == 2.0 * b(1, j));
+    }
+    _CHECK_(is_equal);
+}
+
+void test_spgemm_edges() {
+    // A sum cancelling to zero stays stored, and mismatched sizes throw.
+    const math::Matrix<double> a(1, 2, [](size_t, size_t j) { return j == 0 ? 1.0 : -1.0; }), b(2, 1, 1.0);
+    const math::SparseMatrix<double> c = math::SparseMatrix<double>(a) * math::SparseMatrix<double>(b);
+    _CHECK_((c.non_zeros() == 1) && (c(0, 0) == 0.0));
+    const math::SparseMatrix<double> empty = math::SparseMatrix<double>(4, 3) * math::SparseMatrix<double>(3, 5);
+    _CHECK_((empty.non_zeros() == 0) && (empty.num_rows() == 4) && (empty.num_columns() == 5));
+    _CHECK_THROWS_(std::invalid_argument, math::SparseMatrix<double>(4, 3) * math::SparseMatrix<double>(4, 3));
+
+    // The largest 8 bit column would be taken for a free slot of the hash table, so the kernel refuses 256 columns and multiplies 255.
+    const std::vector<std::uint8_t> a_offsets = { 0, 1 }, a_indices = { 0 }, b_offsets = { 0, 2 }, wide_indices = { 0, 255 }, narrow_indices = { 0, 254 };
+    const std::vector<double> values = { 2.0, 3.0 };
+    std::vector<std::uint8_t> c_offsets, c_indices;
+    std::vector<double> c_values;
+    const auto product = [&](const std::vector<std::uint8_t> &b_indices, const size_t n) {
+        const math::matrix::impl::SpgemmOperands<double, std::uint8_t> operands{ a_offsets.data(), a_indices.data(), values.data(),
+                                                                                 b_offsets.data(), b_indices.data(), values.data() };
+        math::matrix::impl::spgemm_kernel<double, std::uint8_t>(1, n, operands, c_offsets, c_indices, c_values);
+    };
+    _CHECK_THROWS_(std::invalid_argument, product(wide_indices, 256));
+    product(narrow_indices, 255);
+    _CHECK_((c_indices == std::vector<std::uint8_t>{ 0, 254 }) && (c_values == std::vector<double>{ 4.0, 6.0 }));
+}
+}
+
+int main() {
+    test_spgemm<double>(1e-14);
+    test_spgemm<float>(1e-5);
+    test_spgemm_wide();
+    test_spgemm_edges();
+    return math::test::finish("SpgemmTest");
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+// StatisticsTest.cpp
+#include "Test.hpp"
+#include "../Benchmark/Compare/Compare.hpp"
+#include <string>
+
+namespace {
+using math::bench::Verdict;
+
+bool near(const double x, const double y, const double tolerance) noexcept {
+    return std::fabs(x - y) <= tolerance;
+}
+
+// A run of math_benchmarks with the given ns/op samples per benchmark.
+math::bench::JsonValue run_of(const std::vector<std::pair<std::string, std::vector<double>>> &benchmarks) {
+    std::string json = "{\"benchmarks\":[";
+    for (size_t b = 0; b < benchmarks.size(); b++) {
+        json += (b == 0 ? "" : ",") + std::string("{\"name\":\"") + benchmarks[b].first + "\",\"samples_ns_per_op\":[";
+        for (size_t i = 0; i < benchmarks[b].second.size(); i++) json += (i == 0 ? "" : ",") + std::to_string(benchmarks[b].second[i]);
+        json += "]}";
+    }
+    return math::bench::parse_json(json + "]}");
+}
+
+// Count samples spread evenly over center * (1 +- spread).
+std::vector<double> samples_around(const double center, const double spread, const size_t count) {
+    std::vector<double> samples(count);
+    for (size_t i = 0; i < count; i++) samples[i] = center * (1 + spread * (2.0 * static_cast<double>(i) / static_cast<double>(count - 1) - 1));
+    return samples;
+}
+
+void test_median() {
+    _CHECK_(math::bench::median({ 5, 1, 3 }) == 3);
+    _CHECK_(math::bench::median({ 4, 1, 3, 2 }) == 2.5);
+    _CHECK_(math::bench::median({ 7 }) == 7);
+    _CHECK_(std::isnan(math::bench::median({})));
+    // Deviations from 3 are {2, 2, 1, 0, 1, 6, 3}.
+    _CHECK_(math::bench::median_absolute_deviation({ 1, 5, 2, 3, 4, 9, 6 }) == 2);
+    _CHECK_(std::isnan(math::bench::median_absolute_deviation({})));
+}
+
+void test_median_interval() {
+    // The binomial tables: 95% of x(2)..x(8) for 9 samples and x(6)..x(15) for 20(1 based), 99% of x(4)..x(17) for 20.
+    std::vector<double> nine = { 9, 3, 7, 1, 5, 2, 8, 4, 6 }, twenty(20);
+    for (size_t i = 0; i < 20; i++) twenty[i] = static_cast<double>((i * 7) % 20 + 1);
+    const math::bench::MedianInterval i9 = math::bench::median_confidence_interval(nine), i20 = math::bench::median_confidence_interval(twenty);
+    _CHECK_(i9.low == 2 && i9.high == 8);
+    _CHECK_(i20.low == 6 && i20.high == 15);
+    const math::bench::MedianInterval i20_99 = math::bench::median_confidence_interval(twenty, 0.99);
+    _CHECK_(i20_99.low == 4 && i20_99.high == 17);
+    // Too few samples for 95% keep their whole range.
+    const math::bench::MedianInterval i3 = math::bench::median_confidence_interval({ 3, 1, 2 });
+    _CHECK_(i3.low == 1 && i3.high == 3);
+    const math::bench::MedianInterval empty = math::bench::median_confidence_interval({});
+    _CHECK_(std::isnan(empty.low) && std::isnan(empty.high));
+}
+
+void test_mann_whitney() {
+    // Exact: every value of a below every value of b is 1 of C(6, 3) = 20 arrangements on each side, 1 of C(10, 5) = 252 for 5 and 5.
+    const math::bench::MannWhitneyResult three = math::bench::mann_whitney_u({ 1, 2, 3 }, { 4, 5, 6 });
+    _CHECK_(three.exact && three.u == 0 && near(three.p_value, 2.0 / 20, 1e-12));
+    const math::bench::MannWhitneyResult five = math::bench::mann_whitney_u({ 6, 7, 8, 9, 10 }, { 1, 2, 3, 4, 5 });
+    _CHECK_(five.exact && five.u == 25 && near(five.p_value, 2.0 / 252, 1e-12));
+    // Interleaved samples: U = 10 of 25, close to the middle of the distribution.
+    const math::bench::MannWhitneyResult mixed = math::bench::mann_whitney_u({ 1, 3, 5, 7, 9 }, { 2, 4, 6, 8, 10 });
+    _CHECK_(mixed.exact && mixed.u == 10 && mixed.p_value > 0.5);
+    // Ties and larger samples go to the normal approximation.
+    const math::bench::MannWhitneyResult tied = math::bench::mann_whitney_u({ 1, 1, 2, 2 }, { 1, 2, 2, 3 });
+    _CHECK_(!tied.exact && tied.p_value > 0.3);
+    const math::bench::MannWhitneyResult apart = math::bench::mann_whitney_u(samples_around(100, 0.01, 30), samples_around(110, 0.01, 30));
+    _CHECK_(!apart.exact && apart.u == 0 && apart.p_value < 1e-9);
+    _CHECK_(math::bench::mann_whitney_u({ 4, 4, 4 }, { 4, 4 }).p_value == 1);
+    _CHECK_(math::bench::mann_whitney_u({}, { 1 }).p_value == 1);
+}
+
+void test_verdict() {
+    // Significant changes past the threshold are verdicts, noise and changes within the threshold are not.
+    const std::vector<double> base = samples_around(100, 0.01, 10);
+    const math::bench::JsonValue baseline = run_of({ {"slower", base}, {"faster", base}, {"within", base}, {"noisy", samples_around(100, 0.5, 10)},
+                                                    {"few", { 100, 101 }}, {"tuned", base}, {"gone", base} });
+    const math::bench::JsonValue contender = run_of({ {"slower", samples_around(110, 0.01, 10)}, {"faster", samples_around(90, 0.01, 10)},
+                                                     {"within", samples_around(103, 0.01, 10)}, {"noisy", samples_around(110, 0.5, 10)},
+                                                     {"few", { 120, 121 }}, {"tuned", samples_around(110, 0.01, 10)}, {"new", base} });
+    math::bench::CompareOptions options;
+    options.thresholds.push_back(math::bench::Threshold{ "tun", 0.2 });
+    const std::vector<math::bench::Comparison> comparisons = math::bench::compare_runs(baseline, contender, options);
+    const auto verdict_of = [&comparisons](const std::string &name) {
+        for (const math::bench::Comparison &c : comparisons) if (c.name == name) return c;
+        return math::bench::Comparison{};
+    };
+    _CHECK_(comparisons.size() == 8);
+    const math::bench::Comparison slower = verdict_of("slower");
+    _CHECK_(slower.verdict == Verdict::regression && near(slower.change, 0.1, 1e-12) && slower.p_value < options.alpha && slower.enough_samples);
+    _CHECK_(slower.contender_interval.low < 110 && slower.contender_interval.high > 110 && slower.contender_interval.high < 111.1);
+    _CHECK_(verdict_of("faster").verdict == Verdict::improvement);
+    _CHECK_(verdict_of("within").verdict == Verdict::same && verdict_of("within").p_value < options.alpha);
+    _CHECK_(verdict_of("noisy").verdict == Verdict::same && verdict_of("noisy").p_value >= options.alpha);
+    _CHECK_(verdict_of("few").verdict == Verdict::regression && !verdict_of("few").enough_samples);
+    _CHECK_(verdict_of("tuned").verdict == Verdict::same && verdict_of("tuned").threshold == 0.2);
+    _CHECK_(verdict_of("new").verdict == Verdict::added && verdict_of("gone").verdict == Verdict::missing);
+    _CHECK_THROWS_(std::runtime_error, math::bench::compare_runs(math::bench::parse_json("{}"), contender, options));
+}
+}
+
+int main() {
+    test_median();
+    test_median_interval();
+    test_mann_whitney();
+    test_verdict();
+    return math::test::finish("StatisticsTest");
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+// StrassenTest.cpp
+#include "Test.hpp"
+
+namespace {
+template <typename T>
+void test_strassen(const double tolerance) {
+    // Small crossovers force several levels, odd sizes go through the peeling of the last row and column.
+    for (const size_t n : math::test::edge_sizes)
+        for (const size_t crossover : { size_t(1), size_t(4), size_t(16) }) {
+            if (n == 0) continue;
+            const math::Matrix<T> a = math::test::filled<T>(n, n, 1), b = math::test::filled<T>(n, n, 2), expected = math::test::naive_multiply(a, b);
+            math::Matrix<T> c(n, n, T(7));
+            const bool is_done = math::matrix::strassen_multiply<T>(c.view(), a.view(), b.view(), crossover);
+            _CHECK_(is_done == (n > crossover));
+            if (is_done) _CHECK_(math::test::max_difference(c, expected) <= tolerance * static_cast<double>(n));
+            else _CHECK_(c == math::Matrix<T>(n, n, T(7)));
+        }
+    // Matrix::operator* takes the recursion past the crossover.
+    const size_t crossover = math::matrix::strassen_crossover();
+    math::matrix::set_strassen_crossover(16);
+    const math::Matrix<T> a = math::test::filled<T>(130, 130, 3), b = math::test::filled<T>(130, 130, 4);
+    _CHECK_(math::test::max_difference(a * b, math::test::naive_multiply(a, b)) <= tolerance * 130.0);
+    math::matrix::set_strassen_crossover(crossover);
+    math::Matrix<T> c(3, 3);
+    const math::Matrix<T> wide(3, 4);
+    _CHECK_THROWS_(std::invalid_argument, math::matrix::strassen_multiply<T>(c.view(), wide.view(), wide.view(), 1));
+}
+}
+
+int main() {
+    test_strassen<double>(1e-13);
+    test_strassen<float>(1e-4);
+    return math::test::finish("StrassenTest");
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+// SymmetricEigenTest.cpp
+#include "Test.hpp"
+#include "../Matrix/Decomposition/SymmetricEigen.hpp"
+
+namespace {
+using math::matrix::EV;
+using math::matrix::TR;
+
+// Symmetric with NaN above the diagonal, which must never be read.
+template <typename T>
+math::Matrix<T> lower_symmetric(const size_t n, const size_t seed) {
+    return math::Matrix<T>(n, n, [seed](size_t i, size_t j) {
+        return j > i ? std::numeric_limits<T>::quiet_NaN() : math::test::value_at<T>(i, j, seed);
+    });
+}
+
+// Largest element of A * V - V * diag(values) and of V^T * V - I, A taken from its lower triangle.
+template <typename T>
+double eigen_error(const math::Matrix<T> &a, const math::SymmetricEigen<T> &eigen) {
+    const size_t n = a.num_rows(), count = eigen.values().size();
+    const math::Matrix<T> full(n, n, [&a](size_t i, size_t j) { return j > i ? a(j, i) : a(i, j); });
+    const math::Matrix<T> &v = eigen.vectors();
+    const math::Matrix<T> scaled(n, count, [&](size_t i, size_t j) { return v(i, j) * eigen.values()[j]; });
+    return std::max(math::test::max_difference(math::test::naive_multiply(full, v), scaled),
+                    math::test::max_difference(math::test::naive_multiply(v, TR::yes, v, TR::no), math::test::identity<T>(count)));
+}
+
+template <typename T>
+void test_eigen(const double tolerance) {
+    // Past the 32 leaves of divide and conquer and the 64 column panels of the tridiagonalisation.
+    for (const size_t n : { size_t(1), size_t(2), size_t(7), size_t(33), size_t(65), size_t(130) }) {
+        const math::Matrix<T> a = lower_symmetric<T>(n, n);
+        const double bound = tolerance * static_cast<double>(n);
+        const math::SymmetricEigen<T> eigen(a);
+        _CHECK_(eigen.has_vectors() && (eigen.size() == n) && (eigen.values().size() == n));
+        _CHECK_(std::is_sorted(eigen.values().begin(), eigen.values().end()));
+        _CHECK_(eigen_error(a, eigen) <= bound);
+        double trace = 0.0, sum = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            trace += static_cast<double>(a(i, i));
+            sum += static_cast<double>(eigen.values()[i]);
+        }
+        _CHECK_(std::fabs(trace - sum) <= bound);
+
+        const math::SymmetricEigen<T> values_only(a, EV::no);
+        _CHECK_(!values_only.has_vectors());
+        bool is_equal = true;
+        for (size_t i = 0; i < n; i++) is_equal = is_equal && (std::fabs(static_cast<double>(values_only.values()[i] - eigen.values()[i])) <= bound);
+        _CHECK_(is_equal);
+
+        // A few values through bisection and inverse iteration, and over half of them through divide and conquer.
+        for (const size_t count : { std::min(n, size_t(3)), n - n / 3 }) {
+            const size_t first = (n - count) / 2;
+            for (const EV vectors : { EV::yes, EV::no }) {
+                const math::SymmetricEigen<T> range(a, first, count, vectors);
+                _CHECK_(range.values().size() == count);
+                is_equal = true;
+                for (size_t i = 0; i < count; i++) is_equal = is_equal && (std::fabs(static_cast<double>(range.values()[i] - eigen.values()[first + i])) <= bound);
+                _CHECK_(is_equal);
+                if (vectors == EV::yes) _CHECK_(eigen_error(a, range) <= bound);
+            }
+        }
+    }
+}
+
+void test_eigen_edges() {
+    // Repeated eigenvalues still get orthonormal vectors, from bisection too, and a zero Matrix the unit vectors.
+    for (const size_t n : { size_t(7), size_t(130) }) {
+        const math::Matrix<double> clustered(n, n, [](size_t i, size_t j) { return i == j ? (i % 2 == 0 ? 1.0 : 2.0) : 0.0; });
+        const math::SymmetricEigen<double> all(clustered), some(clustered, 1, 3);
+        _CHECK_((all.values()[0] == 1.0) && (all.values()[n - 1] == 2.0));
+        _CHECK_((eigen_error(clustered, all) <= 1e-13) && (eigen_error(clustered, some) <= 1e-13));
+        const math::Matrix<double> zero(n, n);
+        const math::SymmetricEigen<double> zeros(zero, 2, 2);
+        _CHECK_((zeros.values()[1] == 0.0) && (eigen_error(zero, zeros) == 0.0));
+    }
+    const math::SymmetricEigen<double> empty{math::Matrix<double>()};
+    _CHECK_((empty.size() == 0) && empty.values().empty() && !empty.has_vectors());
+    _CHECK_THROWS_(std::invalid_argument, math::SymmetricEigen<double>(math::Matrix<double>(2, 3)));
+    _CHECK_THROWS_(std::invalid_argument, math::SymmetricEigen<double>(math::Matrix<double>(3, 3), 2, 2));
+}
+}
+
+int main() {
+    test_eigen<double>(1e-13);
+    test_eigen<float>(1e-5);
+    test_eigen_edges();
+    return math::test::finish("SymmetricEigenTest");
+}
\ No newline at end of file
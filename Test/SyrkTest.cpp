@@ -0,0 +1,53 @@
+// SyrkTest.cpp
+#include "Test.hpp"
+
+namespace {
+using math::matrix::TR;
+using math::matrix::TRI;
+
+template <typename T>
+void test_syrk(const double tolerance) {
+    // Sides around the 128 row tiles and the 16 row diagonal triangles, depths past one gemm block.
+    const size_t shapes[][2] = { {1, 1}, {2, 7}, {7, 1}, {17, 33}, {130, 5}, {33, 300}, {257, 40} };
+    size_t seed = 0;
+    for (const auto &shape : shapes)
+        for (const TR ta : { TR::no, TR::yes })
+            for (const TRI triangle : { TRI::lower, TRI::upper })
+                for (const bool mirror : { false, true }) {
+                    const size_t n = shape[0], k = shape[1];
+                    const math::Matrix<T> a = (ta == TR::no) ? math::test::filled<T>(n, k, ++seed) : math::test::filled<T>(k, n, ++seed);
+                    const math::Matrix<T> c0 = math::test::filled<T>(n, n, ++seed);
+                    math::Matrix<T> c = c0;
+                    const T alpha = T(2), beta = mirror ? T(0) : T(-1);
+                    math::syrk<T>(alpha, a, ta, beta, c, triangle, mirror);
+                    const math::Matrix<T> product = math::test::naive_multiply(a, ta, a, (ta == TR::no) ? TR::yes : TR::no);
+                    double error = 0.0;
+                    bool is_untouched = true;
+                    for (size_t i = 0; i < n; i++)
+                        for (size_t j = 0; j < n; j++) {
+                            const bool is_computed = (triangle == TRI::lower) ? (j <= i) : (j >= i);
+                            if (is_computed || mirror) error = std::max(error, std::fabs(static_cast<double>(c(i, j)) - static_cast<double>(alpha * product(i, j) + beta * c0(i, j))));
+                            else is_untouched = is_untouched && (c(i, j) == c0(i, j));
+                        }
+                    _CHECK_(error <= tolerance * static_cast<double>(k));
+                    _CHECK_(is_untouched);
+                }
+}
+
+void test_syrk_edges() {
+    math::Matrix<double> c(3, 3);
+    const math::Matrix<double> a = math::test::filled<double>(4, 2, 1);
+    _CHECK_THROWS_(std::invalid_argument, math::syrk<double>(1.0, a, TR::no, 0.0, c, TRI::lower));
+    math::Matrix<double> d(2, 2, 5.0);
+    math::syrk<double>(1.0, a.view().block(0, 0, 2, 0), TR::no, 3.0, d.view(), TRI::upper); // Empty depth only scales the triangle.
+    _CHECK_((d(0, 0) == 15.0) && (d(0, 1) == 15.0) && (d(1, 1) == 15.0) && (d(1, 0) == 5.0));
+}
+}
+
+int main() {
+    test_syrk<double>(1e-14);
+    test_syrk<float>(1e-5);
+    test_syrk<long long>(0.0);
+    test_syrk_edges();
+    return math::test::finish("SyrkTest");
+}
\ No newline at end of file
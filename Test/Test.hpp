@@ -0,0 +1,85 @@
+// Test.hpp
+#pragma once
+
+#include "../Matrix/Matrix.hpp"
+#include <cstdio>
+
+// Records a failed check with its expression and location, the test keeps running so one run reports every failure.
+#define _CHECK_(condition) math::test::check((condition), #condition, __FILE__, __LINE__)
+
+namespace math::test {
+inline size_t checks = 0, failures = 0;
+
+inline void check(const bool condition, const char *const expression, const char *const file, const int line) noexcept {
+    checks++;
+    if (condition) return;
+    failures++;
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+}
+
+// Expects body to throw E, anything else(or nothing) is a failure.
+template <typename E, typename Body>
+inline void check_throws(Body &&body, const char *const expression, const char *const file, const int line) noexcept {
+    bool is_thrown = false;
+    try { body(); } catch (const E &) { is_thrown = true; } catch (...) {}
+    math::test::check(is_thrown, expression, file, line);
+}
+#define _CHECK_THROWS_(E, ...) math::test::check_throws<E>([&]() { (void)(__VA_ARGS__); }, #__VA_ARGS__, __FILE__, __LINE__)
+
+// Exit code of a test executable, with a one line summary.
+inline int finish(const char *const name) noexcept {
+    std::printf("%s: %zu checks, %zu failed\n", name, checks, failures);
+    return failures == 0 ? 0 : 1;
+}
+
+// Deterministic entries in [-1, 1) from the position and a seed, the same on every platform.
+_MTEMPL_ _NODISC_ inline T value_at(const size_t i, const size_t j, const size_t seed) noexcept {
+    std::uint64_t x = (static_cast<std::uint64_t>(i) * 0x9e3779b97f4a7c15ull) ^ (static_cast<std::uint64_t>(j) * 0xc2b2ae3d27d4eb4full) ^ (seed * 0x165667b19e3779f9ull);
+    x ^= x >> 31;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 29;
+    if constexpr (std::floating_point<T>) return static_cast<T>(static_cast<double>(x >> 11) * 0x1.0p-52 - 1.0);
+    else return static_cast<T>(static_cast<std::int64_t>(x >> 60) - 8);
+}
+
+_MTEMPL_ _NODISC_ inline Matrix<T> filled(const size_t rows, const size_t columns, const size_t seed) {
+    return Matrix<T>(rows, columns, [seed](size_t i, size_t j) { return math::test::value_at<T>(i, j, seed); });
+}
+
+// The reference the kernels are checked against: op(a) * op(b) by the textbook triple loop.
+_MTEMPL_ _NODISC_ inline Matrix<T> naive_multiply(const Matrix<T> &a, const math::matrix::Transpose ta, const Matrix<T> &b, const math::matrix::Transpose tb) {
+    const bool is_a = ta == math::matrix::TR::yes, is_b = tb == math::matrix::TR::yes;
+    const size_t m = is_a ? a.num_columns() : a.num_rows(), k = is_a ? a.num_rows() : a.num_columns(), n = is_b ? b.num_rows() : b.num_columns();
+    Matrix<T> c(m, n);
+    for (size_t i = 0; i < m; i++)
+        for (size_t j = 0; j < n; j++) {
+            T sum = T(0);
+            for (size_t p = 0; p < k; p++) sum += (is_a ? a(p, i) : a(i, p)) * (is_b ? b(j, p) : b(p, j));
+            c(i, j) = sum;
+        }
+    return c;
+}
+_MTEMPL_ _NODISC_ inline Matrix<T> naive_multiply(const Matrix<T> &a, const Matrix<T> &b) {
+    return math::test::naive_multiply<T>(a, math::matrix::TR::no, b, math::matrix::TR::no);
+}
+
+// Largest absolute difference of two matrices of the same shape, infinity when the shapes differ or an element is NaN.
+_MTEMPL_ _NODISC_ inline double max_difference(const Matrix<T> &a, const Matrix<T> &b) {
+    if ((a.num_rows() != b.num_rows()) || (a.num_columns() != b.num_columns())) return std::numeric_limits<double>::infinity();
+    double result = 0.0;
+    for (size_t i = 0; i < a.num_rows(); i++)
+        for (size_t j = 0; j < a.num_columns(); j++) {
+            const double difference = std::fabs(static_cast<double>(a(i, j)) - static_cast<double>(b(i, j)));
+            if (std::isnan(difference)) return std::numeric_limits<double>::infinity(); // std::max would drop it.
+            result = std::max(result, difference);
+        }
+    return result;
+}
+
+_MTEMPL_ _NODISC_ inline Matrix<T> identity(const size_t size) {
+    return Matrix<T>(size, size, [](size_t i, size_t j) { return i == j ? T(1) : T(0); });
+}
+
+// Shapes every kernel goes through: empty, single, odd and past one block of the packed kernels.
+inline constexpr size_t edge_sizes[] = { 0, 1, 2, 7, 33, 130 };
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+// TraceTest.cpp
+#include "Test.hpp"
+#include "../Profile/Trace.hpp"
+#include <thread>
+
+namespace {
+void test_retired_cap() {
+    // Threads that keep exiting don't grow the retired spans past trace_retired_capacity, the latest threads are the ones kept.
+    math::profile::reset_trace();
+    const size_t spans = math::profile::trace_buffer_capacity;
+    for (size_t t = 0; t < 12; t++)
+        std::thread([spans]() {
+            for (size_t i = 0; i < spans; i++) math::profile::TraceSpan span(math::profile::SK::compute, "span");
+        }).join();
+    const std::vector<math::profile::ThreadTrace> snapshot = math::profile::trace_snapshot();
+    size_t total = 0;
+    for (const math::profile::ThreadTrace &thread : snapshot) total += thread.events.size();
+    _CHECK_(total <= math::profile::trace_retired_capacity);
+    _CHECK_(total >= math::profile::trace_retired_capacity - spans);
+    _CHECK_(!snapshot.empty() && (snapshot.back().thread + 1 == math::profile::impl::TraceRegistry::instance().next_thread));
+    math::profile::reset_trace();
+    _CHECK_(math::profile::trace_snapshot().empty());
+}
+}
+
+int main() {
+    test_retired_cap();
+    return math::test::finish("TraceTest");
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+// TrsmTest.cpp
+#include "Test.hpp"
+#include <vector>
+
+namespace {
+using math::matrix::SD;
+using math::matrix::TRI;
+using math::matrix::TR;
+using math::matrix::DG;
+
+// A well conditioned triangle(off diagonal entries scaled down by the size) and NaN everywhere the solve must not read.
+template <typename T>
+math::Matrix<T> stored_triangle(const size_t n, const TRI triangle, const DG diagonal, const size_t seed) {
+    return math::Matrix<T>(n, n, [=](size_t i, size_t j) {
+        if (i == j) return diagonal == DG::unit ? std::numeric_limits<T>::quiet_NaN() : T(2) + std::fabs(math::test::value_at<T>(i, j, seed));
+        if ((triangle == TRI::lower) != (j < i)) return std::numeric_limits<T>::quiet_NaN();
+        return math::test::value_at<T>(i, j, seed) / static_cast<T>(n);
+    });
+}
+
+// The triangle the solve is meant to see, ones on the diagonal if unit and zeros across it.
+template <typename T>
+math::Matrix<T> referenced_triangle(const math::Matrix<T> &a, const TRI triangle, const DG diagonal) {
+    return math::Matrix<T>(a.num_rows(), a.num_columns(), [&](size_t i, size_t j) {
+        if (i == j) return diagonal == DG::unit ? T(1) : a(i, j);
+        return ((triangle == TRI::lower) == (j < i)) ? a(i, j) : T(0);
+    });
+}
+
+template <typename T>
+void test_trsm(const double tolerance) {
+    // Sides of a around the 64 diagonal blocks, and right hand sides past a 256 chunk of the team.
+    const T alpha = T(1.5);
+    size_t seed = 0;
+    for (const size_t n : { size_t(1), size_t(7), size_t(65), size_t(130) })
+        for (const size_t count : { size_t(1), size_t(3), size_t(257) })
+            for (const SD side : { SD::left, SD::right })
+                for (const TRI triangle : { TRI::lower, TRI::upper })
+                    for (const TR ta : { TR::no, TR::yes })
+                        for (const DG diagonal : { DG::non_unit, DG::unit }) {
+                            const math::Matrix<T> a = stored_triangle<T>(n, triangle, diagonal, ++seed);
+                            const math::Matrix<T> reference = referenced_triangle(a, triangle, diagonal);
+                            const bool is_left = side == SD::left;
+                            const math::Matrix<T> b = is_left ? math::test::filled<T>(n, count, ++seed) : math::test::filled<T>(count, n, ++seed);
+                            math::Matrix<T> x = b;
+                            math::trsm(alpha, a, side, triangle, ta, diagonal, x);
+                            const math::Matrix<T> product = is_left ? math::test::naive_multiply(reference, ta, x, TR::no) : math::test::naive_multiply(x, TR::no, reference, ta);
+                            const math::Matrix<T> scaled(b.num_rows(), b.num_columns(), [&](size_t i, size_t j) { return alpha * b(i, j); });
+                            _CHECK_(math::test::max_difference(product, scaled) <= tolerance * static_cast<double>(n));
+                        }
+}
+
+template <typename T>
+void test_trsv(const double tolerance) {
+    // Sides around the 256 diagonal blocks of the vector solve.
+    size_t seed = 100;
+    for (const size_t n : { size_t(1), size_t(7), size_t(257), size_t(300) })
+        for (const TRI triangle : { TRI::lower, TRI::upper })
+            for (const TR ta : { TR::no, TR::yes })
+                for (const DG diagonal : { DG::non_unit, DG::unit }) {
+                    const math::Matrix<T> a = stored_triangle<T>(n, triangle, diagonal, ++seed);
+                    const math::Matrix<T> reference = referenced_triangle(a, triangle, diagonal);
+                    const math::Matrix<T> b = math::test::filled<T>(n, 1, ++seed);
+                    std::vector<T> x(n);
+                    for (size_t i = 0; i < n; i++) x[i] = b(i, 0);
+                    math::trsv(a, triangle, ta, diagonal, std::span<T>(x));
+                    const math::Matrix<T> column(n, 1, [&x](size_t i, size_t) { return x[i]; });
+                    _CHECK_(math::test::max_difference(math::test::naive_multiply(reference, ta, column, TR::no), b) <= tolerance * static_cast<double>(n));
+                }
+}
+
+void test_trsm_edges() {
+    const math::Matrix<double> a = math::test::identity<double>(3);
+    math::Matrix<double> b(3, 4), c(4, 3), e;
+    _CHECK_THROWS_(std::invalid_argument, math::trsm(1.0, a, SD::right, TRI::lower, TR::no, DG::non_unit, b));
+    _CHECK_THROWS_(std::invalid_argument, math::trsm(1.0, a, SD::left, TRI::lower, TR::no, DG::non_unit, c));
+    _CHECK_THROWS_(std::invalid_argument, math::trsm(1.0, math::Matrix<double>(3, 4), SD::left, TRI::lower, TR::no, DG::non_unit, b));
+    math::Matrix<double> d = a;
+    _CHECK_THROWS_(std::invalid_argument, math::trsm(1.0, d, SD::left, TRI::lower, TR::no, DG::non_unit, d));
+    math::trsm(1.0, math::Matrix<double>(), SD::left, TRI::lower, TR::no, DG::non_unit, e);
+    _CHECK_(e.size() == 0);
+    std::vector<double> x(2);
+    _CHECK_THROWS_(std::invalid_argument, math::trsv(a, TRI::upper, TR::no, DG::unit, std::span<double>(x)));
+}
+}
+
+int main() {
+    test_trsm<double>(1e-14);
+    test_trsm<float>(1e-5);
+    test_trsv<double>(1e-14);
+    test_trsv<float>(1e-5);
+    test_trsm_edges();
+    return math::test::finish("TrsmTest");
+}
\ No newline at end of file
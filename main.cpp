@@ -1,4 +1,4 @@
-#include "Expression\Utility\Variable\VariableString.hpp"
+#include "Expression/Utility/Variable/VariableString.hpp"
 #include <iostream>
 
 int main(void) {